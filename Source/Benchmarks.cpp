@@ -0,0 +1,1648 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmarks.cpp
+// ============
+// command line microbenchmarks for the scene rendering code
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Benchmarks.h"
+
+#include "BoundingVolumeTree.h"
+#include "CommandList.h"
+#include "Frustum.h"
+#include "ImageKernels.h"
+#include "InstanceRenderer.h"
+#include "JobSystem.h"
+#include "MaterialBuffer.h"
+#include "OcclusionCuller.h"
+#include "PrimitiveGeometry.h"
+#include "RenderQueue.h"
+#include "SceneGraph.h"
+#include "SceneManager.h"
+#include "ShaderManager.h"
+#include "ShaderStateCache.h"
+#include "TagRegistry.h"
+#include "TransformStore.h"
+#include "stb_image.h"
+
+#include "GLFW/glfw3.h"
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// number of draws in one simulated frame
+	const int g_DrawsPerFrame = 256;
+	// number of simulated frames timed for each tag count
+	const int g_FrameCount = 200;
+
+	// keeps the optimizer from removing the timed lookups
+	volatile float g_Sink = 0.0f;
+
+	/***********************************************************
+	 *  FindTextureByScan()
+	 *
+	 *  The texture lookup used before tags were interned - the
+	 *  tag is passed by value and compared against every
+	 *  loaded texture until it matches.
+	 ***********************************************************/
+	int FindTextureByScan(
+		const std::vector<SceneManager::TEXTURE_INFO>& textures,
+		std::string tag)
+	{
+		int textureSlot = -1;
+		int index = 0;
+		bool bFound = false;
+
+		while ((index < (int)textures.size()) && (bFound == false))
+		{
+			if (textures[index].tag.compare(tag) == 0)
+			{
+				textureSlot = index;
+				bFound = true;
+			}
+			else
+			{
+				index++;
+			}
+		}
+
+		return(textureSlot);
+	}
+
+	/***********************************************************
+	 *  FindMaterialByScan()
+	 *
+	 *  The material lookup used before tags were interned -
+	 *  the tag is passed by value, compared against every
+	 *  defined material, and the match is copied out.
+	 ***********************************************************/
+	bool FindMaterialByScan(
+		const std::vector<SceneManager::OBJECT_MATERIAL>& materials,
+		std::string tag,
+		SceneManager::OBJECT_MATERIAL& material)
+	{
+		int index = 0;
+		bool bFound = false;
+
+		while ((index < (int)materials.size()) && (bFound == false))
+		{
+			if (materials[index].tag.compare(tag) == 0)
+			{
+				bFound = true;
+				material = materials[index];
+			}
+			else
+			{
+				index++;
+			}
+		}
+
+		return(bFound);
+	}
+
+	/***********************************************************
+	 *  MakeTag()
+	 *
+	 *  Build a tag name for the benchmark data.  The tags share
+	 *  a prefix, like real texture names often do, so every
+	 *  compare has to look past the first few characters.
+	 ***********************************************************/
+	std::string MakeTag(int index)
+	{
+		return("scene_tag_" + std::to_string(index));
+	}
+
+	/***********************************************************
+	 *  FlipByRowCopy()
+	 *
+	 *  The flip stb_image did while loading - rows are swapped
+	 *  through a small buffer with memcpy.
+	 ***********************************************************/
+	void FlipByRowCopy(unsigned char* pixels, size_t rowSize, int height)
+	{
+		unsigned char temp[2048];
+		for (int y = 0; y < height / 2; y++)
+		{
+			unsigned char* row0 = pixels + (size_t)y * rowSize;
+			unsigned char* row1 = pixels + (size_t)(height - 1 - y) * rowSize;
+			size_t left = rowSize;
+			while (left > 0)
+			{
+				size_t count = (left < sizeof(temp)) ? left : sizeof(temp);
+				memcpy(temp, row0, count);
+				memcpy(row0, row1, count);
+				memcpy(row1, temp, count);
+				row0 += count;
+				row1 += count;
+				left -= count;
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  DownsampleBox()
+	 *
+	 *  The mip filter the texture cooker used before - each
+	 *  2x2 block of 8-bit values is averaged without gamma
+	 *  correction.
+	 ***********************************************************/
+	void DownsampleBox(
+		const unsigned char* source, int sourceWidth, int sourceHeight,
+		unsigned char* destination, int width, int height,
+		int colorChannels)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			int y0 = (2 * y < sourceHeight) ? 2 * y : sourceHeight - 1;
+			int y1 = (2 * y + 1 < sourceHeight) ? 2 * y + 1 : sourceHeight - 1;
+			const unsigned char* row0 = source + (size_t)y0 * sourceWidth * colorChannels;
+			const unsigned char* row1 = source + (size_t)y1 * sourceWidth * colorChannels;
+
+			for (int x = 0; x < width; x++)
+			{
+				int x0 = ((2 * x < sourceWidth) ? 2 * x : sourceWidth - 1) * colorChannels;
+				int x1 = ((2 * x + 1 < sourceWidth) ? 2 * x + 1 : sourceWidth - 1) * colorChannels;
+
+				for (int c = 0; c < colorChannels; c++)
+				{
+					int sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+					*destination++ = (unsigned char)((sum + 2) >> 2);
+				}
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  BuildMipChain()
+	 *
+	 *  Build every mip level below an image with a filter,
+	 *  the way the texture cooker does.
+	 ***********************************************************/
+	void BuildMipChain(
+		const unsigned char* pixels, int width, int height, int colorChannels,
+		std::vector<unsigned char>& scratch,
+		void (*filter)(const unsigned char*, int, int, unsigned char*, int, int, int))
+	{
+		scratch.resize((size_t)width * height * colorChannels);
+		const unsigned char* source = pixels;
+		unsigned char* destination = &scratch[0];
+		while ((width > 1) || (height > 1))
+		{
+			int levelWidth = (width > 1) ? width / 2 : 1;
+			int levelHeight = (height > 1) ? height / 2 : 1;
+			filter(source, width, height, destination, levelWidth, levelHeight, colorChannels);
+			source = destination;
+			destination += (size_t)levelWidth * levelHeight * colorChannels;
+			width = levelWidth;
+			height = levelHeight;
+		}
+	}
+
+	/***********************************************************
+	 *  MakeTransforms()
+	 *
+	 *  Build transforms for the benchmark objects, spread by a
+	 *  fixed pseudo random sequence so that, like the scene's
+	 *  objects, they are all different.
+	 ***********************************************************/
+	void MakeTransforms(
+		int objectCount,
+		std::vector<glm::vec3>& scales,
+		std::vector<glm::vec3>& rotations,
+		std::vector<glm::vec3>& positions)
+	{
+		unsigned int seed = 12345;
+		for (int i = 0; i < objectCount; i++)
+		{
+			float values[9];
+			for (int v = 0; v < 9; v++)
+			{
+				seed = seed * 1103515245u + 12345u;
+				values[v] = (float)((seed >> 8) % 1000u) / 10.0f;
+			}
+			scales.push_back(glm::vec3(values[0], values[1], values[2]) / 50.0f + glm::vec3(0.1f));
+			rotations.push_back(glm::vec3(values[3], values[4], values[5]) * 3.6f);
+			positions.push_back(glm::vec3(values[6], values[7], values[8]) - glm::vec3(50.0f));
+		}
+	}
+
+	/***********************************************************
+	 *  TimeBest()
+	 *
+	 *  Run some work a few times and return the fastest run in
+	 *  milliseconds.
+	 ***********************************************************/
+	double TimeBest(int runs, const std::function<void()>& work)
+	{
+		double best = 0.0;
+		for (int run = 0; run < runs; run++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			work();
+			double milliseconds = std::chrono::duration<double, std::milli>(
+				std::chrono::steady_clock::now() - start).count();
+			if ((run == 0) || (milliseconds < best))
+			{
+				best = milliseconds;
+			}
+		}
+		return(best);
+	}
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for running the benchmark with the
+ *  passed in name.  It returns false for an unknown name.
+ ***********************************************************/
+bool Benchmarks::Run(const std::string& name)
+{
+	bool bAll = (name == "all");
+	bool bFound = false;
+
+	if (bAll || (name == "tags"))
+	{
+		RunTagLookup();
+		bFound = true;
+	}
+
+	if (bAll || (name == "kernels"))
+	{
+		RunImageKernels();
+		bFound = true;
+	}
+
+	if (bAll || (name == "transforms"))
+	{
+		RunTransforms();
+		bFound = true;
+	}
+
+	if (bAll || (name == "compose"))
+	{
+		RunComposeBatch();
+		bFound = true;
+	}
+
+	if (bAll || (name == "graph"))
+	{
+		RunSceneGraph();
+		bFound = true;
+	}
+
+	if (bAll || (name == "normals"))
+	{
+		RunNormalMatrix();
+		bFound = true;
+	}
+
+	if (bAll || (name == "instancing"))
+	{
+		RunInstancing();
+		bFound = true;
+	}
+
+	if (bAll || (name == "renderqueue"))
+	{
+		RunRenderQueue();
+		bFound = true;
+	}
+
+	if (bAll || (name == "commandlist"))
+	{
+		RunCommandList();
+		bFound = true;
+	}
+
+	if (bAll || (name == "jobs"))
+	{
+		RunJobs();
+		bFound = true;
+	}
+
+	if (bAll || (name == "culling"))
+	{
+		RunCulling();
+		bFound = true;
+	}
+
+	if (bAll || (name == "occlusion"))
+	{
+		RunOcclusion();
+		bFound = true;
+	}
+
+	if (bFound == false)
+	{
+		std::cout << "ERROR: unknown benchmark \"" << name << "\"" << std::endl;
+		std::cout << "benchmarks: all, tags, kernels, transforms, compose, graph, normals, instancing, renderqueue, commandlist, jobs, culling, occlusion" << std::endl;
+	}
+
+	return(bFound);
+}
+
+/***********************************************************
+ *  RunTagLookup()
+ *
+ *  This method is used for timing the per-draw cost of
+ *  selecting a texture and a material, first by scanning for
+ *  the tag strings and then by indexing with interned
+ *  handles, with 20, 200 and 2000 registered tags.
+ ***********************************************************/
+void Benchmarks::RunTagLookup()
+{
+	const int tagCounts[] = { 20, 200, 2000 };
+
+	std::cout << "tag lookup, " << g_DrawsPerFrame << " draws per frame, "
+		<< g_FrameCount << " frames" << std::endl;
+
+	for (int countIndex = 0; countIndex < 3; countIndex++)
+	{
+		int tagCount = tagCounts[countIndex];
+
+		std::vector<SceneManager::TEXTURE_INFO> textures;
+		std::vector<SceneManager::OBJECT_MATERIAL> materials;
+		TagRegistry textureTags;
+		TagRegistry materialTags;
+		for (int i = 0; i < tagCount; i++)
+		{
+			SceneManager::TEXTURE_INFO info;
+			info.tag = MakeTag(i);
+			info.ID = (uint32_t)i;
+			textures.push_back(info);
+			textureTags.Register(info.tag);
+
+			SceneManager::OBJECT_MATERIAL material;
+			material.ambientStrength = 0.1f;
+			material.ambientColor = glm::vec3(0.1f);
+			material.diffuseColor = glm::vec3((float)i);
+			material.specularColor = glm::vec3(0.5f);
+			material.shininess = 32.0f;
+			material.tag = MakeTag(i);
+			materials.push_back(material);
+			materialTags.Register(material.tag);
+		}
+
+		// the tags drawn in one frame, spread over the whole
+		// range by a fixed pseudo random sequence
+		std::vector<std::string> drawTags;
+		unsigned int seed = 12345;
+		for (int i = 0; i < g_DrawsPerFrame; i++)
+		{
+			seed = seed * 1103515245u + 12345u;
+			drawTags.push_back(MakeTag((int)((seed >> 8) % (unsigned int)tagCount)));
+		}
+
+		// before - every draw searches for its tags
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < g_FrameCount; frame++)
+		{
+			for (int draw = 0; draw < g_DrawsPerFrame; draw++)
+			{
+				SceneManager::OBJECT_MATERIAL material;
+				int slot = FindTextureByScan(textures, drawTags[draw]);
+				if (FindMaterialByScan(materials, drawTags[draw], material))
+				{
+					g_Sink = g_Sink + material.diffuseColor.x + (float)textures[slot].ID;
+				}
+			}
+		}
+		double scanNanoseconds = std::chrono::duration<double, std::nano>(
+			std::chrono::steady_clock::now() - start).count();
+
+		// after - the tags are resolved once, then every draw
+		// indexes by handle
+		std::vector<int> textureHandles;
+		std::vector<int> materialHandles;
+		for (int draw = 0; draw < g_DrawsPerFrame; draw++)
+		{
+			textureHandles.push_back(textureTags.Find(drawTags[draw]));
+			materialHandles.push_back(materialTags.Find(drawTags[draw]));
+		}
+
+		start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < g_FrameCount; frame++)
+		{
+			for (int draw = 0; draw < g_DrawsPerFrame; draw++)
+			{
+				const SceneManager::OBJECT_MATERIAL& material = materials[materialHandles[draw]];
+				g_Sink = g_Sink + material.diffuseColor.x + (float)textures[textureHandles[draw]].ID;
+			}
+		}
+		double handleNanoseconds = std::chrono::duration<double, std::nano>(
+			std::chrono::steady_clock::now() - start).count();
+
+		double lookups = (double)g_DrawsPerFrame * g_FrameCount;
+		std::cout << "  " << tagCount << " tags: string scan "
+			<< scanNanoseconds / lookups << " ns/draw, handle "
+			<< handleNanoseconds / lookups << " ns/draw" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  RunImageKernels()
+ *
+ *  This method is used for timing each load time pixel
+ *  kernel on every scene texture, with each instruction set
+ *  the CPU supports, against the way the same work was done
+ *  before.  The flip is compared with stb_image's row copy
+ *  and the gamma-correct mips with the old 8-bit box filter.
+ *  RGB to RGBA expansion used to be left to the driver and
+ *  premultiplying is new, so those are only compared with
+ *  their scalar versions.  Premultiplying runs on the
+ *  expanded pixels, as the scene textures have no alpha.
+ ***********************************************************/
+void Benchmarks::RunImageKernels()
+{
+	const int runs = 5;
+	ImageKernels::ISA supported = ImageKernels::GetSupportedISA();
+	ImageKernels::ISA original = ImageKernels::GetISA();
+	std::vector<TextureLoader::TEXTURE_REQUEST> requests;
+	SceneManager::GetSceneTextureRequests(requests);
+
+	// totals over every texture, the before path first and then
+	// one per instruction set
+	double flip[4] = { 0.0, 0.0, 0.0, 0.0 };
+	double expand[4] = { 0.0, 0.0, 0.0, 0.0 };
+	double premultiply[4] = { 0.0, 0.0, 0.0, 0.0 };
+	double mips[4] = { 0.0, 0.0, 0.0, 0.0 };
+	size_t pixelCount = 0;
+	int imageCount = 0;
+
+	stbi_set_flip_vertically_on_load(false);
+	for (size_t i = 0; i < requests.size(); i++)
+	{
+		int width = 0;
+		int height = 0;
+		int colorChannels = 0;
+		unsigned char* pixels = stbi_load(requests[i].filename.c_str(), &width, &height, &colorChannels, 0);
+		if (NULL == pixels)
+		{
+			std::cout << "  could not load " << requests[i].filename << std::endl;
+			continue;
+		}
+		if ((colorChannels != 3) && (colorChannels != 4))
+		{
+			stbi_image_free(pixels);
+			continue;
+		}
+
+		size_t count = (size_t)width * height;
+		size_t rowSize = (size_t)width * colorChannels;
+		std::vector<unsigned char> rgba(count * 4);
+		std::vector<unsigned char> work(count * 4);
+		std::vector<unsigned char> scratch;
+		pixelCount += count;
+		imageCount++;
+
+		if (colorChannels == 3)
+		{
+			ImageKernels::ExpandRGBToRGBA(pixels, &rgba[0], count);
+		}
+		else
+		{
+			memcpy(&rgba[0], pixels, count * 4);
+		}
+
+		flip[0] += TimeBest(runs, [&]() { FlipByRowCopy(pixels, rowSize, height); });
+		mips[0] += TimeBest(runs, [&]() { BuildMipChain(pixels, width, height, colorChannels, scratch, DownsampleBox); });
+
+		for (int isa = ImageKernels::ISA_SCALAR; isa <= supported; isa++)
+		{
+			ImageKernels::SetISA((ImageKernels::ISA)isa);
+			flip[isa + 1] += TimeBest(runs, [&]() { ImageKernels::FlipVertical(pixels, rowSize, height); });
+			if (colorChannels == 3)
+			{
+				expand[isa + 1] += TimeBest(runs, [&]() { ImageKernels::ExpandRGBToRGBA(pixels, &work[0], count); });
+			}
+			premultiply[isa + 1] += TimeBest(runs, [&]()
+			{
+				memcpy(&work[0], &rgba[0], count * 4);
+				ImageKernels::PremultiplyAlpha(&work[0], count);
+			});
+			mips[isa + 1] += TimeBest(runs, [&]()
+			{
+				BuildMipChain(pixels, width, height, colorChannels, scratch, ImageKernels::DownsampleSRGB);
+			});
+		}
+
+		stbi_image_free(pixels);
+	}
+	ImageKernels::SetISA(original);
+
+	std::cout << "image kernels, " << imageCount << " scene textures, "
+		<< std::fixed << std::setprecision(1) << pixelCount / 1000000.0 << " megapixels, best of "
+		<< runs << " runs" << std::endl;
+
+	const char* names[4] = { "flip", "rgb to rgba", "premultiply", "mip chain" };
+	const char* before[4] = { "stb row copy", NULL, NULL, "8-bit box" };
+	double* totals[4] = { flip, expand, premultiply, mips };
+	for (int kernel = 0; kernel < 4; kernel++)
+	{
+		std::cout << "  " << names[kernel] << ":";
+		if (NULL != before[kernel])
+		{
+			std::cout << " " << before[kernel] << " " << totals[kernel][0] << " ms,";
+		}
+		for (int isa = ImageKernels::ISA_SCALAR; isa <= supported; isa++)
+		{
+			std::cout << " " << ImageKernels::GetISAName((ImageKernels::ISA)isa) << " " << totals[kernel][isa + 1] << " ms";
+			std::cout << ((isa < supported) ? "," : "");
+		}
+		std::cout << std::endl;
+	}
+	std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+/***********************************************************
+ *  RunTransforms()
+ *
+ *  This method is used for timing the model matrix work of
+ *  one frame as the number of objects grows, composing every
+ *  matrix in every frame as SetTransformations() used to,
+ *  against the transform store when nothing moves and when
+ *  one object in ten moves every frame.
+ ***********************************************************/
+void Benchmarks::RunTransforms()
+{
+	const int objectCounts[] = { 50, 500, 5000, 50000 };
+
+	std::cout << "model matrices, " << g_FrameCount << " frames" << std::endl;
+
+	for (int countIndex = 0; countIndex < 4; countIndex++)
+	{
+		int objectCount = objectCounts[countIndex];
+
+		std::vector<glm::vec3> scales;
+		std::vector<glm::vec3> rotations;
+		std::vector<glm::vec3> positions;
+		MakeTransforms(objectCount, scales, rotations, positions);
+
+		// before - every matrix is composed in every frame
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < g_FrameCount; frame++)
+		{
+			for (int i = 0; i < objectCount; i++)
+			{
+				glm::mat4 model = TransformStore::Compose(scales[i], rotations[i].x, rotations[i].y, rotations[i].z, positions[i]);
+				g_Sink = g_Sink + model[3][0];
+			}
+		}
+		double composeMilliseconds = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count();
+
+		// after - the store composes a matrix only when its
+		// transform changed, first with every object static and
+		// then with one in ten turning a little every frame
+		double storeMilliseconds[2] = { 0.0, 0.0 };
+		unsigned long long storeComposed[2] = { 0, 0 };
+		for (int moving = 0; moving < 2; moving++)
+		{
+			TransformStore store;
+			for (int i = 0; i < objectCount; i++)
+			{
+				store.Add();
+				store.SetTransform(i, scales[i], rotations[i].x, rotations[i].y, rotations[i].z, positions[i]);
+				store.GetMatrix(i);
+			}
+			unsigned long long composedBefore = store.GetTotalComposedCount();
+
+			start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < g_FrameCount; frame++)
+			{
+				for (int i = 0; i < objectCount; i++)
+				{
+					float yRotation = rotations[i].y;
+					if ((moving == 1) && (i % 10 == 0))
+					{
+						yRotation += (float)(frame + 1);
+					}
+					store.SetTransform(i, scales[i], rotations[i].x, yRotation, rotations[i].z, positions[i]);
+					g_Sink = g_Sink + store.GetMatrix(i)[3][0];
+				}
+			}
+			storeMilliseconds[moving] = std::chrono::duration<double, std::milli>(
+				std::chrono::steady_clock::now() - start).count();
+			storeComposed[moving] = store.GetTotalComposedCount() - composedBefore;
+		}
+
+		std::cout << "  " << objectCount << " objects: compose every frame "
+			<< composeMilliseconds / g_FrameCount << " ms/frame (" << objectCount << " composed), store static "
+			<< storeMilliseconds[0] / g_FrameCount << " ms/frame (" << storeComposed[0] / g_FrameCount << " composed), store 10% moving "
+			<< storeMilliseconds[1] / g_FrameCount << " ms/frame (" << storeComposed[1] / g_FrameCount << " composed)" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  RunComposeBatch()
+ *
+ *  This method is used for timing the composition of every
+ *  model matrix in a frame where every object moves, with
+ *  glm one object at a time as SetTransformations() does,
+ *  against the transform store composing the dirty objects
+ *  with each instruction set the CPU supports.  The largest
+ *  difference from the glm matrices is printed as well.
+ ***********************************************************/
+void Benchmarks::RunComposeBatch()
+{
+	const int objectCounts[] = { 50, 500, 5000, 50000 };
+	ImageKernels::ISA supported = ImageKernels::GetSupportedISA();
+	ImageKernels::ISA original = ImageKernels::GetISA();
+
+	std::cout << "model matrix composition, every object moving, " << g_FrameCount << " frames" << std::endl;
+
+	for (int countIndex = 0; countIndex < 4; countIndex++)
+	{
+		int objectCount = objectCounts[countIndex];
+		std::vector<glm::vec3> scales;
+		std::vector<glm::vec3> rotations;
+		std::vector<glm::vec3> positions;
+		MakeTransforms(objectCount, scales, rotations, positions);
+
+		// before - glm composes each matrix in turn
+		std::vector<glm::mat4> expected(objectCount);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < g_FrameCount; frame++)
+		{
+			for (int i = 0; i < objectCount; i++)
+			{
+				expected[i] = TransformStore::Compose(scales[i], rotations[i].x, rotations[i].y + (float)frame, rotations[i].z, positions[i]);
+			}
+			g_Sink = g_Sink + expected[frame % objectCount][3][0];
+		}
+		double glmMilliseconds = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count();
+
+		std::cout << "  " << objectCount << " objects: glm " << glmMilliseconds / g_FrameCount << " ms/frame";
+
+		// after - the store composes every dirty object at once
+		// with the scalar path and the AVX2 kernel
+		for (int isa = ImageKernels::ISA_SCALAR; isa <= supported; isa++)
+		{
+			if (isa == ImageKernels::ISA_SSSE3)
+			{
+				continue;
+			}
+			ImageKernels::SetISA((ImageKernels::ISA)isa);
+
+			TransformStore store;
+			for (int i = 0; i < objectCount; i++)
+			{
+				store.Add();
+			}
+
+			start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < g_FrameCount; frame++)
+			{
+				for (int i = 0; i < objectCount; i++)
+				{
+					store.SetTransform(i, scales[i], rotations[i].x, rotations[i].y + (float)frame, rotations[i].z, positions[i]);
+				}
+				store.UpdateMatrices();
+				g_Sink = g_Sink + store.GetMatrix(frame % objectCount)[3][0];
+			}
+			double storeMilliseconds = std::chrono::duration<double, std::milli>(
+				std::chrono::steady_clock::now() - start).count();
+
+			// the last frame of both is compared, relative to the
+			// largest value in each matrix
+			float largestError = 0.0f;
+			for (int i = 0; i < objectCount; i++)
+			{
+				const glm::mat4& matrix = store.GetMatrix(i);
+				float largest = 1.0f;
+				float error = 0.0f;
+				for (int column = 0; column < 4; column++)
+				{
+					for (int row = 0; row < 4; row++)
+					{
+						float value = expected[i][column][row];
+						float difference = matrix[column][row] - value;
+						largest = (value > largest) ? value : ((-value > largest) ? -value : largest);
+						error = (difference > error) ? difference : ((-difference > error) ? -difference : error);
+					}
+				}
+				largestError = (error / largest > largestError) ? error / largest : largestError;
+			}
+
+			std::cout << ", store " << ImageKernels::GetISAName((ImageKernels::ISA)isa) << " "
+				<< storeMilliseconds / g_FrameCount << " ms/frame (error " << largestError << ")";
+		}
+		std::cout << std::endl;
+	}
+	ImageKernels::SetISA(original);
+}
+
+/***********************************************************
+ *  RunSceneGraph()
+ *
+ *  This method is used for timing a frame in which one group
+ *  of parts moves, like the candle with its jar, wax, wicks
+ *  and flames, out of a growing number of groups.  Placing
+ *  every part by hand from its group position, as the render
+ *  functions used to, is compared with the scene graph,
+ *  which only recomputes the moved group.
+ ***********************************************************/
+void Benchmarks::RunSceneGraph()
+{
+	const int groupCounts[] = { 10, 100, 1000, 10000 };
+	const int partsPerGroup = 7;
+
+	std::cout << "scene graph, one group of " << partsPerGroup << " parts moving, "
+		<< g_FrameCount << " frames" << std::endl;
+
+	for (int countIndex = 0; countIndex < 4; countIndex++)
+	{
+		int groupCount = groupCounts[countIndex];
+		int partCount = groupCount * partsPerGroup;
+		std::vector<glm::vec3> scales;
+		std::vector<glm::vec3> rotations;
+		std::vector<glm::vec3> offsets;
+		MakeTransforms(partCount, scales, rotations, offsets);
+		std::vector<glm::vec3> groupPositions(groupCount, glm::vec3(0.0f));
+
+		// before - every part is composed from its group position
+		// plus its offset in every frame
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < g_FrameCount; frame++)
+		{
+			groupPositions[frame % groupCount].x += 0.01f;
+			for (int part = 0; part < partCount; part++)
+			{
+				glm::mat4 model = TransformStore::Compose(scales[part], rotations[part].x, rotations[part].y, rotations[part].z,
+					groupPositions[part / partsPerGroup] + offsets[part]);
+				g_Sink = g_Sink + model[3][0];
+			}
+		}
+		double flatMilliseconds = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count();
+
+		// after - the groups are nodes with their parts below them
+		TransformStore localTransforms;
+		SceneGraph graph(&localTransforms);
+		std::vector<int> groups;
+		std::vector<int> parts;
+		for (int group = 0; group < groupCount; group++)
+		{
+			groups.push_back(graph.AddNode(-1));
+			for (int part = 0; part < partsPerGroup; part++)
+			{
+				int index = group * partsPerGroup + part;
+				parts.push_back(graph.AddNode(groups[group]));
+				graph.SetLocalTransform(parts[index], scales[index], rotations[index].x, rotations[index].y, rotations[index].z, offsets[index]);
+			}
+		}
+		graph.UpdateWorldMatrices();
+		std::fill(groupPositions.begin(), groupPositions.end(), glm::vec3(0.0f));
+		unsigned long long updatedBefore = graph.GetTotalUpdatedCount();
+
+		start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < g_FrameCount; frame++)
+		{
+			int group = frame % groupCount;
+			groupPositions[group].x += 0.01f;
+			graph.SetLocalTransform(groups[group], glm::vec3(1.0f), 0.0f, 0.0f, 0.0f, groupPositions[group]);
+			for (int part = 0; part < partCount; part++)
+			{
+				g_Sink = g_Sink + graph.GetWorldMatrix(parts[part])[3][0];
+			}
+		}
+		double graphMilliseconds = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count();
+		unsigned long long updated = graph.GetTotalUpdatedCount() - updatedBefore;
+
+		std::cout << "  " << groupCount << " groups: by hand " << flatMilliseconds / g_FrameCount << " ms/frame ("
+			<< partCount << " composed), scene graph " << graphMilliseconds / g_FrameCount << " ms/frame ("
+			<< updated / g_FrameCount << " world matrices recomputed)" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  RunNormalMatrix()
+ *
+ *  This method is used for estimating the vertex stage work
+ *  saved by finding the normal matrix once per object.  The
+ *  vertex shader's normal transform is run on the CPU for
+ *  every vertex of a draw, first inverting the model matrix
+ *  for each vertex as the shader used to, then with the
+ *  normal matrix found once for the draw.  The draws have
+ *  256 to 16384 vertices and the model matrix of the candle
+ *  jar, the torus, whose scale is not uniform.
+ ***********************************************************/
+void Benchmarks::RunNormalMatrix()
+{
+	const int vertexCounts[] = { 256, 1024, 4096, 16384 };
+	const int runs = 5;
+	glm::mat4 model = TransformStore::Compose(glm::vec3(1.5f, 1.5f, 5.0f), 90.0f, 0.0f, 0.0f, glm::vec3(17.0f, 1.0f, 5.0f));
+
+	std::cout << "normal matrix per vertex and per draw, best of " << runs << " runs" << std::endl;
+
+	for (int countIndex = 0; countIndex < 4; countIndex++)
+	{
+		int vertexCount = vertexCounts[countIndex];
+		std::vector<glm::vec3> normals;
+		std::vector<glm::vec3> transformed(vertexCount);
+		for (int i = 0; i < vertexCount; i++)
+		{
+			float angle = (float)i * 0.37f;
+			normals.push_back(glm::vec3(std::cos(angle), std::sin(angle * 0.5f), std::sin(angle)));
+		}
+
+		// before - the inverse of the model matrix for every vertex
+		double perVertex = TimeBest(runs, [&]()
+		{
+			for (int i = 0; i < vertexCount; i++)
+			{
+				transformed[i] = glm::mat3(glm::transpose(glm::inverse(model))) * normals[i];
+			}
+			g_Sink = g_Sink + transformed[vertexCount - 1].x;
+		});
+
+		// after - the normal matrix once for the draw
+		double perDraw = TimeBest(runs, [&]()
+		{
+			glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+			for (int i = 0; i < vertexCount; i++)
+			{
+				transformed[i] = normalMatrix * normals[i];
+			}
+			g_Sink = g_Sink + transformed[vertexCount - 1].x;
+		});
+
+		std::cout << "  " << vertexCount << " vertices: inverse per vertex " << perVertex * 1000.0 << " us, "
+			<< "once per draw " << perDraw * 1000.0 << " us (" << perVertex / perDraw << "x)" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  RunInstancing()
+ *
+ *  This method is used for timing frames of 10000 lit basic
+ *  shapes, every part of every mesh in turn, drawn with the
+ *  scene shaders: first with one draw call per shape, the
+ *  way the scene used to draw, then with one instanced draw
+ *  call per part, and then, where the context has OpenGL
+ *  4.3 and ARB_shader_draw_parameters, with one multi-draw
+ *  indirect call for all of them.  A hidden window is
+ *  opened for the OpenGL context, the shapes are drawn into
+ *  an offscreen framebuffer, and every frame waits for the
+ *  GPU to finish, so the times include the rendering.  Run
+ *  it with LIBGL_ALWAYS_SOFTWARE=1 to time Mesa's llvmpipe.
+ ***********************************************************/
+void Benchmarks::RunInstancing()
+{
+	const int gridSize = 100;
+	const int shapeCount = gridSize * gridSize;
+	const int frames = 20;
+	const int width = 1280;
+	const int height = 720;
+
+	if (!glfwInit())
+	{
+		std::cout << "instancing: skipped, GLFW could not be initialized" << std::endl;
+		return;
+	}
+	// OpenGL 4.3 for multi-draw indirect, or 3.3 without it
+	GLFWwindow* window = NULL;
+	const int versions[2][2] = { { 4, 3 }, { 3, 3 } };
+	for (int version = 0; (version < 2) && (NULL == window); version++)
+	{
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, versions[version][0]);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, versions[version][1]);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		window = glfwCreateWindow(width, height, "benchmark", NULL, NULL);
+	}
+	if (NULL == window)
+	{
+		std::cout << "instancing: skipped, no OpenGL 3.3 context could be created" << std::endl;
+		glfwTerminate();
+		return;
+	}
+	glfwMakeContextCurrent(window);
+	if (glewInit() != GLEW_OK)
+	{
+		std::cout << "instancing: skipped, GLEW could not be initialized" << std::endl;
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		return;
+	}
+
+	bool bIndirect = InstanceRenderer::IsIndirectSupported();
+	std::cout << "instancing, " << shapeCount << " shapes at " << width << "x" << height << " on "
+		<< glGetString(GL_RENDERER) << ", " << frames << " frames" << std::endl;
+
+	{
+		// the same scene shaders, reading the instances as vertex
+		// attributes or from a shader storage buffer
+		ShaderManager shaders[2];
+		MaterialBuffer materials[2];
+		glm::vec3 eye = glm::vec3(0.0f, 80.0f, 120.0f);
+		for (int program = 0; program < (bIndirect ? 2 : 1); program++)
+		{
+			shaders[program].LoadShaders((program == 0) ? "vertexShader.glsl" : "vertexShaderIndirect.glsl", "fragmentShader.glsl");
+			shaders[program].use();
+
+			ShaderStateCache shaderState;
+			shaderState.Resolve();
+			shaderState.SetMat4(ShaderStateCache::UNIFORM_VIEW, glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+			shaderState.SetMat4(ShaderStateCache::UNIFORM_PROJECTION, glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 500.0f));
+			shaderState.SetVec3(ShaderStateCache::UNIFORM_VIEW_POSITION, eye);
+			shaderState.SetBool(ShaderStateCache::UNIFORM_USE_LIGHTING, true);
+			shaderState.SetVec3(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_POSITION), glm::vec3(-8.0f, 60.0f, 20.0f));
+			shaderState.SetVec3(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_AMBIENT_COLOR), glm::vec3(0.65f, 0.55f, 0.35f));
+			shaderState.SetVec3(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_DIFFUSE_COLOR), glm::vec3(0.25f, 0.25f, 0.25f));
+			shaderState.SetVec3(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_SPECULAR_COLOR), glm::vec3(0.55f, 0.55f, 0.55f));
+			shaderState.SetFloat(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_FOCAL_STRENGTH), 35.0f);
+			shaderState.SetFloat(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_SPECULAR_INTENSITY), 5.5f);
+
+			GLint programID = 0;
+			glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+			std::vector<MaterialBuffer::MATERIAL> material(1);
+			material[0].ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
+			material[0].ambientStrength = 0.3f;
+			material[0].diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
+			material[0].shininess = 22.0f;
+			material[0].specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
+			material[0].padding = 0.0f;
+			materials[program].Upload((GLuint)programID, material);
+		}
+
+		// draw offscreen, as a hidden window may not be drawn to
+		GLuint framebufferID = 0;
+		GLuint renderbufferIDs[2] = { 0, 0 };
+		glGenFramebuffers(1, &framebufferID);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
+		glGenRenderbuffers(2, renderbufferIDs);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbufferIDs[0]);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbufferIDs[0]);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbufferIDs[1]);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbufferIDs[1]);
+		glViewport(0, 0, width, height);
+		glEnable(GL_DEPTH_TEST);
+
+		PrimitiveGeometry geometry;
+
+		// a grid of shapes of different heights and colors
+		std::vector<InstanceRenderer::INSTANCE> instances(shapeCount);
+		for (int i = 0; i < shapeCount; i++)
+		{
+			float x = (float)(i % gridSize) - 0.5f * gridSize;
+			float z = (float)(i / gridSize) - 0.5f * gridSize;
+			InstanceRenderer::INSTANCE& instance = instances[i];
+			instance.model = TransformStore::Compose(glm::vec3(0.3f, 1.0f + 0.5f * std::sin(0.1f * i), 0.3f), 0.0f, 10.0f * i, 0.0f, glm::vec3(x, 0.0f, z));
+			glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(instance.model)));
+			for (int column = 0; column < 3; column++)
+			{
+				instance.normalMatrix[column] = glm::vec4(normalMatrix[column], 0.0f);
+			}
+			instance.color = glm::vec4(0.5f + 0.5f * std::sin(0.37f * i), 0.5f, 0.5f + 0.5f * std::cos(0.23f * i), 1.0f);
+			instance.textureRect = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+			instance.surface = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+			instance.flags = glm::ivec4(0, 0, 0, 0);
+		}
+
+		// draw every shape added to a renderer once per frame,
+		// flushing after every drawsPerFlush shapes
+		auto timeFrames = [&](InstanceRenderer& renderer, int drawsPerFlush)
+		{
+			return(TimeBest(1, [&]()
+			{
+				for (int frame = 0; frame < frames; frame++)
+				{
+					glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+					for (int first = 0; first < shapeCount; first += drawsPerFlush)
+					{
+						renderer.Begin(eye);
+						for (int i = first; (i < first + drawsPerFlush) && (i < shapeCount); i++)
+						{
+							renderer.Add((PrimitiveGeometry::PART)(i % PrimitiveGeometry::PART_COUNT), false, instances[i]);
+						}
+						renderer.Flush();
+					}
+					glFinish();
+				}
+			}));
+		};
+
+		// before - one draw call per shape
+		shaders[0].use();
+		InstanceRenderer renderer;
+		renderer.Create(geometry, false);
+		double perDraw = timeFrames(renderer, 1);
+
+		// after - one instanced draw call per part
+		double instanced = timeFrames(renderer, shapeCount);
+		std::cout << "  one draw call per shape " << perDraw / frames << " ms/frame (" << (1000.0 * frames) / perDraw << " fps), "
+			<< renderer.GetDrawCallCount() << " instanced draw calls " << instanced / frames << " ms/frame ("
+			<< (1000.0 * frames) / instanced << " fps, " << perDraw / instanced << "x)" << std::endl;
+		renderer.Destroy();
+
+		// and one multi-draw indirect call for every part
+		if (bIndirect)
+		{
+			shaders[1].use();
+			renderer.Create(geometry, true);
+			double indirect = timeFrames(renderer, shapeCount);
+			std::cout << "  1 multi-draw indirect call of " << renderer.GetCommandCount() << " commands " << indirect / frames << " ms/frame ("
+				<< (1000.0 * frames) / indirect << " fps, " << perDraw / indirect << "x)" << std::endl;
+			renderer.Destroy();
+		}
+		else
+		{
+			std::cout << "  multi-draw indirect skipped, it needs OpenGL 4.3 and ARB_shader_draw_parameters" << std::endl;
+		}
+
+		materials[0].Destroy();
+		materials[1].Destroy();
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteRenderbuffers(2, renderbufferIDs);
+		glDeleteFramebuffers(1, &framebufferID);
+	}
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+}
+
+/***********************************************************
+ *  RunRenderQueue()
+ *
+ *  This method is used for timing the radix sort of the
+ *  render queue against std::stable_sort of the same keys,
+ *  for 64 to 16384 draws spread over 11 shape parts, 8
+ *  texture arrays and 16 materials, a quarter of them
+ *  transparent.  The state changes left after sorting are
+ *  printed next to the ones in the submitted order.
+ ***********************************************************/
+void Benchmarks::RunRenderQueue()
+{
+	const int drawCounts[] = { 64, 1024, 16384 };
+	const int runs = 20;
+
+	std::cout << "render queue sort, best of " << runs << " runs" << std::endl;
+
+	for (int countIndex = 0; countIndex < 3; countIndex++)
+	{
+		int drawCount = drawCounts[countIndex];
+		std::vector<uint64_t> keys;
+		for (int i = 0; i < drawCount; i++)
+		{
+			RenderQueue::PASS pass = ((i % 4) == 3) ? RenderQueue::PASS_TRANSPARENT : RenderQueue::PASS_OPAQUE;
+			int part = (i * 7) % PrimitiveGeometry::PART_COUNT;
+			int texture = ((i * 5) % 9) - 1;
+			int material = (i * 3) % 16;
+			float depth = 1.0f + 40.0f * (0.5f + 0.5f * std::sin(0.61f * i));
+			keys.push_back(RenderQueue::MakeKey(pass, part, texture, material, depth));
+		}
+
+		// before - a comparison sort of the keys and their draws
+		std::vector<std::pair<uint64_t, unsigned int> > sorted;
+		double comparison = TimeBest(runs, [&]()
+		{
+			sorted.clear();
+			for (int i = 0; i < drawCount; i++)
+			{
+				sorted.push_back(std::make_pair(keys[i], (unsigned int)i));
+			}
+			std::stable_sort(sorted.begin(), sorted.end(),
+				[](const std::pair<uint64_t, unsigned int>& a, const std::pair<uint64_t, unsigned int>& b) { return(a.first < b.first); });
+			g_Sink = g_Sink + (float)sorted[0].second;
+		});
+
+		// after - the radix sort of the render queue
+		RenderQueue queue;
+		double radix = TimeBest(runs, [&]()
+		{
+			queue.Clear();
+			for (int i = 0; i < drawCount; i++)
+			{
+				queue.Push(keys[i], (unsigned int)i);
+			}
+			queue.Sort();
+			g_Sink = g_Sink + (float)queue.GetItem(0);
+		});
+
+		std::cout << "  " << drawCount << " draws: std::stable_sort " << comparison * 1000.0 << " us, "
+			<< "radix " << radix * 1000.0 << " us (" << comparison / radix << "x), state changes mesh "
+			<< queue.GetSubmittedChanges(RenderQueue::STATE_MESH) << " -> " << queue.GetSortedChanges(RenderQueue::STATE_MESH)
+			<< ", texture " << queue.GetSubmittedChanges(RenderQueue::STATE_TEXTURE) << " -> " << queue.GetSortedChanges(RenderQueue::STATE_TEXTURE)
+			<< ", material " << queue.GetSubmittedChanges(RenderQueue::STATE_MATERIAL) << " -> " << queue.GetSortedChanges(RenderQueue::STATE_MATERIAL)
+			<< std::endl;
+	}
+}
+
+/***********************************************************
+ *  RunCommandList()
+ *
+ *  This method is used for timing a frame of 16384 draws
+ *  defined the way RenderScene used to, composing each
+ *  model matrix, its normal matrix and the draw's values
+ *  every frame, against replaying the same draws from a
+ *  recorded command list.  Recording is then timed on 1 to
+ *  N threads, each recording its share of the objects into a
+ *  list of its own that is appended in order at the end.
+ ***********************************************************/
+void Benchmarks::RunCommandList()
+{
+	const int objectCount = 16384;
+	const int runs = 10;
+
+	// one object - a shape part, its color and its transform,
+	// a third of them scaled unevenly
+	struct OBJECT
+	{
+		int part;
+		glm::vec4 color;
+		glm::vec3 scale;
+		glm::vec3 rotation;
+		glm::vec3 position;
+	};
+	std::vector<OBJECT> objects(objectCount);
+	for (int i = 0; i < objectCount; i++)
+	{
+		objects[i].part = i % PrimitiveGeometry::PART_COUNT;
+		objects[i].color = glm::vec4((float)(i % 7) / 7.0f, (float)(i % 5) / 5.0f, (float)(i % 3) / 3.0f, 1.0f);
+		objects[i].scale = ((i % 3) == 0) ? glm::vec3(1.0f, 2.0f, 0.5f) : glm::vec3(1.5f);
+		objects[i].rotation = glm::vec3((float)(i % 90), (float)(i % 45), 0.0f);
+		objects[i].position = glm::vec3((float)(i % 128), 0.0f, (float)(i / 128));
+	}
+
+	// record the draws of a range of objects into a list
+	auto record = [&](CommandList& list, int first, int last)
+	{
+		for (int i = first; i < last; i++)
+		{
+			const OBJECT& object = objects[i];
+			glm::mat4 model = glm::translate(object.position) *
+				glm::rotate(glm::radians(object.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f)) *
+				glm::rotate(glm::radians(object.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f)) *
+				glm::rotate(glm::radians(object.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f)) *
+				glm::scale(object.scale);
+			bool bUniformScale = (object.scale.x == object.scale.y) && (object.scale.y == object.scale.z);
+			glm::mat3 normalMatrix(1.0f);
+			if (!bUniformScale)
+			{
+				normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+			}
+			list.SetColor(object.color);
+			list.SetMaterial(i % 4);
+			list.Draw(object.part, false, model, normalMatrix, bUniformScale);
+		}
+	};
+
+	// turn the commands of a list into the values of its draws
+	std::vector<InstanceRenderer::INSTANCE> instances(objectCount);
+	auto replay = [&](const CommandList& list)
+	{
+		size_t offset = 0;
+		size_t draw = 0;
+		CommandList::COMMAND command;
+		glm::vec4 color(1.0f);
+		int material = 0;
+		while (list.Read(offset, command))
+		{
+			if (command.opcode == CommandList::OP_COLOR)
+			{
+				color = command.color;
+			}
+			else if (command.opcode == CommandList::OP_MATERIAL)
+			{
+				material = command.handle;
+			}
+			else if (command.opcode == CommandList::OP_DRAW)
+			{
+				InstanceRenderer::INSTANCE& instance = instances[draw++];
+				instance.model = command.model;
+				for (int column = 0; column < 3; column++)
+				{
+					instance.normalMatrix[column] = glm::vec4(command.normalMatrix[column], 0.0f);
+				}
+				instance.color = color;
+				instance.flags = glm::ivec4(material, 0, 0, 0);
+			}
+		}
+		g_Sink = g_Sink + instances[draw - 1].model[3][0];
+	};
+
+	std::cout << "command list, " << objectCount << " draws, best of " << runs << " runs" << std::endl;
+
+	// before - every frame defines the scene again
+	CommandList list;
+	double define = TimeBest(runs, [&]()
+	{
+		list.Clear();
+		record(list, 0, objectCount);
+		replay(list);
+	});
+
+	// after - the recorded scene is replayed
+	double replayed = TimeBest(runs, [&]() { replay(list); });
+
+	std::cout << "  defined every frame " << define << " ms, replayed " << replayed << " ms (" << define / replayed << "x), "
+		<< list.GetCommandCount() << " commands in " << list.GetSize() / 1024 << " KB, "
+		<< (double)list.GetSize() / list.GetDrawCount() << " bytes per draw" << std::endl;
+
+	// recording the scene again on worker threads
+	int threadCount = (int)std::thread::hardware_concurrency();
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+	double single = 0.0;
+	for (int threads = 1; threads <= threadCount; threads *= 2)
+	{
+		std::vector<CommandList> lists(threads);
+		CommandList merged;
+		double recorded = TimeBest(runs, [&]()
+		{
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; t++)
+			{
+				int first = (int)((long long)objectCount * t / threads);
+				int last = (int)((long long)objectCount * (t + 1) / threads);
+				lists[t].Clear();
+				workers.push_back(std::thread([&, t, first, last]() { record(lists[t], first, last); }));
+			}
+			merged.Clear();
+			for (int t = 0; t < threads; t++)
+			{
+				workers[t].join();
+				merged.Append(lists[t]);
+			}
+		});
+		if (threads == 1)
+		{
+			single = recorded;
+		}
+
+		std::cout << "  recorded on " << threads << " threads " << recorded << " ms (" << single / recorded << "x), "
+			<< merged.GetDrawCount() << " draws" << std::endl;
+		if ((threads < threadCount) && (threads * 2 > threadCount))
+		{
+			threads = threadCount / 2;
+		}
+	}
+}
+
+/***********************************************************
+ *  RunJobs()
+ *
+ *  This method is used for timing the per-object work of a
+ *  frame of 100000 spinning objects on 1 to N threads.  For
+ *  every object the world matrix is composed, its bounding
+ *  sphere is tested against the view frustum and the sort
+ *  key of the visible ones is made.  Each chunk writes the
+ *  draws it keeps into its own list, and the lists are
+ *  merged in order on the calling thread, which is all the
+ *  GL thread would have to read.
+ ***********************************************************/
+void Benchmarks::RunJobs()
+{
+	const int objectCount = 100000;
+	const int chunkSize = 1024;
+	const int frames = 10;
+	const int chunkCount = (objectCount + chunkSize - 1) / chunkSize;
+
+	// one object - a shape part spinning about its position
+	struct OBJECT
+	{
+		int part;
+		int material;
+		glm::vec3 position;
+		float scale;
+		float spin;
+	};
+	std::vector<OBJECT> objects(objectCount);
+	for (int i = 0; i < objectCount; i++)
+	{
+		objects[i].part = i % PrimitiveGeometry::PART_COUNT;
+		objects[i].material = i % 16;
+		objects[i].position = glm::vec3((float)(i % 400) - 200.0f, (float)((i / 400) % 25), -(float)(i / 10000) * 20.0f);
+		objects[i].scale = 0.5f + 0.1f * (float)(i % 5);
+		objects[i].spin = (float)(i % 360);
+	}
+
+	// the planes of a camera looking down -z, with their normals
+	// pointing into the frustum
+	glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+		glm::lookAt(glm::vec3(0.0f, 10.0f, 30.0f), glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::vec4 planes[6];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		for (int side = 0; side < 2; side++)
+		{
+			glm::vec4& plane = planes[axis * 2 + side];
+			for (int column = 0; column < 4; column++)
+			{
+				float value = viewProjection[column][axis];
+				plane[column] = viewProjection[column][3] + (side ? -value : value);
+			}
+			plane = plane / glm::length(glm::vec3(plane));
+		}
+	}
+
+	// the draws each chunk keeps, and the merged draw list
+	struct DRAW
+	{
+		uint64_t key;
+		glm::mat4 model;
+	};
+	std::vector<std::vector<DRAW> > chunkDraws(chunkCount);
+	std::vector<DRAW> drawList;
+
+	int frame = 0;
+	JobSystem::RANGE_JOB updateChunk = [&](int first, int last)
+	{
+		std::vector<DRAW>& kept = chunkDraws[first / chunkSize];
+		kept.clear();
+		for (int i = first; i < last; i++)
+		{
+			const OBJECT& object = objects[i];
+
+			// transform update
+			DRAW draw;
+			draw.model = glm::translate(object.position) *
+				glm::rotate(glm::radians(object.spin + 3.0f * frame), glm::vec3(0.0f, 1.0f, 0.0f)) *
+				glm::scale(glm::vec3(object.scale));
+
+			// visibility - a unit shape fits in a sphere of radius
+			// sqrt(3) around its origin
+			glm::vec3 center(draw.model[3]);
+			float radius = 1.7320508f * object.scale;
+			bool bVisible = true;
+			for (int plane = 0; (plane < 6) && bVisible; plane++)
+			{
+				bVisible = (glm::dot(glm::vec3(planes[plane]), center) + planes[plane].w > -radius);
+			}
+			if (!bVisible)
+			{
+				continue;
+			}
+
+			// sort key
+			float depth = glm::length(center - glm::vec3(0.0f, 10.0f, 30.0f));
+			draw.key = RenderQueue::MakeKey(RenderQueue::PASS_OPAQUE, object.part, -1, object.material, depth);
+			kept.push_back(draw);
+		}
+	};
+
+	std::cout << "job system, " << objectCount << " objects in chunks of " << chunkSize << ", best of " << frames << " frames" << std::endl;
+
+	int threadCount = (int)std::thread::hardware_concurrency();
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+	double single = 0.0;
+	for (int threads = 1; threads <= threadCount; threads++)
+	{
+		JobSystem jobs(threads - 1);
+		double best = TimeBest(frames, [&]()
+		{
+			jobs.ParallelFor(objectCount, chunkSize, updateChunk);
+
+			// the GL thread only reads the merged draws
+			drawList.clear();
+			for (int chunk = 0; chunk < chunkCount; chunk++)
+			{
+				drawList.insert(drawList.end(), chunkDraws[chunk].begin(), chunkDraws[chunk].end());
+			}
+			frame++;
+		});
+		if (threads == 1)
+		{
+			single = best;
+		}
+
+		std::cout << "  " << threads << " threads: " << best << " ms (" << single / best << "x), "
+			<< drawList.size() << " of " << objectCount << " visible, " << jobs.GetStolenCount() << " of "
+			<< jobs.GetJobCount() << " chunks stolen" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  RunCulling()
+ *
+ *  This method is used for timing how long finding the
+ *  objects inside the view frustum takes when every object
+ *  is tested and when the bounding volume tree is walked,
+ *  for a camera turning around a field of 100000 shape
+ *  parts, and how long moving a tenth of them in the tree
+ *  takes.
+ ***********************************************************/
+void Benchmarks::RunCulling()
+{
+	const int objectCount = 100000;
+	const int frames = 10;
+	const int views = 8;
+
+	PrimitiveGeometry geometry;
+	std::vector<PrimitiveGeometry::BOUNDS> bounds(objectCount);
+	std::vector<int> leaves(objectCount);
+	BoundingVolumeTree tree;
+	for (int i = 0; i < objectCount; i++)
+	{
+		glm::vec3 position((float)(i % 400) - 200.0f, (float)((i / 400) % 25), (float)(i / 10000) * 40.0f - 200.0f);
+		glm::mat4 model = glm::translate(position) * glm::rotate(glm::radians((float)(i % 360)), glm::vec3(0.0f, 1.0f, 0.0f)) *
+			glm::scale(glm::vec3(0.5f + 0.1f * (float)(i % 5)));
+		bounds[i] = PrimitiveGeometry::TransformBounds(geometry.GetBounds((PrimitiveGeometry::PART)(i % PrimitiveGeometry::PART_COUNT)), model);
+	}
+
+	double insertTime = TimeBest(1, [&]()
+	{
+		for (int i = 0; i < objectCount; i++)
+		{
+			leaves[i] = tree.Insert(bounds[i], i);
+		}
+	});
+
+	// a camera in the middle of the field turning a full circle
+	// over the views
+	std::vector<Frustum> frustums(views);
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+	for (int view = 0; view < views; view++)
+	{
+		float angle = glm::radians(360.0f * (float)view / (float)views);
+		glm::vec3 eye(0.0f, 10.0f, 0.0f);
+		frustums[view].Set(projection * glm::lookAt(eye, eye + glm::vec3(std::sin(angle), -0.2f, std::cos(angle)), glm::vec3(0.0f, 1.0f, 0.0f)));
+	}
+
+	std::vector<int> visible;
+	size_t bruteVisible = 0;
+	double brute = TimeBest(frames, [&]()
+	{
+		bruteVisible = 0;
+		for (int view = 0; view < views; view++)
+		{
+			visible.clear();
+			for (int i = 0; i < objectCount; i++)
+			{
+				const PrimitiveGeometry::BOUNDS& object = bounds[i];
+				Frustum::RESULT result = frustums[view].TestSphere(object.center, object.radius);
+				if (result == Frustum::RESULT_INTERSECTING)
+				{
+					result = frustums[view].TestBox(object.minimum, object.maximum);
+				}
+				if (result != Frustum::RESULT_OUTSIDE)
+				{
+					visible.push_back(i);
+				}
+			}
+			bruteVisible += visible.size();
+		}
+	}) / views;
+
+	size_t treeVisible = 0;
+	unsigned int tested = 0;
+	double walk = TimeBest(frames, [&]()
+	{
+		treeVisible = 0;
+		tested = 0;
+		for (int view = 0; view < views; view++)
+		{
+			visible.clear();
+			tree.Cull(frustums[view], visible);
+			treeVisible += visible.size();
+			tested += tree.GetTestedCount();
+		}
+	}) / views;
+
+	// a tenth of the objects move a little every frame, and the
+	// ones that leave the margin of their leaves are put back
+	int moved = 0;
+	double move = TimeBest(frames, [&]()
+	{
+		moved = 0;
+		for (int i = 0; i < objectCount; i += 10)
+		{
+			glm::vec3 offset(0.05f * (float)((i / 10) % 7) - 0.15f, 0.0f, 0.0f);
+			bounds[i].minimum += offset;
+			bounds[i].maximum += offset;
+			bounds[i].center += offset;
+			moved += tree.Move(leaves[i], bounds[i]) ? 1 : 0;
+		}
+	});
+
+	std::cout << "culling, " << objectCount << " objects, best of " << frames << " frames of " << views << " views" << std::endl;
+	std::cout << "  every object tested: " << brute << " ms per view, " << bruteVisible / views << " visible" << std::endl;
+	std::cout << "  bounding volume tree: " << walk << " ms per view (" << brute / walk << "x), " << treeVisible / views
+		<< " visible, " << tested / views << " nodes tested, height " << tree.GetHeight() << std::endl;
+	std::cout << "  building the tree: " << insertTime << " ms, moving " << objectCount / 10 << " objects: " << move
+		<< " ms, " << moved << " reinserted" << std::endl;
+}
+
+/***********************************************************
+ *  RunOcclusion()
+ *
+ *  This method is used for timing a frame of occlusion
+ *  culling - a wall of 48 boxes with gaps between them is
+ *  drawn into the depth buffer, and 10000 small objects in
+ *  front of and behind it are tested - on 1 to N threads,
+ *  then how the number of occluders drawn follows a time
+ *  budget too small for all of them.
+ ***********************************************************/
+void Benchmarks::RunOcclusion()
+{
+	const int objectCount = 10000;
+	const int frames = 20;
+
+	PrimitiveGeometry geometry;
+	glm::vec3 eye(0.0f, 5.0f, 30.0f);
+	glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 1000.0f / 800.0f, 0.1f, 100.0f) *
+		glm::lookAt(eye, glm::vec3(0.0f, 5.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	// the wall, 8 boxes across and 6 up, standing at z = 0
+	std::vector<glm::mat4> wall;
+	for (int row = 0; row < 6; row++)
+	{
+		for (int column = 0; column < 8; column++)
+		{
+			glm::vec3 position(-14.0f + 4.0f * (float)column, 0.5f + 2.0f * (float)row, 0.0f);
+			wall.push_back(glm::translate(position) * glm::scale(glm::vec3(3.8f, 1.9f, 1.0f)));
+		}
+	}
+
+	std::vector<PrimitiveGeometry::BOUNDS> objects(objectCount);
+	for (int i = 0; i < objectCount; i++)
+	{
+		glm::vec3 position((float)(i % 100) * 0.3f - 15.0f, (float)((i / 100) % 50) * 0.24f, ((i / 5000) ? -2.0f : 2.0f) - (float)(i % 7));
+		objects[i] = PrimitiveGeometry::TransformBounds(geometry.GetBounds(PrimitiveGeometry::PART_BOX),
+			glm::translate(position) * glm::scale(glm::vec3(0.2f)));
+	}
+
+	std::vector<char> visible;
+	int hidden = 0;
+	auto frame = [&](OcclusionCuller& culler)
+	{
+		culler.Begin(viewProjection, eye);
+		for (size_t box = 0; box < wall.size(); box++)
+		{
+			culler.AddOccluder(PrimitiveGeometry::PART_BOX, wall[box],
+				PrimitiveGeometry::TransformBounds(geometry.GetBounds(PrimitiveGeometry::PART_BOX), wall[box]));
+		}
+		culler.RenderOccluders();
+		culler.TestBounds(objects, visible);
+		hidden = 0;
+		for (int i = 0; i < objectCount; i++)
+		{
+			hidden += visible[i] ? 0 : 1;
+		}
+	};
+
+	std::cout << "occlusion, " << wall.size() << " occluders and " << objectCount << " objects, best of " << frames << " frames" << std::endl;
+
+	int threadCount = (int)std::thread::hardware_concurrency();
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+	double single = 0.0;
+	for (int threads = 1; threads <= threadCount; threads++)
+	{
+		JobSystem jobs(threads - 1);
+		OcclusionCuller culler(&geometry);
+		culler.SetJobSystem(&jobs);
+		culler.SetTimeBudget(1000.0);
+		double best = TimeBest(frames, [&]() { frame(culler); });
+		if (threads == 1)
+		{
+			single = best;
+		}
+
+		std::cout << "  " << threads << " threads: " << best << " ms (" << single / best << "x), " << culler.GetTriangleCount()
+			<< " triangles, " << hidden << " of " << objectCount << " hidden" << std::endl;
+	}
+
+	// a budget a quarter of what a frame takes without one
+	JobSystem jobs(threadCount - 1);
+	OcclusionCuller unlimited(&geometry);
+	unlimited.SetJobSystem(&jobs);
+	unlimited.SetTimeBudget(1000.0);
+	double full = TimeBest(frames, [&]() { frame(unlimited); });
+	OcclusionCuller culler(&geometry);
+	culler.SetJobSystem(&jobs);
+	culler.SetTimeBudget(full * 0.25);
+	double budgeted = 0.0;
+	for (int i = 0; i < frames; i++)
+	{
+		frame(culler);
+		budgeted += culler.GetMilliseconds();
+	}
+	std::cout << "  budget of " << full * 0.25 << " ms: " << budgeted / frames << " ms per frame, " << culler.GetOccluderCount()
+		<< " occluders in the last frame, " << hidden << " hidden, " << culler.GetOverBudgetCount() << " of " << frames
+		<< " frames over budget" << std::endl;
+}
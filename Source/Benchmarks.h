@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmarks.h
+// ============
+// command line microbenchmarks for the scene rendering code
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+
+/***********************************************************
+ *  Benchmarks
+ *
+ *  This class runs the microbenchmarks that are selected
+ *  with the --benchmark command line option.  They run
+ *  before the scene window is opened and print their
+ *  results to the console.  The ones that draw open a
+ *  hidden window of their own.
+ ***********************************************************/
+class Benchmarks
+{
+public:
+	// run the named benchmark, or every benchmark for "all"
+	static bool Run(const std::string& name);
+
+private:
+	// per-draw cost of looking up texture and material tags
+	static void RunTagLookup();
+	// load time pixel kernels on the scene's own textures
+	static void RunImageKernels();
+	// model matrix work per frame as the object count grows
+	static void RunTransforms();
+	// composing every model matrix with glm or in batches
+	static void RunComposeBatch();
+	// moving one group of parts with and without a scene graph
+	static void RunSceneGraph();
+	// the vertex stage normal transform with and without a
+	// normal matrix found once per draw
+	static void RunNormalMatrix();
+	// frames of 10000 shapes drawn one draw call at a time, one
+	// instanced draw call per part and one multi-draw indirect
+	// call
+	static void RunInstancing();
+	// sorting the draw keys of a frame with a radix sort and
+	// with std::stable_sort
+	static void RunRenderQueue();
+	// defining the scene's draws every frame against replaying
+	// a recorded command list, and recording on 1 to N threads
+	static void RunCommandList();
+	// a frame of 100000 objects - transform, visibility and sort
+	// key - split over 1 to N threads by the job system
+	static void RunJobs();
+	// culling 100000 objects against the view frustum one by
+	// one and with a bounding volume tree
+	static void RunCulling();
+	// hiding 10000 objects behind a wall of boxes drawn into a
+	// CPU depth buffer on 1 to N threads, and with a time budget
+	static void RunOcclusion();
+};
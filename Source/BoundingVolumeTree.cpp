@@ -0,0 +1,563 @@
+///////////////////////////////////////////////////////////////////////////////
+// boundingvolumetree.cpp
+// ============
+// a dynamic hierarchy of bounding boxes for culling the drawn objects
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BoundingVolumeTree.h"
+
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	// how much bigger than its object a leaf's box is made, so
+	// small moves stay inside it
+	const float g_LeafMargin = 0.1f;
+	// subtrees crossing the sides a cull is split into for each
+	// thread, so threads that finish early can steal the rest
+	const int g_SubtreesPerThread = 4;
+
+	/***********************************************************
+	 *  SurfaceArea()
+	 *
+	 *  Return the surface area of a box, the cost of visiting
+	 *  it when the tree is walked.
+	 ***********************************************************/
+	float SurfaceArea(const glm::vec3& minimum, const glm::vec3& maximum)
+	{
+		glm::vec3 size = maximum - minimum;
+		return(2.0f * (size.x * size.y + size.y * size.z + size.z * size.x));
+	}
+
+	/***********************************************************
+	 *  Contains()
+	 *
+	 *  Return true when the first box holds the second.
+	 ***********************************************************/
+	bool Contains(const glm::vec3& outerMinimum, const glm::vec3& outerMaximum,
+		const glm::vec3& minimum, const glm::vec3& maximum)
+	{
+		return((outerMinimum.x <= minimum.x) && (outerMinimum.y <= minimum.y) && (outerMinimum.z <= minimum.z) &&
+			(maximum.x <= outerMaximum.x) && (maximum.y <= outerMaximum.y) && (maximum.z <= outerMaximum.z));
+	}
+}
+
+/***********************************************************
+ *  BoundingVolumeTree()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+BoundingVolumeTree::BoundingVolumeTree()
+{
+	m_root = -1;
+	m_freeNode = -1;
+	m_count = 0;
+	m_testedCount = 0;
+	m_pJobSystem = NULL;
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every object, keeping
+ *  the memory of the nodes.
+ ***********************************************************/
+void BoundingVolumeTree::Clear()
+{
+	m_nodes.clear();
+	m_root = -1;
+	m_freeNode = -1;
+	m_count = 0;
+}
+
+/***********************************************************
+ *  SetJobSystem()
+ *
+ *  This method is used for choosing the job system the
+ *  subtrees of a cull are walked on.
+ ***********************************************************/
+void BoundingVolumeTree::SetJobSystem(JobSystem* pJobSystem)
+{
+	m_pJobSystem = pJobSystem;
+}
+
+/***********************************************************
+ *  AllocateNode()
+ *
+ *  This method is used for taking a node from the free list,
+ *  or adding one.
+ ***********************************************************/
+int BoundingVolumeTree::AllocateNode()
+{
+	int node = m_freeNode;
+	if (node >= 0)
+	{
+		m_freeNode = m_nodes[node].children[0];
+	}
+	else
+	{
+		node = (int)m_nodes.size();
+		m_nodes.push_back(NODE());
+	}
+
+	NODE& added = m_nodes[node];
+	added.parent = -1;
+	added.children[0] = -1;
+	added.children[1] = -1;
+	added.height = 0;
+	added.item = -1;
+	return(node);
+}
+
+/***********************************************************
+ *  FreeNode()
+ *
+ *  This method is used for putting a node on the free list.
+ ***********************************************************/
+void BoundingVolumeTree::FreeNode(int node)
+{
+	m_nodes[node].children[0] = m_freeNode;
+	m_nodes[node].height = -1;
+	m_freeNode = node;
+}
+
+/***********************************************************
+ *  IsLeaf()
+ *
+ *  This method returns true when a node is an object.
+ ***********************************************************/
+bool BoundingVolumeTree::IsLeaf(int node) const
+{
+	return(m_nodes[node].children[0] < 0);
+}
+
+/***********************************************************
+ *  Insert()
+ *
+ *  This method is used for adding an object to the tree.
+ ***********************************************************/
+int BoundingVolumeTree::Insert(const PrimitiveGeometry::BOUNDS& bounds, int item)
+{
+	int leaf = AllocateNode();
+	NODE& node = m_nodes[leaf];
+	node.minimum = bounds.minimum - glm::vec3(g_LeafMargin);
+	node.maximum = bounds.maximum + glm::vec3(g_LeafMargin);
+	node.item = item;
+	node.bounds = bounds;
+
+	InsertLeaf(leaf);
+	m_count++;
+	return(leaf);
+}
+
+/***********************************************************
+ *  Remove()
+ *
+ *  This method is used for removing an object from the tree.
+ ***********************************************************/
+void BoundingVolumeTree::Remove(int leaf)
+{
+	RemoveLeaf(leaf);
+	FreeNode(leaf);
+	m_count--;
+}
+
+/***********************************************************
+ *  Move()
+ *
+ *  This method is used for giving an object new bounds.  The
+ *  tree only changes when the new box no longer fits in the
+ *  leaf's box with its margin.
+ ***********************************************************/
+bool BoundingVolumeTree::Move(int leaf, const PrimitiveGeometry::BOUNDS& bounds)
+{
+	NODE& node = m_nodes[leaf];
+	node.bounds = bounds;
+	if (Contains(node.minimum, node.maximum, bounds.minimum, bounds.maximum))
+	{
+		return(false);
+	}
+
+	RemoveLeaf(leaf);
+	m_nodes[leaf].minimum = bounds.minimum - glm::vec3(g_LeafMargin);
+	m_nodes[leaf].maximum = bounds.maximum + glm::vec3(g_LeafMargin);
+	InsertLeaf(leaf);
+	return(true);
+}
+
+/***********************************************************
+ *  InsertLeaf()
+ *
+ *  This method is used for hanging a leaf on the tree.  The
+ *  walk down picks the child whose box grows the least to
+ *  hold the leaf, and stops where pairing the leaf with the
+ *  node itself costs less.  The leaf and that node become
+ *  the children of a new node.
+ ***********************************************************/
+void BoundingVolumeTree::InsertLeaf(int leaf)
+{
+	if (m_root < 0)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = -1;
+		return;
+	}
+
+	glm::vec3 leafMinimum = m_nodes[leaf].minimum;
+	glm::vec3 leafMaximum = m_nodes[leaf].maximum;
+
+	int sibling = m_root;
+	while (!IsLeaf(sibling))
+	{
+		const NODE& node = m_nodes[sibling];
+		float area = SurfaceArea(node.minimum, node.maximum);
+		float combinedArea = SurfaceArea(glm::min(node.minimum, leafMinimum), glm::max(node.maximum, leafMaximum));
+
+		// a new parent of this node and the leaf, and the growth
+		// every node below inherits by going further down
+		float cost = 2.0f * combinedArea;
+		float inheritedCost = 2.0f * (combinedArea - area);
+
+		float childCosts[2];
+		for (int i = 0; i < 2; i++)
+		{
+			const NODE& child = m_nodes[node.children[i]];
+			float grownArea = SurfaceArea(glm::min(child.minimum, leafMinimum), glm::max(child.maximum, leafMaximum));
+			childCosts[i] = IsLeaf(node.children[i]) ? grownArea : grownArea - SurfaceArea(child.minimum, child.maximum);
+			childCosts[i] += inheritedCost;
+		}
+
+		if ((cost < childCosts[0]) && (cost < childCosts[1]))
+		{
+			break;
+		}
+		sibling = (childCosts[0] < childCosts[1]) ? node.children[0] : node.children[1];
+	}
+
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = AllocateNode();
+	NODE& parent = m_nodes[newParent];
+	parent.parent = oldParent;
+	parent.children[0] = sibling;
+	parent.children[1] = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent >= 0)
+	{
+		NODE& grandParent = m_nodes[oldParent];
+		grandParent.children[(grandParent.children[0] == sibling) ? 0 : 1] = newParent;
+	}
+	else
+	{
+		m_root = newParent;
+	}
+
+	Refit(newParent);
+}
+
+/***********************************************************
+ *  RemoveLeaf()
+ *
+ *  This method is used for taking a leaf off the tree.  Its
+ *  parent is freed and its sibling takes the parent's place.
+ ***********************************************************/
+void BoundingVolumeTree::RemoveLeaf(int leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = -1;
+		return;
+	}
+
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = (m_nodes[parent].children[0] == leaf) ? m_nodes[parent].children[1] : m_nodes[parent].children[0];
+
+	FreeNode(parent);
+	m_nodes[sibling].parent = grandParent;
+	if (grandParent >= 0)
+	{
+		NODE& node = m_nodes[grandParent];
+		node.children[(node.children[0] == parent) ? 0 : 1] = sibling;
+		Refit(grandParent);
+	}
+	else
+	{
+		m_root = sibling;
+	}
+}
+
+/***********************************************************
+ *  Refit()
+ *
+ *  This method is used for walking from a node up to the
+ *  root, balancing each node and fitting its box and height
+ *  to its children.
+ ***********************************************************/
+void BoundingVolumeTree::Refit(int node)
+{
+	while (node >= 0)
+	{
+		node = Balance(node);
+		FitNode(node);
+		node = m_nodes[node].parent;
+	}
+}
+
+/***********************************************************
+ *  FitNode()
+ *
+ *  This method is used for setting a node's box to hold its
+ *  children's boxes, and its height to one more than theirs.
+ ***********************************************************/
+void BoundingVolumeTree::FitNode(int node)
+{
+	NODE& fitted = m_nodes[node];
+	const NODE& first = m_nodes[fitted.children[0]];
+	const NODE& second = m_nodes[fitted.children[1]];
+	fitted.minimum = glm::min(first.minimum, second.minimum);
+	fitted.maximum = glm::max(first.maximum, second.maximum);
+	fitted.height = 1 + std::max(first.height, second.height);
+}
+
+/***********************************************************
+ *  Balance()
+ *
+ *  This method is used for rotating a node whose children
+ *  differ in height by more than one.  The taller child
+ *  takes the node's place, the node becomes its child, and
+ *  the taller of the taller child's children stays with it
+ *  while the other moves under the node.
+ ***********************************************************/
+int BoundingVolumeTree::Balance(int node)
+{
+	if (IsLeaf(node) || (m_nodes[node].height < 2))
+	{
+		return(node);
+	}
+
+	int children[2] = { m_nodes[node].children[0], m_nodes[node].children[1] };
+	int balance = m_nodes[children[1]].height - m_nodes[children[0]].height;
+	if ((balance >= -1) && (balance <= 1))
+	{
+		return(node);
+	}
+
+	// the taller child and the side it is on
+	int side = (balance > 1) ? 1 : 0;
+	int raised = children[side];
+	int kept = children[1 - side];
+	int grandChildren[2] = { m_nodes[raised].children[0], m_nodes[raised].children[1] };
+
+	// the raised child takes the node's place
+	int parent = m_nodes[node].parent;
+	m_nodes[raised].parent = parent;
+	if (parent >= 0)
+	{
+		NODE& parentNode = m_nodes[parent];
+		parentNode.children[(parentNode.children[0] == node) ? 0 : 1] = raised;
+	}
+	else
+	{
+		m_root = raised;
+	}
+
+	// the taller grandchild stays under the raised child, the
+	// other one moves under the node
+	int taller = (m_nodes[grandChildren[0]].height > m_nodes[grandChildren[1]].height) ? grandChildren[0] : grandChildren[1];
+	int moved = (taller == grandChildren[0]) ? grandChildren[1] : grandChildren[0];
+
+	m_nodes[node].children[0] = kept;
+	m_nodes[node].children[1] = moved;
+	m_nodes[node].parent = raised;
+	m_nodes[moved].parent = node;
+	m_nodes[raised].children[0] = node;
+	m_nodes[raised].children[1] = taller;
+
+	FitNode(node);
+	FitNode(raised);
+	return(raised);
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for finding every object that is not
+ *  outside the frustum.  Without a job system the whole
+ *  tree is walked here.  With one, the top of the tree is
+ *  walked breadth first until there are enough subtrees
+ *  still crossing the sides to share out, and those are
+ *  walked on the job system's threads.
+ ***********************************************************/
+void BoundingVolumeTree::Cull(const Frustum& frustum, std::vector<int>& visibleItems)
+{
+	m_testedCount = 0;
+	if (m_root < 0)
+	{
+		return;
+	}
+	if (NULL == m_pJobSystem)
+	{
+		m_testedCount = CullSubtree(frustum, m_root, m_stack, visibleItems);
+		return;
+	}
+
+	// the nodes before next are tested, the ones after it are
+	// the subtrees left to walk
+	size_t wanted = (size_t)(m_pJobSystem->GetThreadCount() * g_SubtreesPerThread);
+	size_t next = 0;
+	m_subtrees.clear();
+	m_subtrees.push_back(m_root);
+	while ((next < m_subtrees.size()) && (m_subtrees.size() - next < wanted))
+	{
+		int node = m_subtrees[next++];
+		m_testedCount++;
+		if (CullNode(frustum, node, visibleItems))
+		{
+			m_subtrees.push_back(m_nodes[node].children[0]);
+			m_subtrees.push_back(m_nodes[node].children[1]);
+		}
+	}
+
+	int count = (int)(m_subtrees.size() - next);
+	if (m_subtreeItems.size() < (size_t)count)
+	{
+		m_subtreeItems.resize(count);
+		m_subtreeStacks.resize(count);
+	}
+	m_subtreeTested.assign(count, 0);
+	m_pJobSystem->ParallelFor(count, 1, [&](int first, int last)
+	{
+		for (int subtree = first; subtree < last; subtree++)
+		{
+			m_subtreeItems[subtree].clear();
+			m_subtreeTested[subtree] = CullSubtree(frustum, m_subtrees[next + subtree],
+				m_subtreeStacks[subtree], m_subtreeItems[subtree]);
+		}
+	});
+
+	for (int subtree = 0; subtree < count; subtree++)
+	{
+		visibleItems.insert(visibleItems.end(), m_subtreeItems[subtree].begin(), m_subtreeItems[subtree].end());
+		m_testedCount += m_subtreeTested[subtree];
+	}
+}
+
+/***********************************************************
+ *  CullNode()
+ *
+ *  This method is used for testing one node of the tree.
+ *  Nothing below a node outside the frustum is taken, and
+ *  everything below a node inside it is taken.  A leaf
+ *  crossing the sides is tested again with its object's
+ *  sphere, then its box, as the leaf's box has the margin.
+ *  Only a node crossing the sides with children below it
+ *  returns true.
+ ***********************************************************/
+bool BoundingVolumeTree::CullNode(const Frustum& frustum, int node, std::vector<int>& visibleItems) const
+{
+	const NODE& tested = m_nodes[node];
+	Frustum::RESULT result = frustum.TestBox(tested.minimum, tested.maximum);
+	if (result == Frustum::RESULT_OUTSIDE)
+	{
+		return(false);
+	}
+	if (result == Frustum::RESULT_INSIDE)
+	{
+		AddLeaves(node, visibleItems);
+		return(false);
+	}
+
+	if (IsLeaf(node))
+	{
+		const PrimitiveGeometry::BOUNDS& bounds = tested.bounds;
+		Frustum::RESULT objectResult = frustum.TestSphere(bounds.center, bounds.radius);
+		if (objectResult == Frustum::RESULT_INTERSECTING)
+		{
+			objectResult = frustum.TestBox(bounds.minimum, bounds.maximum);
+		}
+		if (objectResult != Frustum::RESULT_OUTSIDE)
+		{
+			visibleItems.push_back(tested.item);
+		}
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  CullSubtree()
+ *
+ *  This method is used for walking the tree below a node
+ *  from the top, with a stack of nodes still to visit that
+ *  only this walk uses.
+ ***********************************************************/
+unsigned int BoundingVolumeTree::CullSubtree(const Frustum& frustum, int node, std::vector<int>& stack, std::vector<int>& visibleItems) const
+{
+	unsigned int testedCount = 0;
+	stack.clear();
+	stack.push_back(node);
+	while (!stack.empty())
+	{
+		int tested = stack.back();
+		stack.pop_back();
+
+		testedCount++;
+		if (CullNode(frustum, tested, visibleItems))
+		{
+			stack.push_back(m_nodes[tested].children[0]);
+			stack.push_back(m_nodes[tested].children[1]);
+		}
+	}
+	return(testedCount);
+}
+
+/***********************************************************
+ *  AddLeaves()
+ *
+ *  This method is used for adding the item of every leaf
+ *  below a node, without testing them.
+ ***********************************************************/
+void BoundingVolumeTree::AddLeaves(int node, std::vector<int>& visibleItems) const
+{
+	if (IsLeaf(node))
+	{
+		visibleItems.push_back(m_nodes[node].item);
+		return;
+	}
+	AddLeaves(m_nodes[node].children[0], visibleItems);
+	AddLeaves(m_nodes[node].children[1], visibleItems);
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method returns the number of objects in the tree.
+ ***********************************************************/
+int BoundingVolumeTree::GetCount() const
+{
+	return(m_count);
+}
+
+/***********************************************************
+ *  GetHeight()
+ *
+ *  This method returns the number of levels below the root.
+ ***********************************************************/
+int BoundingVolumeTree::GetHeight() const
+{
+	return((m_root >= 0) ? m_nodes[m_root].height : 0);
+}
+
+/***********************************************************
+ *  GetTestedCount()
+ *
+ *  This method returns the number of nodes the last Cull()
+ *  tested against the frustum.
+ ***********************************************************/
+unsigned int BoundingVolumeTree::GetTestedCount() const
+{
+	return(m_testedCount);
+}
@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////
+// boundingvolumetree.h
+// ============
+// a dynamic hierarchy of bounding boxes for culling the drawn objects
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "PrimitiveGeometry.h"
+
+#include <vector>
+
+/***********************************************************
+ *  BoundingVolumeTree
+ *
+ *  This class keeps the bounds of the drawn objects in a
+ *  binary tree of axis aligned boxes, each box holding the
+ *  boxes below it.  An object is a leaf, added where it
+ *  grows the tree's boxes the least, and the tree is kept
+ *  balanced by rotating nodes on the way back up, so objects
+ *  can be added, moved and removed at any time.  A leaf's
+ *  box is made a little bigger than its object, so small
+ *  moves do not change the tree.
+ *
+ *  Culling walks the tree from the top.  A node outside the
+ *  frustum is skipped with everything below it, and a node
+ *  inside it has everything below it drawn without another
+ *  test.  Only the leaves whose parents cross the sides are
+ *  tested against the objects' own spheres and boxes.
+ *
+ *  With a job system, the top of the tree is walked on the
+ *  calling thread until there are a few subtrees crossing
+ *  the sides for every thread, and the subtrees are walked
+ *  on the job system's threads, each into a list of its
+ *  own that is added to the result in order.
+ ***********************************************************/
+class BoundingVolumeTree
+{
+public:
+	// constructor
+	BoundingVolumeTree();
+
+	// add an object and its bounds, returning its leaf - item
+	// is what culling hands back for it
+	int Insert(const PrimitiveGeometry::BOUNDS& bounds, int item);
+	// remove an object by its leaf
+	void Remove(int leaf);
+	// give an object new bounds, returning true when the tree
+	// had to change
+	bool Move(int leaf, const PrimitiveGeometry::BOUNDS& bounds);
+	// remove every object
+	void Clear();
+
+	// the job system culling is split over, or NULL to walk the
+	// whole tree on the calling thread
+	void SetJobSystem(JobSystem* pJobSystem);
+
+	// add the item of every object that is not outside the
+	// frustum
+	void Cull(const Frustum& frustum, std::vector<int>& visibleItems);
+
+	// objects in the tree, the height of the tree, and the
+	// nodes tested by the last Cull()
+	int GetCount() const;
+	int GetHeight() const;
+	unsigned int GetTestedCount() const;
+
+private:
+	struct NODE
+	{
+		// the box around everything below the node, with the
+		// margin for a leaf
+		glm::vec3 minimum;
+		glm::vec3 maximum;
+		int parent;
+		// both -1 for a leaf, and the next free node of an unused
+		// node is kept in the first
+		int children[2];
+		// 0 for a leaf, -1 for an unused node
+		int height;
+		// the object of a leaf
+		int item;
+		PrimitiveGeometry::BOUNDS bounds;
+	};
+
+	std::vector<NODE> m_nodes;
+	int m_root;
+	int m_freeNode;
+	int m_count;
+	unsigned int m_testedCount;
+	// nodes still to visit while culling, kept to reuse its
+	// memory
+	std::vector<int> m_stack;
+
+	JobSystem* m_pJobSystem;
+	// the subtrees a cull is split into, and the items seen,
+	// nodes still to visit and nodes tested of each one
+	std::vector<int> m_subtrees;
+	std::vector<std::vector<int> > m_subtreeItems;
+	std::vector<std::vector<int> > m_subtreeStacks;
+	std::vector<unsigned int> m_subtreeTested;
+
+	int AllocateNode();
+	void FreeNode(int node);
+	bool IsLeaf(int node) const;
+	// hang a leaf on the tree, and take it off again
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	// fit the boxes and heights from a node up to the root,
+	// rotating unbalanced nodes
+	void Refit(int node);
+	// rotate a node whose children differ in height by more
+	// than one, returning the node that took its place
+	int Balance(int node);
+	// set a node's box and height from its children
+	void FitNode(int node);
+	// test one node, adding the items below it that are seen,
+	// and returning true when its children need testing
+	bool CullNode(const Frustum& frustum, int node, std::vector<int>& visibleItems) const;
+	// cull everything below a node, returning the nodes tested
+	unsigned int CullSubtree(const Frustum& frustum, int node, std::vector<int>& stack, std::vector<int>& visibleItems) const;
+	// add the items of every leaf below a node
+	void AddLeaves(int node, std::vector<int>& visibleItems) const;
+};
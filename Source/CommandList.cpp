@@ -0,0 +1,309 @@
+///////////////////////////////////////////////////////////////////////////////
+// commandlist.cpp
+// ============
+// record the draws of a scene into a compact binary buffer and replay them
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CommandList.h"
+
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// bits of the flags byte of a draw
+	const unsigned char g_DrawStatic = 0x01;
+	const unsigned char g_DrawNormalMatrix = 0x02;
+}
+
+/***********************************************************
+ *  CommandList()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+CommandList::CommandList()
+{
+	m_commandCount = 0;
+	m_drawCount = 0;
+	m_color = glm::vec4(0.0f);
+	m_texture = 0;
+	m_uvScale = glm::vec2(0.0f);
+	m_material = 0;
+	ResetState();
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every command, keeping
+ *  the memory for the next recording.
+ ***********************************************************/
+void CommandList::Clear()
+{
+	m_bytes.clear();
+	m_commandCount = 0;
+	m_drawCount = 0;
+	ResetState();
+}
+
+/***********************************************************
+ *  ResetState()
+ *
+ *  This method is used for forgetting the last state that
+ *  was recorded, so the next change of each kind is written
+ *  even if it sets the same value.
+ ***********************************************************/
+void CommandList::ResetState()
+{
+	m_bColorSet = false;
+	m_bTextureSet = false;
+	m_bUVScaleSet = false;
+	m_bMaterialSet = false;
+}
+
+/***********************************************************
+ *  WriteOpcode()
+ *
+ *  This method is used for starting a new command.
+ ***********************************************************/
+void CommandList::WriteOpcode(OPCODE opcode)
+{
+	m_bytes.push_back((unsigned char)opcode);
+	m_commandCount++;
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method is used for appending the values of a
+ *  command.  They are copied byte by byte, so they need no
+ *  alignment in the list.
+ ***********************************************************/
+void CommandList::Write(const void* data, size_t bytes)
+{
+	size_t offset = m_bytes.size();
+	m_bytes.resize(offset + bytes);
+	memcpy(&m_bytes[offset], data, bytes);
+}
+
+/***********************************************************
+ *  SetColor()
+ *
+ *  This method is used for recording the color of the draws
+ *  that follow, which are drawn without a texture.
+ ***********************************************************/
+void CommandList::SetColor(const glm::vec4& color)
+{
+	if (m_bColorSet && (m_color == color))
+	{
+		return;
+	}
+
+	WriteOpcode(OP_COLOR);
+	Write(&color[0], 4 * sizeof(float));
+	m_color = color;
+	m_bColorSet = true;
+	// a color turns the texture off
+	m_bTextureSet = false;
+}
+
+/***********************************************************
+ *  SetTexture()
+ *
+ *  This method is used for recording the texture handle of
+ *  the draws that follow.
+ ***********************************************************/
+void CommandList::SetTexture(int textureHandle)
+{
+	if (m_bTextureSet && (m_texture == textureHandle))
+	{
+		return;
+	}
+
+	WriteOpcode(OP_TEXTURE);
+	Write(&textureHandle, sizeof(textureHandle));
+	m_texture = textureHandle;
+	m_bTextureSet = true;
+	// a texture replaces the color
+	m_bColorSet = false;
+}
+
+/***********************************************************
+ *  SetUVScale()
+ *
+ *  This method is used for recording the texture UV scale of
+ *  the draws that follow.
+ ***********************************************************/
+void CommandList::SetUVScale(const glm::vec2& uvScale)
+{
+	if (m_bUVScaleSet && (m_uvScale == uvScale))
+	{
+		return;
+	}
+
+	WriteOpcode(OP_UV_SCALE);
+	Write(&uvScale[0], 2 * sizeof(float));
+	m_uvScale = uvScale;
+	m_bUVScaleSet = true;
+}
+
+/***********************************************************
+ *  SetMaterial()
+ *
+ *  This method is used for recording the material handle of
+ *  the draws that follow.
+ ***********************************************************/
+void CommandList::SetMaterial(int materialHandle)
+{
+	if (m_bMaterialSet && (m_material == materialHandle))
+	{
+		return;
+	}
+
+	WriteOpcode(OP_MATERIAL);
+	Write(&materialHandle, sizeof(materialHandle));
+	m_material = materialHandle;
+	m_bMaterialSet = true;
+}
+
+/***********************************************************
+ *  Draw()
+ *
+ *  This method is used for recording a draw of a shape part
+ *  with its world matrix, and its normal matrix when the
+ *  world matrix does not scale uniformly.  Only the top three
+ *  rows of the world matrix are written.
+ ***********************************************************/
+void CommandList::Draw(int part, bool bStatic, const glm::mat4& model, const glm::mat3& normalMatrix, bool bUniformScale)
+{
+	unsigned char header[2];
+	header[0] = (unsigned char)part;
+	header[1] = (bStatic ? g_DrawStatic : 0) | (bUniformScale ? 0 : g_DrawNormalMatrix);
+
+	WriteOpcode(OP_DRAW);
+	Write(header, sizeof(header));
+	for (int column = 0; column < 4; column++)
+	{
+		Write(&model[column][0], 3 * sizeof(float));
+	}
+	if (!bUniformScale)
+	{
+		for (int column = 0; column < 3; column++)
+		{
+			Write(&normalMatrix[column][0], 3 * sizeof(float));
+		}
+	}
+	m_drawCount++;
+}
+
+/***********************************************************
+ *  Append()
+ *
+ *  This method is used for adding the commands of another
+ *  list after the ones recorded so far, as if they had been
+ *  recorded here.
+ ***********************************************************/
+void CommandList::Append(const CommandList& list)
+{
+	m_bytes.insert(m_bytes.end(), list.m_bytes.begin(), list.m_bytes.end());
+	m_commandCount += list.m_commandCount;
+	m_drawCount += list.m_drawCount;
+	// the appended commands may have changed any state
+	ResetState();
+}
+
+/***********************************************************
+ *  Read()
+ *
+ *  This method is used for reading the command at an offset
+ *  of the list and moving the offset past it.  It returns
+ *  false when there are no more commands.
+ ***********************************************************/
+bool CommandList::Read(size_t& offset, COMMAND& command) const
+{
+	if (offset >= m_bytes.size())
+	{
+		return(false);
+	}
+
+	const unsigned char* pData = &m_bytes[offset];
+	command.opcode = (OPCODE)*pData++;
+
+	switch (command.opcode)
+	{
+	case OP_COLOR:
+		memcpy(&command.color[0], pData, 4 * sizeof(float));
+		pData += 4 * sizeof(float);
+		break;
+	case OP_TEXTURE:
+	case OP_MATERIAL:
+		memcpy(&command.handle, pData, sizeof(int));
+		pData += sizeof(int);
+		break;
+	case OP_UV_SCALE:
+		memcpy(&command.uvScale[0], pData, 2 * sizeof(float));
+		pData += 2 * sizeof(float);
+		break;
+	default:
+	{
+		command.part = pData[0];
+		command.bStatic = ((pData[1] & g_DrawStatic) != 0);
+		bool bNormalMatrix = ((pData[1] & g_DrawNormalMatrix) != 0);
+		pData += 2;
+
+		for (int column = 0; column < 4; column++)
+		{
+			memcpy(&command.model[column][0], pData, 3 * sizeof(float));
+			command.model[column][3] = (column == 3) ? 1.0f : 0.0f;
+			pData += 3 * sizeof(float);
+		}
+		if (bNormalMatrix)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				memcpy(&command.normalMatrix[column][0], pData, 3 * sizeof(float));
+				pData += 3 * sizeof(float);
+			}
+		}
+		else
+		{
+			command.normalMatrix = glm::mat3(command.model);
+		}
+		break;
+	}
+	}
+
+	offset = pData - m_bytes.data();
+	return(true);
+}
+
+/***********************************************************
+ *  GetSize()
+ *
+ *  This method returns the number of bytes the commands take
+ *  up.
+ ***********************************************************/
+size_t CommandList::GetSize() const
+{
+	return(m_bytes.size());
+}
+
+/***********************************************************
+ *  GetCommandCount()
+ *
+ *  This method returns the number of commands in the list.
+ ***********************************************************/
+unsigned int CommandList::GetCommandCount() const
+{
+	return(m_commandCount);
+}
+
+/***********************************************************
+ *  GetDrawCount()
+ *
+ *  This method returns the number of draws in the list.
+ ***********************************************************/
+unsigned int CommandList::GetDrawCount() const
+{
+	return(m_drawCount);
+}
@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////
+// commandlist.h
+// ============
+// record the draws of a scene into a compact binary buffer and replay them
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+/***********************************************************
+ *  CommandList
+ *
+ *  This class records the state changes and draws of a
+ *  scene into one packed byte buffer, so they can be read
+ *  back every frame without running the code that defined
+ *  them.  Each command is a one byte opcode followed by its
+ *  values.  A draw keeps its shape part and the world matrix
+ *  it was drawn with, the matrix's bottom row left out as it
+ *  is always (0, 0, 0, 1), and the normal matrix only when
+ *  the world matrix does not scale every axis the same.  A
+ *  state change is left out when it sets what the last one
+ *  of its kind already set.
+ *
+ *  Textures and materials are recorded by their handles,
+ *  not their locations, so a list stays valid when textures
+ *  are streamed in, moved or evicted.
+ *
+ *  A list only uses its own memory, so lists can be recorded
+ *  on worker threads, one list per thread, and appended in
+ *  order into one list on the thread that replays it.  Only
+ *  the "commandlist" benchmark records that way.  The scene
+ *  is recorded into one list on the GL thread, as each part
+ *  of it is placed with the scene graph nodes and draw state
+ *  the parts before it left.
+ ***********************************************************/
+class CommandList
+{
+public:
+	// the kinds of command
+	enum OPCODE
+	{
+		OP_COLOR = 0,
+		OP_TEXTURE,
+		OP_UV_SCALE,
+		OP_MATERIAL,
+		OP_DRAW
+	};
+
+	// one command read back out of the list - only the values
+	// of its opcode are set
+	struct COMMAND
+	{
+		OPCODE opcode;
+		// OP_COLOR
+		glm::vec4 color;
+		// texture handle (OP_TEXTURE) or material handle
+		// (OP_MATERIAL)
+		int handle;
+		// OP_UV_SCALE
+		glm::vec2 uvScale;
+		// OP_DRAW - shape part, whether the draw never moves,
+		// and its matrices
+		int part;
+		bool bStatic;
+		glm::mat4 model;
+		glm::mat3 normalMatrix;
+	};
+
+	// constructor
+	CommandList();
+
+	// remove every command, keeping the memory
+	void Clear();
+
+	// record a state change for the draws that follow
+	void SetColor(const glm::vec4& color);
+	void SetTexture(int textureHandle);
+	void SetUVScale(const glm::vec2& uvScale);
+	void SetMaterial(int materialHandle);
+	// record a draw of a shape part - bUniformScale means the
+	// normal matrix is the upper 3x3 of the model matrix and is
+	// not stored
+	void Draw(int part, bool bStatic, const glm::mat4& model, const glm::mat3& normalMatrix, bool bUniformScale);
+
+	// add the commands of another list after the ones recorded
+	void Append(const CommandList& list);
+
+	// read the command at offset and move offset to the next
+	// one, returning false at the end of the list
+	bool Read(size_t& offset, COMMAND& command) const;
+
+	// bytes, commands and draws in the list
+	size_t GetSize() const;
+	unsigned int GetCommandCount() const;
+	unsigned int GetDrawCount() const;
+
+private:
+	std::vector<unsigned char> m_bytes;
+	unsigned int m_commandCount;
+	unsigned int m_drawCount;
+
+	// the last state recorded of each kind, to leave out the
+	// changes that change nothing
+	bool m_bColorSet;
+	glm::vec4 m_color;
+	bool m_bTextureSet;
+	int m_texture;
+	bool m_bUVScaleSet;
+	glm::vec2 m_uvScale;
+	bool m_bMaterialSet;
+	int m_material;
+
+	// append an opcode and its values
+	void WriteOpcode(OPCODE opcode);
+	void Write(const void* data, size_t bytes);
+	// forget the last state recorded, so the next change of
+	// each kind is always recorded
+	void ResetState();
+};
@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustum.cpp
+// ============
+// test bounding volumes against the six planes of the view frustum
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Frustum.h"
+
+#include <cfloat>
+#include <cmath>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// planes in the padded arrays
+	const int g_PlaneCount = 6;
+	const int g_PaddedPlaneCount = 8;
+}
+
+/***********************************************************
+ *  Frustum()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+Frustum::Frustum()
+{
+	// planes everything is far in front of
+	for (int plane = 0; plane < g_PaddedPlaneCount; plane++)
+	{
+		m_planeX[plane] = 0.0f;
+		m_planeY[plane] = 0.0f;
+		m_planeZ[plane] = 0.0f;
+		m_planeD[plane] = FLT_MAX;
+	}
+}
+
+/***********************************************************
+ *  Set()
+ *
+ *  This method is used for taking the planes of the frustum
+ *  from a projection times view matrix.  A point is inside
+ *  when its clip space x, y and z are between -w and w, so
+ *  each plane is the fourth row of the matrix plus or minus
+ *  one of the first three.  The planes are normalized, so
+ *  they give distances in world units.
+ ***********************************************************/
+void Frustum::Set(const glm::mat4& viewProjection)
+{
+	for (int axis = 0; axis < 3; axis++)
+	{
+		for (int side = 0; side < 2; side++)
+		{
+			glm::vec4 plane;
+			for (int column = 0; column < 4; column++)
+			{
+				float value = viewProjection[column][axis];
+				plane[column] = viewProjection[column][3] + (side ? -value : value);
+			}
+
+			float length = glm::length(glm::vec3(plane));
+			if (length > 0.0f)
+			{
+				plane = plane * (1.0f / length);
+			}
+
+			int index = axis * 2 + side;
+			m_planeX[index] = plane.x;
+			m_planeY[index] = plane.y;
+			m_planeZ[index] = plane.z;
+			m_planeD[index] = plane.w;
+		}
+	}
+
+	for (int plane = g_PlaneCount; plane < g_PaddedPlaneCount; plane++)
+	{
+		m_planeX[plane] = m_planeX[0];
+		m_planeY[plane] = m_planeY[0];
+		m_planeZ[plane] = m_planeZ[0];
+		m_planeD[plane] = m_planeD[0];
+	}
+}
+
+/***********************************************************
+ *  TestBox()
+ *
+ *  This method is used for finding where an axis aligned
+ *  box is.  Against each plane the box reaches as far as
+ *  its half size along the plane's normal.
+ ***********************************************************/
+Frustum::RESULT Frustum::TestBox(const glm::vec3& minimum, const glm::vec3& maximum) const
+{
+	return(Test(0.5f * (minimum + maximum), 0.5f * (maximum - minimum), 0.0f));
+}
+
+/***********************************************************
+ *  TestSphere()
+ *
+ *  This method is used for finding where a sphere is.
+ ***********************************************************/
+Frustum::RESULT Frustum::TestSphere(const glm::vec3& center, float radius) const
+{
+	return(Test(center, glm::vec3(0.0f), radius));
+}
+
+/***********************************************************
+ *  Test()
+ *
+ *  This method is used for testing a volume against every
+ *  plane.  The volume is outside when it is entirely behind
+ *  any plane, and inside when it is entirely in front of
+ *  all of them.
+ ***********************************************************/
+Frustum::RESULT Frustum::Test(const glm::vec3& center, const glm::vec3& extents, float radius) const
+{
+#ifdef FRUSTUM_SSE
+	const __m128 centerX = _mm_set1_ps(center.x);
+	const __m128 centerY = _mm_set1_ps(center.y);
+	const __m128 centerZ = _mm_set1_ps(center.z);
+	const __m128 extentX = _mm_set1_ps(extents.x);
+	const __m128 extentY = _mm_set1_ps(extents.y);
+	const __m128 extentZ = _mm_set1_ps(extents.z);
+	const __m128 sphere = _mm_set1_ps(radius);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	const __m128 zero = _mm_setzero_ps();
+
+	int behind = 0;
+	int crossing = 0;
+	for (int first = 0; first < g_PaddedPlaneCount; first += 4)
+	{
+		__m128 planeX = _mm_loadu_ps(m_planeX + first);
+		__m128 planeY = _mm_loadu_ps(m_planeY + first);
+		__m128 planeZ = _mm_loadu_ps(m_planeZ + first);
+		__m128 planeD = _mm_loadu_ps(m_planeD + first);
+
+		// distance of the center, and how far the volume reaches
+		// along the normal
+		__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX, centerX), _mm_mul_ps(planeY, centerY)),
+			_mm_add_ps(_mm_mul_ps(planeZ, centerZ), planeD));
+		__m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signBit, planeX), extentX),
+			_mm_mul_ps(_mm_andnot_ps(signBit, planeY), extentY)),
+			_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signBit, planeZ), extentZ), sphere));
+
+		behind |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, reach), zero));
+		crossing |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, reach), zero));
+	}
+#else
+	bool behind = false;
+	bool crossing = false;
+	for (int plane = 0; plane < g_PlaneCount; plane++)
+	{
+		float distance = m_planeX[plane] * center.x + m_planeY[plane] * center.y + m_planeZ[plane] * center.z + m_planeD[plane];
+		float reach = std::fabs(m_planeX[plane]) * extents.x + std::fabs(m_planeY[plane]) * extents.y +
+			std::fabs(m_planeZ[plane]) * extents.z + radius;
+		behind = behind || (distance + reach < 0.0f);
+		crossing = crossing || (distance - reach < 0.0f);
+	}
+#endif
+
+	if (behind)
+	{
+		return(RESULT_OUTSIDE);
+	}
+	return(crossing ? RESULT_INTERSECTING : RESULT_INSIDE);
+}
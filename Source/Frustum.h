@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustum.h
+// ============
+// test bounding volumes against the six planes of the view frustum
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  Frustum
+ *
+ *  This class holds the planes of the volume the camera
+ *  sees, taken from the view and projection matrices, and
+ *  tells whether a box or sphere is outside it, crosses its
+ *  sides or is inside it.  The planes are stored one array
+ *  per component, so on x86 four planes are tested at once
+ *  with SSE, the six planes in two steps.
+ *
+ *  A frustum that was never set holds everything, so the
+ *  scene is drawn in full until the camera is known.
+ ***********************************************************/
+class Frustum
+{
+public:
+	// where a volume is
+	enum RESULT
+	{
+		RESULT_OUTSIDE = 0,
+		RESULT_INTERSECTING,
+		RESULT_INSIDE
+	};
+
+	// constructor
+	Frustum();
+
+	// take the planes from a projection times view matrix
+	void Set(const glm::mat4& viewProjection);
+
+	// test an axis aligned box, and a sphere
+	RESULT TestBox(const glm::vec3& minimum, const glm::vec3& maximum) const;
+	RESULT TestSphere(const glm::vec3& center, float radius) const;
+
+private:
+	// the six planes, padded to eight with copies of the first,
+	// each one facing into the frustum with ax + by + cz + d
+	// its distance from a point
+	float m_planeX[8];
+	float m_planeY[8];
+	float m_planeZ[8];
+	float m_planeD[8];
+
+	// test a volume around a center that reaches extents along
+	// the axes, and radius further along every plane normal
+	RESULT Test(const glm::vec3& center, const glm::vec3& extents, float radius) const;
+};
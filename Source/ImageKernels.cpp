@@ -0,0 +1,719 @@
+///////////////////////////////////////////////////////////////////////////////
+// imagekernels.cpp
+// ============
+// SIMD pixel kernels for the work done on images while they are loaded
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ImageKernels.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define IMAGE_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC allows any intrinsic in any function
+#define IMAGE_KERNELS_TARGET(isa)
+#else
+#include <cpuid.h>
+// GCC and Clang need every function using an intrinsic marked
+// with its instruction set, so the rest of the program still
+// builds for the baseline CPU
+#define IMAGE_KERNELS_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+// declaration of global variables
+namespace
+{
+	// entries in the linear to sRGB table, enough that neighbouring
+	// entries are less than half an 8-bit step apart near black
+	const int g_LinearSteps = 8192;
+
+	/***********************************************************
+	 *  DetectISA()
+	 *
+	 *  Ask the CPU, and for AVX the operating system, which
+	 *  instruction sets can be used.
+	 ***********************************************************/
+	ImageKernels::ISA DetectISA()
+	{
+#ifdef IMAGE_KERNELS_X86
+		unsigned int registers1[4] = { 0, 0, 0, 0 };
+		unsigned int registers7[4] = { 0, 0, 0, 0 };
+		unsigned int maxLeaf = 0;
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		maxLeaf = (unsigned int)info[0];
+		__cpuid(info, 1);
+		memcpy(registers1, info, sizeof(registers1));
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			memcpy(registers7, info, sizeof(registers7));
+		}
+#else
+		maxLeaf = __get_cpuid_max(0, NULL);
+		__cpuid(1, registers1[0], registers1[1], registers1[2], registers1[3]);
+		if (maxLeaf >= 7)
+		{
+			__cpuid_count(7, 0, registers7[0], registers7[1], registers7[2], registers7[3]);
+		}
+#endif
+
+		bool bSSE2 = (registers1[3] & (1u << 26)) != 0;
+		bool bSSSE3 = (registers1[2] & (1u << 9)) != 0;
+		bool bOSXSAVE = (registers1[2] & (1u << 27)) != 0;
+		bool bAVX = (registers1[2] & (1u << 28)) != 0;
+		bool bAVX2 = (registers7[1] & (1u << 5)) != 0;
+
+		// the operating system has to save the AVX registers too
+		if (bAVX && bAVX2 && bOSXSAVE)
+		{
+#ifdef _MSC_VER
+			unsigned long long xcr0 = _xgetbv(0);
+#else
+			unsigned int xcr0Low = 0;
+			unsigned int xcr0High = 0;
+			__asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+			unsigned long long xcr0 = ((unsigned long long)xcr0High << 32) | xcr0Low;
+#endif
+			if ((xcr0 & 6) == 6)
+			{
+				return(ImageKernels::ISA_AVX2);
+			}
+		}
+		if (bSSE2 && bSSSE3)
+		{
+			return(ImageKernels::ISA_SSSE3);
+		}
+#endif
+		return(ImageKernels::ISA_SCALAR);
+	}
+
+	// instruction set the kernels run with
+	std::atomic<int> g_ISA(DetectISA());
+
+	// lookup tables for converting between sRGB and linear light
+	struct SRGB_TABLES
+	{
+		float toLinear[256];
+		unsigned char toSRGB[g_LinearSteps + 1];
+
+		SRGB_TABLES()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				double value = i / 255.0;
+				toLinear[i] = (float)((value <= 0.04045) ? value / 12.92 : pow((value + 0.055) / 1.055, 2.4));
+			}
+			for (int i = 0; i <= g_LinearSteps; i++)
+			{
+				double value = (double)i / g_LinearSteps;
+				value = (value <= 0.0031308) ? value * 12.92 : 1.055 * pow(value, 1.0 / 2.4) - 0.055;
+				toSRGB[i] = (unsigned char)(value * 255.0 + 0.5);
+			}
+		}
+	};
+
+	/***********************************************************
+	 *  GetSRGBTables()
+	 *
+	 *  Get the sRGB tables, built on first use.
+	 ***********************************************************/
+	const SRGB_TABLES& GetSRGBTables()
+	{
+		static const SRGB_TABLES tables;
+		return(tables);
+	}
+
+	/***********************************************************
+	 *  SwapRowsScalar()
+	 *
+	 *  Swap the bytes of two rows.
+	 ***********************************************************/
+	void SwapRowsScalar(unsigned char* row0, unsigned char* row1, size_t size)
+	{
+		for (size_t i = 0; i < size; i++)
+		{
+			unsigned char value = row0[i];
+			row0[i] = row1[i];
+			row1[i] = value;
+		}
+	}
+
+	/***********************************************************
+	 *  ExpandRGBScalar()
+	 *
+	 *  Expand RGB pixels to RGBA one at a time.
+	 ***********************************************************/
+	void ExpandRGBScalar(const unsigned char* rgb, unsigned char* rgba, size_t pixelCount)
+	{
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			rgba[i * 4 + 0] = rgb[i * 3 + 0];
+			rgba[i * 4 + 1] = rgb[i * 3 + 1];
+			rgba[i * 4 + 2] = rgb[i * 3 + 2];
+			rgba[i * 4 + 3] = 255;
+		}
+	}
+
+	/***********************************************************
+	 *  PremultiplyScalar()
+	 *
+	 *  Premultiply RGBA pixels one at a time.  The division by
+	 *  255 is rounded exactly without dividing.
+	 ***********************************************************/
+	void PremultiplyScalar(unsigned char* rgba, size_t pixelCount)
+	{
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			unsigned int alpha = rgba[i * 4 + 3];
+			for (int c = 0; c < 3; c++)
+			{
+				unsigned int value = rgba[i * 4 + c] * alpha + 128;
+				rgba[i * 4 + c] = (unsigned char)((value + (value >> 8)) >> 8);
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  AddRowsScalar()
+	 *
+	 *  Add two rows of floats.
+	 ***********************************************************/
+	void AddRowsScalar(const float* row0, const float* row1, float* sum, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			sum[i] = row0[i] + row1[i];
+		}
+	}
+
+	/***********************************************************
+	 *  ScaleToStepsScalar()
+	 *
+	 *  Turn linear values from 0 to 1 into linear to sRGB
+	 *  table indices, rounding to the nearest step.
+	 ***********************************************************/
+	void ScaleToStepsScalar(const float* values, int* steps, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			float step = values[i] * (float)g_LinearSteps + 0.5f;
+			step = (step < 0.0f) ? 0.0f : ((step > (float)g_LinearSteps) ? (float)g_LinearSteps : step);
+			steps[i] = (int)step;
+		}
+	}
+
+#ifdef IMAGE_KERNELS_X86
+	/***********************************************************
+	 *  SwapRowsSSE()
+	 *
+	 *  Swap the bytes of two rows 16 at a time.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("ssse3")
+	void SwapRowsSSE(unsigned char* row0, unsigned char* row1, size_t size)
+	{
+		size_t i = 0;
+		for (; i + 16 <= size; i += 16)
+		{
+			__m128i value0 = _mm_loadu_si128((const __m128i*)(row0 + i));
+			__m128i value1 = _mm_loadu_si128((const __m128i*)(row1 + i));
+			_mm_storeu_si128((__m128i*)(row0 + i), value1);
+			_mm_storeu_si128((__m128i*)(row1 + i), value0);
+		}
+		SwapRowsScalar(row0 + i, row1 + i, size - i);
+	}
+
+	/***********************************************************
+	 *  SwapRowsAVX2()
+	 *
+	 *  Swap the bytes of two rows 32 at a time.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("avx2")
+	void SwapRowsAVX2(unsigned char* row0, unsigned char* row1, size_t size)
+	{
+		size_t i = 0;
+		for (; i + 32 <= size; i += 32)
+		{
+			__m256i value0 = _mm256_loadu_si256((const __m256i*)(row0 + i));
+			__m256i value1 = _mm256_loadu_si256((const __m256i*)(row1 + i));
+			_mm256_storeu_si256((__m256i*)(row0 + i), value1);
+			_mm256_storeu_si256((__m256i*)(row1 + i), value0);
+		}
+		SwapRowsScalar(row0 + i, row1 + i, size - i);
+	}
+
+	/***********************************************************
+	 *  ExpandRGBSSSE3()
+	 *
+	 *  Expand RGB pixels to RGBA four at a time with a byte
+	 *  shuffle.  Each 16 byte load holds 4 whole pixels, so
+	 *  the loop stops while 6 pixels are left to stay inside
+	 *  the source.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("ssse3")
+	void ExpandRGBSSSE3(const unsigned char* rgb, unsigned char* rgba, size_t pixelCount)
+	{
+		const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+		const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+		size_t i = 0;
+		for (; i + 6 <= pixelCount; i += 4)
+		{
+			__m128i source = _mm_loadu_si128((const __m128i*)(rgb + i * 3));
+			__m128i pixels = _mm_or_si128(_mm_shuffle_epi8(source, shuffle), alpha);
+			_mm_storeu_si128((__m128i*)(rgba + i * 4), pixels);
+		}
+		ExpandRGBScalar(rgb + i * 3, rgba + i * 4, pixelCount - i);
+	}
+
+	/***********************************************************
+	 *  ExpandRGBAVX2()
+	 *
+	 *  Expand RGB pixels to RGBA eight at a time, with four
+	 *  pixels in each 128-bit lane.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("avx2")
+	void ExpandRGBAVX2(const unsigned char* rgb, unsigned char* rgba, size_t pixelCount)
+	{
+		const __m256i shuffle = _mm256_setr_epi8(
+			0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+			0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+		const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+		size_t i = 0;
+		for (; i + 10 <= pixelCount; i += 8)
+		{
+			__m128i low = _mm_loadu_si128((const __m128i*)(rgb + i * 3));
+			__m128i high = _mm_loadu_si128((const __m128i*)(rgb + i * 3 + 12));
+			__m256i source = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+			__m256i pixels = _mm256_or_si256(_mm256_shuffle_epi8(source, shuffle), alpha);
+			_mm256_storeu_si256((__m256i*)(rgba + i * 4), pixels);
+		}
+		ExpandRGBSSSE3(rgb + i * 3, rgba + i * 4, pixelCount - i);
+	}
+
+	/***********************************************************
+	 *  PremultiplySSE()
+	 *
+	 *  Premultiply RGBA pixels four at a time, widening the
+	 *  channels to 16 bits for the multiply.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("ssse3")
+	void PremultiplySSE(unsigned char* rgba, size_t pixelCount)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i half = _mm_set1_epi16(128);
+		const __m128i alphaMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+		size_t i = 0;
+		for (; i + 4 <= pixelCount; i += 4)
+		{
+			__m128i pixels = _mm_loadu_si128((const __m128i*)(rgba + i * 4));
+			__m128i halves[2] = { _mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero) };
+			for (int h = 0; h < 2; h++)
+			{
+				__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[h], 0xFF), 0xFF);
+				__m128i value = _mm_add_epi16(_mm_mullo_epi16(halves[h], alpha), half);
+				value = _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+				halves[h] = _mm_or_si128(_mm_andnot_si128(alphaMask, value), _mm_and_si128(alphaMask, halves[h]));
+			}
+			_mm_storeu_si128((__m128i*)(rgba + i * 4), _mm_packus_epi16(halves[0], halves[1]));
+		}
+		PremultiplyScalar(rgba + i * 4, pixelCount - i);
+	}
+
+	/***********************************************************
+	 *  PremultiplyAVX2()
+	 *
+	 *  Premultiply RGBA pixels eight at a time.  Unpacking and
+	 *  packing both work inside each 128-bit lane, so the
+	 *  pixels come back out in their original order.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("avx2")
+	void PremultiplyAVX2(unsigned char* rgba, size_t pixelCount)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i half = _mm256_set1_epi16(128);
+		const __m256i alphaMask = _mm256_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1);
+		size_t i = 0;
+		for (; i + 8 <= pixelCount; i += 8)
+		{
+			__m256i pixels = _mm256_loadu_si256((const __m256i*)(rgba + i * 4));
+			__m256i halves[2] = { _mm256_unpacklo_epi8(pixels, zero), _mm256_unpackhi_epi8(pixels, zero) };
+			for (int h = 0; h < 2; h++)
+			{
+				__m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(halves[h], 0xFF), 0xFF);
+				__m256i value = _mm256_add_epi16(_mm256_mullo_epi16(halves[h], alpha), half);
+				value = _mm256_srli_epi16(_mm256_add_epi16(value, _mm256_srli_epi16(value, 8)), 8);
+				halves[h] = _mm256_or_si256(_mm256_andnot_si256(alphaMask, value), _mm256_and_si256(alphaMask, halves[h]));
+			}
+			_mm256_storeu_si256((__m256i*)(rgba + i * 4), _mm256_packus_epi16(halves[0], halves[1]));
+		}
+		PremultiplySSE(rgba + i * 4, pixelCount - i);
+	}
+
+	/***********************************************************
+	 *  AddRowsSSE()
+	 *
+	 *  Add two rows of floats four at a time.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("ssse3")
+	void AddRowsSSE(const float* row0, const float* row1, float* sum, size_t count)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			_mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(row0 + i), _mm_loadu_ps(row1 + i)));
+		}
+		AddRowsScalar(row0 + i, row1 + i, sum + i, count - i);
+	}
+
+	/***********************************************************
+	 *  AddRowsAVX2()
+	 *
+	 *  Add two rows of floats eight at a time.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("avx2")
+	void AddRowsAVX2(const float* row0, const float* row1, float* sum, size_t count)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			_mm256_storeu_ps(sum + i, _mm256_add_ps(_mm256_loadu_ps(row0 + i), _mm256_loadu_ps(row1 + i)));
+		}
+		AddRowsScalar(row0 + i, row1 + i, sum + i, count - i);
+	}
+
+	/***********************************************************
+	 *  ScaleToStepsSSE()
+	 *
+	 *  Turn linear values into table indices four at a time.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("ssse3")
+	void ScaleToStepsSSE(const float* values, int* steps, size_t count)
+	{
+		const __m128 scale = _mm_set1_ps((float)g_LinearSteps);
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 highest = _mm_set1_ps((float)g_LinearSteps);
+		const __m128 zero = _mm_setzero_ps();
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 step = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(values + i), scale), half);
+			step = _mm_min_ps(_mm_max_ps(step, zero), highest);
+			_mm_storeu_si128((__m128i*)(steps + i), _mm_cvttps_epi32(step));
+		}
+		ScaleToStepsScalar(values + i, steps + i, count - i);
+	}
+
+	/***********************************************************
+	 *  ScaleToStepsAVX2()
+	 *
+	 *  Turn linear values into table indices eight at a time.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("avx2")
+	void ScaleToStepsAVX2(const float* values, int* steps, size_t count)
+	{
+		const __m256 scale = _mm256_set1_ps((float)g_LinearSteps);
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 highest = _mm256_set1_ps((float)g_LinearSteps);
+		const __m256 zero = _mm256_setzero_ps();
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 step = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(values + i), scale), half);
+			step = _mm256_min_ps(_mm256_max_ps(step, zero), highest);
+			_mm256_storeu_si256((__m256i*)(steps + i), _mm256_cvttps_epi32(step));
+		}
+		ScaleToStepsScalar(values + i, steps + i, count - i);
+	}
+
+	/***********************************************************
+	 *  ToLinearAVX2()
+	 *
+	 *  Look up the linear values of bytes eight at a time with
+	 *  a gather, returning how many were converted.
+	 ***********************************************************/
+	IMAGE_KERNELS_TARGET("avx2")
+	size_t ToLinearAVX2(const unsigned char* row, size_t count, const float* toLinear, float* linear)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(row + i)));
+			_mm256_storeu_ps(linear + i, _mm256_i32gather_ps(toLinear, indices, 4));
+		}
+		return(i);
+	}
+#endif
+
+	/***********************************************************
+	 *  AddRows()
+	 *
+	 *  Add two rows of floats with the current instruction set.
+	 ***********************************************************/
+	void AddRows(const float* row0, const float* row1, float* sum, size_t count)
+	{
+#ifdef IMAGE_KERNELS_X86
+		switch (g_ISA.load())
+		{
+		case ImageKernels::ISA_AVX2:
+			AddRowsAVX2(row0, row1, sum, count);
+			return;
+		case ImageKernels::ISA_SSSE3:
+			AddRowsSSE(row0, row1, sum, count);
+			return;
+		}
+#endif
+		AddRowsScalar(row0, row1, sum, count);
+	}
+
+	/***********************************************************
+	 *  ScaleToSteps()
+	 *
+	 *  Turn linear values into table indices with the current
+	 *  instruction set.
+	 ***********************************************************/
+	void ScaleToSteps(const float* values, int* steps, size_t count)
+	{
+#ifdef IMAGE_KERNELS_X86
+		switch (g_ISA.load())
+		{
+		case ImageKernels::ISA_AVX2:
+			ScaleToStepsAVX2(values, steps, count);
+			return;
+		case ImageKernels::ISA_SSSE3:
+			ScaleToStepsSSE(values, steps, count);
+			return;
+		}
+#endif
+		ScaleToStepsScalar(values, steps, count);
+	}
+
+	/***********************************************************
+	 *  ToLinearRow()
+	 *
+	 *  Convert a row of 8-bit pixels to linear light floats.
+	 ***********************************************************/
+	void ToLinearRow(const unsigned char* row, size_t count, int colorChannels, int alphaChannel, float* linear)
+	{
+		const float* toLinear = GetSRGBTables().toLinear;
+		size_t i = 0;
+#ifdef IMAGE_KERNELS_X86
+		if (g_ISA.load() == ImageKernels::ISA_AVX2)
+		{
+			i = ToLinearAVX2(row, count, toLinear, linear);
+		}
+#endif
+		for (; i < count; i++)
+		{
+			linear[i] = toLinear[row[i]];
+		}
+		if (alphaChannel >= 0)
+		{
+			for (i = alphaChannel; i < count; i += colorChannels)
+			{
+				linear[i] = row[i] * (1.0f / 255.0f);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  GetSupportedISA()
+ *
+ *  This method returns the best instruction set the CPU and
+ *  operating system support.
+ ***********************************************************/
+ImageKernels::ISA ImageKernels::GetSupportedISA()
+{
+	static const ISA supported = DetectISA();
+	return(supported);
+}
+
+/***********************************************************
+ *  SetISA()
+ *
+ *  This method is used for choosing the instruction set the
+ *  kernels run with, no higher than the CPU supports.
+ ***********************************************************/
+void ImageKernels::SetISA(ISA isa)
+{
+	g_ISA = (isa < GetSupportedISA()) ? isa : GetSupportedISA();
+}
+
+/***********************************************************
+ *  GetISA()
+ *
+ *  This method returns the instruction set the kernels run
+ *  with.
+ ***********************************************************/
+ImageKernels::ISA ImageKernels::GetISA()
+{
+	return((ISA)g_ISA.load());
+}
+
+/***********************************************************
+ *  GetISAName()
+ *
+ *  This method returns the name of an instruction set.
+ ***********************************************************/
+const char* ImageKernels::GetISAName(ISA isa)
+{
+	switch (isa)
+	{
+	case ISA_AVX2:
+		return("avx2");
+	case ISA_SSSE3:
+		return("ssse3");
+	default:
+		return("scalar");
+	}
+}
+
+/***********************************************************
+ *  FlipVertical()
+ *
+ *  This method is used for turning an image upside down, so
+ *  its first row is the bottom row OpenGL expects.
+ ***********************************************************/
+void ImageKernels::FlipVertical(unsigned char* pixels, size_t rowSize, int height)
+{
+	for (int y = 0; y < height / 2; y++)
+	{
+		unsigned char* top = pixels + (size_t)y * rowSize;
+		unsigned char* bottom = pixels + (size_t)(height - 1 - y) * rowSize;
+#ifdef IMAGE_KERNELS_X86
+		switch (g_ISA.load())
+		{
+		case ISA_AVX2:
+			SwapRowsAVX2(top, bottom, rowSize);
+			continue;
+		case ISA_SSSE3:
+			SwapRowsSSE(top, bottom, rowSize);
+			continue;
+		}
+#endif
+		SwapRowsScalar(top, bottom, rowSize);
+	}
+}
+
+/***********************************************************
+ *  ExpandRGBToRGBA()
+ *
+ *  This method is used for adding an opaque alpha channel
+ *  to RGB pixels.  OpenGL stores RGB textures with four
+ *  bytes per pixel anyway, so doing it here saves the driver
+ *  converting every upload on the GL thread.
+ ***********************************************************/
+void ImageKernels::ExpandRGBToRGBA(const unsigned char* rgb, unsigned char* rgba, size_t pixelCount)
+{
+#ifdef IMAGE_KERNELS_X86
+	switch (g_ISA.load())
+	{
+	case ISA_AVX2:
+		ExpandRGBAVX2(rgb, rgba, pixelCount);
+		return;
+	case ISA_SSSE3:
+		ExpandRGBSSSE3(rgb, rgba, pixelCount);
+		return;
+	}
+#endif
+	ExpandRGBScalar(rgb, rgba, pixelCount);
+}
+
+/***********************************************************
+ *  PremultiplyAlpha()
+ *
+ *  This method is used for multiplying the color channels
+ *  of RGBA pixels by their alpha, rounding to the nearest
+ *  value.  Filtering premultiplied pixels stops the color of
+ *  transparent pixels bleeding into their neighbours.
+ ***********************************************************/
+void ImageKernels::PremultiplyAlpha(unsigned char* rgba, size_t pixelCount)
+{
+#ifdef IMAGE_KERNELS_X86
+	switch (g_ISA.load())
+	{
+	case ISA_AVX2:
+		PremultiplyAVX2(rgba, pixelCount);
+		return;
+	case ISA_SSSE3:
+		PremultiplySSE(rgba, pixelCount);
+		return;
+	}
+#endif
+	PremultiplyScalar(rgba, pixelCount);
+}
+
+/***********************************************************
+ *  DownsampleSRGB()
+ *
+ *  This method is used for building the next mip level by
+ *  averaging each 2x2 block of source pixels.  The color
+ *  channels are converted to linear light before averaging
+ *  and back to sRGB after, so the smaller levels keep the
+ *  brightness of the full image.  Odd edges reuse the last
+ *  row or column.  The row adds and the conversion back to
+ *  table steps use SIMD, and with AVX2 so does the lookup of
+ *  the linear values.
+ ***********************************************************/
+void ImageKernels::DownsampleSRGB(
+	const unsigned char* source,
+	int sourceWidth,
+	int sourceHeight,
+	unsigned char* destination,
+	int width,
+	int height,
+	int colorChannels)
+{
+	const unsigned char* toSRGB = GetSRGBTables().toSRGB;
+	int alphaChannel = ((colorChannels == 2) || (colorChannels == 4)) ? colorChannels - 1 : -1;
+	size_t sourceRowSize = (size_t)sourceWidth * colorChannels;
+	size_t rowSize = (size_t)width * colorChannels;
+
+	std::vector<float> linear0(sourceRowSize);
+	std::vector<float> linear1(sourceRowSize);
+	std::vector<float> sum(sourceRowSize);
+	std::vector<float> average(rowSize);
+	std::vector<int> steps(rowSize);
+
+	for (int y = 0; y < height; y++)
+	{
+		int y0 = (2 * y < sourceHeight) ? 2 * y : sourceHeight - 1;
+		int y1 = (2 * y + 1 < sourceHeight) ? 2 * y + 1 : sourceHeight - 1;
+		ToLinearRow(source + (size_t)y0 * sourceRowSize, sourceRowSize, colorChannels, alphaChannel, &linear0[0]);
+		ToLinearRow(source + (size_t)y1 * sourceRowSize, sourceRowSize, colorChannels, alphaChannel, &linear1[0]);
+		AddRows(&linear0[0], &linear1[0], &sum[0], sourceRowSize);
+
+		for (int x = 0; x < width; x++)
+		{
+			int x0 = ((2 * x < sourceWidth) ? 2 * x : sourceWidth - 1) * colorChannels;
+			int x1 = ((2 * x + 1 < sourceWidth) ? 2 * x + 1 : sourceWidth - 1) * colorChannels;
+			for (int c = 0; c < colorChannels; c++)
+			{
+				average[x * colorChannels + c] = (sum[x0 + c] + sum[x1 + c]) * 0.25f;
+			}
+		}
+
+		ScaleToSteps(&average[0], &steps[0], rowSize);
+		unsigned char* row = destination + (size_t)y * rowSize;
+		for (size_t i = 0; i < rowSize; i++)
+		{
+			row[i] = toSRGB[steps[i]];
+		}
+		if (alphaChannel >= 0)
+		{
+			for (size_t i = alphaChannel; i < rowSize; i += colorChannels)
+			{
+				row[i] = (unsigned char)(average[i] * 255.0f + 0.5f);
+			}
+		}
+	}
+}
@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+// imagekernels.h
+// ============
+// SIMD pixel kernels for the work done on images while they are loaded
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+/***********************************************************
+ *  ImageKernels
+ *
+ *  This class holds the pixel loops run on every image
+ *  while it is decoded or cooked - flipping it the right way
+ *  up for OpenGL, expanding RGB to RGBA so the driver never
+ *  has to, premultiplying alpha and building gamma-correct
+ *  mip levels.  Each kernel has AVX2 and SSE versions that
+ *  are picked at run time from what the CPU supports, and a
+ *  scalar version for every other CPU.
+ ***********************************************************/
+class ImageKernels
+{
+public:
+	// instruction sets a kernel can run with, each one also
+	// able to run everything before it
+	enum ISA
+	{
+		ISA_SCALAR = 0,
+		ISA_SSSE3,
+		ISA_AVX2
+	};
+
+	// best instruction set the CPU supports
+	static ISA GetSupportedISA();
+	// instruction set the kernels run with - lower it to time the
+	// slower versions, it is limited to what the CPU supports
+	static void SetISA(ISA isa);
+	static ISA GetISA();
+	// name of an instruction set
+	static const char* GetISAName(ISA isa);
+
+	// turn an image upside down in place
+	static void FlipVertical(unsigned char* pixels, size_t rowSize, int height);
+
+	// expand RGB pixels to RGBA with an alpha of 255 - the source
+	// and destination must not overlap
+	static void ExpandRGBToRGBA(const unsigned char* rgb, unsigned char* rgba, size_t pixelCount);
+
+	// multiply the color of RGBA pixels by their alpha in place
+	static void PremultiplyAlpha(unsigned char* rgba, size_t pixelCount);
+
+	// build the next mip level by averaging each 2x2 block of
+	// source pixels in linear light - color channels are sRGB,
+	// and the last channel of a 2 or 4 channel image is alpha
+	static void DownsampleSRGB(
+		const unsigned char* source,
+		int sourceWidth,
+		int sourceHeight,
+		unsigned char* destination,
+		int width,
+		int height,
+		int colorChannels);
+};
@@ -0,0 +1,571 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancerenderer.cpp
+// ============
+// draw every basic shape of the scene from one geometry arena, with one
+// multi-draw indirect call where the driver supports it
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InstanceRenderer.h"
+
+#include <algorithm>
+#include <cstddef>
+
+// declaration of global variables
+namespace
+{
+	// attribute locations of the vertex shader
+	const GLuint g_PositionLocation = 0;
+	const GLuint g_NormalLocation = 1;
+	const GLuint g_TextureCoordinateLocation = 2;
+	// the model matrix takes 4 locations and the normal
+	// matrix 3, one per column
+	const GLuint g_ModelLocation = 3;
+	const GLuint g_NormalMatrixLocation = 7;
+	const GLuint g_ColorLocation = 10;
+	const GLuint g_TextureRectLocation = 11;
+	const GLuint g_SurfaceLocation = 12;
+	const GLuint g_FlagsLocation = 13;
+	// shader storage binding vertexShaderIndirect.glsl reads
+	// the instances from
+	const GLuint g_InstanceBinding = 1;
+	// instances the buffer is first created to hold
+	const size_t g_InitialInstances = 256;
+	// draw commands the indirect buffer is first created to hold
+	const size_t g_InitialCommands = 64;
+	// draws per chunk of the work handed to the job system
+	const int g_DrawsPerJob = 1024;
+}
+
+/***********************************************************
+ *  InstanceRenderer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InstanceRenderer::InstanceRenderer()
+{
+	m_vertexArrayID = 0;
+	m_vertexBufferID = 0;
+	m_indexBufferID = 0;
+	m_primitiveVertexCount = 0;
+	m_primitiveIndexCount = 0;
+	m_instanceBufferID = 0;
+	m_instanceCapacity = 0;
+	m_indirectBufferID = 0;
+	m_indirectCapacity = 0;
+	m_bIndirect = false;
+	m_instanceCount = 0;
+	m_drawCalls = 0;
+	m_viewPosition = glm::vec3(0.0f);
+	m_pJobSystem = NULL;
+}
+
+/***********************************************************
+ *  ~InstanceRenderer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+InstanceRenderer::~InstanceRenderer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  IsIndirectSupported()
+ *
+ *  This method returns true when the context has multi-draw
+ *  indirect and shader storage buffers, both core in OpenGL
+ *  4.3, and the gl_BaseInstanceARB input the indirect vertex
+ *  shader finds its instances with.
+ ***********************************************************/
+bool InstanceRenderer::IsIndirectSupported()
+{
+	return((GLEW_VERSION_4_3 != GL_FALSE) && (GLEW_ARB_shader_draw_parameters != GL_FALSE));
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for copying the vertices and indices
+ *  of every mesh into the arena, one after another, and
+ *  setting up its vertex array.  Each part remembers where
+ *  its indices start and the first vertex of its mesh.
+ ***********************************************************/
+bool InstanceRenderer::Create(const PrimitiveGeometry& geometry, bool bIndirect)
+{
+	Destroy();
+
+	m_bIndirect = bIndirect && IsIndirectSupported();
+
+	// suballocate every mesh from one vertex and index list
+	std::vector<PrimitiveGeometry::VERTEX>& vertices = m_arenaVertices;
+	std::vector<unsigned int>& indices = m_arenaIndices;
+	vertices.clear();
+	indices.clear();
+	GLuint meshFirstIndex[PrimitiveGeometry::MESH_COUNT];
+	GLint meshBaseVertex[PrimitiveGeometry::MESH_COUNT];
+	for (int mesh = 0; mesh < PrimitiveGeometry::MESH_COUNT; mesh++)
+	{
+		const std::vector<PrimitiveGeometry::VERTEX>& meshVertices = geometry.GetVertices((PrimitiveGeometry::MESH)mesh);
+		const std::vector<unsigned int>& meshIndices = geometry.GetIndices((PrimitiveGeometry::MESH)mesh);
+
+		meshFirstIndex[mesh] = (GLuint)indices.size();
+		meshBaseVertex[mesh] = (GLint)vertices.size();
+		vertices.insert(vertices.end(), meshVertices.begin(), meshVertices.end());
+		indices.insert(indices.end(), meshIndices.begin(), meshIndices.end());
+	}
+	m_primitiveVertexCount = vertices.size();
+	m_primitiveIndexCount = indices.size();
+	m_parts.resize(PrimitiveGeometry::PART_COUNT);
+	for (int part = 0; part < PrimitiveGeometry::PART_COUNT; part++)
+	{
+		const PrimitiveGeometry::PART_RANGE& range = geometry.GetPart((PrimitiveGeometry::PART)part);
+		m_parts[part].indexCount = (GLuint)range.indexCount;
+		m_parts[part].firstIndex = meshFirstIndex[range.mesh] + (GLuint)range.firstIndex;
+		m_parts[part].baseVertex = meshBaseVertex[range.mesh];
+	}
+
+	m_instanceCapacity = g_InitialInstances * sizeof(INSTANCE);
+	glGenBuffers(1, &m_instanceBufferID);
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBufferID);
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity, NULL, GL_STREAM_DRAW);
+
+	glGenVertexArrays(1, &m_vertexArrayID);
+	glBindVertexArray(m_vertexArrayID);
+
+	glGenBuffers(1, &m_vertexBufferID);
+	glGenBuffers(1, &m_indexBufferID);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBufferID);
+	UploadArena();
+
+	GLsizei stride = (GLsizei)sizeof(PrimitiveGeometry::VERTEX);
+	glEnableVertexAttribArray(g_PositionLocation);
+	glVertexAttribPointer(g_PositionLocation, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(PrimitiveGeometry::VERTEX, position));
+	glEnableVertexAttribArray(g_NormalLocation);
+	glVertexAttribPointer(g_NormalLocation, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(PrimitiveGeometry::VERTEX, normal));
+	glEnableVertexAttribArray(g_TextureCoordinateLocation);
+	glVertexAttribPointer(g_TextureCoordinateLocation, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(PrimitiveGeometry::VERTEX, textureCoordinate));
+
+	if (m_bIndirect)
+	{
+		// the instances are read from the storage buffer, and the
+		// draw commands from a buffer of their own
+		m_indirectCapacity = g_InitialCommands * sizeof(DRAW_COMMAND);
+		glGenBuffers(1, &m_indirectBufferID);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBufferID);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, m_indirectCapacity, NULL, GL_STREAM_DRAW);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+	else
+	{
+		// every per-instance attribute steps once per instance
+		glBindBuffer(GL_ARRAY_BUFFER, m_instanceBufferID);
+		for (GLuint location = g_ModelLocation; location <= g_FlagsLocation; location++)
+		{
+			glEnableVertexAttribArray(location);
+			glVertexAttribDivisor(location, 1);
+		}
+		SetInstanceAttributes(0);
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the arena, the instance
+ *  buffer and the indirect buffer.
+ ***********************************************************/
+void InstanceRenderer::Destroy()
+{
+	if (m_vertexArrayID != 0)
+	{
+		glDeleteVertexArrays(1, &m_vertexArrayID);
+		glDeleteBuffers(1, &m_vertexBufferID);
+		glDeleteBuffers(1, &m_indexBufferID);
+		m_vertexArrayID = 0;
+		m_vertexBufferID = 0;
+		m_indexBufferID = 0;
+	}
+	if (m_instanceBufferID != 0)
+	{
+		glDeleteBuffers(1, &m_instanceBufferID);
+		m_instanceBufferID = 0;
+	}
+	if (m_indirectBufferID != 0)
+	{
+		glDeleteBuffers(1, &m_indirectBufferID);
+		m_indirectBufferID = 0;
+	}
+	m_instanceCapacity = 0;
+	m_indirectCapacity = 0;
+	m_parts.clear();
+	m_arenaVertices.clear();
+	m_arenaIndices.clear();
+	m_primitiveVertexCount = 0;
+	m_primitiveIndexCount = 0;
+}
+
+/***********************************************************
+ *  UploadArena()
+ *
+ *  This method is used for uploading the vertices and
+ *  indices of the arena into its buffers, replacing what
+ *  they held.  The buffers keep their names, so the vertex
+ *  array needs no changes.
+ ***********************************************************/
+void InstanceRenderer::UploadArena()
+{
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferID);
+	glBufferData(GL_ARRAY_BUFFER, m_arenaVertices.size() * sizeof(PrimitiveGeometry::VERTEX), m_arenaVertices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBufferID);
+	glBufferData(GL_COPY_WRITE_BUFFER, m_arenaIndices.size() * sizeof(unsigned int), m_arenaIndices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  SetStaticMeshes()
+ *
+ *  This method is used for putting baked meshes at the end
+ *  of the arena, after the basic shapes, in place of any
+ *  baked meshes set before.  The meshes are drawn with
+ *  AddStatic() by their index in indexCounts.
+ ***********************************************************/
+void InstanceRenderer::SetStaticMeshes(const std::vector<PrimitiveGeometry::VERTEX>& vertices,
+	const std::vector<unsigned int>& indices, const std::vector<int>& indexCounts)
+{
+	if (m_vertexArrayID == 0)
+	{
+		return;
+	}
+
+	m_arenaVertices.resize(m_primitiveVertexCount);
+	m_arenaIndices.resize(m_primitiveIndexCount);
+	m_arenaVertices.insert(m_arenaVertices.end(), vertices.begin(), vertices.end());
+	m_arenaIndices.insert(m_arenaIndices.end(), indices.begin(), indices.end());
+
+	m_parts.resize(PrimitiveGeometry::PART_COUNT);
+	GLuint firstIndex = (GLuint)m_primitiveIndexCount;
+	for (size_t mesh = 0; mesh < indexCounts.size(); mesh++)
+	{
+		PART_DRAW part;
+		part.indexCount = (GLuint)indexCounts[mesh];
+		part.firstIndex = firstIndex;
+		part.baseVertex = (GLint)m_primitiveVertexCount;
+		m_parts.push_back(part);
+		firstIndex += part.indexCount;
+	}
+
+	UploadArena();
+}
+
+/***********************************************************
+ *  IsIndirect()
+ *
+ *  This method returns true when Create() chose to draw with
+ *  multi-draw indirect.
+ ***********************************************************/
+bool InstanceRenderer::IsIndirect() const
+{
+	return(m_bIndirect);
+}
+
+/***********************************************************
+ *  SetInstanceAttributes()
+ *
+ *  This method is used for pointing the per-instance
+ *  attributes of the bound vertex array at the instance
+ *  buffer, starting at an instance.  The instance buffer
+ *  must be bound to GL_ARRAY_BUFFER.
+ ***********************************************************/
+void InstanceRenderer::SetInstanceAttributes(size_t firstInstance)
+{
+	GLsizei stride = (GLsizei)sizeof(INSTANCE);
+	size_t base = firstInstance * sizeof(INSTANCE);
+
+	for (GLuint column = 0; column < 4; column++)
+	{
+		glVertexAttribPointer(g_ModelLocation + column, 4, GL_FLOAT, GL_FALSE, stride,
+			(void*)(base + offsetof(INSTANCE, model) + column * sizeof(glm::vec4)));
+	}
+	for (GLuint column = 0; column < 3; column++)
+	{
+		glVertexAttribPointer(g_NormalMatrixLocation + column, 3, GL_FLOAT, GL_FALSE, stride,
+			(void*)(base + offsetof(INSTANCE, normalMatrix) + column * sizeof(glm::vec4)));
+	}
+	glVertexAttribPointer(g_ColorLocation, 4, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(INSTANCE, color)));
+	glVertexAttribPointer(g_TextureRectLocation, 4, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(INSTANCE, textureRect)));
+	glVertexAttribPointer(g_SurfaceLocation, 3, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(INSTANCE, surface)));
+	glVertexAttribIPointer(g_FlagsLocation, 3, GL_INT, stride, (void*)(base + offsetof(INSTANCE, flags)));
+}
+
+/***********************************************************
+ *  UploadStream()
+ *
+ *  This method is used for refilling a buffer that is
+ *  written every frame.  The buffer is orphaned before it is
+ *  refilled, so the driver never waits for the last frame's
+ *  draws to finish, and grows when the data does not fit.
+ ***********************************************************/
+void InstanceRenderer::UploadStream(GLenum target, GLuint bufferID, size_t& capacity, const void* data, size_t bytes)
+{
+	glBindBuffer(target, bufferID);
+	if (bytes > capacity)
+	{
+		capacity = std::max(bytes, 2 * capacity);
+	}
+	glBufferData(target, capacity, NULL, GL_STREAM_DRAW);
+	glBufferSubData(target, 0, bytes, data);
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used for starting a new frame of draws
+ *  seen from a camera position.
+ ***********************************************************/
+void InstanceRenderer::Begin(const glm::vec3& viewPosition)
+{
+	m_viewPosition = viewPosition;
+	m_draws.clear();
+	m_instances.clear();
+	m_queue.Clear();
+}
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for adding a draw of a shape part.
+ *  Nothing is drawn until Flush().
+ ***********************************************************/
+void InstanceRenderer::Add(PrimitiveGeometry::PART part, bool bTransparent, const INSTANCE& instance)
+{
+	AddDraw(part, bTransparent, instance);
+}
+
+/***********************************************************
+ *  AddStatic()
+ *
+ *  This method is used for adding an opaque draw of a mesh
+ *  set by SetStaticMeshes().  Nothing is drawn until Flush().
+ ***********************************************************/
+void InstanceRenderer::AddStatic(int staticMesh, const INSTANCE& instance)
+{
+	int part = PrimitiveGeometry::PART_COUNT + staticMesh;
+	if ((staticMesh >= 0) && (part < (int)m_parts.size()))
+	{
+		AddDraw(part, false, instance);
+	}
+}
+
+/***********************************************************
+ *  AddDraw()
+ *
+ *  This method is used for adding a draw of the shape part
+ *  or baked mesh at an index of the part table, with its
+ *  sort key.
+ ***********************************************************/
+void InstanceRenderer::AddDraw(int part, bool bTransparent, const INSTANCE& instance)
+{
+	DRAW draw;
+	draw.part = part;
+	draw.bTransparent = bTransparent;
+	draw.instance = (int)m_instances.size();
+
+	m_draws.push_back(draw);
+	m_instances.push_back(instance);
+}
+
+/***********************************************************
+ *  MakeDrawKey()
+ *
+ *  This method returns the sort key of an added draw.  It
+ *  only reads the draw, so keys can be made on any thread.
+ ***********************************************************/
+uint64_t InstanceRenderer::MakeDrawKey(size_t draw) const
+{
+	const DRAW& added = m_draws[draw];
+	const INSTANCE& instance = m_instances[added.instance];
+
+	// the distance to the origin of the shape orders the draws
+	// within a group, and the transparent draws back to front
+	float depth = glm::length(glm::vec3(instance.model[3]) - m_viewPosition);
+	RenderQueue::PASS pass = added.bTransparent ? RenderQueue::PASS_TRANSPARENT : RenderQueue::PASS_OPAQUE;
+	int texture = (instance.flags.y != 0) ? instance.flags.z : -1;
+	// past 16383 parts and baked meshes the key's mesh bits are
+	// shared, which only splits runs, as runs are cut by part
+	return(RenderQueue::MakeKey(pass, added.part, texture, instance.flags.x, depth));
+}
+
+/***********************************************************
+ *  SetJobSystem()
+ *
+ *  This method is used for choosing the job system the
+ *  per-draw work of Flush() is split over.
+ ***********************************************************/
+void InstanceRenderer::SetJobSystem(JobSystem* pJobSystem)
+{
+	m_pJobSystem = pJobSystem;
+}
+
+/***********************************************************
+ *  RunRange()
+ *
+ *  This method is used for running per-draw work over the
+ *  draws 0 to count, in chunks on the job system's threads
+ *  or all at once on the calling thread.
+ ***********************************************************/
+void InstanceRenderer::RunRange(int count, const JobSystem::RANGE_JOB& job)
+{
+	if (NULL != m_pJobSystem)
+	{
+		m_pJobSystem->ParallelFor(count, g_DrawsPerJob, job);
+	}
+	else
+	{
+		job(0, count);
+	}
+}
+
+/***********************************************************
+ *  Flush()
+ *
+ *  This method is used for drawing every draw added since
+ *  Begin().  The sort keys are made and the render queue
+ *  puts the draws in drawing order, their instance values
+ *  are gathered in that order and uploaded in one go, the
+ *  keys and the gather split over the job system's threads
+ *  when there is one, and each run of draws of the same shape part
+ *  becomes one instanced draw command.  The texture array
+ *  and material are read per instance, so they do not split
+ *  a run.  The commands are then drawn with one multi-draw
+ *  indirect call, or one call each.
+ ***********************************************************/
+void InstanceRenderer::Flush()
+{
+	m_instanceCount = (unsigned int)m_draws.size();
+	m_drawCalls = 0;
+	m_commands.clear();
+	if (m_draws.empty() || (m_vertexArrayID == 0))
+	{
+		return;
+	}
+
+	// every draw writes only its own queue entry and its own
+	// sorted instance, so the chunks need no locking
+	int drawCount = (int)m_draws.size();
+	m_queue.Resize(m_draws.size());
+	RunRange(drawCount, [this](int first, int last)
+	{
+		for (int i = first; i < last; i++)
+		{
+			m_queue.Set(i, MakeDrawKey(i), (unsigned int)i);
+		}
+	});
+	m_queue.Sort();
+
+	m_sorted.resize(m_draws.size());
+	RunRange(drawCount, [this](int first, int last)
+	{
+		for (int i = first; i < last; i++)
+		{
+			m_sorted[i] = m_instances[m_draws[m_queue.GetItem(i)].instance];
+		}
+	});
+
+	size_t first = 0;
+	while (first < m_draws.size())
+	{
+		int part = m_draws[m_queue.GetItem(first)].part;
+		size_t end = first + 1;
+		while ((end < m_draws.size()) && (m_draws[m_queue.GetItem(end)].part == part))
+		{
+			end++;
+		}
+
+		DRAW_COMMAND command;
+		command.count = m_parts[part].indexCount;
+		command.instanceCount = (GLuint)(end - first);
+		command.firstIndex = m_parts[part].firstIndex;
+		command.baseVertex = m_parts[part].baseVertex;
+		command.baseInstance = (GLuint)first;
+		m_commands.push_back(command);
+
+		first = end;
+	}
+
+	UploadStream(GL_ARRAY_BUFFER, m_instanceBufferID, m_instanceCapacity, m_sorted.data(), m_sorted.size() * sizeof(INSTANCE));
+	glBindVertexArray(m_vertexArrayID);
+
+	if (m_bIndirect)
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, g_InstanceBinding, m_instanceBufferID);
+		UploadStream(GL_DRAW_INDIRECT_BUFFER, m_indirectBufferID, m_indirectCapacity, m_commands.data(), m_commands.size() * sizeof(DRAW_COMMAND));
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, (GLsizei)m_commands.size(), 0);
+		m_drawCalls++;
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+	else
+	{
+		// without base instances the attributes are pointed at
+		// the first instance of every command
+		for (size_t i = 0; i < m_commands.size(); i++)
+		{
+			const DRAW_COMMAND& command = m_commands[i];
+			SetInstanceAttributes(command.baseInstance);
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)command.count, GL_UNSIGNED_INT,
+				(void*)(command.firstIndex * sizeof(unsigned int)), (GLsizei)command.instanceCount, command.baseVertex);
+			m_drawCalls++;
+		}
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  GetInstanceCount()
+ *
+ *  This method returns the draws added before the last
+ *  Flush().
+ ***********************************************************/
+unsigned int InstanceRenderer::GetInstanceCount() const
+{
+	return(m_instanceCount);
+}
+
+/***********************************************************
+ *  GetCommandCount()
+ *
+ *  This method returns the draw commands the draws of the
+ *  last Flush() were grouped into.
+ ***********************************************************/
+unsigned int InstanceRenderer::GetCommandCount() const
+{
+	return((unsigned int)m_commands.size());
+}
+
+/***********************************************************
+ *  GetDrawCallCount()
+ *
+ *  This method returns the draw calls the last Flush()
+ *  issued.
+ ***********************************************************/
+unsigned int InstanceRenderer::GetDrawCallCount() const
+{
+	return(m_drawCalls);
+}
+
+/***********************************************************
+ *  GetRenderQueue()
+ *
+ *  This method returns the queue the last Flush() sorted,
+ *  with its counts of the state changes sorting removed.
+ ***********************************************************/
+const RenderQueue& InstanceRenderer::GetRenderQueue() const
+{
+	return(m_queue);
+}
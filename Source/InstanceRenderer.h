@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancerenderer.h
+// ============
+// draw every basic shape of the scene from one geometry arena, with one
+// multi-draw indirect call where the driver supports it
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "JobSystem.h"
+#include "PrimitiveGeometry.h"
+#include "RenderQueue.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  InstanceRenderer
+ *
+ *  This class collects the draws of a frame and draws them
+ *  all at the end of it.  The vertices and indices of every
+ *  mesh are suballocated from one shared vertex and index
+ *  buffer, the arena, drawn through a single vertex array,
+ *  so moving from one shape to another binds nothing.
+ *
+ *  What used to be set in uniforms before each draw, the
+ *  model matrix, color, texture array and layer, UV scale
+ *  and material, is written to a per-instance buffer.  The
+ *  draws of the same shape part that follow each other in
+ *  drawing order are one instanced draw command.
+ *
+ *  Meshes baked from the static draws of the scene can be
+ *  added to the end of the arena, replacing the ones added
+ *  before, and are drawn like any other shape part.
+ *
+ *  On OpenGL 4.3 with ARB_shader_draw_parameters the
+ *  commands go out as one glMultiDrawElementsIndirect call,
+ *  and vertexShaderIndirect.glsl reads each instance from
+ *  the buffer bound as a shader storage buffer.  Otherwise,
+ *  as on OpenGL 3.3 and macOS, every command is its own
+ *  glDrawElementsInstancedBaseVertex call, and
+ *  vertexShader.glsl reads the instances as vertex
+ *  attributes with a divisor of one.
+ *
+ *  The draws are put in order by a RenderQueue.  Opaque
+ *  draws are grouped whatever order they were added in.
+ *  Transparent draws are drawn after every opaque one, back
+ *  to front.  With a job system, the sort keys and the
+ *  instance values in drawing order are built in chunks on
+ *  its worker threads, and the GL calls are only made once
+ *  every chunk is done.
+ ***********************************************************/
+class InstanceRenderer
+{
+public:
+	// constructor
+	InstanceRenderer();
+	// destructor
+	~InstanceRenderer();
+
+	// the values of one draw, laid out the way the vertex
+	// shaders read them
+	struct INSTANCE
+	{
+		glm::mat4 model;
+		// columns of the normal matrix, w unused
+		glm::vec4 normalMatrix[3];
+		glm::vec4 color;
+		// scale (xy) and offset (zw) of the image in its layer
+		glm::vec4 textureRect;
+		// UV scale (xy) and texture layer (z), w unused
+		glm::vec4 surface;
+		// material index (x), whether the texture is used (y) and
+		// the texture array, which is also its unit (z)
+		glm::ivec4 flags;
+	};
+
+	// true when the context can draw with one multi-draw
+	// indirect call and the shader of vertexShaderIndirect.glsl
+	static bool IsIndirectSupported();
+
+	// upload the meshes into the arena and create the instance
+	// buffer - bIndirect chooses multi-draw indirect, which the
+	// loaded vertex shader must match, and is ignored when it
+	// is not supported
+	bool Create(const PrimitiveGeometry& geometry, bool bIndirect);
+	// free the arena and the instance buffer
+	void Destroy();
+	// true when the draws go out with multi-draw indirect
+	bool IsIndirect() const;
+	// split the per-draw work of Flush() over a job system's
+	// threads, or NULL to do it on the calling thread
+	void SetJobSystem(JobSystem* pJobSystem);
+
+	// start collecting the draws of a frame seen from a camera
+	// position
+	void Begin(const glm::vec3& viewPosition);
+	// add a draw of a shape part
+	void Add(PrimitiveGeometry::PART part, bool bTransparent, const INSTANCE& instance);
+
+	// put baked meshes at the end of the arena, in place of the
+	// ones set before - each mesh is the next indexCounts[i]
+	// indices, which index the passed in vertices
+	void SetStaticMeshes(const std::vector<PrimitiveGeometry::VERTEX>& vertices,
+		const std::vector<unsigned int>& indices, const std::vector<int>& indexCounts);
+	// add an opaque draw of a baked mesh
+	void AddStatic(int staticMesh, const INSTANCE& instance);
+	// draw everything added since Begin()
+	void Flush();
+
+	// draws added, the draw commands they were grouped into and
+	// the draw calls issued by the last Flush()
+	unsigned int GetInstanceCount() const;
+	unsigned int GetCommandCount() const;
+	unsigned int GetDrawCallCount() const;
+	// the queue the last Flush() sorted the draws with
+	const RenderQueue& GetRenderQueue() const;
+
+private:
+	// one draw command, laid out the way
+	// glMultiDrawElementsIndirect reads it
+	struct DRAW_COMMAND
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// where a part lies in the arena
+	struct PART_DRAW
+	{
+		GLuint indexCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+	};
+
+	// one added draw, pointing at its instance values
+	struct DRAW
+	{
+		int part;
+		bool bTransparent;
+		int instance;
+	};
+
+	// the arena every mesh is suballocated from
+	GLuint m_vertexArrayID;
+	GLuint m_vertexBufferID;
+	GLuint m_indexBufferID;
+	// the shape parts, followed by the baked meshes
+	std::vector<PART_DRAW> m_parts;
+	// the arena's contents, the basic shapes followed by the
+	// baked meshes, kept to upload it again when they change
+	std::vector<PrimitiveGeometry::VERTEX> m_arenaVertices;
+	std::vector<unsigned int> m_arenaIndices;
+	size_t m_primitiveVertexCount;
+	size_t m_primitiveIndexCount;
+
+	GLuint m_instanceBufferID;
+	// bytes the instance buffer holds
+	size_t m_instanceCapacity;
+	GLuint m_indirectBufferID;
+	// bytes the indirect buffer holds
+	size_t m_indirectCapacity;
+	bool m_bIndirect;
+
+	// draws of the frame and their instance values, kept to
+	// reuse their memory
+	std::vector<DRAW> m_draws;
+	std::vector<INSTANCE> m_instances;
+	// the instance values in the order they are drawn
+	std::vector<INSTANCE> m_sorted;
+	// the draw commands of the frame
+	std::vector<DRAW_COMMAND> m_commands;
+	// the sort keys of the draws
+	RenderQueue m_queue;
+	// camera position of the frame the draws are sorted for
+	glm::vec3 m_viewPosition;
+
+	unsigned int m_instanceCount;
+	unsigned int m_drawCalls;
+	// not owned, may be NULL
+	JobSystem* m_pJobSystem;
+
+	// add a draw of the shape part or baked mesh at an index
+	// of m_parts
+	void AddDraw(int part, bool bTransparent, const INSTANCE& instance);
+	// upload the arena's contents into its buffers
+	void UploadArena();
+	// the sort key of an added draw
+	uint64_t MakeDrawKey(size_t draw) const;
+	// run per-draw work over a range of draws, on the job
+	// system when there is one
+	void RunRange(int count, const JobSystem::RANGE_JOB& job);
+	// point the per-instance attributes of the arena's vertex
+	// array at the instances from firstInstance on
+	void SetInstanceAttributes(size_t firstInstance);
+	// upload data into a stream buffer, growing it if needed
+	static void UploadStream(GLenum target, GLuint bufferID, size_t& capacity, const void* data, size_t bytes);
+};
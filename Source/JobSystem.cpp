@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.cpp
+// ============
+// split per-frame work over worker threads that steal from each other
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+
+/***********************************************************
+ *  JobSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+JobSystem::JobSystem(int workerCount)
+{
+	m_generation = 0;
+	m_bShutdown = false;
+	m_pJob = NULL;
+	m_pendingChunks = 0;
+	m_jobCount = 0;
+	m_stolenCount = 0;
+
+	if (workerCount < 0)
+	{
+		workerCount = 0;
+	}
+
+	// the calling thread has the first queue
+	for (int thread = 0; thread <= workerCount; thread++)
+	{
+		m_queues.push_back(new QUEUE());
+	}
+	for (int thread = 1; thread <= workerCount; thread++)
+	{
+		m_workers.push_back(std::thread(&JobSystem::WorkerLoop, this, thread));
+	}
+}
+
+/***********************************************************
+ *  ~JobSystem()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bShutdown = true;
+	}
+	m_wakeSignal.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	for (size_t i = 0; i < m_queues.size(); i++)
+	{
+		delete m_queues[i];
+	}
+	m_queues.clear();
+}
+
+/***********************************************************
+ *  GetThreadCount()
+ *
+ *  This method returns the number of threads a range is run
+ *  on, the workers and the calling thread.
+ ***********************************************************/
+int JobSystem::GetThreadCount() const
+{
+	return((int)m_queues.size());
+}
+
+/***********************************************************
+ *  ParallelFor()
+ *
+ *  This method is used for running a job over the range 0
+ *  to count.  The range is cut into chunks of chunkSize that
+ *  are dealt out to the threads in turn, so neighbouring
+ *  chunks start on different threads.  The calling thread
+ *  works on the chunks too, then waits for the ones still
+ *  running on the workers.  A range of one chunk runs on the
+ *  calling thread without waking anyone.
+ ***********************************************************/
+void JobSystem::ParallelFor(int count, int chunkSize, const RANGE_JOB& job)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+	if (chunkSize < 1)
+	{
+		chunkSize = 1;
+	}
+
+	int chunkCount = (count + chunkSize - 1) / chunkSize;
+	if ((chunkCount == 1) || m_workers.empty())
+	{
+		job(0, count);
+		m_jobCount++;
+		return;
+	}
+
+	m_pJob = &job;
+	m_pendingChunks = chunkCount;
+	int threadCount = (int)m_queues.size();
+	for (int chunk = 0; chunk < chunkCount; chunk++)
+	{
+		CHUNK range;
+		range.first = chunk * chunkSize;
+		range.last = (range.first + chunkSize < count) ? range.first + chunkSize : count;
+
+		QUEUE* pQueue = m_queues[chunk % threadCount];
+		std::lock_guard<std::mutex> lock(pQueue->mutex);
+		pQueue->chunks.push_back(range);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_generation++;
+	}
+	m_wakeSignal.notify_all();
+
+	while (RunChunk(0))
+	{
+	}
+
+	// the last chunks may still be running on the workers
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneSignal.wait(lock, [this] { return m_pendingChunks == 0; });
+	m_pJob = NULL;
+}
+
+/***********************************************************
+ *  RunChunk()
+ *
+ *  This method is used for running one chunk on a thread.
+ *  The thread takes the newest chunk of its own queue, which
+ *  is the one most likely to still be in its cache, or else
+ *  the oldest chunk of the next thread's queue that has one.
+ *  It returns false when every queue is empty.
+ ***********************************************************/
+bool JobSystem::RunChunk(int thread)
+{
+	CHUNK range;
+	bool bFound = false;
+	int threadCount = (int)m_queues.size();
+
+	{
+		QUEUE* pQueue = m_queues[thread];
+		std::lock_guard<std::mutex> lock(pQueue->mutex);
+		if (!pQueue->chunks.empty())
+		{
+			range = pQueue->chunks.back();
+			pQueue->chunks.pop_back();
+			bFound = true;
+		}
+	}
+
+	for (int i = 1; (i < threadCount) && !bFound; i++)
+	{
+		QUEUE* pQueue = m_queues[(thread + i) % threadCount];
+		std::lock_guard<std::mutex> lock(pQueue->mutex);
+		if (!pQueue->chunks.empty())
+		{
+			range = pQueue->chunks.front();
+			pQueue->chunks.pop_front();
+			bFound = true;
+			m_stolenCount++;
+		}
+	}
+
+	if (!bFound)
+	{
+		return(false);
+	}
+
+	(*m_pJob)(range.first, range.last);
+	m_jobCount++;
+
+	if (--m_pendingChunks == 0)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_doneSignal.notify_all();
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method runs on every worker thread, sleeping until
+ *  a new range is started and then running chunks until
+ *  none are left, until the system is shut down.
+ ***********************************************************/
+void JobSystem::WorkerLoop(int thread)
+{
+	unsigned int generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeSignal.wait(lock, [this, generation] { return m_bShutdown || (m_generation != generation); });
+			if (m_bShutdown)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		while (RunChunk(thread))
+		{
+		}
+	}
+}
+
+/***********************************************************
+ *  GetJobCount()
+ *
+ *  This method returns the number of chunks run.
+ ***********************************************************/
+unsigned long long JobSystem::GetJobCount() const
+{
+	return(m_jobCount);
+}
+
+/***********************************************************
+ *  GetStolenCount()
+ *
+ *  This method returns the number of chunks a thread took
+ *  from another thread's queue.
+ ***********************************************************/
+unsigned long long JobSystem::GetStolenCount() const
+{
+	return(m_stolenCount);
+}
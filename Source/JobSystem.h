@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.h
+// ============
+// split per-frame work over worker threads that steal from each other
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  JobSystem
+ *
+ *  This class runs a range of work, such as every draw of a
+ *  frame, on a pool of worker threads and the calling
+ *  thread.  The range is cut into chunks that are dealt out
+ *  to one queue per thread.  Each thread runs the newest
+ *  chunk of its own queue, and when it runs out it steals
+ *  the oldest chunk of another thread's queue, so threads
+ *  slowed by bigger chunks or by the OS are helped by the
+ *  others instead of holding up the frame.
+ *
+ *  ParallelFor() returns once every chunk has run, so the
+ *  calling thread, the GL thread, only ever sees finished
+ *  results.  It is meant to be called from one thread at a
+ *  time, and not from inside a job.
+ ***********************************************************/
+class JobSystem
+{
+public:
+	// one chunk of a range, from first up to but not including
+	// last
+	typedef std::function<void(int first, int last)> RANGE_JOB;
+
+	// constructor - the number of worker threads besides the
+	// calling thread, which can be 0
+	explicit JobSystem(int workerCount);
+	// destructor
+	~JobSystem();
+
+	// worker threads plus the calling thread
+	int GetThreadCount() const;
+
+	// run job over the range 0 to count in chunks of chunkSize
+	// and wait for all of them
+	void ParallelFor(int count, int chunkSize, const RANGE_JOB& job);
+
+	// chunks run, and the chunks that were stolen from another
+	// thread's queue, since the system was created
+	unsigned long long GetJobCount() const;
+	unsigned long long GetStolenCount() const;
+
+private:
+	struct CHUNK
+	{
+		int first;
+		int last;
+	};
+
+	// the chunks dealt to one thread, the calling thread's is
+	// the first
+	struct QUEUE
+	{
+		std::mutex mutex;
+		std::deque<CHUNK> chunks;
+	};
+
+	std::vector<QUEUE*> m_queues;
+	std::vector<std::thread> m_workers;
+
+	// wakes the workers for a new range, and the calling
+	// thread when the last chunk is done
+	std::mutex m_mutex;
+	std::condition_variable m_wakeSignal;
+	std::condition_variable m_doneSignal;
+	unsigned int m_generation;
+	bool m_bShutdown;
+
+	// the job of the range being run and its chunks not done yet
+	const RANGE_JOB* m_pJob;
+	std::atomic<int> m_pendingChunks;
+
+	std::atomic<unsigned long long> m_jobCount;
+	std::atomic<unsigned long long> m_stolenCount;
+
+	// run the loop of one worker thread
+	void WorkerLoop(int thread);
+	// run one chunk from the thread's own queue or a stolen one,
+	// returning false when every queue is empty
+	bool RunChunk(int thread);
+};
@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+// materialbuffer.cpp
+// ============
+// hold every object material in one std140 uniform buffer
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MaterialBuffer.h"
+
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// name of the uniform block in the fragment shader
+	const char* g_MaterialBlockName = "MaterialBlock";
+	// uniform buffer binding point the block reads from
+	const GLuint g_MaterialBinding = 0;
+
+	static_assert(sizeof(MaterialBuffer::MATERIAL) == 48, "MATERIAL must match the std140 layout of the shader's Material");
+}
+
+/***********************************************************
+ *  MaterialBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MaterialBuffer::MaterialBuffer()
+{
+	m_bufferID = 0;
+	m_count = 0;
+	m_capacity = 0;
+}
+
+/***********************************************************
+ *  ~MaterialBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MaterialBuffer::~MaterialBuffer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for creating the uniform buffer with
+ *  the size of the program's material block, copying the
+ *  materials into it, and binding it to the block.  Space
+ *  past the last material is left zeroed.
+ ***********************************************************/
+bool MaterialBuffer::Upload(GLuint programID, const std::vector<MATERIAL>& materials)
+{
+	Destroy();
+
+	GLuint blockIndex = glGetUniformBlockIndex(programID, g_MaterialBlockName);
+	if (blockIndex == GL_INVALID_INDEX)
+	{
+		std::cout << "ERROR: The shader has no " << g_MaterialBlockName << " uniform block" << std::endl;
+		return(false);
+	}
+
+	GLint blockSize = 0;
+	glGetActiveUniformBlockiv(programID, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize);
+	m_capacity = blockSize / (int)sizeof(MATERIAL);
+	if ((int)materials.size() > m_capacity)
+	{
+		std::cout << "ERROR: " << materials.size() << " materials do not fit in the " << m_capacity << " the shader's material block holds" << std::endl;
+		return(false);
+	}
+
+	std::vector<MATERIAL> data(m_capacity);
+	for (size_t i = 0; i < materials.size(); i++)
+	{
+		data[i] = materials[i];
+	}
+
+	glUniformBlockBinding(programID, blockIndex, g_MaterialBinding);
+	glGenBuffers(1, &m_bufferID);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferData(GL_UNIFORM_BUFFER, blockSize, data.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, g_MaterialBinding, m_bufferID);
+	m_count = (int)materials.size();
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the uniform buffer.
+ ***********************************************************/
+void MaterialBuffer::Destroy()
+{
+	if (m_bufferID != 0)
+	{
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+	m_count = 0;
+	m_capacity = 0;
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method returns the number of materials uploaded.
+ ***********************************************************/
+int MaterialBuffer::GetCount() const
+{
+	return(m_count);
+}
+
+/***********************************************************
+ *  GetCapacity()
+ *
+ *  This method returns the number of materials the shader's
+ *  material block can hold.
+ ***********************************************************/
+int MaterialBuffer::GetCapacity() const
+{
+	return(m_capacity);
+}
@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+// materialbuffer.h
+// ============
+// hold every object material in one std140 uniform buffer
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  MaterialBuffer
+ *
+ *  This class uploads the whole material library once into
+ *  a uniform buffer bound to the MaterialBlock uniform block
+ *  of the fragment shader.  A draw then picks its material
+ *  by setting one integer, the material's index, so the
+ *  cost of changing material does not grow with the size of
+ *  the library.  The number of materials the block can hold
+ *  is set by MAX_MATERIALS in the fragment shader.
+ ***********************************************************/
+class MaterialBuffer
+{
+public:
+	// constructor
+	MaterialBuffer();
+	// destructor
+	~MaterialBuffer();
+
+	// one material laid out the way std140 lays out the Material
+	// struct of the fragment shader
+	struct MATERIAL
+	{
+		glm::vec3 ambientColor;
+		float ambientStrength;
+		glm::vec3 diffuseColor;
+		float shininess;
+		glm::vec3 specularColor;
+		float padding;
+	};
+
+	// upload the materials into the block of a linked program,
+	// the index of a material is its position in the vector
+	bool Upload(GLuint programID, const std::vector<MATERIAL>& materials);
+	// free the uniform buffer
+	void Destroy();
+
+	// number of materials uploaded
+	int GetCount() const;
+	// number of materials the uniform block can hold
+	int GetCapacity() const;
+
+private:
+	GLuint m_bufferID;
+	int m_count;
+	int m_capacity;
+};
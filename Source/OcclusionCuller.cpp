@@ -0,0 +1,765 @@
+///////////////////////////////////////////////////////////////////////////////
+// occlusionculler.cpp
+// ============
+// reject draws hidden behind the biggest solid shapes with a small depth
+// buffer rasterized on the CPU
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define OCCLUSION_SSE
+#include <xmmintrin.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// size of the depth buffer, a quarter of the window's 1000
+	// by 800 on each side - the width is a multiple of four so
+	// a row is read four pixels at a time
+	const int g_BufferWidth = 256;
+	const int g_BufferHeight = 200;
+	// pixels on each side of a tile of the second level
+	const int g_TileSize = 8;
+	const int g_TileColumns = g_BufferWidth / g_TileSize;
+	const int g_TileRows = g_BufferHeight / g_TileSize;
+
+	// the most occluders drawn in a frame, and the smallest
+	// size, radius over distance, worth drawing
+	const int g_MaxOccluders = 64;
+	const float g_MinOccluderSize = 0.05f;
+	// default milliseconds a frame may take
+	const double g_DefaultBudget = 1.0;
+	// bounds tested in one job
+	const int g_BoundsPerJob = 64;
+	// how much nearer than a draw an occluder has to be to hide
+	// it, so a shape facing the camera never hides itself
+	const float g_DepthBias = 1.0e-5f;
+
+	/***********************************************************
+	 *  ToBuffer()
+	 *
+	 *  Return the buffer position of a clip space point in x
+	 *  and y, and its depth, z over w, in z.
+	 ***********************************************************/
+	glm::vec3 ToBuffer(const glm::vec4& clip)
+	{
+		float inverseW = 1.0f / clip.w;
+		return(glm::vec3((clip.x * inverseW * 0.5f + 0.5f) * (float)g_BufferWidth,
+			(clip.y * inverseW * 0.5f + 0.5f) * (float)g_BufferHeight, clip.z * inverseW));
+	}
+
+	/***********************************************************
+	 *  Evaluate()
+	 *
+	 *  Return ax + by + c of a function over the buffer.
+	 ***********************************************************/
+	float Evaluate(const glm::vec3& function, float x, float y)
+	{
+		return(function.x * x + function.y * y + function.z);
+	}
+}
+
+/***********************************************************
+ *  OcclusionCuller()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+OcclusionCuller::OcclusionCuller(const PrimitiveGeometry* pGeometry)
+{
+	m_pGeometry = pGeometry;
+	m_pJobSystem = NULL;
+	m_viewProjection = glm::mat4(1.0f);
+	m_viewPosition = glm::vec3(0.0f);
+	m_depth.assign(g_BufferWidth * g_BufferHeight, FLT_MAX);
+	m_tileDepth.assign(g_TileColumns * g_TileRows, FLT_MAX);
+	m_budget = std::chrono::microseconds((long long)(g_DefaultBudget * 1000.0));
+	m_start = std::chrono::steady_clock::now();
+	m_deadline = m_start + m_budget;
+	m_bOutOfTime = false;
+	m_occluderLimit = g_MaxOccluders;
+	m_offeredCount = 0;
+	m_occluderCount = 0;
+	m_triangleCount = 0;
+	m_milliseconds = 0.0;
+	m_renderMilliseconds = 0.0;
+	m_overBudgetCount = 0;
+}
+
+/***********************************************************
+ *  SetJobSystem()
+ *
+ *  This method is used for choosing the job system the
+ *  rasterizing and testing are split over.
+ ***********************************************************/
+void OcclusionCuller::SetJobSystem(JobSystem* pJobSystem)
+{
+	m_pJobSystem = pJobSystem;
+}
+
+/***********************************************************
+ *  SetTimeBudget()
+ *
+ *  This method is used for setting the milliseconds the
+ *  occlusion culling of a frame may take, from Begin() to
+ *  the end of TestBounds().
+ ***********************************************************/
+void OcclusionCuller::SetTimeBudget(double milliseconds)
+{
+	m_budget = std::chrono::microseconds((long long)(milliseconds * 1000.0));
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used for starting a frame.  The number of
+ *  occluders the frame may draw is lowered when drawing the
+ *  last frame's took more than half of the budget, leaving
+ *  the rest for testing, and raised when it took less than
+ *  a quarter.
+ ***********************************************************/
+void OcclusionCuller::Begin(const glm::mat4& viewProjection, const glm::vec3& viewPosition)
+{
+	double budget = (double)m_budget.count() / 1000.0;
+	if (m_renderMilliseconds > budget * 0.5)
+	{
+		m_occluderLimit = std::max(1, m_occluderLimit * 3 / 4);
+	}
+	else if ((m_renderMilliseconds < budget * 0.25) && (m_occluderCount >= m_occluderLimit))
+	{
+		m_occluderLimit = std::min(g_MaxOccluders, m_occluderLimit + m_occluderLimit / 4 + 1);
+	}
+
+	m_viewProjection = viewProjection;
+	m_viewPosition = viewPosition;
+	m_occluders.clear();
+	m_offeredCount = 0;
+	m_occluderCount = 0;
+	m_triangleCount = 0;
+	m_milliseconds = 0.0;
+	m_renderMilliseconds = 0.0;
+	m_bOutOfTime = false;
+	m_start = std::chrono::steady_clock::now();
+	m_deadline = m_start + m_budget;
+}
+
+/***********************************************************
+ *  AddOccluder()
+ *
+ *  This method is used for offering a draw as an occluder.
+ *  It has to be solid, hiding everything behind it, and it
+ *  is only drawn when it is among the biggest.
+ ***********************************************************/
+void OcclusionCuller::AddOccluder(PrimitiveGeometry::PART part, const glm::mat4& model, const PrimitiveGeometry::BOUNDS& bounds, int id)
+{
+	m_offeredCount++;
+
+	// how big the draw looks, from its sphere
+	float distance = glm::length(bounds.center - m_viewPosition);
+	float size = (distance > bounds.radius) ? bounds.radius / distance : 1.0f;
+	if (size < g_MinOccluderSize)
+	{
+		return;
+	}
+
+	OCCLUDER occluder;
+	occluder.part = part;
+	occluder.model = model;
+	occluder.size = size;
+	occluder.id = id;
+	m_occluders.push_back(occluder);
+}
+
+/***********************************************************
+ *  RenderOccluders()
+ *
+ *  This method is used for drawing the biggest occluders
+ *  into the depth buffer.  Their triangles are set up in
+ *  parallel, one occluder per job, then every row of tiles
+ *  is rasterized by one job, so no two threads write the
+ *  same pixels.
+ ***********************************************************/
+void OcclusionCuller::RenderOccluders()
+{
+	std::sort(m_occluders.begin(), m_occluders.end(), [](const OCCLUDER& first, const OCCLUDER& second)
+	{
+		return(first.size > second.size);
+	});
+	if ((int)m_occluders.size() > m_occluderLimit)
+	{
+		m_occluders.resize(m_occluderLimit);
+	}
+	m_occluderCount = (int)m_occluders.size();
+	if (m_occluderCount == 0)
+	{
+		return;
+	}
+
+	// every triangle can become two when it is clipped
+	m_firstTriangles.resize(m_occluderCount);
+	m_triangleCounts.resize(m_occluderCount);
+	int capacity = 0;
+	for (int occluder = 0; occluder < m_occluderCount; occluder++)
+	{
+		m_firstTriangles[occluder] = capacity;
+		capacity += (m_pGeometry->GetPart(m_occluders[occluder].part).indexCount / 3) * 2;
+	}
+	m_triangles.resize(capacity);
+
+	RunRange(m_occluderCount, 1, [this](int first, int last)
+	{
+		for (int occluder = first; occluder < last; occluder++)
+		{
+			m_triangleCounts[occluder] = SetupTriangles(m_occluders[occluder], &m_triangles[m_firstTriangles[occluder]]);
+		}
+	});
+	m_triangleCount = 0;
+	for (int occluder = 0; occluder < m_occluderCount; occluder++)
+	{
+		m_triangleCount += m_triangleCounts[occluder];
+	}
+
+	RunRange(g_TileRows, 1, [this](int first, int last)
+	{
+		for (int tileRow = first; tileRow < last; tileRow++)
+		{
+			RasterizeTileRow(tileRow);
+		}
+	});
+
+	m_renderMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+	m_milliseconds = m_renderMilliseconds;
+}
+
+/***********************************************************
+ *  SetupTriangles()
+ *
+ *  This method is used for taking an occluder's triangles
+ *  into the buffer.  They are clipped to the near plane,
+ *  which leaves three or four corners, and each one left is
+ *  turned into edge functions that are positive inside it
+ *  and a depth function, all linear over the buffer.
+ ***********************************************************/
+int OcclusionCuller::SetupTriangles(const OCCLUDER& occluder, TRIANGLE* pTriangles) const
+{
+	const PrimitiveGeometry::PART_RANGE& range = m_pGeometry->GetPart(occluder.part);
+	const std::vector<PrimitiveGeometry::VERTEX>& vertices = m_pGeometry->GetVertices(range.mesh);
+	const std::vector<unsigned int>& indices = m_pGeometry->GetIndices(range.mesh);
+	glm::mat4 transform = m_viewProjection * occluder.model;
+
+	int count = 0;
+	for (int index = 0; index + 2 < range.indexCount; index += 3)
+	{
+		glm::vec4 clip[3];
+		for (int corner = 0; corner < 3; corner++)
+		{
+			clip[corner] = transform * glm::vec4(vertices[indices[range.firstIndex + index + corner]].position, 1.0f);
+		}
+
+		// a point is in front of the near plane when z + w >= 0
+		glm::vec4 polygon[4];
+		int corners = 0;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			const glm::vec4& start = clip[corner];
+			const glm::vec4& end = clip[(corner + 1) % 3];
+			float startDistance = start.z + start.w;
+			float endDistance = end.z + end.w;
+			if (startDistance >= 0.0f)
+			{
+				polygon[corners++] = start;
+			}
+			if ((startDistance >= 0.0f) != (endDistance >= 0.0f))
+			{
+				polygon[corners++] = start + (end - start) * (startDistance / (startDistance - endDistance));
+			}
+		}
+
+		glm::vec3 points[4];
+		bool bProjected = (corners >= 3);
+		for (int corner = 0; (corner < corners) && bProjected; corner++)
+		{
+			bProjected = (polygon[corner].w > 0.0f);
+			points[corner] = bProjected ? ToBuffer(polygon[corner]) : glm::vec3(0.0f);
+		}
+		if (!bProjected)
+		{
+			continue;
+		}
+
+		for (int corner = 1; corner + 1 < corners; corner++)
+		{
+			const glm::vec3& a = points[0];
+			const glm::vec3& b = points[corner];
+			const glm::vec3& c = points[corner + 1];
+			float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+			if (std::fabs(area) < 1.0e-6f)
+			{
+				continue;
+			}
+
+			// each edge function is the area of the triangle the
+			// point makes with the edge, and is the whole area at
+			// the corner across from it
+			TRIANGLE& triangle = pTriangles[count];
+			float sign = (area > 0.0f) ? 1.0f : -1.0f;
+			triangle.edges[0] = sign * glm::vec3(b.y - c.y, c.x - b.x, b.x * c.y - b.y * c.x);
+			triangle.edges[1] = sign * glm::vec3(c.y - a.y, a.x - c.x, c.x * a.y - c.y * a.x);
+			triangle.edges[2] = sign * glm::vec3(a.y - b.y, b.x - a.x, a.x * b.y - a.y * b.x);
+			triangle.depth = (triangle.edges[0] * a.z + triangle.edges[1] * b.z + triangle.edges[2] * c.z) / std::fabs(area);
+
+			// the pixels whose centers may be inside, starting on a
+			// multiple of four
+			float minimumX = std::min(a.x, std::min(b.x, c.x));
+			float maximumX = std::max(a.x, std::max(b.x, c.x));
+			float minimumY = std::min(a.y, std::min(b.y, c.y));
+			float maximumY = std::max(a.y, std::max(b.y, c.y));
+			triangle.minimumX = std::max(0, (int)std::ceil(minimumX - 0.5f)) & ~3;
+			triangle.maximumX = std::min(g_BufferWidth - 1, (int)std::floor(maximumX - 0.5f));
+			triangle.minimumY = std::max(0, (int)std::ceil(minimumY - 0.5f));
+			triangle.maximumY = std::min(g_BufferHeight - 1, (int)std::floor(maximumY - 0.5f));
+			if ((triangle.minimumX <= triangle.maximumX) && (triangle.minimumY <= triangle.maximumY))
+			{
+				count++;
+			}
+		}
+	}
+	return(count);
+}
+
+/***********************************************************
+ *  RasterizeTileRow()
+ *
+ *  This method is used for drawing every occluder into one
+ *  row of tiles, keeping the nearest depth of each pixel,
+ *  then finding the farthest depth of each of its tiles.
+ *  The occluders are drawn biggest first, and the row stops
+ *  drawing when the frame is out of time, which leaves its
+ *  pixels farther than they could be but never nearer.
+ ***********************************************************/
+void OcclusionCuller::RasterizeTileRow(int tileRow)
+{
+	int firstY = tileRow * g_TileSize;
+	int lastY = firstY + g_TileSize - 1;
+	std::fill(m_depth.begin() + firstY * g_BufferWidth, m_depth.begin() + (lastY + 1) * g_BufferWidth, FLT_MAX);
+
+	for (int occluder = 0; occluder < m_occluderCount; occluder++)
+	{
+		if (IsOutOfTime())
+		{
+			break;
+		}
+
+		const TRIANGLE* pTriangles = &m_triangles[m_firstTriangles[occluder]];
+		for (int i = 0; i < m_triangleCounts[occluder]; i++)
+		{
+			const TRIANGLE& triangle = pTriangles[i];
+			int startY = std::max(firstY, triangle.minimumY);
+			int endY = std::min(lastY, triangle.maximumY);
+			for (int y = startY; y <= endY; y++)
+			{
+				float* pRow = &m_depth[y * g_BufferWidth];
+				float centerY = (float)y + 0.5f;
+				float centerX = (float)triangle.minimumX + 0.5f;
+#ifdef OCCLUSION_SSE
+				// the functions at four pixel centers, moved four
+				// pixels along at a time
+				const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+				const __m128 zero = _mm_setzero_ps();
+				__m128 edge0 = _mm_add_ps(_mm_set1_ps(Evaluate(triangle.edges[0], centerX, centerY)), _mm_mul_ps(_mm_set1_ps(triangle.edges[0].x), lanes));
+				__m128 edge1 = _mm_add_ps(_mm_set1_ps(Evaluate(triangle.edges[1], centerX, centerY)), _mm_mul_ps(_mm_set1_ps(triangle.edges[1].x), lanes));
+				__m128 edge2 = _mm_add_ps(_mm_set1_ps(Evaluate(triangle.edges[2], centerX, centerY)), _mm_mul_ps(_mm_set1_ps(triangle.edges[2].x), lanes));
+				__m128 depth = _mm_add_ps(_mm_set1_ps(Evaluate(triangle.depth, centerX, centerY)), _mm_mul_ps(_mm_set1_ps(triangle.depth.x), lanes));
+				const __m128 step0 = _mm_set1_ps(4.0f * triangle.edges[0].x);
+				const __m128 step1 = _mm_set1_ps(4.0f * triangle.edges[1].x);
+				const __m128 step2 = _mm_set1_ps(4.0f * triangle.edges[2].x);
+				const __m128 depthStep = _mm_set1_ps(4.0f * triangle.depth.x);
+
+				for (int x = triangle.minimumX; x <= triangle.maximumX; x += 4)
+				{
+					__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+					if (_mm_movemask_ps(inside) != 0)
+					{
+						__m128 current = _mm_loadu_ps(pRow + x);
+						__m128 nearest = _mm_min_ps(current, depth);
+						_mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+					}
+					edge0 = _mm_add_ps(edge0, step0);
+					edge1 = _mm_add_ps(edge1, step1);
+					edge2 = _mm_add_ps(edge2, step2);
+					depth = _mm_add_ps(depth, depthStep);
+				}
+#else
+				for (int x = triangle.minimumX; x <= triangle.maximumX; x++)
+				{
+					float pixelX = centerX + (float)(x - triangle.minimumX);
+					if ((Evaluate(triangle.edges[0], pixelX, centerY) >= 0.0f) && (Evaluate(triangle.edges[1], pixelX, centerY) >= 0.0f) &&
+						(Evaluate(triangle.edges[2], pixelX, centerY) >= 0.0f))
+					{
+						pRow[x] = std::min(pRow[x], Evaluate(triangle.depth, pixelX, centerY));
+					}
+				}
+#endif
+			}
+		}
+	}
+
+	// the farthest depth of each tile of the row
+	for (int tileColumn = 0; tileColumn < g_TileColumns; tileColumn++)
+	{
+		const float* pTile = &m_depth[firstY * g_BufferWidth + tileColumn * g_TileSize];
+#ifdef OCCLUSION_SSE
+		__m128 farthest = _mm_loadu_ps(pTile);
+		for (int y = 0; y < g_TileSize; y++)
+		{
+			for (int x = 0; x < g_TileSize; x += 4)
+			{
+				farthest = _mm_max_ps(farthest, _mm_loadu_ps(pTile + y * g_BufferWidth + x));
+			}
+		}
+		farthest = _mm_max_ps(farthest, _mm_shuffle_ps(farthest, farthest, _MM_SHUFFLE(1, 0, 3, 2)));
+		farthest = _mm_max_ps(farthest, _mm_shuffle_ps(farthest, farthest, _MM_SHUFFLE(2, 3, 0, 1)));
+		_mm_store_ss(&m_tileDepth[tileRow * g_TileColumns + tileColumn], farthest);
+#else
+		float farthest = pTile[0];
+		for (int y = 0; y < g_TileSize; y++)
+		{
+			for (int x = 0; x < g_TileSize; x++)
+			{
+				farthest = std::max(farthest, pTile[y * g_BufferWidth + x]);
+			}
+		}
+		m_tileDepth[tileRow * g_TileColumns + tileColumn] = farthest;
+#endif
+	}
+}
+
+/***********************************************************
+ *  IsVisible()
+ *
+ *  This method returns false when bounds are hidden.  The
+ *  corners of the box are projected into the buffer, and
+ *  the box is hidden when every pixel of the rectangle
+ *  around them is nearer than its nearest corner.  Tiles
+ *  whose farthest depth is nearer are passed over, and only
+ *  the others are tested pixel by pixel.
+ ***********************************************************/
+bool OcclusionCuller::IsVisible(const PrimitiveGeometry::BOUNDS& bounds) const
+{
+	if (m_occluderCount == 0)
+	{
+		return(true);
+	}
+
+	float minimumX = FLT_MAX;
+	float maximumX = -FLT_MAX;
+	float minimumY = FLT_MAX;
+	float maximumY = -FLT_MAX;
+	float nearest = FLT_MAX;
+#ifdef OCCLUSION_SSE
+	// the corners four at a time, the near face then the far
+	// one, each lane one corner
+	const glm::mat4& matrix = m_viewProjection;
+	const __m128 cornerX = _mm_setr_ps(bounds.minimum.x, bounds.maximum.x, bounds.minimum.x, bounds.maximum.x);
+	const __m128 cornerY = _mm_setr_ps(bounds.minimum.y, bounds.minimum.y, bounds.maximum.y, bounds.maximum.y);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 half = _mm_set1_ps(0.5f);
+	__m128 lowX = _mm_set1_ps(FLT_MAX);
+	__m128 highX = _mm_set1_ps(-FLT_MAX);
+	__m128 lowY = _mm_set1_ps(FLT_MAX);
+	__m128 highY = _mm_set1_ps(-FLT_MAX);
+	__m128 lowZ = _mm_set1_ps(FLT_MAX);
+	for (int face = 0; face < 2; face++)
+	{
+		__m128 cornerZ = _mm_set1_ps(face ? bounds.maximum.z : bounds.minimum.z);
+		__m128 clip[4];
+		for (int row = 0; row < 4; row++)
+		{
+			clip[row] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(matrix[0][row]), cornerX), _mm_mul_ps(_mm_set1_ps(matrix[1][row]), cornerY)),
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(matrix[2][row]), cornerZ), _mm_set1_ps(matrix[3][row])));
+		}
+
+		// a box reaching in front of the near plane is always seen
+		if (_mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(_mm_add_ps(clip[2], clip[3]), zero), _mm_cmple_ps(clip[3], zero))) != 0)
+		{
+			return(true);
+		}
+
+		__m128 inverseW = _mm_div_ps(_mm_set1_ps(1.0f), clip[3]);
+		__m128 x = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(clip[0], inverseW), half), half), _mm_set1_ps((float)g_BufferWidth));
+		__m128 y = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(clip[1], inverseW), half), half), _mm_set1_ps((float)g_BufferHeight));
+		lowX = _mm_min_ps(lowX, x);
+		highX = _mm_max_ps(highX, x);
+		lowY = _mm_min_ps(lowY, y);
+		highY = _mm_max_ps(highY, y);
+		lowZ = _mm_min_ps(lowZ, _mm_mul_ps(clip[2], inverseW));
+	}
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, lowX);
+	minimumX = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+	_mm_storeu_ps(lanes, highX);
+	maximumX = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+	_mm_storeu_ps(lanes, lowY);
+	minimumY = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+	_mm_storeu_ps(lanes, highY);
+	maximumY = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+	_mm_storeu_ps(lanes, lowZ);
+	nearest = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+#else
+	for (int corner = 0; corner < 8; corner++)
+	{
+		glm::vec3 position((corner & 1) ? bounds.maximum.x : bounds.minimum.x, (corner & 2) ? bounds.maximum.y : bounds.minimum.y,
+			(corner & 4) ? bounds.maximum.z : bounds.minimum.z);
+		glm::vec4 clip = m_viewProjection * glm::vec4(position, 1.0f);
+
+		// a box reaching in front of the near plane is always seen
+		if ((clip.z + clip.w < 0.0f) || (clip.w <= 0.0f))
+		{
+			return(true);
+		}
+
+		glm::vec3 point = ToBuffer(clip);
+		minimumX = std::min(minimumX, point.x);
+		maximumX = std::max(maximumX, point.x);
+		minimumY = std::min(minimumY, point.y);
+		maximumY = std::max(maximumY, point.y);
+		nearest = std::min(nearest, point.z);
+	}
+#endif
+
+	// every pixel the rectangle touches, and one more on each
+	// side, as an occluder covering a pixel's center can still
+	// leave part of the pixel uncovered
+	int firstX = std::max(0, (int)std::floor(minimumX) - 1);
+	int lastX = std::min(g_BufferWidth - 1, (int)std::floor(maximumX) + 1);
+	int firstY = std::max(0, (int)std::floor(minimumY) - 1);
+	int lastY = std::min(g_BufferHeight - 1, (int)std::floor(maximumY) + 1);
+	if ((firstX > lastX) || (firstY > lastY))
+	{
+		return(true);
+	}
+
+	float depth = nearest - g_DepthBias;
+	for (int tileRow = firstY / g_TileSize; tileRow <= lastY / g_TileSize; tileRow++)
+	{
+		for (int tileColumn = firstX / g_TileSize; tileColumn <= lastX / g_TileSize; tileColumn++)
+		{
+			if (m_tileDepth[tileRow * g_TileColumns + tileColumn] < depth)
+			{
+				continue;
+			}
+			if (HasFartherPixel(std::max(firstX, tileColumn * g_TileSize), std::min(lastX, tileColumn * g_TileSize + g_TileSize - 1),
+				std::max(firstY, tileRow * g_TileSize), std::min(lastY, tileRow * g_TileSize + g_TileSize - 1), depth))
+			{
+				return(true);
+			}
+		}
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  HasFartherPixel()
+ *
+ *  This method returns true when a pixel of a rectangle of
+ *  the buffer is at or beyond depth.
+ ***********************************************************/
+bool OcclusionCuller::HasFartherPixel(int minimumX, int maximumX, int minimumY, int maximumY, float depth) const
+{
+#ifdef OCCLUSION_SSE
+	const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+	const __m128 first = _mm_set1_ps((float)minimumX);
+	const __m128 last = _mm_set1_ps((float)maximumX);
+	const __m128 limit = _mm_set1_ps(depth);
+	for (int y = minimumY; y <= maximumY; y++)
+	{
+		const float* pRow = &m_depth[y * g_BufferWidth];
+		for (int x = minimumX & ~3; x <= maximumX; x += 4)
+		{
+			__m128 column = _mm_add_ps(_mm_set1_ps((float)x), lanes);
+			__m128 inside = _mm_and_ps(_mm_cmpge_ps(column, first), _mm_cmple_ps(column, last));
+			if (_mm_movemask_ps(_mm_and_ps(inside, _mm_cmpge_ps(_mm_loadu_ps(pRow + x), limit))) != 0)
+			{
+				return(true);
+			}
+		}
+	}
+#else
+	for (int y = minimumY; y <= maximumY; y++)
+	{
+		const float* pRow = &m_depth[y * g_BufferWidth];
+		for (int x = minimumX; x <= maximumX; x++)
+		{
+			if (pRow[x] >= depth)
+			{
+				return(true);
+			}
+		}
+	}
+#endif
+	return(false);
+}
+
+/***********************************************************
+ *  TestBounds()
+ *
+ *  This method is used for testing many bounds in chunks on
+ *  the job system.  Once the frame is out of time the bounds
+ *  not tested yet are all kept.
+ ***********************************************************/
+void OcclusionCuller::TestBounds(const std::vector<PrimitiveGeometry::BOUNDS>& bounds, std::vector<char>& visible)
+{
+	visible.resize(bounds.size());
+	RunRange((int)bounds.size(), g_BoundsPerJob, [&](int first, int last)
+	{
+		// without workers the whole range is one call, so the
+		// clock is read every g_BoundsPerJob bounds
+		bool bOutOfTime = false;
+		for (int i = first; i < last; i++)
+		{
+			if (!bOutOfTime && ((i - first) % g_BoundsPerJob == 0))
+			{
+				bOutOfTime = IsOutOfTime();
+			}
+			visible[i] = (bOutOfTime || IsVisible(bounds[i])) ? 1 : 0;
+		}
+	});
+
+	m_milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+/***********************************************************
+ *  IsOutOfTime()
+ *
+ *  This method returns true once the frame has used up its
+ *  budget, counting the frame as over budget the first
+ *  time.  It is called from every thread working on the
+ *  frame.
+ ***********************************************************/
+bool OcclusionCuller::IsOutOfTime()
+{
+	if (m_bOutOfTime)
+	{
+		return(true);
+	}
+	if (std::chrono::steady_clock::now() <= m_deadline)
+	{
+		return(false);
+	}
+	// only the thread that sets the flag counts the frame
+	if (!m_bOutOfTime.exchange(true))
+	{
+		m_overBudgetCount++;
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  RunRange()
+ *
+ *  This method is used for running work over 0 to count, in
+ *  chunks on the job system's threads or all at once on the
+ *  calling thread.
+ ***********************************************************/
+void OcclusionCuller::RunRange(int count, int chunkSize, const JobSystem::RANGE_JOB& job)
+{
+	if (NULL != m_pJobSystem)
+	{
+		m_pJobSystem->ParallelFor(count, chunkSize, job);
+	}
+	else
+	{
+		job(0, count);
+	}
+}
+
+/***********************************************************
+ *  GetOfferedCount()
+ *
+ *  This method returns the occluders offered in the frame.
+ ***********************************************************/
+int OcclusionCuller::GetOfferedCount() const
+{
+	return(m_offeredCount);
+}
+
+/***********************************************************
+ *  GetOccluderCount()
+ *
+ *  This method returns the occluders drawn in the frame.
+ ***********************************************************/
+int OcclusionCuller::GetOccluderCount() const
+{
+	return(m_occluderCount);
+}
+
+/***********************************************************
+ *  GetTriangleCount()
+ *
+ *  This method returns the triangles the drawn occluders
+ *  were set up as.
+ ***********************************************************/
+int OcclusionCuller::GetTriangleCount() const
+{
+	return(m_triangleCount);
+}
+
+/***********************************************************
+ *  GetMilliseconds()
+ *
+ *  This method returns the milliseconds from Begin() to the
+ *  end of the frame's rasterizing and testing.
+ ***********************************************************/
+double OcclusionCuller::GetMilliseconds() const
+{
+	return(m_milliseconds);
+}
+
+/***********************************************************
+ *  GetOccluderLimit()
+ *
+ *  This method returns the most occluders the next frame
+ *  may draw.
+ ***********************************************************/
+int OcclusionCuller::GetOccluderLimit() const
+{
+	return(m_occluderLimit);
+}
+
+/***********************************************************
+ *  GetOverBudgetCount()
+ *
+ *  This method returns the frames that ran out of time.
+ ***********************************************************/
+unsigned int OcclusionCuller::GetOverBudgetCount() const
+{
+	return(m_overBudgetCount);
+}
+
+/***********************************************************
+ *  GetOccluderPart()
+ *
+ *  This method returns the shape part of a drawn occluder.
+ *  The drawn occluders are sorted biggest first.
+ ***********************************************************/
+PrimitiveGeometry::PART OcclusionCuller::GetOccluderPart(int occluder) const
+{
+	return(m_occluders[occluder].part);
+}
+
+/***********************************************************
+ *  GetOccluderID()
+ *
+ *  This method returns the id a drawn occluder was offered
+ *  with.
+ ***********************************************************/
+int OcclusionCuller::GetOccluderID(int occluder) const
+{
+	return(m_occluders[occluder].id);
+}
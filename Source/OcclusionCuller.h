@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+// occlusionculler.h
+// ============
+// reject draws hidden behind the biggest solid shapes with a small depth
+// buffer rasterized on the CPU
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "JobSystem.h"
+#include "PrimitiveGeometry.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+/***********************************************************
+ *  OcclusionCuller
+ *
+ *  This class finds draws that are hidden behind others
+ *  before anything is sent to OpenGL.  The biggest solid
+ *  shapes of the frame, the occluders, are rasterized into
+ *  a low resolution depth buffer on the CPU, keeping the
+ *  nearest depth of every pixel.  A second level holds the
+ *  farthest depth of each 8 by 8 tile, so a draw's bounds
+ *  are mostly tested a tile at a time, and only down to the
+ *  pixels where a tile holds something farther than them.
+ *  A draw is hidden when every pixel its box covers is
+ *  nearer than the nearest corner of its box.
+ *
+ *  A pixel only holds the depth of an occluder that covers
+ *  its center, and a box that reaches in front of the near
+ *  plane is always seen, so a draw is never hidden by
+ *  something that is not in front of it.  A gap between two
+ *  occluders narrower than a pixel of the buffer is not
+ *  seen, so a draw only showing through one can be culled.
+ *  Only shapes that hide everything behind them may be
+ *  offered as occluders.
+ *  The buffer is cut into rows of tiles that are rasterized
+ *  on the job system's threads, the inner loops testing and
+ *  writing four pixels at once with SSE on x86.
+ *
+ *  The work of a frame has a time budget.  Occluders are
+ *  drawn biggest first, and when the budget runs out the
+ *  rest are skipped and draws not tested yet are kept, which
+ *  only culls less.  The number of occluders drawn is
+ *  lowered for the next frame when drawing them took more
+ *  than half of the budget, and raised again while it takes
+ *  well under that.
+ ***********************************************************/
+class OcclusionCuller
+{
+public:
+	// constructor - the shape parts occluders are drawn with
+	explicit OcclusionCuller(const PrimitiveGeometry* pGeometry);
+
+	// the job system the rasterizing and testing is split over,
+	// or NULL to do it all on the calling thread
+	void SetJobSystem(JobSystem* pJobSystem);
+	// milliseconds a frame's occlusion culling may take
+	void SetTimeBudget(double milliseconds);
+
+	// start a frame seen with a projection times view matrix
+	// from viewPosition, clearing the occluders
+	void Begin(const glm::mat4& viewProjection, const glm::vec3& viewPosition);
+	// offer a solid draw of a part as an occluder, with an id
+	// the caller knows it by
+	void AddOccluder(PrimitiveGeometry::PART part, const glm::mat4& model, const PrimitiveGeometry::BOUNDS& bounds, int id = -1);
+	// rasterize the biggest occluders into the depth buffer
+	void RenderOccluders();
+
+	// false when bounds are hidden behind the occluders
+	bool IsVisible(const PrimitiveGeometry::BOUNDS& bounds) const;
+	// test many bounds on the job system, setting a flag for
+	// each one that may be seen
+	void TestBounds(const std::vector<PrimitiveGeometry::BOUNDS>& bounds, std::vector<char>& visible);
+
+	// occluders offered and drawn in the last frame, their
+	// triangles, and the milliseconds the frame took
+	int GetOfferedCount() const;
+	int GetOccluderCount() const;
+	int GetTriangleCount() const;
+	double GetMilliseconds() const;
+	// occluders the next frame may draw, and the frames that
+	// ran out of time
+	int GetOccluderLimit() const;
+	unsigned int GetOverBudgetCount() const;
+	// the part and id of a drawn occluder, biggest first, below
+	// GetOccluderCount()
+	PrimitiveGeometry::PART GetOccluderPart(int occluder) const;
+	int GetOccluderID(int occluder) const;
+
+private:
+	// an offered occluder, and how big it looks
+	struct OCCLUDER
+	{
+		PrimitiveGeometry::PART part;
+		glm::mat4 model;
+		float size;
+		int id;
+	};
+
+	// a triangle set up for rasterizing - the three edge
+	// functions and the depth, each ax + by + c over the
+	// buffer, and the pixels it may cover
+	struct TRIANGLE
+	{
+		glm::vec3 edges[3];
+		glm::vec3 depth;
+		int minimumX;
+		int maximumX;
+		int minimumY;
+		int maximumY;
+	};
+
+	const PrimitiveGeometry* m_pGeometry;
+	JobSystem* m_pJobSystem;
+
+	glm::mat4 m_viewProjection;
+	glm::vec3 m_viewPosition;
+	std::vector<OCCLUDER> m_occluders;
+
+	// the triangles of each drawn occluder, from its first
+	// triangle up to its count
+	std::vector<TRIANGLE> m_triangles;
+	std::vector<int> m_firstTriangles;
+	std::vector<int> m_triangleCounts;
+
+	// nearest depth of every pixel, and farthest of every tile
+	std::vector<float> m_depth;
+	std::vector<float> m_tileDepth;
+
+	std::chrono::microseconds m_budget;
+	std::chrono::steady_clock::time_point m_start;
+	std::chrono::steady_clock::time_point m_deadline;
+	std::atomic<bool> m_bOutOfTime;
+	int m_occluderLimit;
+	int m_offeredCount;
+	int m_occluderCount;
+	int m_triangleCount;
+	double m_milliseconds;
+	double m_renderMilliseconds;
+	unsigned int m_overBudgetCount;
+
+	// true once the frame is over its budget
+	bool IsOutOfTime();
+	// run work over 0 to count in chunks on the job system
+	void RunRange(int count, int chunkSize, const JobSystem::RANGE_JOB& job);
+	// clip an occluder's triangles to the near plane and set
+	// them up, returning how many were kept
+	int SetupTriangles(const OCCLUDER& occluder, TRIANGLE* pTriangles) const;
+	// rasterize every drawn occluder into one row of tiles
+	void RasterizeTileRow(int tileRow);
+	// true when the pixels of a rectangle hold something at or
+	// beyond depth
+	bool HasFartherPixel(int minimumX, int maximumX, int minimumY, int maximumY, float depth) const;
+};
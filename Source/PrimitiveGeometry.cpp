@@ -0,0 +1,416 @@
+///////////////////////////////////////////////////////////////////////////////
+// primitivegeometry.cpp
+// ============
+// vertices and indices of the basic shapes the scene is built from
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PrimitiveGeometry.h"
+
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	// segments around the round shapes
+	const int g_RoundSlices = 36;
+	// segments around the ring of the torus and around its tube
+	const int g_TorusMainSegments = 36;
+	const int g_TorusTubeSegments = 18;
+	// radius of the ring of the torus and of its tube
+	const float g_TorusMainRadius = 1.0f;
+	const float g_TorusTubeRadius = 0.2f;
+	const float g_Pi = 3.14159265358979f;
+
+	/***********************************************************
+	 *  AddVertex()
+	 *
+	 *  Add one vertex to a mesh, returning its index.
+	 ***********************************************************/
+	unsigned int AddVertex(
+		std::vector<PrimitiveGeometry::VERTEX>& vertices,
+		const glm::vec3& position,
+		const glm::vec3& normal,
+		const glm::vec2& textureCoordinate)
+	{
+		PrimitiveGeometry::VERTEX vertex;
+		vertex.position = position;
+		vertex.normal = normal;
+		vertex.textureCoordinate = textureCoordinate;
+		vertices.push_back(vertex);
+		return((unsigned int)vertices.size() - 1);
+	}
+
+	/***********************************************************
+	 *  AddTriangle()
+	 *
+	 *  Add a flat shaded triangle with its own three vertices,
+	 *  counter-clockwise seen from the side it faces.
+	 ***********************************************************/
+	void AddTriangle(
+		std::vector<PrimitiveGeometry::VERTEX>& vertices,
+		std::vector<unsigned int>& indices,
+		const glm::vec3& p0, const glm::vec2& uv0,
+		const glm::vec3& p1, const glm::vec2& uv1,
+		const glm::vec3& p2, const glm::vec2& uv2)
+	{
+		glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+		indices.push_back(AddVertex(vertices, p0, normal, uv0));
+		indices.push_back(AddVertex(vertices, p1, normal, uv1));
+		indices.push_back(AddVertex(vertices, p2, normal, uv2));
+	}
+
+	/***********************************************************
+	 *  AddQuad()
+	 *
+	 *  Add a flat shaded quad from one corner along two edges.
+	 *  The quad faces the way of the cross product of the
+	 *  edges, and the texture covers it once.
+	 ***********************************************************/
+	void AddQuad(
+		std::vector<PrimitiveGeometry::VERTEX>& vertices,
+		std::vector<unsigned int>& indices,
+		const glm::vec3& corner,
+		const glm::vec3& uEdge,
+		const glm::vec3& vEdge)
+	{
+		glm::vec3 normal = glm::normalize(glm::cross(uEdge, vEdge));
+		unsigned int first = AddVertex(vertices, corner, normal, glm::vec2(0.0f, 0.0f));
+		AddVertex(vertices, corner + uEdge, normal, glm::vec2(1.0f, 0.0f));
+		AddVertex(vertices, corner + uEdge + vEdge, normal, glm::vec2(1.0f, 1.0f));
+		AddVertex(vertices, corner + vEdge, normal, glm::vec2(0.0f, 1.0f));
+
+		const unsigned int order[6] = { 0, 1, 2, 0, 2, 3 };
+		for (int i = 0; i < 6; i++)
+		{
+			indices.push_back(first + order[i]);
+		}
+	}
+
+	/***********************************************************
+	 *  AddCap()
+	 *
+	 *  Add a round cap of a cylinder at a height, facing up or
+	 *  down, as a fan around its center.
+	 ***********************************************************/
+	void AddCap(
+		std::vector<PrimitiveGeometry::VERTEX>& vertices,
+		std::vector<unsigned int>& indices,
+		float height,
+		float radius,
+		bool bFacingUp)
+	{
+		glm::vec3 normal = glm::vec3(0.0f, bFacingUp ? 1.0f : -1.0f, 0.0f);
+		unsigned int center = AddVertex(vertices, glm::vec3(0.0f, height, 0.0f), normal, glm::vec2(0.5f, 0.5f));
+
+		for (int slice = 0; slice <= g_RoundSlices; slice++)
+		{
+			float angle = (2.0f * g_Pi * slice) / g_RoundSlices;
+			float x = std::cos(angle);
+			float z = std::sin(angle);
+			AddVertex(vertices, glm::vec3(x * radius, height, z * radius), normal, glm::vec2(0.5f + 0.5f * x, 0.5f + 0.5f * z));
+		}
+
+		for (int slice = 0; slice < g_RoundSlices; slice++)
+		{
+			unsigned int current = center + 1 + slice;
+			indices.push_back(center);
+			indices.push_back(bFacingUp ? current + 1 : current);
+			indices.push_back(bFacingUp ? current : current + 1);
+		}
+	}
+
+	/***********************************************************
+	 *  AddRoundSide()
+	 *
+	 *  Add the side of a cylinder from its bottom radius at
+	 *  height 0 to its top radius at height 1.  The texture
+	 *  wraps around it once.
+	 ***********************************************************/
+	void AddRoundSide(
+		std::vector<PrimitiveGeometry::VERTEX>& vertices,
+		std::vector<unsigned int>& indices,
+		float bottomRadius,
+		float topRadius)
+	{
+		unsigned int first = (unsigned int)vertices.size();
+
+		for (int slice = 0; slice <= g_RoundSlices; slice++)
+		{
+			float angle = (2.0f * g_Pi * slice) / g_RoundSlices;
+			float x = std::cos(angle);
+			float z = std::sin(angle);
+			float u = (float)slice / g_RoundSlices;
+			glm::vec3 normal = glm::normalize(glm::vec3(x, bottomRadius - topRadius, z));
+			AddVertex(vertices, glm::vec3(x * bottomRadius, 0.0f, z * bottomRadius), normal, glm::vec2(u, 0.0f));
+			AddVertex(vertices, glm::vec3(x * topRadius, 1.0f, z * topRadius), normal, glm::vec2(u, 1.0f));
+		}
+
+		for (int slice = 0; slice < g_RoundSlices; slice++)
+		{
+			unsigned int bottom = first + 2 * slice;
+			unsigned int top = bottom + 1;
+			indices.push_back(bottom);
+			indices.push_back(top);
+			indices.push_back(bottom + 2);
+			indices.push_back(bottom + 2);
+			indices.push_back(top);
+			indices.push_back(top + 2);
+		}
+	}
+}
+
+/***********************************************************
+ *  PrimitiveGeometry()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+PrimitiveGeometry::PrimitiveGeometry()
+{
+	// plane - 2x2 units in XZ facing up, with the top of the
+	// texture toward -Z
+	MESH_DATA& plane = m_meshes[MESH_PLANE];
+	AddQuad(plane.vertices, plane.indices, glm::vec3(-1.0f, 0.0f, 1.0f), glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -2.0f));
+	SetPart(PART_PLANE, MESH_PLANE, 0);
+
+	// box - a unit cube around the origin, the texture
+	// covering every face
+	MESH_DATA& box = m_meshes[MESH_BOX];
+	AddQuad(box.vertices, box.indices, glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	AddQuad(box.vertices, box.indices, glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	AddQuad(box.vertices, box.indices, glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	AddQuad(box.vertices, box.indices, glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	AddQuad(box.vertices, box.indices, glm::vec3(-0.5f, 0.5f, 0.5f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+	AddQuad(box.vertices, box.indices, glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+	SetPart(PART_BOX, MESH_BOX, 0);
+
+	// cylinder - radius 1 from height 0 to 1, with the top
+	// first so the side and bottom are one range
+	MESH_DATA& cylinder = m_meshes[MESH_CYLINDER];
+	AddCap(cylinder.vertices, cylinder.indices, 1.0f, 1.0f, true);
+	int sideStart = (int)cylinder.indices.size();
+	AddRoundSide(cylinder.vertices, cylinder.indices, 1.0f, 1.0f);
+	AddCap(cylinder.vertices, cylinder.indices, 0.0f, 1.0f, false);
+	SetPart(PART_CYLINDER, MESH_CYLINDER, 0);
+	SetPart(PART_CYLINDER_OPEN_TOP, MESH_CYLINDER, sideStart);
+
+	// cone - base of radius 1 at height 0, tip at height 1
+	MESH_DATA& cone = m_meshes[MESH_CONE];
+	for (int slice = 0; slice < g_RoundSlices; slice++)
+	{
+		float angle0 = (2.0f * g_Pi * slice) / g_RoundSlices;
+		float angle1 = (2.0f * g_Pi * (slice + 1)) / g_RoundSlices;
+		float angleTip = 0.5f * (angle0 + angle1);
+		float u0 = (float)slice / g_RoundSlices;
+		float u1 = (float)(slice + 1) / g_RoundSlices;
+		glm::vec3 base0 = glm::vec3(std::cos(angle0), 0.0f, std::sin(angle0));
+		glm::vec3 base1 = glm::vec3(std::cos(angle1), 0.0f, std::sin(angle1));
+
+		// the side slopes at 45 degrees, and the tip takes the
+		// normal from the middle of the slice
+		cone.indices.push_back(AddVertex(cone.vertices, base0, glm::normalize(base0 + glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec2(u0, 0.0f)));
+		cone.indices.push_back(AddVertex(cone.vertices, glm::vec3(0.0f, 1.0f, 0.0f),
+			glm::normalize(glm::vec3(std::cos(angleTip), 1.0f, std::sin(angleTip))), glm::vec2(0.5f * (u0 + u1), 1.0f)));
+		cone.indices.push_back(AddVertex(cone.vertices, base1, glm::normalize(base1 + glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec2(u1, 0.0f)));
+	}
+	AddCap(cone.vertices, cone.indices, 0.0f, 1.0f, false);
+	SetPart(PART_CONE, MESH_CONE, 0);
+
+	// torus - a ring of radius 1 around the Z axis, built one
+	// segment of the ring at a time so the first half of the
+	// indices is the half torus above the X axis
+	MESH_DATA& torus = m_meshes[MESH_TORUS];
+	for (int ring = 0; ring <= g_TorusMainSegments; ring++)
+	{
+		float mainAngle = (2.0f * g_Pi * ring) / g_TorusMainSegments;
+		for (int tube = 0; tube <= g_TorusTubeSegments; tube++)
+		{
+			float tubeAngle = (2.0f * g_Pi * tube) / g_TorusTubeSegments;
+			glm::vec3 normal = glm::vec3(std::cos(tubeAngle) * std::cos(mainAngle), std::cos(tubeAngle) * std::sin(mainAngle), std::sin(tubeAngle));
+			glm::vec3 center = glm::vec3(std::cos(mainAngle), std::sin(mainAngle), 0.0f) * g_TorusMainRadius;
+			AddVertex(torus.vertices, center + normal * g_TorusTubeRadius, normal,
+				glm::vec2((float)ring / g_TorusMainSegments, (float)tube / g_TorusTubeSegments));
+		}
+	}
+	for (int ring = 0; ring < g_TorusMainSegments; ring++)
+	{
+		for (int tube = 0; tube < g_TorusTubeSegments; tube++)
+		{
+			unsigned int current = ring * (g_TorusTubeSegments + 1) + tube;
+			unsigned int next = current + g_TorusTubeSegments + 1;
+			torus.indices.push_back(current);
+			torus.indices.push_back(next);
+			torus.indices.push_back(current + 1);
+			torus.indices.push_back(current + 1);
+			torus.indices.push_back(next);
+			torus.indices.push_back(next + 1);
+		}
+	}
+	SetPart(PART_TORUS, MESH_TORUS, 0);
+	m_parts[PART_HALF_TORUS] = m_parts[PART_TORUS];
+	m_parts[PART_HALF_TORUS].indexCount /= 2;
+
+	// prism - a triangle in XY pushed along Z, in the unit cube
+	MESH_DATA& prism = m_meshes[MESH_PRISM];
+	glm::vec3 left = glm::vec3(-0.5f, -0.5f, 0.0f);
+	glm::vec3 right = glm::vec3(0.5f, -0.5f, 0.0f);
+	glm::vec3 top = glm::vec3(0.0f, 0.5f, 0.0f);
+	glm::vec3 front = glm::vec3(0.0f, 0.0f, 0.5f);
+	AddTriangle(prism.vertices, prism.indices, left + front, glm::vec2(0.0f, 0.0f), right + front, glm::vec2(1.0f, 0.0f), top + front, glm::vec2(0.5f, 1.0f));
+	AddTriangle(prism.vertices, prism.indices, right - front, glm::vec2(0.0f, 0.0f), left - front, glm::vec2(1.0f, 0.0f), top - front, glm::vec2(0.5f, 1.0f));
+	AddQuad(prism.vertices, prism.indices, left - front, right - left, 2.0f * front);
+	AddQuad(prism.vertices, prism.indices, right + front, right - front - (right + front), top - right);
+	AddQuad(prism.vertices, prism.indices, top + front, top - front - (top + front), left - top);
+	SetPart(PART_PRISM, MESH_PRISM, 0);
+
+	// pyramids - a triangle or square base at the bottom of the
+	// unit cube and the tip at the middle of its top
+	glm::vec3 tip = glm::vec3(0.0f, 0.5f, 0.0f);
+	MESH_DATA& pyramid3 = m_meshes[MESH_PYRAMID3];
+	glm::vec3 base3[3] = { glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(0.0f, -0.5f, -0.5f) };
+	for (int side = 0; side < 3; side++)
+	{
+		AddTriangle(pyramid3.vertices, pyramid3.indices, base3[side], glm::vec2(0.0f, 0.0f), base3[(side + 1) % 3], glm::vec2(1.0f, 0.0f), tip, glm::vec2(0.5f, 1.0f));
+	}
+	AddTriangle(pyramid3.vertices, pyramid3.indices, base3[0], glm::vec2(0.0f, 1.0f), base3[2], glm::vec2(0.5f, 0.0f), base3[1], glm::vec2(1.0f, 1.0f));
+	SetPart(PART_PYRAMID3, MESH_PYRAMID3, 0);
+
+	MESH_DATA& pyramid4 = m_meshes[MESH_PYRAMID4];
+	glm::vec3 base4[4] = { glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, -0.5f, -0.5f) };
+	for (int side = 0; side < 4; side++)
+	{
+		AddTriangle(pyramid4.vertices, pyramid4.indices, base4[side], glm::vec2(0.0f, 0.0f), base4[(side + 1) % 4], glm::vec2(1.0f, 0.0f), tip, glm::vec2(0.5f, 1.0f));
+	}
+	AddQuad(pyramid4.vertices, pyramid4.indices, base4[3], glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+	SetPart(PART_PYRAMID4, MESH_PYRAMID4, 0);
+
+	// tapered cylinder - radius 1 at the bottom narrowing to
+	// 0.5 at the top
+	MESH_DATA& tapered = m_meshes[MESH_TAPERED_CYLINDER];
+	AddCap(tapered.vertices, tapered.indices, 1.0f, 0.5f, true);
+	AddRoundSide(tapered.vertices, tapered.indices, 1.0f, 0.5f);
+	AddCap(tapered.vertices, tapered.indices, 0.0f, 1.0f, false);
+	SetPart(PART_TAPERED_CYLINDER, MESH_TAPERED_CYLINDER, 0);
+
+	ComputeBounds();
+}
+
+/***********************************************************
+ *  ComputeBounds()
+ *
+ *  This method is used for finding the box around the
+ *  vertices each part's indices use, and the sphere around
+ *  them centered on the box.
+ ***********************************************************/
+void PrimitiveGeometry::ComputeBounds()
+{
+	for (int part = 0; part < PART_COUNT; part++)
+	{
+		const PART_RANGE& range = m_parts[part];
+		const MESH_DATA& mesh = m_meshes[range.mesh];
+		BOUNDS& bounds = m_bounds[part];
+
+		bounds.minimum = glm::vec3(0.0f);
+		bounds.maximum = glm::vec3(0.0f);
+		for (int i = 0; i < range.indexCount; i++)
+		{
+			const glm::vec3& position = mesh.vertices[mesh.indices[range.firstIndex + i]].position;
+			bounds.minimum = (i == 0) ? position : glm::min(bounds.minimum, position);
+			bounds.maximum = (i == 0) ? position : glm::max(bounds.maximum, position);
+		}
+
+		bounds.center = 0.5f * (bounds.minimum + bounds.maximum);
+		bounds.radius = 0.0f;
+		for (int i = 0; i < range.indexCount; i++)
+		{
+			const glm::vec3& position = mesh.vertices[mesh.indices[range.firstIndex + i]].position;
+			bounds.radius = std::fmax(bounds.radius, glm::length(position - bounds.center));
+		}
+	}
+}
+
+/***********************************************************
+ *  TransformBounds()
+ *
+ *  This method returns the bounds of a part drawn with a
+ *  world matrix.  The box is the smallest one around the
+ *  transformed box, its half size found from the absolute
+ *  values of the matrix, and the sphere is scaled by the
+ *  longest axis of the matrix.
+ ***********************************************************/
+PrimitiveGeometry::BOUNDS PrimitiveGeometry::TransformBounds(const BOUNDS& bounds, const glm::mat4& model)
+{
+	glm::vec3 boxCenter = 0.5f * (bounds.minimum + bounds.maximum);
+	glm::vec3 boxExtents = 0.5f * (bounds.maximum - bounds.minimum);
+
+	glm::vec3 worldCenter = glm::vec3(model * glm::vec4(boxCenter, 1.0f));
+	glm::vec3 worldExtents(0.0f);
+	float scale = 0.0f;
+	for (int column = 0; column < 3; column++)
+	{
+		glm::vec3 axis = glm::vec3(model[column]);
+		worldExtents += glm::abs(axis) * boxExtents[column];
+		scale = std::fmax(scale, glm::length(axis));
+	}
+
+	BOUNDS world;
+	world.minimum = worldCenter - worldExtents;
+	world.maximum = worldCenter + worldExtents;
+	world.center = glm::vec3(model * glm::vec4(bounds.center, 1.0f));
+	world.radius = bounds.radius * scale;
+	return(world);
+}
+
+/***********************************************************
+ *  SetPart()
+ *
+ *  This method is used for setting the range of a part to
+ *  the indices of its mesh from firstIndex to the end.
+ ***********************************************************/
+void PrimitiveGeometry::SetPart(PART part, MESH mesh, int firstIndex)
+{
+	m_parts[part].mesh = mesh;
+	m_parts[part].firstIndex = firstIndex;
+	m_parts[part].indexCount = (int)m_meshes[mesh].indices.size() - firstIndex;
+}
+
+/***********************************************************
+ *  GetVertices()
+ *
+ *  This method returns the vertices of a mesh.
+ ***********************************************************/
+const std::vector<PrimitiveGeometry::VERTEX>& PrimitiveGeometry::GetVertices(MESH mesh) const
+{
+	return(m_meshes[mesh].vertices);
+}
+
+/***********************************************************
+ *  GetIndices()
+ *
+ *  This method returns the triangle indices of a mesh.
+ ***********************************************************/
+const std::vector<unsigned int>& PrimitiveGeometry::GetIndices(MESH mesh) const
+{
+	return(m_meshes[mesh].indices);
+}
+
+/***********************************************************
+ *  GetPart()
+ *
+ *  This method returns the mesh of a part and the range of
+ *  its indices.
+ ***********************************************************/
+const PrimitiveGeometry::PART_RANGE& PrimitiveGeometry::GetPart(PART part) const
+{
+	return(m_parts[part]);
+}
+
+/***********************************************************
+ *  GetBounds()
+ *
+ *  This method returns the box and sphere around a part in
+ *  its own space.
+ ***********************************************************/
+const PrimitiveGeometry::BOUNDS& PrimitiveGeometry::GetBounds(PART part) const
+{
+	return(m_bounds[part]);
+}
@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////
+// primitivegeometry.h
+// ============
+// vertices and indices of the basic shapes the scene is built from
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  PrimitiveGeometry
+ *
+ *  This class builds the vertices and indices of the basic
+ *  shapes on the CPU, with the same sizes, orientations and
+ *  texture coordinates as the ShapeMeshes shapes: a plane
+ *  of 2x2 units lying in XZ, a unit box and a unit cylinder
+ *  and cone standing on the XZ plane, and a torus of radius
+ *  one around the Z axis.
+ *
+ *  Every mesh is a list of triangles indexing its vertices.
+ *  The parts of a mesh that can be drawn on their own, such
+ *  as a cylinder without its top or half of the torus, are
+ *  one range of its indices each, with a bounding box and
+ *  sphere around the vertices it uses.
+ ***********************************************************/
+class PrimitiveGeometry
+{
+public:
+	// every mesh
+	enum MESH
+	{
+		MESH_PLANE = 0,
+		MESH_BOX,
+		MESH_CYLINDER,
+		MESH_CONE,
+		MESH_TORUS,
+		MESH_PRISM,
+		MESH_PYRAMID3,
+		MESH_PYRAMID4,
+		MESH_TAPERED_CYLINDER,
+		MESH_COUNT
+	};
+
+	// every drawable part of a mesh
+	enum PART
+	{
+		PART_PLANE = 0,
+		PART_BOX,
+		PART_CYLINDER,
+		// the side and bottom of the cylinder
+		PART_CYLINDER_OPEN_TOP,
+		PART_CONE,
+		PART_TORUS,
+		PART_HALF_TORUS,
+		PART_PRISM,
+		PART_PYRAMID3,
+		PART_PYRAMID4,
+		PART_TAPERED_CYLINDER,
+		PART_COUNT
+	};
+
+	// one vertex, laid out the way the vertex shader reads it
+	struct VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 textureCoordinate;
+	};
+
+	// the indices a part is drawn with
+	struct PART_RANGE
+	{
+		MESH mesh;
+		int firstIndex;
+		int indexCount;
+	};
+
+	// the volume a part, or a group of them, lies in - an axis
+	// aligned box and a sphere
+	struct BOUNDS
+	{
+		glm::vec3 minimum;
+		glm::vec3 maximum;
+		glm::vec3 center;
+		float radius;
+	};
+
+	// constructor, builds every mesh
+	PrimitiveGeometry();
+
+	// vertices and indices of a mesh
+	const std::vector<VERTEX>& GetVertices(MESH mesh) const;
+	const std::vector<unsigned int>& GetIndices(MESH mesh) const;
+	// mesh and indices of a part
+	const PART_RANGE& GetPart(PART part) const;
+	// bounds of a part in its own space
+	const BOUNDS& GetBounds(PART part) const;
+
+	// bounds of a part drawn with a world matrix - the box
+	// holds the transformed box, the sphere the transformed
+	// sphere
+	static BOUNDS TransformBounds(const BOUNDS& bounds, const glm::mat4& model);
+
+private:
+	struct MESH_DATA
+	{
+		std::vector<VERTEX> vertices;
+		std::vector<unsigned int> indices;
+	};
+
+	MESH_DATA m_meshes[MESH_COUNT];
+	PART_RANGE m_parts[PART_COUNT];
+	BOUNDS m_bounds[PART_COUNT];
+
+	// set the range of a part to the indices added to its mesh
+	// since firstIndex
+	void SetPart(PART part, MESH mesh, int firstIndex);
+	// find the bounds of every part from its vertices
+	void ComputeBounds();
+};
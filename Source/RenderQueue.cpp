@@ -0,0 +1,343 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.cpp
+// ============
+// put the draws of a frame in drawing order by sorting 64-bit keys
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// the pass takes the top two bits of every key
+	const int g_PassShift = 62;
+	// opaque keys: mesh, texture, material, then the distance
+	// so that each group is drawn front to back
+	const int g_OpaqueMeshShift = 48;
+	const int g_OpaqueTextureShift = 36;
+	const int g_OpaqueMaterialShift = 24;
+	const int g_OpaqueDepthShift = 0;
+	// transparent keys: the distance first, inverted so that
+	// the farthest draw sorts first, then the state
+	const int g_TransparentDepthShift = 38;
+	const int g_TransparentMeshShift = 24;
+	const int g_TransparentTextureShift = 12;
+	const int g_TransparentMaterialShift = 0;
+
+	// 14 bits of mesh cover the shape parts and thousands of
+	// baked meshes, and 12 bits of texture and of material cover
+	// every texture handle and the material buffer's
+	// MAX_MATERIALS, using all 64 bits of a key
+	const uint64_t g_MeshMask = 0x3FFF;
+	const uint64_t g_TextureMask = 0xFFF;
+	const uint64_t g_MaterialMask = 0xFFF;
+	const uint64_t g_DepthMask = 0xFFFFFF;
+
+	// bits of the key sorted by each radix pass
+	const int g_RadixBits = 8;
+	const int g_RadixSize = 1 << g_RadixBits;
+
+	/***********************************************************
+	 *  QuantizeDepth()
+	 *
+	 *  Turn a distance into 24 bits that sort in the same
+	 *  order.  The bits of a positive float grow with its
+	 *  value, so the top 24 of them (the exponent and 15 bits
+	 *  of the mantissa) are kept, whatever the scene's scale.
+	 ***********************************************************/
+	uint64_t QuantizeDepth(float depth)
+	{
+		if (!(depth > 0.0f))
+		{
+			return(0);
+		}
+		uint32_t bits;
+		memcpy(&bits, &depth, sizeof(bits));
+		return((bits >> 8) & g_DepthMask);
+	}
+
+	/***********************************************************
+	 *  GetState()
+	 *
+	 *  Read one of the state fields back out of a key, along
+	 *  with its pass, so that the same state in the two passes
+	 *  counts as different.
+	 ***********************************************************/
+	uint64_t GetState(uint64_t key, RenderQueue::STATE state)
+	{
+		uint64_t pass = key >> g_PassShift;
+		bool bTransparent = (pass == RenderQueue::PASS_TRANSPARENT);
+		uint64_t value = 0;
+
+		switch (state)
+		{
+		case RenderQueue::STATE_MESH:
+			value = (key >> (bTransparent ? g_TransparentMeshShift : g_OpaqueMeshShift)) & g_MeshMask;
+			break;
+		case RenderQueue::STATE_TEXTURE:
+			value = (key >> (bTransparent ? g_TransparentTextureShift : g_OpaqueTextureShift)) & g_TextureMask;
+			break;
+		default:
+			value = (key >> (bTransparent ? g_TransparentMaterialShift : g_OpaqueMaterialShift)) & g_MaterialMask;
+			break;
+		}
+		return((pass << 16) | value);
+	}
+}
+
+/***********************************************************
+ *  RenderQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderQueue::RenderQueue()
+{
+	for (int state = 0; state < STATE_COUNT; state++)
+	{
+		m_submittedChanges[state] = 0;
+		m_sortedChanges[state] = 0;
+	}
+}
+
+/***********************************************************
+ *  MakeKey()
+ *
+ *  This method is used for building the sort key of a draw.
+ *  Lower keys are drawn first.  The texture is stored one
+ *  higher, so that untextured draws (-1) come first.  A mesh,
+ *  texture or material past the bits of its field shares
+ *  the field's last value rather than wrapping onto a lower
+ *  one, so it still sorts after every value that fits and
+ *  only its own runs are split.
+ ***********************************************************/
+uint64_t RenderQueue::MakeKey(PASS pass, int mesh, int texture, int material, float depth)
+{
+	uint64_t meshBits = ((uint64_t)mesh < g_MeshMask) ? (uint64_t)mesh : g_MeshMask;
+	uint64_t textureBits = (texture < 0) ? 0 : (((uint64_t)texture + 1 < g_TextureMask) ? (uint64_t)texture + 1 : g_TextureMask);
+	uint64_t materialBits = ((uint64_t)material < g_MaterialMask) ? (uint64_t)material : g_MaterialMask;
+	uint64_t depthBits = QuantizeDepth(depth);
+	uint64_t key = (uint64_t)pass << g_PassShift;
+
+	if (pass == PASS_TRANSPARENT)
+	{
+		key |= (g_DepthMask - depthBits) << g_TransparentDepthShift;
+		key |= meshBits << g_TransparentMeshShift;
+		key |= textureBits << g_TransparentTextureShift;
+		key |= materialBits << g_TransparentMaterialShift;
+	}
+	else
+	{
+		key |= meshBits << g_OpaqueMeshShift;
+		key |= textureBits << g_OpaqueTextureShift;
+		key |= materialBits << g_OpaqueMaterialShift;
+		key |= depthBits << g_OpaqueDepthShift;
+	}
+	return(key);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every draw, keeping the
+ *  memory for the next frame.
+ ***********************************************************/
+void RenderQueue::Clear()
+{
+	m_entries.clear();
+}
+
+/***********************************************************
+ *  Push()
+ *
+ *  This method is used for adding a draw to the queue.
+ ***********************************************************/
+void RenderQueue::Push(uint64_t key, unsigned int item)
+{
+	ENTRY entry;
+	entry.key = key;
+	entry.item = item;
+	m_entries.push_back(entry);
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the number of draws in
+ *  the queue, before each one is set with Set().
+ ***********************************************************/
+void RenderQueue::Resize(size_t count)
+{
+	m_entries.resize(count);
+}
+
+/***********************************************************
+ *  Set()
+ *
+ *  This method is used for setting the draw at an index.
+ *  Nothing but that entry is written, so the draws can be
+ *  set from worker threads.
+ ***********************************************************/
+void RenderQueue::Set(size_t index, uint64_t key, unsigned int item)
+{
+	m_entries[index].key = key;
+	m_entries[index].item = item;
+}
+
+/***********************************************************
+ *  Sort()
+ *
+ *  This method is used for putting the draws in key order
+ *  with a least significant digit radix sort, 8 bits per
+ *  pass.  The counts of every digit are gathered in one
+ *  read of the keys.  Each pass is stable, so draws with
+ *  the same key keep the order they were pushed in, and a
+ *  pass is skipped when every key has the same digit, which
+ *  skips the unused low bits and most of the high ones in a
+ *  scene with few meshes and textures.
+ ***********************************************************/
+void RenderQueue::Sort()
+{
+	CountChanges(m_submittedChanges);
+
+	size_t count = m_entries.size();
+	if (count > 1)
+	{
+		const int passCount = 64 / g_RadixBits;
+		size_t offsets[passCount][g_RadixSize];
+		memset(offsets, 0, sizeof(offsets));
+		for (size_t i = 0; i < count; i++)
+		{
+			uint64_t key = m_entries[i].key;
+			for (int pass = 0; pass < passCount; pass++)
+			{
+				offsets[pass][(key >> (pass * g_RadixBits)) & (g_RadixSize - 1)]++;
+			}
+		}
+
+		m_scratch.resize(count);
+		ENTRY* pSource = m_entries.data();
+		ENTRY* pTarget = m_scratch.data();
+
+		for (int pass = 0; pass < passCount; pass++)
+		{
+			int shift = pass * g_RadixBits;
+			size_t* pOffsets = offsets[pass];
+			if (pOffsets[(pSource[0].key >> shift) & (g_RadixSize - 1)] == count)
+			{
+				continue;
+			}
+
+			// turn the counts into the first index of each digit
+			size_t offset = 0;
+			for (int digit = 0; digit < g_RadixSize; digit++)
+			{
+				size_t digitCount = pOffsets[digit];
+				pOffsets[digit] = offset;
+				offset += digitCount;
+			}
+			for (size_t i = 0; i < count; i++)
+			{
+				pTarget[pOffsets[(pSource[i].key >> shift) & (g_RadixSize - 1)]++] = pSource[i];
+			}
+
+			ENTRY* pSorted = pTarget;
+			pTarget = pSource;
+			pSource = pSorted;
+		}
+
+		// an odd number of passes leaves the result in the
+		// scratch buffer
+		if (pSource != m_entries.data())
+		{
+			m_entries.swap(m_scratch);
+		}
+	}
+
+	CountChanges(m_sortedChanges);
+}
+
+/***********************************************************
+ *  CountChanges()
+ *
+ *  This method is used for counting, for each state, how
+ *  many neighbouring entries differ in it.
+ ***********************************************************/
+void RenderQueue::CountChanges(unsigned int changes[STATE_COUNT]) const
+{
+	for (int state = 0; state < STATE_COUNT; state++)
+	{
+		changes[state] = 0;
+	}
+	for (size_t i = 1; i < m_entries.size(); i++)
+	{
+		uint64_t key = m_entries[i].key;
+		uint64_t previous = m_entries[i - 1].key;
+		// neighbours with the same key share every state
+		if (key == previous)
+		{
+			continue;
+		}
+		for (int state = 0; state < STATE_COUNT; state++)
+		{
+			if (GetState(key, (STATE)state) != GetState(previous, (STATE)state))
+			{
+				changes[state]++;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method returns the number of draws in the queue.
+ ***********************************************************/
+size_t RenderQueue::GetCount() const
+{
+	return(m_entries.size());
+}
+
+/***********************************************************
+ *  GetItem()
+ *
+ *  This method returns the item of the draw at an index.
+ ***********************************************************/
+unsigned int RenderQueue::GetItem(size_t index) const
+{
+	return(m_entries[index].item);
+}
+
+/***********************************************************
+ *  GetKey()
+ *
+ *  This method returns the key of the draw at an index.
+ ***********************************************************/
+uint64_t RenderQueue::GetKey(size_t index) const
+{
+	return(m_entries[index].key);
+}
+
+/***********************************************************
+ *  GetSubmittedChanges()
+ *
+ *  This method returns the changes of a state between the
+ *  draws in the order they were pushed before the last
+ *  Sort().
+ ***********************************************************/
+unsigned int RenderQueue::GetSubmittedChanges(STATE state) const
+{
+	return(m_submittedChanges[state]);
+}
+
+/***********************************************************
+ *  GetSortedChanges()
+ *
+ *  This method returns the changes of a state between the
+ *  draws in the order the last Sort() put them in.
+ ***********************************************************/
+unsigned int RenderQueue::GetSortedChanges(STATE state) const
+{
+	return(m_sortedChanges[state]);
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.h
+// ============
+// put the draws of a frame in drawing order by sorting 64-bit keys
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  RenderQueue
+ *
+ *  This class orders the draws of a frame so that draws
+ *  with the same state follow each other.  Every draw is
+ *  pushed as a 64-bit key built from its pass, mesh,
+ *  texture, material and distance from the camera, and the
+ *  keys are radix sorted before anything is drawn.
+ *
+ *  Opaque draws are grouped by mesh, then texture, then
+ *  material, and drawn front to back within a group.  The
+ *  transparent pass is drawn after them, back to front, so
+ *  blending sees the farthest surface first.  Draws with
+ *  the same key keep the order they were pushed in.
+ *
+ *  The queue counts the changes of mesh, texture and
+ *  material between neighbouring draws in the order they
+ *  were pushed and in the sorted order, to show how many
+ *  state changes sorting removed.
+ ***********************************************************/
+class RenderQueue
+{
+public:
+	// the passes, in drawing order
+	enum PASS
+	{
+		PASS_OPAQUE = 0,
+		PASS_TRANSPARENT
+	};
+
+	// the state a key groups draws by
+	enum STATE
+	{
+		STATE_MESH = 0,
+		STATE_TEXTURE,
+		STATE_MATERIAL,
+		STATE_COUNT
+	};
+
+	// constructor
+	RenderQueue();
+
+	// build the key of a draw - mesh below 16383, texture from -1
+	// (untextured) below 4094 and material below 4095, any value
+	// past these sharing its field's last value
+	static uint64_t MakeKey(PASS pass, int mesh, int texture, int material, float depth);
+
+	// remove every draw
+	void Clear();
+	// add a draw, item is handed back in drawing order
+	void Push(uint64_t key, unsigned int item);
+	// make room for count draws and set the draw at an index -
+	// draws at different indices can be set from different
+	// threads
+	void Resize(size_t count);
+	void Set(size_t index, uint64_t key, unsigned int item);
+	// put the draws in key order
+	void Sort();
+
+	// number of draws and the item and key of the draw at an
+	// index, in sorted order after Sort()
+	size_t GetCount() const;
+	unsigned int GetItem(size_t index) const;
+	uint64_t GetKey(size_t index) const;
+
+	// changes of a state between neighbouring draws in the
+	// order they were pushed, and after the last Sort()
+	unsigned int GetSubmittedChanges(STATE state) const;
+	unsigned int GetSortedChanges(STATE state) const;
+
+private:
+	struct ENTRY
+	{
+		uint64_t key;
+		unsigned int item;
+	};
+
+	std::vector<ENTRY> m_entries;
+	// the other half of every radix pass, kept to reuse its
+	// memory
+	std::vector<ENTRY> m_scratch;
+
+	unsigned int m_submittedChanges[STATE_COUNT];
+	unsigned int m_sortedChanges[STATE_COUNT];
+
+	// count the state changes between neighbouring entries
+	void CountChanges(unsigned int changes[STATE_COUNT]) const;
+};
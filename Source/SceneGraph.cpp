@@ -0,0 +1,333 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenegraph.cpp
+// ============
+// parent and child transforms for objects drawn as groups of meshes
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneGraph.h"
+
+#include <cassert>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	// relative difference allowed between the lengths of the
+	// axes of a uniformly scaled matrix, and in how far they are
+	// from square to one another
+	const float g_UniformScaleTolerance = 1.0e-5f;
+
+	/***********************************************************
+	 *  IsUniformScale()
+	 *
+	 *  Check whether the upper 3x3 of a matrix is a rotation, or
+	 *  a reflection, times the same scale on every axis.  Its
+	 *  columns are then square to one another and of the same
+	 *  length, and its inverse transpose is itself divided by
+	 *  the scale squared.
+	 ***********************************************************/
+	bool IsUniformScale(const glm::mat4& matrix)
+	{
+		glm::vec3 x = glm::vec3(matrix[0][0], matrix[0][1], matrix[0][2]);
+		glm::vec3 y = glm::vec3(matrix[1][0], matrix[1][1], matrix[1][2]);
+		glm::vec3 z = glm::vec3(matrix[2][0], matrix[2][1], matrix[2][2]);
+		float xx = glm::dot(x, x);
+		float yy = glm::dot(y, y);
+		float zz = glm::dot(z, z);
+		float tolerance = g_UniformScaleTolerance * xx;
+
+		return((xx > 0.0f) &&
+			(std::fabs(yy - xx) <= tolerance) &&
+			(std::fabs(zz - xx) <= tolerance) &&
+			(std::fabs(glm::dot(x, y)) <= tolerance) &&
+			(std::fabs(glm::dot(y, z)) <= tolerance) &&
+			(std::fabs(glm::dot(z, x)) <= tolerance));
+	}
+}
+
+/***********************************************************
+ *  SceneGraph()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneGraph::SceneGraph(TransformStore* pLocalTransforms)
+{
+	m_pLocalTransforms = pLocalTransforms;
+	m_updated = 0;
+	m_lastUpdated = 0;
+	m_totalUpdated = 0;
+	m_totalInverted = 0;
+}
+
+/***********************************************************
+ *  AddNode()
+ *
+ *  This method is used for adding a node with an identity
+ *  local transform below a parent node.  The new node's
+ *  world matrix is dirty until it is first asked for.
+ ***********************************************************/
+int SceneGraph::AddNode(int parent)
+{
+	int node = m_pLocalTransforms->Add();
+
+	m_parents.push_back(parent);
+	m_firstChildren.push_back(-1);
+	m_nextSiblings.push_back(-1);
+	m_worldMatrices.push_back(glm::mat4(1.0f));
+	m_worldDirty.push_back(1);
+	m_normalMatrices.push_back(glm::mat3(1.0f));
+	m_uniformScale.push_back(1);
+
+	if (parent >= 0)
+	{
+		m_nextSiblings[node] = m_firstChildren[parent];
+		m_firstChildren[parent] = node;
+	}
+
+	return(node);
+}
+
+/***********************************************************
+ *  SetLocalTransform()
+ *
+ *  This method is used for setting the transform of a node
+ *  relative to its parent.  Only a change marks the world
+ *  matrices of the node and its descendants dirty.
+ ***********************************************************/
+void SceneGraph::SetLocalTransform(
+	int node,
+	const glm::vec3& scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	const glm::vec3& positionXYZ)
+{
+	if (m_pLocalTransforms->SetTransform(node, scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ))
+	{
+		MarkSubtreeDirty(node);
+	}
+}
+
+/***********************************************************
+ *  MarkSubtreeDirty()
+ *
+ *  This method is used for marking the world matrix of a
+ *  node and of every node below it dirty.  A node that is
+ *  already dirty has a dirty subtree too, since a world
+ *  matrix is only recomputed after its parent's, so the
+ *  walk stops there.
+ ***********************************************************/
+void SceneGraph::MarkSubtreeDirty(int node)
+{
+	m_markStack.clear();
+	m_markStack.push_back(node);
+
+	while (!m_markStack.empty())
+	{
+		int current = m_markStack.back();
+		m_markStack.pop_back();
+		if (m_worldDirty[current] && (current != node))
+		{
+			continue;
+		}
+		m_worldDirty[current] = 1;
+
+		for (int child = m_firstChildren[current]; child >= 0; child = m_nextSiblings[child])
+		{
+			m_markStack.push_back(child);
+		}
+	}
+}
+
+/***********************************************************
+ *  GetWorldMatrix()
+ *
+ *  This method returns the world matrix of a node.  When it
+ *  is dirty the dirty nodes above it are recomputed first,
+ *  from the top down.
+ ***********************************************************/
+const glm::mat4& SceneGraph::GetWorldMatrix(int node)
+{
+	if (m_worldDirty[node])
+	{
+		int parent = m_parents[node];
+		if ((parent >= 0) && m_worldDirty[parent])
+		{
+			GetWorldMatrix(parent);
+		}
+		UpdateWorldMatrix(node);
+	}
+	return(m_worldMatrices[node]);
+}
+
+/***********************************************************
+ *  GetCachedWorldMatrix()
+ *
+ *  This method returns the world matrix of a node as it was
+ *  last computed.  The node must not be dirty, as nothing is
+ *  recomputed here - it only reads, so worker threads may
+ *  call it while the graph is not being changed.
+ ***********************************************************/
+const glm::mat4& SceneGraph::GetCachedWorldMatrix(int node) const
+{
+	assert(!m_worldDirty[node]);
+	return(m_worldMatrices[node]);
+}
+
+/***********************************************************
+ *  GetNormalMatrix()
+ *
+ *  This method returns the normal matrix of a node, found
+ *  along with its world matrix.
+ ***********************************************************/
+const glm::mat3& SceneGraph::GetNormalMatrix(int node)
+{
+	GetWorldMatrix(node);
+	return(m_normalMatrices[node]);
+}
+
+/***********************************************************
+ *  HasUniformScale()
+ *
+ *  This method returns true when the world matrix of a node
+ *  scales every axis the same.
+ ***********************************************************/
+bool SceneGraph::HasUniformScale(int node)
+{
+	GetWorldMatrix(node);
+	return(m_uniformScale[node] != 0);
+}
+
+/***********************************************************
+ *  UpdateWorldMatrices()
+ *
+ *  This method is used for recomputing every dirty world
+ *  matrix.  The changed local matrices are composed in one
+ *  batch, then the nodes are walked in index order, which
+ *  always reaches a parent before its children.
+ ***********************************************************/
+void SceneGraph::UpdateWorldMatrices()
+{
+	m_pLocalTransforms->UpdateMatrices();
+
+	for (size_t node = 0; node < m_worldDirty.size(); node++)
+	{
+		if (m_worldDirty[node])
+		{
+			UpdateWorldMatrix((int)node);
+		}
+	}
+}
+
+/***********************************************************
+ *  UpdateWorldMatrix()
+ *
+ *  This method is used for recomputing the world matrix of
+ *  a node from its parent's and its own local matrix, and
+ *  its normal matrix unless it has a uniform scale.
+ ***********************************************************/
+void SceneGraph::UpdateWorldMatrix(int node)
+{
+	int parent = m_parents[node];
+	if (parent >= 0)
+	{
+		m_worldMatrices[node] = m_worldMatrices[parent] * m_pLocalTransforms->GetMatrix(node);
+	}
+	else
+	{
+		m_worldMatrices[node] = m_pLocalTransforms->GetMatrix(node);
+	}
+
+	m_uniformScale[node] = IsUniformScale(m_worldMatrices[node]) ? 1 : 0;
+	if (!m_uniformScale[node])
+	{
+		m_normalMatrices[node] = glm::transpose(glm::inverse(glm::mat3(m_worldMatrices[node])));
+		m_totalInverted++;
+	}
+	m_worldDirty[node] = 0;
+	m_updated++;
+	m_totalUpdated++;
+}
+
+/***********************************************************
+ *  GetParent()
+ *
+ *  This method returns the parent of a node, or -1.
+ ***********************************************************/
+int SceneGraph::GetParent(int node) const
+{
+	return(m_parents[node]);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every node, along with
+ *  the local transforms in the transform store.
+ ***********************************************************/
+void SceneGraph::Clear()
+{
+	m_pLocalTransforms->Clear();
+	m_parents.clear();
+	m_firstChildren.clear();
+	m_nextSiblings.clear();
+	m_worldMatrices.clear();
+	m_worldDirty.clear();
+	m_normalMatrices.clear();
+	m_uniformScale.clear();
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method returns the number of nodes.
+ ***********************************************************/
+int SceneGraph::GetCount() const
+{
+	return((int)m_parents.size());
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for keeping the count of the frame
+ *  that just ended and starting a new one.
+ ***********************************************************/
+void SceneGraph::BeginFrame()
+{
+	m_lastUpdated = m_updated;
+	m_updated = 0;
+}
+
+/***********************************************************
+ *  GetUpdatedCount()
+ *
+ *  This method returns the world matrices recomputed during
+ *  the last frame.
+ ***********************************************************/
+unsigned int SceneGraph::GetUpdatedCount() const
+{
+	return(m_lastUpdated);
+}
+
+/***********************************************************
+ *  GetTotalUpdatedCount()
+ *
+ *  This method returns the world matrices recomputed since
+ *  the scene graph was created.
+ ***********************************************************/
+unsigned long long SceneGraph::GetTotalUpdatedCount() const
+{
+	return(m_totalUpdated);
+}
+
+/***********************************************************
+ *  GetTotalInvertedCount()
+ *
+ *  This method returns the normal matrices found with an
+ *  inverse since the scene graph was created.
+ ***********************************************************/
+unsigned long long SceneGraph::GetTotalInvertedCount() const
+{
+	return(m_totalInverted);
+}
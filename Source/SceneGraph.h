@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenegraph.h
+// ============
+// parent and child transforms for objects drawn as groups of meshes
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TransformStore.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  SceneGraph
+ *
+ *  This class links the objects of a transform store into
+ *  a tree.  The transform store holds each node's local
+ *  transform, relative to its parent, and this class holds
+ *  the world matrix, the parent's world matrix times the
+ *  local one.
+ *
+ *  Changing a local transform marks the world matrices of
+ *  the node and everything below it dirty, and nothing
+ *  else, so moving a group only recomputes the matrices of
+ *  that group.  A dirty world matrix is recomputed the next
+ *  time it is asked for, or by UpdateWorldMatrices() for
+ *  every node at once.
+ *
+ *  Each world matrix has its normal matrix cached with it,
+ *  the inverse transpose of its upper 3x3.  When the matrix
+ *  scales every axis the same, the upper 3x3 itself points
+ *  normals the same way, so the inverse is skipped and the
+ *  node is flagged as having a uniform scale.
+ *
+ *  A parent always has a lower index than its children.
+ ***********************************************************/
+class SceneGraph
+{
+public:
+	// constructor, the local transforms are kept in the passed
+	// in transform store, one object per node
+	SceneGraph(TransformStore* pLocalTransforms);
+
+	// add a node below a parent, or a root node for -1,
+	// returning its index
+	int AddNode(int parent);
+	// set the local transform of a node, marking its world
+	// matrix and those below it dirty when it changed
+	void SetLocalTransform(
+		int node,
+		const glm::vec3& scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		const glm::vec3& positionXYZ);
+	// get the world matrix of a node, recomputing it and any
+	// dirty parents first
+	const glm::mat4& GetWorldMatrix(int node);
+	// get the world matrix of a node that is not dirty, without
+	// recomputing anything, so several threads can read it
+	const glm::mat4& GetCachedWorldMatrix(int node) const;
+	// get the normal matrix of a node, only valid when it does
+	// not have a uniform scale
+	const glm::mat3& GetNormalMatrix(int node);
+	// true when the world matrix of a node scales every axis the
+	// same, so its upper 3x3 transforms normals as it is
+	bool HasUniformScale(int node);
+	// recompute every dirty world matrix, composing the changed
+	// local matrices together first
+	void UpdateWorldMatrices();
+	// parent of a node, or -1 for a root node
+	int GetParent(int node) const;
+	// remove every node and every local transform
+	void Clear();
+	// number of nodes
+	int GetCount() const;
+
+	// start counting the world matrices of a new frame
+	void BeginFrame();
+	// world matrices recomputed during the last frame
+	unsigned int GetUpdatedCount() const;
+	// world matrices recomputed since the start
+	unsigned long long GetTotalUpdatedCount() const;
+	// normal matrices found with an inverse since the start, the
+	// other recomputed nodes had a uniform scale
+	unsigned long long GetTotalInvertedCount() const;
+
+private:
+	// local transforms, one object per node
+	TransformStore* m_pLocalTransforms;
+	// tree links of every node, -1 where there is none
+	std::vector<int> m_parents;
+	std::vector<int> m_firstChildren;
+	std::vector<int> m_nextSiblings;
+	// world matrix of every node, valid unless it is dirty
+	std::vector<glm::mat4> m_worldMatrices;
+	std::vector<unsigned char> m_worldDirty;
+	// normal matrix of every node and whether it was skipped
+	std::vector<glm::mat3> m_normalMatrices;
+	std::vector<unsigned char> m_uniformScale;
+	// nodes waiting to be marked dirty, kept to reuse
+	std::vector<int> m_markStack;
+
+	unsigned int m_updated;
+	unsigned int m_lastUpdated;
+	unsigned long long m_totalUpdated;
+	unsigned long long m_totalInverted;
+
+	// mark a node and everything below it dirty
+	void MarkSubtreeDirty(int node);
+	// recompute the world matrix of one node whose parent is
+	// already up to date
+	void UpdateWorldMatrix(int node);
+};
@@ -1,1714 +1,3525 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.cpp
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables
-namespace
-{
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager* pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
-
-
-	//texture collector
-	for (int i = 0; i < 16; i++) //limit number of textures
-	{
-		m_textureIDs[i].tag = "/0";
-		m_textureIDs[i].ID = -1;
-	}
-	m_loadedTextures = 0;
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
-	// override the opengl textures
-	DestroyGLTextures();
-}
-
-
-
-
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-
-
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	// matrix math for calculating the final model matrix
-	modelView = translation * rotationX * rotationY * rotationZ * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		// pass the model matrix into the shader
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		// pass the color values into the shader
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
-
-
-
-
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
-}
-
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
-
- /***********************************************************
-  *  LoadSceneTextures()
-  *
-  *  This method is used for preparing the 3D scene by loading
-  *  the shapes, textures in memory to support the 3D scene
-  *  rendering
-  ***********************************************************/
-void SceneManager::LoadSceneTextures() //todo update this block with textures
-{
-	/*** STUDENTS - add the code BELOW for loading the textures that ***/
-	/*** will be used for mapping to objects in the 3D scene. Up to  ***/
-	/*** 16 textures can be loaded per scene. Refer to the code in   ***/
-	/*** the OpenGL Sample for help.                                 ***/
-
-	bool bReturn = false;
-
-	bReturn = CreateGLTexture(
-		"textures/wood.jpg", "wood");
-	bReturn = CreateGLTexture(
-		"textures/candle.jpg", "candle");
-	bReturn = CreateGLTexture(
-		"textures/er.jpg", "er");
-	bReturn = CreateGLTexture(
-		"textures/flame.jpg", "flame");
-	bReturn = CreateGLTexture(
-		"textures/artbook.jpg", "artbook");
-	bReturn = CreateGLTexture(
-		"textures/hlartbook.jpg", "hlartbook");
-	bReturn = CreateGLTexture(
-		"textures/botwartbook.jpg", "botwartbook");
-	bReturn = CreateGLTexture(
-		"textures/drink.jpg", "drink");
-	bReturn = CreateGLTexture(
-		"textures/cantop.jpg", "cantop");
-	bReturn = CreateGLTexture(
-		"textures/botw_spine.jpg", "botw_spine");
-	bReturn = CreateGLTexture(
-		"textures/pages.jpg", "pages");
-	bReturn = CreateGLTexture(
-		"textures/y_paint.jpg", "y_paint");
-	bReturn = CreateGLTexture(
-		"textures/b_paint.jpg", "b_paint");
-	bReturn = CreateGLTexture(
-		"textures/r_paint.jpg", "r_paint");
-	bReturn = CreateGLTexture(
-		"textures/erspine2.jpg", "erspine2");
-	bReturn = CreateGLTexture(
-		"textures/painting1.jpg", "painting1");
-	bReturn = CreateGLTexture(
-		"textures/curtain_test.jpg", "curtain");
-	bReturn = CreateGLTexture(
-		"textures/w_paint.jpg", "w_paint");
-	bReturn = CreateGLTexture(
-		"textures/headphones.jpg", "headphones");
-	bReturn = CreateGLTexture(
-		"textures/pbhandle.jpg", "pbhandle");
-
-
-
-	// after the texture image data is loaded into memory, the
-	// loaded textures need to be bound to texture slots - there
-	// are a total of 16 available slots for scene textures
-	BindGLTextures();
-}
-
-
-
-
-
-/***********************************************************
- *  DefineObjectMaterials()
- *
- *  This method is used for configuring the various material
- *  settings for all of the objects within the 3D scene.
- ***********************************************************/
-void SceneManager::DefineObjectMaterials()
-{
-	OBJECT_MATERIAL goldMaterial;
-	goldMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	goldMaterial.ambientStrength = 0.3f;
-	goldMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	goldMaterial.specularColor = glm::vec3(0.05f, 0.05f, 0.05f); //adjust shine to be less harsh
-	goldMaterial.shininess = 22.0;
-	goldMaterial.tag = "metal";
-
-	m_objectMaterials.push_back(goldMaterial);
-
-	OBJECT_MATERIAL woodMaterial;
-	woodMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	woodMaterial.ambientStrength = 0.2f;
-	woodMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	woodMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	woodMaterial.shininess = 0.3;
-	woodMaterial.tag = "wood";
-
-	m_objectMaterials.push_back(woodMaterial);
-
-	OBJECT_MATERIAL glassMaterial;
-	glassMaterial.ambientColor = glm::vec3(0.4f, 0.4f, 0.4f);
-	glassMaterial.ambientStrength = 0.3f;
-	glassMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	glassMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.6f);
-	glassMaterial.shininess = 85.0;
-	glassMaterial.tag = "glass";
-
-	m_objectMaterials.push_back(glassMaterial);
-
-
-	OBJECT_MATERIAL backdropMaterial;
-	backdropMaterial.ambientColor = glm::vec3(0.6f, 0.6f, 0.6f);
-	backdropMaterial.ambientStrength = 0.6f;
-	backdropMaterial.diffuseColor = glm::vec3(0.6f, 0.5f, 0.1f);
-	backdropMaterial.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
-	backdropMaterial.shininess = 0.0;
-	backdropMaterial.tag = "backdrop";
-
-}
-
-
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
-}
-
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
-}
-
-
-
-/***********************************************************
- *  SetupSceneLights()
- *
- *  This method is called to add and configure the light
- *  sources for the 3D scene.  There are up to 4 light sources.
- ***********************************************************/
-void SceneManager::SetupSceneLights()
-{
-	// this line of code is NEEDED for telling the shaders to render 
-	// the 3D scene with custom lighting - to use the default rendered 
-	// lighting then comment out the following line
-	m_pShaderManager->setBoolValue(g_UseLightingName, true);
-
-	//overhead lamp with wider reach and neutral/slightly warm toned light
-	m_pShaderManager->setVec3Value("lightSources[0].position", -8.0f, 6.0f, 2.0f);
-	m_pShaderManager->setVec3Value("lightSources[0].ambientColor", 0.65f, 0.55f, 0.35f);
-	m_pShaderManager->setVec3Value("lightSources[0].diffuseColor", 0.25f, 0.25f, 0.25f);
-	m_pShaderManager->setVec3Value("lightSources[0].specularColor", 0.55f, 0.55f, 0.55f);
-	m_pShaderManager->setFloatValue("lightSources[0].focalStrength", 35.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].specularIntensity", 5.50f);
-
-	
-	// light from candle, smaller, specular with a warmer tone
-	m_pShaderManager->setVec3Value("lightSources[1].position", 17.0f, 2.15f, 5.0f);
-	m_pShaderManager->setVec3Value("lightSources[1].ambientColor", 0.25f, 0.25f, 0.25f);
-	m_pShaderManager->setVec3Value("lightSources[1].diffuseColor", 0.95f, 0.85f, 0.35f);
-	m_pShaderManager->setVec3Value("lightSources[1].specularColor", 0.95f, 0.85f, 0.35f);
-	m_pShaderManager->setFloatValue("lightSources[1].focalStrength", 20.0f);
-	m_pShaderManager->setFloatValue("lightSources[1].specularIntensity", 15.0f);
-
-	/*m_pShaderManager->setVec3Value("lightSources[2].position", 0.0f, 3.0f, 20.0f);
-	m_pShaderManager->setVec3Value("lightSources[2].ambientColor", 0.2f, 0.2f, 0.2f);
-	m_pShaderManager->setVec3Value("lightSources[2].diffuseColor", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setVec3Value("lightSources[2].specularColor", 0.0f, 0.0f, 0.0f);
-	m_pShaderManager->setFloatValue("lightSources[2].focalStrength", 12.0f);
-	m_pShaderManager->setFloatValue("lightSources[2].specularIntensity", 0.2f);*/
-}
-
-
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-	LoadSceneTextures();
-
-	// define the materials that will be used for the objects
-	// in the 3D scene
-	DefineObjectMaterials();
-	// add and defile the light sources for the 3D scene
-	SetupSceneLights();
-
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-
-	m_basicMeshes->LoadPlaneMesh();
-	//load additional shape meshes for replicating the 2D image
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadTorusMesh();
-	m_basicMeshes->LoadConeMesh();
-	m_basicMeshes->LoadBoxMesh();
-	//m_basicMeshes->LoadTapperedCylinder();
-	m_basicMeshes->LoadPrismMesh();
-	m_basicMeshes->LoadPyramid3Mesh();
-	m_basicMeshes->LoadPyramid4Mesh();
-	m_basicMeshes->LoadTaperedCylinderMesh();
-}
-
-
-
-
-// function for candle to make moving it around easier
-void SceneManager::RenderCandle(glm::vec3 scaleXYZ,
-								float XrotationDegrees,
-								float YrotationDegrees,
-								float ZrotationDegrees,
-								glm::vec3 positionXYZ)
-{
-	// **** TORUS: Candle Jar ************************************************************************** DONE!
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw candle jar
-	SetShaderColor(0.95, 0.80, 0.55, 0.98f);
-	//SetShaderTexture("candle");
-	SetShaderMaterial("wood"); //frosted glass reflects more like wood, not super shiny
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawTorusMesh(); //Candle jar
-
-
-	// **** CYLINDER: Candle Wax ************************************************************************* DONE!
-	const glm::vec3 waxOffsetXYZ = glm::vec3(0.0f, -0.90f, 0.0f);
-	//set scale
-	scaleXYZ = glm::vec3(1.48, 1.45, 1.48); //inset and shorter than jar
-	//rotation
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ + waxOffsetXYZ); // move inside the torus (candle jar)
-	//set color and draw wax
-	//SetShaderColor(0.70, 0.65, 0.65, 1.0f); // lighter cream almost white color
-	SetShaderTexture("candle");
-	SetShaderMaterial("glass");
-	m_basicMeshes->DrawCylinderMesh(); // Cyl 2
-
-
-	// **** CYLINDER: Wick #1 ************************************************************************* Done!
-	const glm::vec3 wickOneOffsetXYZ = glm::vec3(-0.6f, -0.30f, 0.0f);
-	// set scale
-	scaleXYZ = glm::vec3(0.05, 1.20, 0.05);
-	//rotation
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ + wickOneOffsetXYZ);
-	//set color and draw wick
-	SetShaderColor(0.40, 0.25f, 0.11f, 1.0f); // dark brown
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh();
-
-
-
-	// **** CYLINDER: Wick #2 ************************************************************************* DONE!
-	const glm::vec3 wickTwoOffsetXYZ = glm::vec3(0.55f, -0.30f, -0.25f);
-	// set scale
-	scaleXYZ = glm::vec3(0.05, 1.20, 0.05);
-	//rotation
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ + wickTwoOffsetXYZ);
-	//set color and draw wick
-	SetShaderColor(0.40, 0.25f, 0.11f, 1.0f); // dark brown
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh();
-
-
-	// **** CYLINDER: Wick #3 ************************************************************************* DONE!
-	const glm::vec3 wickThreeOffsetXYZ = glm::vec3(0.10f, -0.30f, 0.6f);
-	// set scale
-	scaleXYZ = glm::vec3(0.05, 1.20, 0.05);
-	//rotation
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ + wickThreeOffsetXYZ);
-	//set color and draw wick
-	SetShaderColor(0.40, 0.25f, 0.11f, 1.0f); // dark brown
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh();
-
-
-	//  **** Flame #1 *********************************************************************************
-	const glm::vec3 flameOneOffsetXYZ = glm::vec3(-0.60f, 0.70f, 0.0f);
-	// set scale and check
-	scaleXYZ = glm::vec3(0.15f, 0.55f, 0.10f); //
-	//rotation not needed for this shape right now
-	XrotationDegrees = 0.0f;//make flame uniquely tilt a bit
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ + flameOneOffsetXYZ);
-
-	//set texture and draw
-	SetShaderTexture("flame");
-	SetShaderMaterial("glass");
-	SetTextureUVScale(3.0, 2.0);
-	m_basicMeshes->DrawConeMesh(); // cone
-
-
-	//  **** Flame #2 *********************************************************************************
-	const glm::vec3 flameTwoOffsetXYZ = glm::vec3(0.55f, 0.70f, -0.25f);
-	// set scale and check
-	scaleXYZ = glm::vec3(0.15f, 0.55f, 0.10f); //
-	//rotation not needed for this shape right now
-	XrotationDegrees = 0.0f;//make flame uniquely tilt a bit
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ + flameTwoOffsetXYZ);
-
-	//set texture and draw
-	SetShaderTexture("flame");
-	SetShaderMaterial("glass");
-	SetTextureUVScale(3.0, 2.0);
-	m_basicMeshes->DrawConeMesh(); // cone
-
-
-	//  **** Flame #3 *********************************************************************************
-	const glm::vec3 flameThreeOffsetXYZ = glm::vec3(0.10f, 0.70f, 0.6f);
-	// set scale and check
-	scaleXYZ = glm::vec3(0.15f, 0.55f, 0.10f); //
-	//rotation not needed for this shape right now
-	XrotationDegrees = 0.0f;//make flame uniquely tilt a bit
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ + flameThreeOffsetXYZ);
-
-	//set texture and draw
-	SetShaderTexture("flame");
-	SetShaderMaterial("glass");
-	SetTextureUVScale(3.0, 2.0);
-	m_basicMeshes->DrawConeMesh(); // cone
-
-	
-}
-
-
-
-// TODO: Complete RenderHeadphones function
-void SceneManager::RenderHeadphones()
-{
-
-}
-
-
-// TODO: Complete RenderController function
-void SceneManager::RenderController()
-{
-
-}
-
-// TODO: Complete RenderDrink function
-void SceneManager::RenderDrink(glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// ******************************************************************************   DRINK ******************************************************************************
-	// main can
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	// Set texture and shader and  draw
-	//SetShaderColor(0.92, 0.55, 0.84, 1); //set to blue
-	SetShaderTexture("drink");
-	SetShaderMaterial("metal");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawCylinderMesh();
-
-	// set the XYZ scale for the mesh                 ************** can top *************
-	scaleXYZ = glm::vec3(1.025f, 0.025f, 1.025f);
-	// set the XYZ rotation for the mesh
-	const glm::vec3 topOffsetXYZ = glm::vec3(0.0f, 5.00f, 0.0f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 80.0f;
-	ZrotationDegrees = 0.0f;
-	//// set the XYZ position for the mesh
-	//positionXYZ = glm::vec3(0.0f, 5.02f, 10.0f);
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ + topOffsetXYZ);
-	// Set texture and shader and  draw
-	SetShaderTexture("cantop");
-	SetShaderMaterial("metal");
-	SetTextureUVScale(0.8, 0.90);
-	m_basicMeshes->DrawCylinderMesh();
-}
-
-
-void SceneManager::RenderPaintTube(glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ,
-	const char* textureName)
-
-{
-
-	// ******************************************************************************   TUBE ******************************************************************************
-	scaleXYZ = glm::vec3(0.55f, 5.0f, 0.55f);
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture(textureName);
-	SetShaderMaterial("metal");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawCylinderMesh();
-
-	// ******************************************************************************   CAP ******************************************************************************
-	scaleXYZ = glm::vec3(0.45f, 0.25f, 0.45f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	// Adjust position with offset
-	const glm::vec3 capOffsetXYZ = glm::vec3(0.0f, -5.45f, 0.0f);
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ + capOffsetXYZ);
-	SetShaderTexture("pages");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(0.014, 0.014);
-	m_basicMeshes->DrawCylinderMesh();
-
-	// ******************************************************************************   CAP NECK ******************************************************************************
-	scaleXYZ = glm::vec3(0.2f, 0.2f, 0.2f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	// Adjust position with offset
-	const glm::vec3 neckOffsetXYZ = glm::vec3(0.0f, -5.2f, 0.0f);
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ + neckOffsetXYZ);
-	SetShaderTexture("pages");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(0.01, 0.01);
-	m_basicMeshes->DrawCylinderMesh();
-	
-
-	////original positions for offsets
-	//positionXYZ = glm::vec3(7.0f, 5.5f, 3.0f); //tube
-	//positionXYZ = glm::vec3(7.0f, 0.3f, 3.0f); //cap
-	//positionXYZ = glm::vec3(7.0f, 0.5f, 3.0f); //neck
-}
-
-
-
-
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-void SceneManager::RenderScene()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-
-	RenderCandle(glm::vec3(1.5f, 1.5f, 5.0f),	//scale		*Torus/Jar only*
-				90.0f, 0.0f, 0.0f,				//rotation	*Torus/Jar only
-				glm::vec3(17.0f, 1.0f, 5.0f ));	//position	All meshes in candle
-
-
-	RenderDrink(glm::vec3(1.0f, 5.0f, 1.0f),		//scale		*Cylinder/Can base only*
-				0.0f, 125.0f, 0.0f,					//rotation	*Cylinder/Can base only
-				glm::vec3(-16.0f, 0.01f, 10.0f));	//position	All meshes in drink
-
-	RenderPaintTube(glm::vec3(0.55f, 5.0f, 0.55f),		//scale		*Cylinder/Can base only*
-					180.0f, 200.0f, 0.0f,				//rotation	*Cylinder/Can base only
-					glm::vec3(7.50f, 5.5f, 3.0f),		//position	All meshes
-					"r_paint");
-
-	RenderPaintTube(glm::vec3(0.55f, 5.0f, 0.55f),		//scale		base only*
-					180.0f, 200.0f, 0.0f,				//rotation	base only
-					glm::vec3(9.5f, 5.5f, 2.5f),		//position	All meshes
-					"y_paint");
-
-	RenderPaintTube(glm::vec3(0.55f, 5.0f, 0.55f),		//scale		base only*
-					180.0f, 200.0f, 0.0f,				//rotation	base only
-					glm::vec3(11.0f, 5.5f, 3.75f),		//position	All meshes in drink
-					"b_paint");
-		 
-	
-//DESK ******************************************************************************
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(25.0f, -40.0f, 10.0f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 0.0f, 5.0f);
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	// set texture and draw
-	SetShaderTexture("wood"); 
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawPlaneMesh();
-	
-
-//WALL ******************************************************************************
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(50.0f, 100.0f, -20.0f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 10.0f, -2.0f);
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	// Set texture and  draw
-	//SetShaderColor(0.42, 0.55, 0.84, 1); //set to blue
-	SetShaderTexture("curtain");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(6.0, 1.0);
-	m_basicMeshes->DrawPlaneMesh();
-
-
-// ************************************************************* Single ROTATED paint tube ************************************************************* 
-	
-	// ********************************************   TUBE ********************************************
-	scaleXYZ = glm::vec3(0.55f, 5.0f, 0.55f);
-	//rotation
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 60.0f;
-	//position
-	positionXYZ = glm::vec3(8.95f, 0.75f, 5.0f); 
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture("w_paint"); //TODO - create and add white lable texture
-	SetShaderMaterial("metal");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawCylinderMesh(false, true, true);
-
-	// ********************************************   CAP ********************************************
-	scaleXYZ = glm::vec3(0.45f, 0.3f, 0.45f);
-	//rotation
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 60.0f;
-	//position 
-	positionXYZ = glm::vec3(4.35f, 0.75f, 7.65f);
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture("pages");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(0.014, 0.014);
-	m_basicMeshes->DrawCylinderMesh();
-
-	// ******************************************** CAP NECK ********************************************
-	scaleXYZ = glm::vec3(0.2f, 0.4f, 0.2f);
-	//rotation
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 60.0f;
-	//position 
-	positionXYZ = glm::vec3(4.65f, 0.75f, 7.45f);
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture("pages");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(0.01, 0.01);
-	m_basicMeshes->DrawCylinderMesh();
-
-
-
-// ****************************************************************************************************** BOOKS ******************************************************************************************************    
-
-// **** Book 1 ******************************************************************************
-	// set scale and check
-	scaleXYZ = glm::vec3(8.0f, 10.5f, 0.50f);
-	//rotation
-	XrotationDegrees = 90.0f; 
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 65.0f;
-	// set and check position 
-	positionXYZ = glm::vec3(-9.0f, 0.40f, 5.0f); 
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture of book 1
-	SetShaderTexture("artbook");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawBoxMesh(); // book 1
-
-
-// **** Book 2 ******************************************************************************
-	// set scale and check
-	scaleXYZ = glm::vec3(8.0f, 12.5f, 0.65f);//same for all books
-	//rotation not needed for this shape right now
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 70.0f;
-	// set position 
-	positionXYZ = glm::vec3(-9.0f, 1.0f, 4.5f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("hlartbook");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawBoxMesh(); // book 2
-
-
-// **** Book 3 ******************************************************************************
-	// set scale and check
-	scaleXYZ = glm::vec3(8.0f, 10.0f, 1.25f);//same for all books
-	//rotation not needed for this shape right now
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 70.0f;
-	// set position 
-	positionXYZ = glm::vec3(-9.0f, 1.90f, 4.0f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ); 
-	//set texture and draw
-	SetShaderTexture("botwartbook");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawBoxMesh(); // book 3
-
-	//spine
-	// set scale and check
-	scaleXYZ = glm::vec3(10.0f, 0.25f, 1.25f);//same for all books
-	//rotation not needed for this shape right now
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -20.0f;
-	// set position 
-	positionXYZ = glm::vec3(-7.60f, 1.90f, 7.85f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("botw_spine");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawBoxMesh();
-
-	//pages- top
-	// set scale and check
-	scaleXYZ = glm::vec3(7.8f, 0.20f, 1.15f);
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -110.0f;
-	// set position 
-	positionXYZ = glm::vec3(-13.60f, 1.90f, 5.75f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("pages");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(0.3, 0.3);
-	m_basicMeshes->DrawBoxMesh();
-	//pages - bottom
-	// set scale and check
-	scaleXYZ = glm::vec3(7.8f, 0.20f, 1.15f);
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -110.0f;
-	// set position 
-	positionXYZ = glm::vec3(-4.30f, 1.90f, 2.45f); 
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("pages");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(0.3, 0.3);
-	m_basicMeshes->DrawBoxMesh();
-	//pages-side
-	// set scale and check
-	scaleXYZ = glm::vec3(10.02f, 0.25f, 1.15f);
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -200.0f;
-	// set position 
-	positionXYZ = glm::vec3(-10.35f, 1.90f, 0.30f);	//**********************
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("pages");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(0.3, 0.3);
-	m_basicMeshes->DrawBoxMesh();
-	
-
-
-// **** Book 4 ******************************************************************************
-	// set scale and check
-	scaleXYZ = glm::vec3(8.0f, 10.0f, 1.0f);//same for all booksd
-	//rotation not needed for this shape right now
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 75.5f;
-	// set position 
-	positionXYZ = glm::vec3(-8.950f, 3.10f, 3.85f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("er");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawBoxMesh(); // book 4
-
-	//pages- top
-	// set scale and check
-	scaleXYZ = glm::vec3(7.8f, 0.20f, 0.90f);
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 75.5f;
-	// set position 
-	positionXYZ = glm::vec3(-13.78f, 3.10f, 5.0f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("pages");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(0.3, 0.3);
-	m_basicMeshes->DrawBoxMesh();
-	
-	//pages - bottom
-	// set scale and check
-	scaleXYZ = glm::vec3(7.8f, 0.20f, 0.9f);
-	XrotationDegrees = 90.0f; 
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 75.5f;
-	// set position 
-	positionXYZ = glm::vec3(-4.22, 3.10f, 2.5f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("pages");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(0.3, 0.3);
-	m_basicMeshes->DrawBoxMesh();
-	
-	//pages-side
-	// set scale and check
-	scaleXYZ = glm::vec3(10.02f, 0.25f, 0.90f);
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -14.50;
-	// set position 
-	positionXYZ = glm::vec3(-9.99f, 3.10f, 0.08f);	//**********************
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("pages");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(0.3, 0.3);
-	m_basicMeshes->DrawBoxMesh();
-
-	//spine
-	// set scale and check
-	scaleXYZ = glm::vec3(10.0f, 0.25f, 0.98f);//same for all books
-	//rotation not needed for this shape right now
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -15.0f;
-	// set position 
-	positionXYZ = glm::vec3(-7.98f, 3.10f, 7.65f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("erspine2");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawBoxMesh();
-	
-
-// ******************************************************************************************************    TODO: canvas painting (box) ******************************************************************************************************
-//	
-// 	//Canvas
-	// set scale and check
-	scaleXYZ = glm::vec3(5.0f, 3.5f, 0.4f);
-	XrotationDegrees = -20.0;
-	YrotationDegrees = 0.0;
-	ZrotationDegrees = -0.0;
-	// set position 
-	positionXYZ = glm::vec3(2.25, 1.75, 4.5);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("painting1");
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawBoxMesh();
-
-	//pic standd
-	//****************************************************************
-	// set scale and check
-	scaleXYZ = glm::vec3(0.50f, 0.3f, 1.0f);
-	XrotationDegrees = -20.0;
-	YrotationDegrees = 0.0;
-	ZrotationDegrees = -0.0;
-	// set position 
-	positionXYZ = glm::vec3(0.80, 0.0, 5.0);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderColor(0.52f, 0.4f, 0.24f, 1.0f);
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawBoxMesh();
-	//****************************************************************
-	// set scale and check
-	scaleXYZ = glm::vec3(0.50f, 0.3f, 1.0f);
-	XrotationDegrees = -20.0;
-	YrotationDegrees = 0.0;
-	ZrotationDegrees = -0.0;
-	// set position 
-	positionXYZ = glm::vec3(3.80, 0.0, 5.0);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderColor(0.52f, 0.4f, 0.24f, 1.0f);
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawBoxMesh();
-	//****************************************************************
-	// set scale and check
-	scaleXYZ = glm::vec3(0.50f, 4.40f, 1.0f);
-	XrotationDegrees = -20.0;
-	YrotationDegrees = 0.0;
-	ZrotationDegrees = 0.0;
-	// set position 
-	positionXYZ = glm::vec3(3.80, 2.0, 3.5);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderColor(0.52f, 0.4f, 0.24f, 1.0f);
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawBoxMesh();
-	//****************************************************************
-	// set scale and check
-	scaleXYZ = glm::vec3(0.50f, 4.40f, 1.0f);
-	XrotationDegrees = -20.0;
-	YrotationDegrees = 0.0;
-	ZrotationDegrees = 0.0;
-	// set position 
-	positionXYZ = glm::vec3(0.80, 2.0, 3.5);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderColor(0.52f, 0.4f, 0.24f, 1.0f);
-	SetShaderMaterial("wood");
-	SetTextureUVScale(1.0, 1.0);
-	m_basicMeshes->DrawBoxMesh();
-
-
-
-
-
-
-	// **********************************************************************   TODO: HEADPHONES   ********************************************************************** 
-
-// TODO: Create RenderHeadphones function
-	// *************************************************************** headband	
-	// set scale and check
-	scaleXYZ = glm::vec3(2.0f, 2.0f, 1.0f);
-	XrotationDegrees = 80.0;
-	YrotationDegrees = 10.0;
-	ZrotationDegrees = 120.0;
-	// set position 
-	positionXYZ = glm::vec3(-6.0, 0.55f, 11.4);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-//	SetShaderColor(0.77f, 0.68f, 0.60f, 1.0f);
-	SetShaderTexture("headphones");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawHalfTorusMesh();
-
-	// *************************************************************** L ear muff	
-	// set scale and check
-	scaleXYZ = glm::vec3(1.20f, 0.800f, 2.0f);
-	XrotationDegrees = 90.0;
-	YrotationDegrees = 0.0;
-	ZrotationDegrees = 20.0;
-	// set position 
-	positionXYZ = glm::vec3(-4.85, 0.50, 13.45);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("headphones");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawTorusMesh();
-
-	// *************************************************************** L Ear cap		
-	// set scale and check
-	//scaleXYZ = glm::vec3(0.90f, 0.250f, 0.65f);
-	scaleXYZ = glm::vec3(1.0f, 0.30f, 0.75f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = -20.0;
-	ZrotationDegrees = 0.0f;
-	// set position 
-	positionXYZ = glm::vec3(-4.85, 0.60, 13.45);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("headphones");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh();
-
-	// *************************************************************** R ear	
-	// set scale and check
-	scaleXYZ = glm::vec3(1.20f, 0.800f, 2.0f);
-	XrotationDegrees = 90.0;
-	YrotationDegrees = 0.0;
-	ZrotationDegrees = 40.0;
-	// set position 
-	positionXYZ = glm::vec3(-3.5, 0.50, 11.25);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("headphones");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawTorusMesh();
-
-
-	// ***************************************************************  R Ear cap
-	// set scale and check
-	//scaleXYZ = glm::vec3(1.0f, 0.30f, 0.75f);
-	scaleXYZ = glm::vec3(1.0f, 0.30f, 0.75f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = -40.0;
-	ZrotationDegrees = 0.0f;
-	// set position 
-	positionXYZ = glm::vec3(-3.5, 0.60, 11.25);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("headphones");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh();
-
-
-
-	// *************************************************************** headband to R Ear connector	
-	// set scale and check
-	scaleXYZ = glm::vec3(0.2f, 1.85f, 0.2f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = -50.0f;
-	ZrotationDegrees = -65.0f;
-	// set position 
-	positionXYZ = glm::vec3(-5.30, 0.15, 9.45);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("headphones");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh();
-
-
-// *************************************************************** headband to L Ear connector	
-	// set scale and check
-	scaleXYZ = glm::vec3(0.2f, 1.65f, 0.2f);
-
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = -5.0f;
-	ZrotationDegrees = -65.0f;
-	// set position 
-	positionXYZ = glm::vec3(-7.30, 0.35, 12.95);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("headphones");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh();
-
-
-
-
-// **********************************************************************   TODO: PAINTBRUSHES   ********************************************************************** 
-
-	// top pb
-	scaleXYZ = glm::vec3(0.10f, 6.0f, 0.10f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 25.0f;
-	ZrotationDegrees = 90.0f;
-	// set position 
-	positionXYZ = glm::vec3(13.7f, 0.250, 4.85f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("pbhandle");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh();
-	//top bristle
-	scaleXYZ = glm::vec3(0.10f, 1.0f, 0.10f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 25.0f;
-	ZrotationDegrees = 90.0f;
-	// set position 
-	positionXYZ = glm::vec3(8.25, 0.250, 7.38);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("candle");
-	//SetShaderMaterial("wood");
-	m_basicMeshes->DrawConeMesh();
-
-
-
-
-	// mid pb
-	scaleXYZ = glm::vec3(0.10f, 6.0f, 0.10f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-	// set position 
-	positionXYZ = glm::vec3(13.75f, 0.250, 4.85f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("pbhandle");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh();
-	//medium bristle
-	scaleXYZ = glm::vec3(0.10f, 1.0f, 0.10f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-	// set position 
-	positionXYZ = glm::vec3(8.55, 0.250, 7.85);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("candle");
-	//SetShaderMaterial("wood");
-	m_basicMeshes->DrawConeMesh();
-
-
-
-	// bottom pb
-	scaleXYZ = glm::vec3(0.10f, 6.0f, 0.10f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 35.0f;
-	ZrotationDegrees = 90.0f;
-	// set position 
-	positionXYZ = glm::vec3(13.7f, 0.250, 4.85f);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("pbhandle");
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh();
-	//bottom bristle
-	scaleXYZ = glm::vec3(0.10f, 1.0f, 0.10f);
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 35.0f;
-	ZrotationDegrees = 90.0f;
-	// set position 
-	positionXYZ = glm::vec3(8.80, 0.250, 8.30);
-	//set transformation
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//set texture and draw
-	SetShaderTexture("candle");
-	//SetShaderMaterial("wood");
-	m_basicMeshes->DrawConeMesh();
-
-
-
-
-
-
-
-
-}
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.cpp
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneManager.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+// declaration of global variables
+namespace
+{
+
+	// image files for the scene textures and the tags they are
+	// referenced by - the order here sets the texture slots
+	struct SCENE_TEXTURE
+	{
+		const char* filename;
+		const char* tag;
+	};
+	const SCENE_TEXTURE g_SceneTextures[] =
+	{
+		{ "textures/wood.jpg", "wood" },
+		{ "textures/candle.jpg", "candle" },
+		{ "textures/er.jpg", "er" },
+		{ "textures/flame.jpg", "flame" },
+		{ "textures/artbook.jpg", "artbook" },
+		{ "textures/hlartbook.jpg", "hlartbook" },
+		{ "textures/botwartbook.jpg", "botwartbook" },
+		{ "textures/drink.jpg", "drink" },
+		{ "textures/cantop.jpg", "cantop" },
+		{ "textures/botw_spine.jpg", "botw_spine" },
+		{ "textures/pages.jpg", "pages" },
+		{ "textures/y_paint.jpg", "y_paint" },
+		{ "textures/b_paint.jpg", "b_paint" },
+		{ "textures/r_paint.jpg", "r_paint" },
+		{ "textures/erspine2.jpg", "erspine2" },
+		{ "textures/painting1.jpg", "painting1" },
+		{ "textures/curtain_test.jpg", "curtain" },
+		{ "textures/w_paint.jpg", "w_paint" },
+		{ "textures/headphones.jpg", "headphones" },
+		{ "textures/pbhandle.jpg", "pbhandle" },
+	};
+	const int g_SceneTextureCount = sizeof(g_SceneTextures) / sizeof(g_SceneTextures[0]);
+
+	// the handle field RenderScene draws each texture tag with -
+	// a tag is only loaded when a recorded draw uses its field
+	struct SCENE_TEXTURE_HANDLE
+	{
+		const char* tag;
+		int SceneManager::SCENE_TEXTURES::* handle;
+	};
+	const SCENE_TEXTURE_HANDLE g_SceneTextureHandles[] =
+	{
+		{ "wood", &SceneManager::SCENE_TEXTURES::wood },
+		{ "candle", &SceneManager::SCENE_TEXTURES::candle },
+		{ "er", &SceneManager::SCENE_TEXTURES::er },
+		{ "flame", &SceneManager::SCENE_TEXTURES::flame },
+		{ "artbook", &SceneManager::SCENE_TEXTURES::artbook },
+		{ "hlartbook", &SceneManager::SCENE_TEXTURES::hlartbook },
+		{ "botwartbook", &SceneManager::SCENE_TEXTURES::botwartbook },
+		{ "drink", &SceneManager::SCENE_TEXTURES::drink },
+		{ "cantop", &SceneManager::SCENE_TEXTURES::cantop },
+		{ "botw_spine", &SceneManager::SCENE_TEXTURES::botwSpine },
+		{ "pages", &SceneManager::SCENE_TEXTURES::pages },
+		{ "y_paint", &SceneManager::SCENE_TEXTURES::yPaint },
+		{ "b_paint", &SceneManager::SCENE_TEXTURES::bPaint },
+		{ "r_paint", &SceneManager::SCENE_TEXTURES::rPaint },
+		{ "erspine2", &SceneManager::SCENE_TEXTURES::erSpine2 },
+		{ "painting1", &SceneManager::SCENE_TEXTURES::painting1 },
+		{ "curtain", &SceneManager::SCENE_TEXTURES::curtain },
+		{ "w_paint", &SceneManager::SCENE_TEXTURES::wPaint },
+		{ "headphones", &SceneManager::SCENE_TEXTURES::headphones },
+		{ "pbhandle", &SceneManager::SCENE_TEXTURES::pbHandle },
+	};
+	const int g_SceneTextureHandleCount = sizeof(g_SceneTextureHandles) / sizeof(g_SceneTextureHandles[0]);
+
+	// default bytes of texture pixels streamed in each frame
+	const size_t g_DefaultUploadBudget = 4 * 1024 * 1024;
+	// neutral grey shown while a texture is streaming in
+	const unsigned char g_PlaceholderPixel[4] = { 128, 128, 128, 255 };
+
+	// near duplicate images are compared as thumbnails of at most
+	// this many pixels on a side, which may differ by this much on
+	// average in each channel, then every pixel has to match to
+	// within this PSNR
+	const int g_ThumbnailSize = 16;
+	const int g_MaxThumbnailDifference = 4;
+	const double g_MinDuplicatePSNR = 38.0;
+
+	// recorded draws whose world bounds each job finds
+	const int g_DrawsPerJob = 64;
+
+	/***********************************************************
+	 *  FindSceneTextureHandle()
+	 *
+	 *  Return the index of the handle field of a texture tag,
+	 *  or -1 when RenderScene has no field for it.
+	 ***********************************************************/
+	int FindSceneTextureHandle(const char* tag)
+	{
+		for (int i = 0; i < g_SceneTextureHandleCount; i++)
+		{
+			if (strcmp(g_SceneTextureHandles[i].tag, tag) == 0)
+			{
+				return(i);
+			}
+		}
+		return(-1);
+	}
+
+	/***********************************************************
+	 *  FindIdenticalFiles()
+	 *
+	 *  Hash the contents of every requested image file.  Each
+	 *  request gets the index of the first request whose file
+	 *  has the same contents, or -1 if it is the first.  Files
+	 *  that cannot be read are never shared.
+	 ***********************************************************/
+	void FindIdenticalFiles(const std::vector<TextureLoader::TEXTURE_REQUEST>& requests, std::vector<int>& sharedWith)
+	{
+		std::unordered_map<uint64_t, int> firstRequests;
+		sharedWith.assign(requests.size(), -1);
+
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			uint64_t hash = 0;
+			if (TextureCache::HashFile(requests[i].filename, hash))
+			{
+				std::pair<std::unordered_map<uint64_t, int>::iterator, bool> inserted =
+					firstRequests.insert(std::make_pair(hash, (int)i));
+				if (!inserted.second)
+				{
+					sharedWith[i] = inserted.first->second;
+				}
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  MakeThumbnail()
+	 *
+	 *  Shrink RGBA pixels to a thumbnail of at most 16 by 16
+	 *  pixels, each the average of the block it covers.
+	 ***********************************************************/
+	void MakeThumbnail(const std::vector<unsigned char>& pixels, int width, int height, std::vector<unsigned char>& thumbnail)
+	{
+		int thumbnailWidth = std::min(width, g_ThumbnailSize);
+		int thumbnailHeight = std::min(height, g_ThumbnailSize);
+		thumbnail.assign((size_t)thumbnailWidth * thumbnailHeight * 4, 0);
+		for (int y = 0; y < thumbnailHeight; y++)
+		{
+			int firstRow = y * height / thumbnailHeight;
+			int lastRow = (y + 1) * height / thumbnailHeight;
+			for (int x = 0; x < thumbnailWidth; x++)
+			{
+				int firstColumn = x * width / thumbnailWidth;
+				int lastColumn = (x + 1) * width / thumbnailWidth;
+				uint64_t sums[4] = { 0, 0, 0, 0 };
+				for (int row = firstRow; row < lastRow; row++)
+				{
+					const unsigned char* pixel = &pixels[((size_t)row * width + firstColumn) * 4];
+					for (int column = firstColumn; column < lastColumn; column++, pixel += 4)
+					{
+						sums[0] += pixel[0];
+						sums[1] += pixel[1];
+						sums[2] += pixel[2];
+						sums[3] += pixel[3];
+					}
+				}
+				uint64_t count = (uint64_t)(lastRow - firstRow) * (lastColumn - firstColumn);
+				for (int channel = 0; channel < 4; channel++)
+				{
+					thumbnail[((size_t)y * thumbnailWidth + x) * 4 + channel] = (unsigned char)((sums[channel] + count / 2) / count);
+				}
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  IsNearDuplicate()
+	 *
+	 *  Check whether two images of the same size look the same.
+	 *  Their thumbnails are compared first, which rejects most
+	 *  different images cheaply, then every pixel, which has
+	 *  to match to within the noise of a re-encode.
+	 ***********************************************************/
+	bool IsNearDuplicate(
+		const std::vector<unsigned char>& firstThumbnail, const std::vector<unsigned char>& firstPixels,
+		const std::vector<unsigned char>& secondThumbnail, const std::vector<unsigned char>& secondPixels)
+	{
+		int thumbnailDifference = 0;
+		for (size_t i = 0; i < firstThumbnail.size(); i++)
+		{
+			thumbnailDifference += abs((int)firstThumbnail[i] - (int)secondThumbnail[i]);
+		}
+		if (thumbnailDifference > g_MaxThumbnailDifference * (int)firstThumbnail.size())
+		{
+			return(false);
+		}
+
+		uint64_t squaredError = 0;
+		for (size_t i = 0; i < firstPixels.size(); i++)
+		{
+			int difference = (int)firstPixels[i] - (int)secondPixels[i];
+			squaredError += (uint64_t)(difference * difference);
+		}
+		if (squaredError == 0)
+		{
+			return(true);
+		}
+		double meanSquaredError = (double)squaredError / (double)firstPixels.size();
+		return(10.0 * log10(255.0 * 255.0 / meanSquaredError) >= g_MinDuplicatePSNR);
+	}
+
+	/***********************************************************
+	 *  FindNearDuplicateImages()
+	 *
+	 *  Compare the pixels of the requested images that were not
+	 *  identical to an earlier file, so an image saved again
+	 *  or re-encoded still shares the texture of the first one.
+	 *  Only images of the same size are compared, and only
+	 *  those are read, from their cache files when they have
+	 *  one.  Requests already sharing a texture are moved onto
+	 *  the one their image is now shared with, and the number
+	 *  of near duplicates found is returned.
+	 ***********************************************************/
+	int FindNearDuplicateImages(const std::vector<TextureLoader::TEXTURE_REQUEST>& requests, std::vector<int>& sharedWith)
+	{
+		struct CANDIDATE
+		{
+			int request;
+			int width;
+			int height;
+		};
+
+		// group the images with a texture of their own by size
+		std::vector<CANDIDATE> candidates;
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			CANDIDATE candidate;
+			int colorChannels = 0;
+			TextureCompressor::FORMAT format = TextureCompressor::FORMAT_UNCOMPRESSED;
+			bool bTranslucent = false;
+			candidate.request = (int)i;
+			if ((sharedWith[i] < 0) &&
+				TextureLoader::ReadImageInfo(requests[i].filename, candidate.width, candidate.height, colorChannels, format, bTranslucent))
+			{
+				candidates.push_back(candidate);
+			}
+		}
+		std::stable_sort(candidates.begin(), candidates.end(), [](const CANDIDATE& first, const CANDIDATE& second)
+		{
+			return((first.width < second.width) || ((first.width == second.width) && (first.height < second.height)));
+		});
+
+		int duplicates = 0;
+		size_t groupStart = 0;
+		while (groupStart < candidates.size())
+		{
+			size_t groupEnd = groupStart + 1;
+			while ((groupEnd < candidates.size()) &&
+				(candidates[groupEnd].width == candidates[groupStart].width) &&
+				(candidates[groupEnd].height == candidates[groupStart].height))
+			{
+				groupEnd++;
+			}
+
+			// an image is compared against the earlier images of its
+			// size that kept their own texture
+			if (groupEnd - groupStart > 1)
+			{
+				size_t groupSize = groupEnd - groupStart;
+				std::vector<std::vector<unsigned char>> pixels(groupSize);
+				std::vector<std::vector<unsigned char>> thumbnails(groupSize);
+				std::vector<char> bRead(groupSize, 0);
+				for (size_t i = 0; i < groupSize; i++)
+				{
+					const CANDIDATE& candidate = candidates[groupStart + i];
+					int width = 0;
+					int height = 0;
+					bRead[i] = TextureLoader::ReadImagePixels(requests[candidate.request].filename, width, height, pixels[i]) &&
+						(width == candidate.width) && (height == candidate.height);
+					if (bRead[i])
+					{
+						MakeThumbnail(pixels[i], width, height, thumbnails[i]);
+					}
+				}
+
+				for (size_t i = 1; i < groupSize; i++)
+				{
+					for (size_t j = 0; bRead[i] && (j < i); j++)
+					{
+						int first = candidates[groupStart + j].request;
+						if (bRead[j] && (sharedWith[first] < 0) &&
+							IsNearDuplicate(thumbnails[j], pixels[j], thumbnails[i], pixels[i]))
+						{
+							sharedWith[candidates[groupStart + i].request] = first;
+							duplicates++;
+							break;
+						}
+					}
+				}
+			}
+			groupStart = groupEnd;
+		}
+
+		// files identical to an image that is now a near duplicate
+		// share the texture its image shares
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			if ((sharedWith[i] >= 0) && (sharedWith[sharedWith[i]] >= 0))
+			{
+				sharedWith[i] = sharedWith[sharedWith[i]];
+			}
+		}
+		return(duplicates);
+	}
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(ShaderManager* pShaderManager)
+{
+	m_pShaderManager = pShaderManager;
+	// the shaders are loaded and in use by now, so the uniform
+	// locations can be looked up once for all of the drawing
+	m_pShaderState = new ShaderStateCache();
+	m_pShaderState->Resolve();
+	m_pPrimitiveGeometry = new PrimitiveGeometry();
+	m_pInstanceRenderer = new InstanceRenderer();
+	// every core but the GL thread's gets a worker, the GL
+	// thread works on the chunks too
+	int workerCount = (int)std::thread::hardware_concurrency() - 1;
+	m_pJobSystem = new JobSystem(workerCount);
+	m_pInstanceRenderer->SetJobSystem(m_pJobSystem);
+	m_pStaticBatcher = new StaticBatcher();
+	m_staticTexturedDraws = 0;
+	m_blendedStaticDraws = 0;
+	m_pCommandList = new CommandList();
+	m_bSceneRecorded = false;
+	m_recordCount = 0;
+	m_bFindingDrawnTextures = false;
+	m_pBoundingVolumes = new BoundingVolumeTree();
+	m_pBoundingVolumes->SetJobSystem(m_pJobSystem);
+	m_culledDraws = 0;
+	m_drawnDraws = 0;
+	m_culledBatches = 0;
+	m_drawnBatches = 0;
+	m_pOcclusionCuller = new OcclusionCuller(m_pPrimitiveGeometry);
+	m_pOcclusionCuller->SetJobSystem(m_pJobSystem);
+	m_viewProjection = glm::mat4(1.0f);
+	m_bViewFrustumSet = false;
+	m_occludedDraws = 0;
+	m_occludedBatches = 0;
+	m_pTextureLoader = new TextureLoader();
+	m_pTextureArrays = new TextureArrayManager();
+	m_pTextureStreamer = new TextureStreamer(m_pTextureArrays);
+	m_pTextureResidency = new TextureResidency(m_pTextureArrays);
+	m_pTextureWatcher = new TextureWatcher();
+	m_pMaterialBuffer = new MaterialBuffer();
+	m_pTransforms = new TransformStore();
+	m_pSceneGraph = new SceneGraph(m_pTransforms);
+	m_sceneNode = 0;
+	m_sceneGroup = -1;
+	m_drawState.node = -1;
+	m_drawState.bUseTexture = false;
+	m_drawState.textureHandle = -1;
+	m_drawState.textureUnit = -1;
+	m_drawState.textureLayer = 0.0f;
+	m_drawState.textureRect = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+	m_drawState.bTransparentTexture = false;
+	m_drawState.color = glm::vec4(1.0f);
+	m_drawState.uvScale = glm::vec2(1.0f);
+	m_drawState.material = 0;
+	m_drawState.bStatic = false;
+	m_viewPosition = glm::vec3(0.0f);
+	m_bStreamTextures = true;
+	m_textureUploadBudget = g_DefaultUploadBudget;
+	m_placeholderTexture = -1;
+	m_bPlaceholderUploaded = false;
+	m_streamingTextures = 0;
+	m_streamFrames = 0;
+
+	// compressed cache files the driver cannot sample are
+	// expanded to RGBA when they are loaded
+	unsigned int formats = 0;
+	if (GLEW_EXT_texture_compression_s3tc)
+	{
+		formats |= (1u << TextureCompressor::FORMAT_BC1) | (1u << TextureCompressor::FORMAT_BC3);
+	}
+	if (GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc)
+	{
+		formats |= (1u << TextureCompressor::FORMAT_BC7);
+	}
+	TextureLoader::SetSupportedFormats(formats);
+
+	//texture collector
+	m_loadedTextures = 0;
+	m_sharedDecodeMilliseconds = 0.0;
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	m_pShaderManager = NULL;
+	delete m_pShaderState;
+	m_pShaderState = NULL;
+	delete m_pInstanceRenderer;
+	m_pInstanceRenderer = NULL;
+	delete m_pOcclusionCuller;
+	m_pOcclusionCuller = NULL;
+	delete m_pJobSystem;
+	m_pJobSystem = NULL;
+	delete m_pStaticBatcher;
+	m_pStaticBatcher = NULL;
+	delete m_pCommandList;
+	m_pCommandList = NULL;
+	delete m_pBoundingVolumes;
+	m_pBoundingVolumes = NULL;
+	delete m_pPrimitiveGeometry;
+	m_pPrimitiveGeometry = NULL;
+	delete m_pTextureLoader;
+	m_pTextureLoader = NULL;
+	// override the opengl textures
+	DestroyGLTextures();
+	delete m_pTextureStreamer;
+	m_pTextureStreamer = NULL;
+	delete m_pTextureResidency;
+	m_pTextureResidency = NULL;
+	delete m_pTextureWatcher;
+	m_pTextureWatcher = NULL;
+	delete m_pMaterialBuffer;
+	m_pMaterialBuffer = NULL;
+	delete m_pSceneGraph;
+	m_pSceneGraph = NULL;
+	delete m_pTransforms;
+	m_pTransforms = NULL;
+	delete m_pTextureArrays;
+	m_pTextureArrays = NULL;
+}
+
+
+
+
+
+/***********************************************************
+ *  CreateGLTexture()
+ *
+ *  This method is used for loading textures from image files,
+ *  configuring the texture mapping parameters in OpenGL,
+ *  generating the mipmaps, and loading the read texture into
+ *  the next available texture slot in memory.  With bAsync
+ *  it returns right away and the texture shows a placeholder
+ *  until UpdateTextureStreaming() has streamed it in.
+ ***********************************************************/
+bool SceneManager::CreateGLTexture(const char* filename, std::string tag, bool bAsync)
+{
+	TextureLoader::TEXTURE_REQUEST request;
+	TextureLoader::DECODED_IMAGE image;
+	bool bReturn = false;
+
+	request.filename = filename;
+	request.tag = tag;
+
+	if (bAsync)
+	{
+		return(StreamGLTexture(request));
+	}
+
+	// try to parse the image data from the specified image file
+	if (TextureLoader::DecodeImage(request, image))
+	{
+		int texture = ReserveGLTexture(image);
+		if (texture >= 0)
+		{
+			m_pTextureArrays->Build();
+			UploadGLTexture(texture, image);
+			m_pTextureArrays->GenerateMipmaps();
+			bReturn = true;
+		}
+	}
+	else
+	{
+		std::cout << "Could not load image:" << filename << std::endl;
+	}
+
+	// free the image data from local memory
+	TextureLoader::FreeImage(image);
+
+	return(bReturn);
+}
+
+/***********************************************************
+ *  ReserveGLTexture()
+ *
+ *  This method is used for reserving a texture array layer
+ *  for a decoded image and registering the texture with its
+ *  tag in the next available texture slot.  The pixels are
+ *  uploaded by UploadGLTexture() once the arrays are built.
+ ***********************************************************/
+int SceneManager::ReserveGLTexture(const TextureLoader::DECODED_IMAGE& image)
+{
+	// if the image was not successfully read from the image file
+	if ((NULL == image.pixels) && image.mipChain.mipLevels.empty())
+	{
+		std::cout << "Could not load image:" << image.filename << std::endl;
+		return(-1);
+	}
+
+	std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << image.colorChannels << (image.bFromCache ? " (cached)" : "") << std::endl;
+
+	// only RGB and RGBA formats are supported
+	if ((image.colorChannels != 3) && (image.colorChannels != 4))
+	{
+		std::cout << "Not implemented to handle image with " << image.colorChannels << " channels" << std::endl;
+		return(-1);
+	}
+
+	int texture = m_pTextureArrays->Reserve(image.width, image.height, image.colorChannels, image.mipChain.format, image.bTranslucent);
+	RegisterGLTexture(image.filename, image.tag, texture);
+
+	return(texture);
+}
+
+/***********************************************************
+ *  StreamGLTexture()
+ *
+ *  This method is used for reserving a texture array layer
+ *  for an image from just its file header, then starting to
+ *  decode it on the worker threads.  The tag shows a 1x1
+ *  placeholder until the image has been streamed in.
+ ***********************************************************/
+bool SceneManager::StreamGLTexture(const TextureLoader::TEXTURE_REQUEST& request)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+	TextureCompressor::FORMAT format = TextureCompressor::FORMAT_UNCOMPRESSED;
+	bool bTranslucent = false;
+
+	if (!TextureLoader::ReadImageInfo(request.filename, width, height, colorChannels, format, bTranslucent))
+	{
+		std::cout << "Could not load image:" << request.filename << std::endl;
+		return(false);
+	}
+
+	// only RGB and RGBA formats are supported
+	if ((colorChannels != 3) && (colorChannels != 4))
+	{
+		std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
+		return(false);
+	}
+
+	// the placeholder is reserved with the first streamed texture,
+	// so it is built into the arrays along with it
+	if (m_placeholderTexture < 0)
+	{
+		m_placeholderTexture = m_pTextureArrays->Reserve(1, 1, 4);
+		m_bPlaceholderUploaded = false;
+	}
+
+	int handle = RegisterGLTexture(request.filename, request.tag, m_pTextureArrays->Reserve(width, height, colorChannels, format, bTranslucent));
+	m_textureIDs[handle].ID = (uint32_t)m_placeholderTexture;
+	RestreamGLTexture(handle);
+
+	return(true);
+}
+
+/***********************************************************
+ *  RestreamGLTexture()
+ *
+ *  This method is used for decoding a registered texture's
+ *  image again and streaming it into its layer, at the base
+ *  level its array has when the decode finishes.  A texture
+ *  that is already decoding is decoded again once it has
+ *  finished, and one that is queued for upload is started
+ *  over.
+ ***********************************************************/
+void SceneManager::RestreamGLTexture(int handle)
+{
+	TEXTURE_INFO& info = m_textureIDs[handle];
+
+	if (!info.bStreaming)
+	{
+		if (m_streamingTextures == 0)
+		{
+			m_streamStart = std::chrono::steady_clock::now();
+			m_streamFrames = 0;
+		}
+		info.bStreaming = true;
+		m_streamingTextures++;
+	}
+
+	if (info.bDecoding)
+	{
+		// the decode may have read the file before it changed
+		info.bDecodeAgain = true;
+	}
+	else
+	{
+		TextureLoader::TEXTURE_REQUEST request;
+		request.filename = info.filename;
+		request.tag = info.tag;
+
+		m_pTextureStreamer->Cancel(info.reservedID);
+		info.bDecoding = true;
+		m_pTextureLoader->QueueDecode(request);
+	}
+}
+
+/***********************************************************
+ *  RegisterGLTexture()
+ *
+ *  This method is used for associating a texture with its
+ *  tag in the next available texture slot, or replacing the
+ *  texture of a tag that is already registered.  The tag's
+ *  handle is returned, which is its index in m_textureIDs.
+ *  The texture is put under the control of the texture
+ *  memory budget.
+ ***********************************************************/
+int SceneManager::RegisterGLTexture(const std::string& filename, const std::string& tag, int texture)
+{
+	TEXTURE_INFO info;
+	info.tag = tag;
+	info.filename = filename;
+	info.ID = (uint32_t)texture;
+	info.reservedID = texture;
+	info.bStreaming = false;
+	info.bDecoding = false;
+	info.sharedTags = 0;
+	info.bReloading = false;
+	info.reloadDecodeMilliseconds = 0.0;
+	info.bDecodeAgain = false;
+	m_pTextureResidency->Track(texture);
+
+	int handle = m_textureTags.Register(tag);
+	if (handle < (int)m_textureIDs.size())
+	{
+		// tags sharing the texture keep sharing it
+		info.sharedTags = m_textureIDs[handle].sharedTags;
+		m_textureIDs[handle] = info;
+	}
+	else
+	{
+		m_textureIDs.push_back(info);
+		m_loadedTextures++;
+	}
+
+	return(handle);
+}
+
+/***********************************************************
+ *  ShareGLTextures()
+ *
+ *  This method is used for giving the tags of image files
+ *  that are identical to an earlier file, or are a near
+ *  duplicate of its image, the texture of that file,
+ *  instead of loading the same image again.
+ *  sharedWith holds the index of the earlier request for
+ *  every request, or -1.
+ ***********************************************************/
+void SceneManager::ShareGLTextures(const std::vector<TextureLoader::TEXTURE_REQUEST>& requests, const std::vector<int>& sharedWith)
+{
+	size_t sharedBytes = 0;
+	int sharedCount = 0;
+
+	for (size_t i = 0; i < requests.size(); i++)
+	{
+		if (sharedWith[i] < 0)
+		{
+			continue;
+		}
+
+		// when the first file could not be loaded the tag is left
+		// unregistered, the same as if its own file had failed
+		const TextureLoader::TEXTURE_REQUEST& first = requests[sharedWith[i]];
+		int handle = m_textureTags.Find(first.tag);
+		if ((handle == TagRegistry::INVALID_HANDLE) ||
+			(m_textureTags.Alias(requests[i].tag, handle) != handle))
+		{
+			continue;
+		}
+
+		m_textureIDs[handle].sharedTags++;
+		sharedBytes += m_pTextureArrays->GetTextureMemorySize(m_textureIDs[handle].reservedID);
+		sharedCount++;
+		std::cout << "INFO: " << requests[i].filename << " is a duplicate of " << first.filename << ", sharing its texture" << std::endl;
+	}
+
+	if (sharedCount > 0)
+	{
+		std::cout << "INFO: Shared " << sharedCount << " textures between duplicate image files, saving " << sharedBytes / 1024 << " KB of texture memory" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  UploadGLTexture()
+ *
+ *  This method is used for uploading decoded image pixels
+ *  into the texture array layer reserved for them.  Images
+ *  without a cooked mip chain have their mipmaps generated
+ *  by the next TextureArrayManager::GenerateMipmaps() call.
+ ***********************************************************/
+void SceneManager::UploadGLTexture(int texture, const TextureLoader::DECODED_IMAGE& image)
+{
+	if (!image.mipChain.mipLevels.empty())
+	{
+		// the full mip chain was cooked ahead of time, so every
+		// level is uploaded as is
+		const std::vector<TextureCache::MIP_LEVEL>& levels = image.mipChain.mipLevels;
+		for (size_t level = 0; level < levels.size(); level++)
+		{
+			m_pTextureArrays->UploadLevel(texture, (int)level, levels[level].width, levels[level].height, levels[level].pixels);
+		}
+	}
+	else
+	{
+		m_pTextureArrays->UploadImage(texture, image.width, image.height, image.pixels);
+	}
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for binding the texture arrays that
+ *  hold the loaded textures to OpenGL texture units.  Each
+ *  array uses one unit, however many textures it holds.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	m_pTextureArrays->Bind();
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory in all the
+ *  used texture memory slots.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	m_pTextureStreamer->Clear();
+	m_placeholderTexture = -1;
+	m_bPlaceholderUploaded = false;
+	m_streamingTextures = 0;
+	m_pTextureResidency->Clear();
+	m_pTextureWatcher->Clear();
+	m_pTextureArrays->Destroy();
+	m_textureIDs.clear();
+	m_textureTags.Clear();
+	m_loadedTextures = 0;
+	m_sharedDecodeMilliseconds = 0.0;
+}
+
+/***********************************************************
+ *  FindTextureID()
+ *
+ *  This method is used for getting an ID for the previously
+ *  loaded texture bitmap associated with the passed in tag.  The
+ *  ID is the OpenGL texture array holding the texture.
+ ***********************************************************/
+int SceneManager::FindTextureID(std::string tag)
+{
+	int textureID = -1;
+	int handle = m_textureTags.Find(tag);
+
+	if (handle != TagRegistry::INVALID_HANDLE)
+	{
+		textureID = m_pTextureArrays->GetArrayID(m_textureIDs[handle].ID);
+	}
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting a slot index for the previously
+ *  loaded texture bitmap associated with the passed in tag.  The
+ *  slot is the texture's handle, which also indexes m_textureIDs.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(std::string tag)
+{
+	return(m_textureTags.Find(tag));
+}
+
+
+
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using the passed in transformation values.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	// every call made while rendering a frame is a node of the
+	// scene graph, in the order of the calls, below the group
+	// being drawn - its world matrix is only recomputed when its
+	// own transform or one of its groups changed
+	int node = NextSceneNode();
+	m_pSceneGraph->SetLocalTransform(node, scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
+
+	// the draws that follow use the node's world matrix
+	m_drawState.node = node;
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for recording a draw of a shape part
+ *  with the world matrix of the last transform set.  It is
+ *  drawn with the texture or color, material and UV scale
+ *  recorded before it when the scene is replayed.  The part
+ *  and the transform node are kept, so the draw's bounds in
+ *  the world can be found with the others once the scene is
+ *  recorded.
+ ***********************************************************/
+void SceneManager::DrawMesh(PrimitiveGeometry::PART part)
+{
+	if (m_drawState.node < 0)
+	{
+		return;
+	}
+
+	// the normal matrix cached with the world matrix is only
+	// recorded when the world matrix does not scale every axis
+	// the same
+	int node = m_drawState.node;
+	const glm::mat4& model = m_pSceneGraph->GetWorldMatrix(node);
+	bool bUniformScale = m_pSceneGraph->HasUniformScale(node);
+	m_pCommandList->Draw(part, m_drawState.bStatic, model,
+		bUniformScale ? glm::mat3(1.0f) : m_pSceneGraph->GetNormalMatrix(node), bUniformScale);
+
+	m_drawParts.push_back(part);
+	m_drawNodes.push_back(node);
+}
+
+/***********************************************************
+ *  UpdateDrawBounds()
+ *
+ *  This method is used for finding the world bounds of every
+ *  recorded draw and keeping them in the bounding volume
+ *  tree.  The world matrices are brought up to date first,
+ *  so the bounds are transformed in chunks on the job
+ *  system, which only reads the cached matrices.  The
+ *  tree is changed here afterwards, a draw recorded again
+ *  keeping its leaf, which only moves in the tree when the
+ *  draw moved out of it.
+ ***********************************************************/
+void SceneManager::UpdateDrawBounds()
+{
+	int drawCount = (int)m_drawNodes.size();
+	m_drawBounds.resize(drawCount);
+	// recording leaves every drawn node clean, this only makes
+	// sure no job is left to recompute one
+	m_pSceneGraph->UpdateWorldMatrices();
+	m_pJobSystem->ParallelFor(drawCount, g_DrawsPerJob, [this](int first, int last)
+	{
+		for (int draw = first; draw < last; draw++)
+		{
+			m_drawBounds[draw] = PrimitiveGeometry::TransformBounds(m_pPrimitiveGeometry->GetBounds(m_drawParts[draw]),
+				m_pSceneGraph->GetCachedWorldMatrix(m_drawNodes[draw]));
+		}
+	});
+
+	for (int draw = 0; draw < drawCount; draw++)
+	{
+		if (draw < (int)m_drawLeaves.size())
+		{
+			m_pBoundingVolumes->Move(m_drawLeaves[draw], m_drawBounds[draw]);
+		}
+		else
+		{
+			m_drawLeaves.push_back(m_pBoundingVolumes->Insert(m_drawBounds[draw], draw));
+		}
+	}
+
+	// draws the scene no longer makes leave the tree
+	for (int draw = drawCount; draw < (int)m_drawLeaves.size(); draw++)
+	{
+		m_pBoundingVolumes->Remove(m_drawLeaves[draw]);
+	}
+	m_drawLeaves.resize(drawCount);
+}
+
+/***********************************************************
+ *  SubmitDraw()
+ *
+ *  This method is used for drawing a replayed draw with the
+ *  last texture or color, material and UV scale replayed.
+ *  The draw is added to the instance renderer, which draws
+ *  it with every other draw of the part at the end of the
+ *  frame, or to the static batcher when it never moves.
+ *  Draws outside the view frustum are skipped, except the
+ *  ones baked into static batches, which are culled by
+ *  batch so the batches are not baked again as the camera
+ *  turns.  The others are kept until the occluders are
+ *  drawn, and solid boxes and planes in the frustum are
+ *  offered as occluders.
+ ***********************************************************/
+void SceneManager::SubmitDraw(const CommandList::COMMAND& command, int draw)
+{
+	PrimitiveGeometry::PART part = (PrimitiveGeometry::PART)command.part;
+	InstanceRenderer::INSTANCE instance;
+	instance.model = command.model;
+	for (int column = 0; column < 3; column++)
+	{
+		instance.normalMatrix[column] = glm::vec4(command.normalMatrix[column], 0.0f);
+	}
+
+	instance.color = m_drawState.color;
+	instance.textureRect = m_drawState.textureRect;
+	instance.surface = glm::vec4(m_drawState.uvScale.x, m_drawState.uvScale.y, m_drawState.textureLayer, 0.0f);
+	instance.flags = glm::ivec4(m_drawState.material, m_drawState.bUseTexture ? 1 : 0,
+		m_drawState.bUseTexture ? m_drawState.textureUnit : 0, 0);
+
+	// blended draws are drawn back to front after the opaque ones
+	bool bTransparent = m_drawState.bUseTexture ? m_drawState.bTransparentTexture : (m_drawState.color.a < 1.0f);
+	// merged batches cannot be sorted back to front, so blended
+	// draws stay on their own even when they never move
+	bool bOccluder = (part == PrimitiveGeometry::PART_BOX) || (part == PrimitiveGeometry::PART_PLANE);
+	if (m_bViewFrustumSet && bOccluder && !bTransparent && m_drawVisible[draw])
+	{
+		// the texture tells the occluders apart in the report
+		m_pOcclusionCuller->AddOccluder(part, command.model, m_drawBounds[draw], m_drawState.bUseTexture ? m_drawState.textureHandle : -1);
+	}
+
+	if (command.bStatic)
+	{
+		m_staticTexturedDraws += m_drawState.bUseTexture ? 1 : 0;
+		m_blendedStaticDraws += bTransparent ? 1 : 0;
+	}
+	if (command.bStatic && !bTransparent)
+	{
+		m_pStaticBatcher->Add(part, instance);
+	}
+	else if (m_drawVisible[draw])
+	{
+		PENDING_DRAW pending;
+		pending.part = part;
+		pending.bTransparent = bTransparent;
+		pending.instance = instance;
+		m_pendingDraws.push_back(pending);
+		m_pendingBounds.push_back(m_drawBounds[draw]);
+	}
+	else
+	{
+		m_culledDraws++;
+	}
+}
+
+/***********************************************************
+ *  NextSceneNode()
+ *
+ *  This method returns the scene graph node for the next
+ *  transform of the frame, adding it below the current
+ *  group in the first frame.
+ ***********************************************************/
+int SceneManager::NextSceneNode()
+{
+	if (m_sceneNode == m_pSceneGraph->GetCount())
+	{
+		m_pSceneGraph->AddNode(m_sceneGroup);
+	}
+	return(m_sceneNode++);
+}
+
+/***********************************************************
+ *  BeginSceneGroup()
+ *
+ *  This method is used for starting a group of parts that
+ *  move together.  The transforms set until EndSceneGroup()
+ *  is called are relative to the position of the group,
+ *  and groups can be nested.
+ ***********************************************************/
+void SceneManager::BeginSceneGroup(glm::vec3 positionXYZ)
+{
+	int node = NextSceneNode();
+	m_pSceneGraph->SetLocalTransform(node, glm::vec3(1.0f), 0.0f, 0.0f, 0.0f, positionXYZ);
+	m_sceneGroup = node;
+}
+
+/***********************************************************
+ *  EndSceneGroup()
+ *
+ *  This method is used for ending the group started last,
+ *  going back to the group it was started in.
+ ***********************************************************/
+void SceneManager::EndSceneGroup()
+{
+	m_sceneGroup = m_pSceneGraph->GetParent(m_sceneGroup);
+
+}
+
+/***********************************************************
+ *  BeginStaticDraws()
+ *
+ *  This method is used for marking the draws made until
+ *  EndStaticDraws() is called as never moving.  They are
+ *  baked into world space batches instead of being drawn
+ *  one by one.
+ ***********************************************************/
+void SceneManager::BeginStaticDraws()
+{
+	m_drawState.bStatic = true;
+}
+
+/***********************************************************
+ *  EndStaticDraws()
+ *
+ *  This method is used for going back to drawing every
+ *  draw on its own.
+ ***********************************************************/
+void SceneManager::EndStaticDraws()
+{
+	m_drawState.bStatic = false;
+}
+
+/***********************************************************
+ *  DrawStaticBatches()
+ *
+ *  This method is used for baking the static draws of the
+ *  frame again when they differ from the last bake, handing
+ *  the baked meshes to the instance renderer, and adding a
+ *  draw of every batch that is not outside the view
+ *  frustum or hidden behind the occluders.
+ ***********************************************************/
+void SceneManager::DrawStaticBatches()
+{
+	if (m_pStaticBatcher->Bake(*m_pPrimitiveGeometry))
+	{
+		std::vector<int> indexCounts(m_pStaticBatcher->GetBatchCount());
+		for (int batch = 0; batch < m_pStaticBatcher->GetBatchCount(); batch++)
+		{
+			indexCounts[batch] = m_pStaticBatcher->GetBatch(batch).indexCount;
+		}
+		m_pInstanceRenderer->SetStaticMeshes(m_pStaticBatcher->GetVertices(), m_pStaticBatcher->GetIndices(), indexCounts);
+	}
+
+	for (int batch = 0; batch < m_pStaticBatcher->GetBatchCount(); batch++)
+	{
+		const StaticBatcher::BATCH& baked = m_pStaticBatcher->GetBatch(batch);
+		if (m_viewFrustum.TestBox(baked.bounds.minimum, baked.bounds.maximum) == Frustum::RESULT_OUTSIDE)
+		{
+			m_culledBatches++;
+			continue;
+		}
+		if (!m_pOcclusionCuller->IsVisible(baked.bounds))
+		{
+			m_occludedBatches++;
+			continue;
+		}
+		m_pInstanceRenderer->AddStatic(batch, baked.instance);
+		m_drawnBatches++;
+	}
+}
+
+/***********************************************************
+ *  SetShaderColor()
+ *
+ *  This method is used for setting the passed in color
+ *  for the next draw command
+ ***********************************************************/
+void SceneManager::SetShaderColor(
+	float redColorValue,
+	float greenColorValue,
+	float blueColorValue,
+	float alphaValue)
+{
+	// variables for this method
+	glm::vec4 currentColor;
+
+	currentColor.r = redColorValue;
+	currentColor.g = greenColorValue;
+	currentColor.b = blueColorValue;
+	currentColor.a = alphaValue;
+
+	// the draws that follow use the color
+	m_pCommandList->SetColor(currentColor);
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+
+
+
+
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for recording the texture associated
+ *  with the passed in handle for the next draw command.  The
+ *  handle is recorded, so the draw finds where the texture
+ *  is when it is replayed.  While the drawn texture tags are
+ *  being found, nothing is loaded yet and every handle is
+ *  recorded.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	int textureHandle)
+{
+	if ((textureHandle >= 0) &&
+		(m_bFindingDrawnTextures || (textureHandle < (int)m_textureIDs.size())))
+	{
+		m_pCommandList->SetTexture(textureHandle);
+	}
+}
+
+/***********************************************************
+ *  ApplyTexture()
+ *
+ *  This method is used for selecting the texture associated
+ *  with the passed in handle for the replayed draws that
+ *  follow, wherever it is streamed to at the time.
+ ***********************************************************/
+void SceneManager::ApplyTexture(
+	int textureHandle)
+{
+	if ((textureHandle >= 0) &&
+		(textureHandle < (int)m_textureIDs.size()))
+	{
+		const TEXTURE_INFO& info = m_textureIDs[textureHandle];
+		m_pTextureResidency->Touch(info.reservedID);
+
+		// select the texture by its array unit and layer - the
+		// arrays stay bound, so nothing is rebound here
+		const TextureArrayManager::TEXTURE_LOCATION& location = m_pTextureArrays->GetLocation(info.ID);
+		m_drawState.bUseTexture = true;
+		m_drawState.textureHandle = textureHandle;
+		m_drawState.textureUnit = location.arrayIndex;
+		m_drawState.textureLayer = (float)location.layer;
+		m_drawState.textureRect = location.uvTransform;
+		m_drawState.bTransparentTexture = m_pTextureArrays->IsTranslucent(info.ID);
+	}
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in tag into the shader.  It
+ *  looks the tag up, so it is meant for load-time use only.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	std::string textureTag)
+{
+	SetShaderTexture(FindTextureSlot(textureTag));
+}
+
+
+/***********************************************************
+ *  SetTextureUVScale()
+ *
+ *  This method is used for setting the texture UV scale
+ *  values for the next draw command.
+ ***********************************************************/
+void SceneManager::SetTextureUVScale(float u, float v)
+{
+	m_pCommandList->SetUVScale(glm::vec2(u, v));
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+
+ /***********************************************************
+  *  LoadSceneTextures()
+  *
+  *  This method is used for preparing the 3D scene by loading
+  *  the shapes, textures in memory to support the 3D scene
+  *  rendering
+  ***********************************************************/
+void SceneManager::LoadSceneTextures() //todo update this block with textures
+{
+	/*** STUDENTS - add the code BELOW for loading the textures that ***/
+	/*** will be used for mapping to objects in the 3D scene. Up to  ***/
+	/*** 16 textures can be loaded per scene. Refer to the code in   ***/
+	/*** the OpenGL Sample for help.                                 ***/
+
+	std::vector<TextureLoader::TEXTURE_REQUEST> sceneRequests;
+	std::vector<TextureLoader::TEXTURE_REQUEST> requests;
+	std::vector<TextureLoader::DECODED_IMAGE> images;
+	std::vector<std::string> unreferencedTags;
+	std::vector<int> sharedWith;
+	double uploadMilliseconds = 0.0;
+	double decodeMilliseconds = 0.0;
+
+	// only the textures the recorded draws use are loaded
+	std::vector<char> drawnTags;
+	FindDrawnTextureTags(drawnTags);
+	GetSceneTextureRequests(sceneRequests, &unreferencedTags, &drawnTags);
+	if (!unreferencedTags.empty())
+	{
+		std::cout << "INFO: Skipped " << unreferencedTags.size() << " textures the scene never draws:";
+		for (size_t i = 0; i < unreferencedTags.size(); i++)
+		{
+			std::cout << " " << unreferencedTags[i];
+		}
+		std::cout << std::endl;
+	}
+
+	// every image file is watched, so a changed file can be
+	// loaded again without restarting
+	for (size_t i = 0; i < sceneRequests.size(); i++)
+	{
+		m_pTextureWatcher->Watch(sceneRequests[i].filename);
+	}
+
+	// image files with identical contents, or images that only
+	// differ by the noise of being saved again, are only loaded
+	// once, then every one of their tags shares the texture
+	std::chrono::steady_clock::time_point hashStart = std::chrono::steady_clock::now();
+	FindIdenticalFiles(sceneRequests, sharedWith);
+	int nearDuplicates = FindNearDuplicateImages(sceneRequests, sharedWith);
+	for (size_t i = 0; i < sceneRequests.size(); i++)
+	{
+		if (sharedWith[i] < 0)
+		{
+			requests.push_back(sceneRequests[i]);
+		}
+	}
+	std::cout << "INFO: Hashed and compared " << sceneRequests.size() << " image files in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hashStart).count()
+		<< " ms, " << sceneRequests.size() - requests.size() - nearDuplicates << " are identical to another file and " << nearDuplicates << " are near duplicates" << std::endl;
+
+	// when streaming, every texture shows a placeholder until
+	// UpdateTextureStreaming() has uploaded it, so the first frame
+	// does not wait for any decoding
+	if (m_bStreamTextures)
+	{
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			CreateGLTexture(requests[i].filename.c_str(), requests[i].tag, true);
+		}
+		ShareGLTextures(sceneRequests, sharedWith);
+		std::cout << "INFO: Streaming " << m_streamingTextures << " of " << requests.size() << " textures using " << m_pTextureLoader->GetWorkerCount() << " decode threads, " << m_textureUploadBudget / 1024 << " KB per frame\n" << std::endl;
+		return;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// decode all of the image files at the same time on the
+	// worker threads
+	m_pTextureLoader->DecodeImages(requests, images);
+
+	std::chrono::steady_clock::time_point decoded = std::chrono::steady_clock::now();
+
+	// reserve an array layer for every decoded image, in the same
+	// order as the requests so every tag keeps the same slot, then
+	// create the texture arrays once they are all known
+	std::vector<int> textures(images.size());
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		textures[i] = ReserveGLTexture(images[i]);
+	}
+	m_pTextureArrays->Build();
+	ShareGLTextures(sceneRequests, sharedWith);
+
+	// upload the decoded images on this thread
+	int cachedImages = 0;
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		if (textures[i] >= 0)
+		{
+			UploadGLTexture(textures[i], images[i]);
+		}
+		decodeMilliseconds += images[i].decodeMilliseconds;
+		int handle = m_textureTags.Find(images[i].tag);
+		if (handle != TagRegistry::INVALID_HANDLE)
+		{
+			m_sharedDecodeMilliseconds += m_textureIDs[handle].sharedTags * images[i].decodeMilliseconds;
+		}
+		if (images[i].bFromCache)
+		{
+			cachedImages++;
+		}
+		TextureLoader::FreeImage(images[i]);
+	}
+
+	m_pTextureArrays->GenerateMipmaps();
+
+	std::chrono::steady_clock::time_point uploaded = std::chrono::steady_clock::now();
+
+	// after the texture image data is loaded into memory, the
+	// texture arrays need to be bound to texture units - each
+	// array takes one unit however many textures it holds
+	BindGLTextures();
+
+	uploadMilliseconds = std::chrono::duration<double, std::milli>(uploaded - decoded).count();
+	std::cout << "INFO: Loaded " << m_loadedTextures << " of " << requests.size() << " textures using " << m_pTextureLoader->GetWorkerCount() << " decode threads, " << cachedImages << " from the texture cache" << std::endl;
+	std::cout << "INFO:   decode " << std::chrono::duration<double, std::milli>(decoded - start).count() << " ms (" << decodeMilliseconds << " ms if decoded one at a time, "
+		<< m_sharedDecodeMilliseconds << " ms more without sharing duplicate files)" << std::endl;
+	std::cout << "INFO:   upload " << uploadMilliseconds << " ms into " << m_pTextureArrays->GetArrayCount() << " texture arrays (" << m_pTextureArrays->GetMemorySize() / (1024 * 1024) << " MB)" << std::endl;
+	std::cout << "INFO:   total  " << std::chrono::duration<double, std::milli>(uploaded - start).count() << " ms\n" << std::endl;
+}
+
+
+
+
+
+/***********************************************************
+ *  SetTextureStreaming()
+ *
+ *  This method is used for choosing whether LoadSceneTextures()
+ *  streams the textures in over the first frames, and how many
+ *  bytes of pixels can be uploaded in one frame.
+ ***********************************************************/
+void SceneManager::SetTextureStreaming(bool bStream, size_t uploadBudget)
+{
+	m_bStreamTextures = bStream;
+	m_textureUploadBudget = uploadBudget;
+}
+
+/***********************************************************
+ *  UpdateTextureStreaming()
+ *
+ *  This method is used for moving the streaming textures
+ *  along by one frame.  Images that finished decoding are
+ *  queued for upload, up to the upload budget is uploaded,
+ *  and every texture that finished replaces its placeholder.
+ ***********************************************************/
+void SceneManager::UpdateTextureStreaming()
+{
+	// fit the texture memory to the draws of the last frame
+	UpdateTextureResidency();
+	// start loading the images whose files were changed
+	ReloadChangedTextures();
+
+	if (m_streamingTextures == 0)
+	{
+		return;
+	}
+
+	// create the arrays for the layers reserved since the last
+	// frame and fill in the placeholder
+	m_pTextureArrays->Build();
+	if (!m_bPlaceholderUploaded && (m_placeholderTexture >= 0))
+	{
+		m_pTextureArrays->UploadLevel(m_placeholderTexture, 0, 1, 1, g_PlaceholderPixel);
+		m_bPlaceholderUploaded = true;
+	}
+
+	std::vector<TextureLoader::DECODED_IMAGE*> images;
+	m_pTextureLoader->CollectDecoded(images);
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		TextureLoader::DECODED_IMAGE* pImage = images[i];
+		int handle = m_textureTags.Find(pImage->tag);
+
+		if ((handle == TagRegistry::INVALID_HANDLE) || !m_textureIDs[handle].bDecoding)
+		{
+			// the textures were destroyed while this was decoding
+			TextureLoader::FreeImage(*pImage);
+			delete pImage;
+			continue;
+		}
+
+		TEXTURE_INFO& info = m_textureIDs[handle];
+		info.bDecoding = false;
+		if (info.bDecodeAgain)
+		{
+			// the file changed while this was decoding
+			info.bDecodeAgain = false;
+			TextureLoader::FreeImage(*pImage);
+			delete pImage;
+			RestreamGLTexture(handle);
+			continue;
+		}
+
+		if (!info.bStreaming)
+		{
+			// the array was evicted while this was decoding
+			TextureLoader::FreeImage(*pImage);
+			delete pImage;
+		}
+		else if ((NULL == pImage->pixels) && pImage->mipChain.mipLevels.empty())
+		{
+			// the texture keeps showing what it showed before
+			std::cout << "Could not load image:" << pImage->filename << std::endl;
+			FinishGLTexture(handle, false);
+			TextureLoader::FreeImage(*pImage);
+			delete pImage;
+		}
+		else if (!FitsGLTexture(info.reservedID, *pImage))
+		{
+			// the file was changed, or cooked again in another
+			// format, after the layer was reserved - the image gets
+			// a new layer and the old one is drawn until it is done
+			int texture = m_pTextureArrays->Reserve(pImage->width, pImage->height, pImage->colorChannels, pImage->mipChain.format, pImage->bTranslucent);
+			m_pTextureArrays->Build();
+			m_pTextureResidency->Track(texture);
+			info.reservedID = texture;
+			info.reloadDecodeMilliseconds = pImage->decodeMilliseconds;
+			m_sharedDecodeMilliseconds += info.sharedTags * pImage->decodeMilliseconds;
+			std::cout << "INFO: Image no longer fits its texture layer, moving it to a new one:" << pImage->filename << std::endl;
+			m_pTextureStreamer->Queue(handle, texture, pImage, 0);
+		}
+		else
+		{
+			// every tag sharing the texture would have decoded
+			// the same image again
+			m_sharedDecodeMilliseconds += info.sharedTags * pImage->decodeMilliseconds;
+			info.reloadDecodeMilliseconds = pImage->decodeMilliseconds;
+
+			// the image file header could only tell whether it has
+			// an alpha channel, the decoded image tells whether it
+			// uses it
+			m_pTextureArrays->SetTranslucent(info.reservedID, pImage->bTranslucent);
+
+			// upload from the level the array is stored from now
+			int arrayIndex = m_pTextureArrays->GetLocation(info.reservedID).arrayIndex;
+			m_pTextureStreamer->Queue(handle, info.reservedID, pImage, m_pTextureArrays->GetBaseLevel(arrayIndex));
+		}
+	}
+
+	std::vector<int> completed;
+	m_pTextureStreamer->Update(m_textureUploadBudget, completed);
+	for (size_t i = 0; i < completed.size(); i++)
+	{
+		FinishGLTexture(completed[i], true);
+	}
+
+	m_streamFrames++;
+	if (m_streamingTextures == 0)
+	{
+		std::cout << "INFO: Streamed textures in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_streamStart).count()
+			<< " ms over " << m_streamFrames << " frames, " << m_pTextureStreamer->GetUploadedBytes() / (1024 * 1024) << " MB uploaded into "
+			<< m_pTextureArrays->GetArrayCount() << " texture arrays, " << m_sharedDecodeMilliseconds << " ms of decoding saved by sharing duplicate files\n" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  FinishGLTexture()
+ *
+ *  This method is used for ending the streaming of a texture,
+ *  whether or not its image could be loaded.  A layer in new
+ *  storage can only be drawn once every layer of its array
+ *  is uploaded, then every texture in the array switches
+ *  from what it showed before to its own layer.
+ ***********************************************************/
+void SceneManager::FinishGLTexture(int handle, bool bLoaded)
+{
+	TEXTURE_INFO& info = m_textureIDs[handle];
+	info.bStreaming = false;
+	m_streamingTextures--;
+
+	if (info.bReloading)
+	{
+		info.bReloading = false;
+		if (bLoaded)
+		{
+			std::cout << "INFO: Reloaded texture:" << info.filename << ", visible " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - info.reloadStart).count()
+				<< " ms after the change was noticed (" << info.reloadDecodeMilliseconds << " ms decoding)" << std::endl;
+		}
+	}
+
+	if (m_pTextureArrays->FinishLayer(info.reservedID))
+	{
+		int arrayIndex = m_pTextureArrays->GetLocation(info.reservedID).arrayIndex;
+		for (size_t i = 0; i < m_textureIDs.size(); i++)
+		{
+			if (!m_textureIDs[i].bStreaming &&
+				((i != (size_t)handle) || bLoaded) &&
+				(m_pTextureArrays->GetLocation(m_textureIDs[i].reservedID).arrayIndex == arrayIndex))
+			{
+				m_textureIDs[i].ID = (uint32_t)m_textureIDs[i].reservedID;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  FitsGLTexture()
+ *
+ *  This method is used for checking that a decoded image has
+ *  the size and format of the image a texture was reserved
+ *  for, so it can be uploaded into the texture's layer.
+ ***********************************************************/
+bool SceneManager::FitsGLTexture(int texture, const TextureLoader::DECODED_IMAGE& image) const
+{
+	int width = 0;
+	int height = 0;
+	m_pTextureArrays->GetImageSize(texture, width, height);
+
+	return((image.width == width) &&
+		(image.height == height) &&
+		(image.colorChannels == m_pTextureArrays->GetColorChannels(texture)) &&
+		(image.mipChain.format == m_pTextureArrays->GetFormat(texture)));
+}
+
+/***********************************************************
+ *  ReloadChangedTextures()
+ *
+ *  This method is used for loading the textures whose image
+ *  files changed again.  The image is decoded on the worker
+ *  threads and streamed into the texture's own layer inside
+ *  the per-frame upload budget, so the frame time stays
+ *  steady.  While the upload is spread over frames, the rows
+ *  already uploaded show the new image and the rest the old
+ *  one.  Evicted textures are skipped, as they are decoded
+ *  again from the changed file once they are drawn.
+ ***********************************************************/
+void SceneManager::ReloadChangedTextures()
+{
+	std::vector<std::string> changed;
+	m_pTextureWatcher->Poll(changed);
+
+	for (size_t i = 0; i < changed.size(); i++)
+	{
+		bool bFound = false;
+		for (size_t handle = 0; handle < m_textureIDs.size(); handle++)
+		{
+			TEXTURE_INFO& info = m_textureIDs[handle];
+			if (info.filename != changed[i])
+			{
+				continue;
+			}
+
+			bFound = true;
+			int arrayIndex = m_pTextureArrays->GetLocation(info.reservedID).arrayIndex;
+			if (m_pTextureArrays->GetBaseLevel(arrayIndex) >= m_pTextureArrays->GetArrayLevelCount(arrayIndex))
+			{
+				continue;
+			}
+
+			info.bReloading = true;
+			info.reloadStart = std::chrono::steady_clock::now();
+			std::cout << "INFO: Reloading texture:" << info.filename << std::endl;
+			if (info.sharedTags > 0)
+			{
+				std::cout << "INFO:   " << info.sharedTags << " other tags with duplicate files share it until the next start" << std::endl;
+			}
+			RestreamGLTexture((int)handle);
+		}
+
+		if (!bFound)
+		{
+			std::cout << "INFO: " << changed[i] << " changed but shares the texture of a duplicate file, it is loaded on its own at the next start" << std::endl;
+		}
+	}
+}
+
+/***********************************************************
+ *  UpdateTextureResidency()
+ *
+ *  This method is used for applying the texture memory
+ *  budget.  Arrays that drop or restore mip levels get new
+ *  storage and every texture in them is streamed in again,
+ *  while the old storage keeps being drawn.  Evicted arrays
+ *  show the placeholder until they are drawn and restored.
+ ***********************************************************/
+void SceneManager::UpdateTextureResidency()
+{
+	std::vector<TextureResidency::RESIDENCY_CHANGE> changes;
+	m_pTextureResidency->Update(changes);
+
+	for (size_t i = 0; i < changes.size(); i++)
+	{
+		int arrayIndex = changes[i].arrayIndex;
+		bool bEvicted = (changes[i].baseLevel >= m_pTextureArrays->GetArrayLevelCount(arrayIndex));
+		m_pTextureArrays->SetBaseLevel(arrayIndex, changes[i].baseLevel);
+
+		for (size_t handle = 0; handle < m_textureIDs.size(); handle++)
+		{
+			TEXTURE_INFO& info = m_textureIDs[handle];
+			if (m_pTextureArrays->GetLocation(info.reservedID).arrayIndex != arrayIndex)
+			{
+				continue;
+			}
+
+			if (bEvicted)
+			{
+				info.ID = (uint32_t)m_placeholderTexture;
+				m_pTextureStreamer->Cancel(info.reservedID);
+				if (info.bStreaming)
+				{
+					info.bStreaming = false;
+					m_streamingTextures--;
+				}
+			}
+			else
+			{
+				RestreamGLTexture((int)handle);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  SetTextureBudget()
+ *
+ *  This method is used for setting how many bytes of texture
+ *  memory the scene textures should fit in.  0 means there
+ *  is no limit.
+ ***********************************************************/
+void SceneManager::SetTextureBudget(size_t budget)
+{
+	m_pTextureResidency->SetBudget(budget);
+}
+
+/***********************************************************
+ *  SetViewPosition()
+ *
+ *  This method is used for setting the camera position the
+ *  draws of the next frame are sorted by.  Transparent draws
+ *  are drawn from the farthest to the nearest.
+ ***********************************************************/
+void SceneManager::SetViewPosition(const glm::vec3& viewPosition)
+{
+	m_viewPosition = viewPosition;
+}
+
+/***********************************************************
+ *  SetViewFrustum()
+ *
+ *  This method is used for setting the projection times
+ *  view matrix the draws of the next frame are culled
+ *  against and the occluders are drawn with.  Until it is
+ *  set nothing is culled.
+ ***********************************************************/
+void SceneManager::SetViewFrustum(const glm::mat4& viewProjection)
+{
+	m_viewFrustum.Set(viewProjection);
+	m_viewProjection = viewProjection;
+	m_bViewFrustumSet = true;
+}
+
+/***********************************************************
+ *  ReportTextureResidency()
+ *
+ *  This method is used for printing the memory used by each
+ *  texture along with how often it was drawn at full size.
+ ***********************************************************/
+void SceneManager::ReportTextureResidency()
+{
+	size_t budget = m_pTextureResidency->GetBudget();
+
+	std::cout << "INFO: Texture memory " << m_pTextureResidency->GetResidentBytes() / 1024 << " KB";
+	if (budget > 0)
+	{
+		std::cout << " of a " << budget / 1024 << " KB budget";
+	}
+	std::cout << ", " << m_pTextureResidency->GetDropCount() << " drops, " << m_pTextureResidency->GetEvictionCount()
+		<< " evictions, " << m_pTextureResidency->GetRestoreCount() << " restores" << std::endl;
+
+	for (size_t handle = 0; handle < m_textureIDs.size(); handle++)
+	{
+		const TEXTURE_INFO& info = m_textureIDs[handle];
+		int arrayIndex = m_pTextureArrays->GetLocation(info.reservedID).arrayIndex;
+		int baseLevel = m_pTextureArrays->GetBaseLevel(arrayIndex);
+		unsigned int hits = m_pTextureResidency->GetHitCount(info.reservedID);
+		unsigned int misses = m_pTextureResidency->GetMissCount(info.reservedID);
+
+		std::cout << "INFO:   " << info.tag << ": ";
+		if (baseLevel >= m_pTextureArrays->GetArrayLevelCount(arrayIndex))
+		{
+			std::cout << "evicted";
+		}
+		else
+		{
+			std::cout << m_pTextureArrays->GetTextureMemorySize(info.reservedID) / 1024 << " KB from mip " << baseLevel;
+		}
+		std::cout << ", " << hits << " hits, " << misses << " misses";
+		if (hits + misses > 0)
+		{
+			std::cout << " (" << (100.0 * hits) / (hits + misses) << "% hit rate)";
+		}
+		std::cout << std::endl;
+	}
+}
+
+/***********************************************************
+ *  ReportShaderState()
+ *
+ *  This method is used for printing how many uniform values
+ *  the scene submitted and how many of them were uploaded
+ *  because they changed, for the last frame and overall.
+ ***********************************************************/
+void SceneManager::ReportShaderState()
+{
+	unsigned int submitted = m_pShaderState->GetSubmittedCount();
+	unsigned int issued = m_pShaderState->GetIssuedCount();
+	unsigned long long totalSubmitted = m_pShaderState->GetTotalSubmittedCount();
+	unsigned long long totalIssued = m_pShaderState->GetTotalIssuedCount();
+
+	std::cout << "INFO: Uniform updates in the last frame: " << submitted << " submitted, " << issued << " issued, "
+		<< submitted - issued << " skipped as unchanged" << std::endl;
+	std::cout << "INFO: Uniform updates in all frames: " << totalSubmitted << " submitted, " << totalIssued << " issued";
+	if (totalSubmitted > 0)
+	{
+		std::cout << " (" << (100.0 * (totalSubmitted - totalIssued)) / totalSubmitted << "% skipped)";
+	}
+	std::cout << std::endl;
+}
+
+/***********************************************************
+ *  ReportTransforms()
+ *
+ *  This method is used for printing how many local matrices
+ *  were composed and how many were reused unchanged, and how
+ *  many world matrices the scene graph recomputed and how
+ *  many of their normal matrices needed an inverse, for the
+ *  last frame and overall.
+ ***********************************************************/
+void SceneManager::ReportTransforms()
+{
+	unsigned long long composed = m_pTransforms->GetTotalComposedCount();
+	unsigned long long reused = m_pTransforms->GetTotalReusedCount();
+
+	std::cout << "INFO: Model matrices in the last frame: " << m_pTransforms->GetComposedCount() << " composed, "
+		<< m_pSceneGraph->GetUpdatedCount() << " world matrices recomputed for " << m_pSceneGraph->GetCount() << " nodes" << std::endl;
+	std::cout << "INFO: Model matrices in all frames: " << composed << " composed, " << reused << " reused";
+	if (composed + reused > 0)
+	{
+		std::cout << " (" << (100.0 * reused) / (composed + reused) << "% reused)";
+	}
+	std::cout << ", " << m_pSceneGraph->GetTotalUpdatedCount() << " world matrices recomputed, "
+		<< m_pSceneGraph->GetTotalInvertedCount() << " normal matrices inverted" << std::endl;
+}
+
+/***********************************************************
+ *  ReportDrawCalls()
+ *
+ *  This method is used for printing how many draws the last
+ *  frame made, the draw commands and calls that drew them, and
+ *  how many mesh, texture and material changes there were
+ *  between the draws in the order RenderScene made them and
+ *  in the order the render queue sorted them into, how many
+ *  static draws were baked into how many batches, and how
+ *  the per-draw work was split over the job system.
+ ***********************************************************/
+void SceneManager::ReportDrawCalls()
+{
+	const RenderQueue& queue = m_pInstanceRenderer->GetRenderQueue();
+	const char* stateNames[RenderQueue::STATE_COUNT] = { "mesh", "texture", "material" };
+	unsigned int removed = 0;
+
+	std::cout << "INFO: Draws in the last frame: " << m_pInstanceRenderer->GetInstanceCount() << " drawn as "
+		<< m_pInstanceRenderer->GetCommandCount() << " instanced draw commands in " << m_pInstanceRenderer->GetDrawCallCount()
+		<< (m_pInstanceRenderer->IsIndirect() ? " multi-draw indirect call" : " draw calls") << std::endl;
+	std::cout << "INFO: State changes in the last frame, submitted -> sorted:";
+	for (int state = 0; state < RenderQueue::STATE_COUNT; state++)
+	{
+		unsigned int submitted = queue.GetSubmittedChanges((RenderQueue::STATE)state);
+		unsigned int sorted = queue.GetSortedChanges((RenderQueue::STATE)state);
+		std::cout << " " << stateNames[state] << " " << submitted << " -> " << sorted;
+		if (submitted > sorted)
+		{
+			removed += submitted - sorted;
+		}
+	}
+	std::cout << ", " << removed << " removed by sorting" << std::endl;
+	std::cout << "INFO: Static draws: " << m_pStaticBatcher->GetDrawCount() << " baked into "
+		<< m_pStaticBatcher->GetBatchCount() << " batches, baked " << m_pStaticBatcher->GetBakeCount() << " times" << std::endl;
+	// a textured static draw that is opaque has to end up in a
+	// batch - only draws that blend are kept out
+	std::cout << "INFO:   " << m_pStaticBatcher->GetTexturedDrawCount() << " of " << m_staticTexturedDraws << " textured static draws baked, "
+		<< m_blendedStaticDraws << " static draws blended on their own" << std::endl;
+	std::cout << "INFO: Per-draw work on " << m_pJobSystem->GetThreadCount() << " threads: " << m_pJobSystem->GetJobCount()
+		<< " chunks run, " << m_pJobSystem->GetStolenCount() << " stolen" << std::endl;
+}
+
+/***********************************************************
+ *  ReportCommandList()
+ *
+ *  This method is used for printing how many commands and
+ *  draws the recorded scene holds, the bytes they take up,
+ *  and how many times the scene was recorded.
+ ***********************************************************/
+void SceneManager::ReportCommandList()
+{
+	std::cout << "INFO: Recorded scene: " << m_pCommandList->GetCommandCount() << " commands, "
+		<< m_pCommandList->GetDrawCount() << " draws in " << m_pCommandList->GetSize() << " bytes, recorded "
+		<< m_recordCount << " times" << std::endl;
+}
+
+/***********************************************************
+ *  ReportCulling()
+ *
+ *  This method is used for printing how many draws and
+ *  static batches the last frame culled against the view
+ *  frustum, how many were hidden behind the occluders and
+ *  how many it drew, the size of the bounding volume tree
+ *  the draws were culled with, and the occluders drawn and
+ *  the time they took.
+ ***********************************************************/
+void SceneManager::ReportCulling()
+{
+	std::cout << "INFO: Culled in the last frame: " << m_culledDraws << " draws culled, " << m_occludedDraws << " hidden, "
+		<< m_drawnDraws << " drawn, " << m_culledBatches << " static batches culled, " << m_occludedBatches << " hidden, "
+		<< m_drawnBatches << " drawn" << std::endl;
+	std::cout << "INFO: Bounding volume tree: " << m_pBoundingVolumes->GetCount() << " draws, height "
+		<< m_pBoundingVolumes->GetHeight() << ", " << m_pBoundingVolumes->GetTestedCount() << " nodes tested" << std::endl;
+	std::cout << "INFO: Occluders: " << m_pOcclusionCuller->GetOccluderCount() << " of " << m_pOcclusionCuller->GetOfferedCount()
+		<< " drawn as " << m_pOcclusionCuller->GetTriangleCount() << " triangles in " << m_pOcclusionCuller->GetMilliseconds()
+		<< " ms, up to " << m_pOcclusionCuller->GetOccluderLimit() << " next frame, " << m_pOcclusionCuller->GetOverBudgetCount()
+		<< " frames over budget" << std::endl;
+
+	// the biggest occluders by their texture, which is enough to
+	// see whether the desk and the walls are among them
+	int listed = std::min(m_pOcclusionCuller->GetOccluderCount(), 8);
+	if (listed > 0)
+	{
+		std::cout << "INFO:   biggest occluders:";
+		for (int occluder = 0; occluder < listed; occluder++)
+		{
+			int texture = m_pOcclusionCuller->GetOccluderID(occluder);
+			std::cout << ((occluder > 0) ? ", " : " ")
+				<< ((texture >= 0) ? m_textureTags.GetTag(texture) : std::string("untextured"))
+				<< ((m_pOcclusionCuller->GetOccluderPart(occluder) == PrimitiveGeometry::PART_PLANE) ? " plane" : " box");
+		}
+		std::cout << std::endl;
+	}
+}
+
+/***********************************************************
+ *  GetSceneTextureRequests()
+ *
+ *  This method is used for listing the image file and tag
+ *  of every texture the scene loads.  Textures with a tag
+ *  RenderScene has no handle field for are left out, and so
+ *  are the ones no recorded draw uses when pDrawnTags, from
+ *  FindDrawnTextureTags(), is not NULL.  The tags left out
+ *  are added to pUnreferencedTags if it is not NULL.
+ ***********************************************************/
+void SceneManager::GetSceneTextureRequests(std::vector<TextureLoader::TEXTURE_REQUEST>& requests,
+	std::vector<std::string>* pUnreferencedTags, const std::vector<char>* pDrawnTags)
+{
+	for (int i = 0; i < g_SceneTextureCount; i++)
+	{
+		int handle = FindSceneTextureHandle(g_SceneTextures[i].tag);
+		if ((handle < 0) || ((NULL != pDrawnTags) && !(*pDrawnTags)[handle]))
+		{
+			if (NULL != pUnreferencedTags)
+			{
+				pUnreferencedTags->push_back(g_SceneTextures[i].tag);
+			}
+			continue;
+		}
+
+		TextureLoader::TEXTURE_REQUEST request;
+		request.filename = g_SceneTextures[i].filename;
+		request.tag = g_SceneTextures[i].tag;
+		requests.push_back(request);
+	}
+}
+
+/***********************************************************
+ *  FindDrawnTextureTags()
+ *
+ *  This method is used for finding the texture tags the
+ *  scene draws with before any texture is loaded.  The scene
+ *  is recorded once with every texture handle field set to
+ *  its own index, which SetShaderTexture() records without
+ *  checking it against the loaded textures, and the list is
+ *  read back the way it is replayed.  A flag is set for each
+ *  field that is selected when a draw is made.  The recording
+ *  is thrown away, so the scene is recorded again with the
+ *  real handles before it is drawn.
+ ***********************************************************/
+void SceneManager::FindDrawnTextureTags(std::vector<char>& drawn)
+{
+	for (int i = 0; i < g_SceneTextureHandleCount; i++)
+	{
+		m_sceneTextures.*(g_SceneTextureHandles[i].handle) = i;
+	}
+
+	unsigned int recordCount = m_recordCount;
+	m_bFindingDrawnTextures = true;
+	RecordScene();
+	m_bFindingDrawnTextures = false;
+	m_recordCount = recordCount;
+	InvalidateScene();
+
+	drawn.assign(g_SceneTextureHandleCount, 0);
+	int texture = -1;
+	size_t offset = 0;
+	CommandList::COMMAND command;
+	while (m_pCommandList->Read(offset, command))
+	{
+		if (command.opcode == CommandList::OP_TEXTURE)
+		{
+			texture = command.handle;
+		}
+		else if (command.opcode == CommandList::OP_COLOR)
+		{
+			texture = -1;
+		}
+		else if ((command.opcode == CommandList::OP_DRAW) && (texture >= 0) && (texture < g_SceneTextureHandleCount))
+		{
+			drawn[texture] = 1;
+		}
+	}
+
+	// the real handles are looked up once the textures are loaded
+	for (int i = 0; i < g_SceneTextureHandleCount; i++)
+	{
+		m_sceneTextures.*(g_SceneTextureHandles[i].handle) = TagRegistry::INVALID_HANDLE;
+	}
+}
+
+/***********************************************************
+ *  CookSceneTextures()
+ *
+ *  This method is used for cooking the texture cache files
+ *  for every scene texture ahead of time, so the first run
+ *  of the scene does not need to decode any images.  The
+ *  format is "bc1", "bc3", "bc7", "none" to store the pixels
+ *  uncompressed, or "auto" for BC1 on RGB images and BC7 on
+ *  RGBA images.  No OpenGL context is needed.
+ ***********************************************************/
+bool SceneManager::CookSceneTextures(const std::string& formatName)
+{
+	TextureCompressor::FORMAT format = TextureCompressor::FORMAT_UNCOMPRESSED;
+	bool bAuto = false;
+	if (!TextureCompressor::ParseFormat(formatName, format, bAuto))
+	{
+		std::cout << "Unknown texture format:" << formatName << " (none, bc1, bc3, bc7, auto)" << std::endl;
+		return(false);
+	}
+
+	std::vector<TextureLoader::TEXTURE_REQUEST> requests;
+	GetSceneTextureRequests(requests);
+
+	TextureLoader loader;
+	int cooked = loader.CookImages(requests, format, bAuto);
+	std::cout << "INFO: Cooked " << cooked << " of " << requests.size() << " scene textures" << std::endl;
+
+	return(cooked == (int)requests.size());
+}
+
+/***********************************************************
+ *  DefineObjectMaterials()
+ *
+ *  This method is used for configuring the various material
+ *  settings for all of the objects within the 3D scene.
+ ***********************************************************/
+void SceneManager::DefineObjectMaterials()
+{
+	OBJECT_MATERIAL goldMaterial;
+	goldMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
+	goldMaterial.ambientStrength = 0.3f;
+	goldMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
+	goldMaterial.specularColor = glm::vec3(0.05f, 0.05f, 0.05f); //adjust shine to be less harsh
+	goldMaterial.shininess = 22.0;
+	goldMaterial.tag = "metal";
+
+	m_objectMaterials.push_back(goldMaterial);
+
+	OBJECT_MATERIAL woodMaterial;
+	woodMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	woodMaterial.ambientStrength = 0.2f;
+	woodMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
+	woodMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	woodMaterial.shininess = 0.3;
+	woodMaterial.tag = "wood";
+
+	m_objectMaterials.push_back(woodMaterial);
+
+	OBJECT_MATERIAL glassMaterial;
+	glassMaterial.ambientColor = glm::vec3(0.4f, 0.4f, 0.4f);
+	glassMaterial.ambientStrength = 0.3f;
+	glassMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
+	glassMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.6f);
+	glassMaterial.shininess = 85.0;
+	glassMaterial.tag = "glass";
+
+	m_objectMaterials.push_back(glassMaterial);
+
+
+	OBJECT_MATERIAL backdropMaterial;
+	backdropMaterial.ambientColor = glm::vec3(0.6f, 0.6f, 0.6f);
+	backdropMaterial.ambientStrength = 0.6f;
+	backdropMaterial.diffuseColor = glm::vec3(0.6f, 0.5f, 0.1f);
+	backdropMaterial.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
+	backdropMaterial.shininess = 0.0;
+	backdropMaterial.tag = "backdrop";
+
+}
+
+
+
+/***********************************************************
+ *  FindMaterial()
+ *
+ *  This method is used for getting a material from the previously
+ *  defined materials list that is associated with the passed in tag.
+ ***********************************************************/
+bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
+{
+	int handle = m_materialTags.Find(tag);
+	if (handle == TagRegistry::INVALID_HANDLE)
+	{
+		return(false);
+	}
+
+	material = m_objectMaterials[handle];
+	return(true);
+}
+
+
+/***********************************************************
+ *  UploadMaterials()
+ *
+ *  This method is used for copying every defined material
+ *  into the material uniform buffer.  A material's index in
+ *  the buffer is its handle.
+ ***********************************************************/
+void SceneManager::UploadMaterials()
+{
+	std::vector<MaterialBuffer::MATERIAL> materials(m_objectMaterials.size());
+	for (size_t i = 0; i < m_objectMaterials.size(); i++)
+	{
+		materials[i].ambientColor = m_objectMaterials[i].ambientColor;
+		materials[i].ambientStrength = m_objectMaterials[i].ambientStrength;
+		materials[i].diffuseColor = m_objectMaterials[i].diffuseColor;
+		materials[i].shininess = m_objectMaterials[i].shininess;
+		materials[i].specularColor = m_objectMaterials[i].specularColor;
+		materials[i].padding = 0.0f;
+	}
+
+	// the buffer is bound to the block of the program in use
+	GLint programID = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+	if (m_pMaterialBuffer->Upload((GLuint)programID, materials))
+	{
+		std::cout << "INFO: Uploaded " << m_pMaterialBuffer->GetCount() << " materials into a uniform buffer that holds "
+			<< m_pMaterialBuffer->GetCapacity() << std::endl;
+	}
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for recording the material associated
+ *  with the passed in handle for the next draw command.
+ *  Every material is already in the material uniform buffer,
+ *  so only its index is drawn with.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	int materialHandle)
+{
+	if ((materialHandle >= 0) &&
+		(materialHandle < m_pMaterialBuffer->GetCount()))
+	{
+		m_pCommandList->SetMaterial(materialHandle);
+	}
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for passing the material values
+ *  associated with the passed in tag into the shader.  It
+ *  looks the tag up, so it is meant for load-time use only.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	std::string materialTag)
+{
+	SetShaderMaterial(m_materialTags.Find(materialTag));
+}
+
+
+
+/***********************************************************
+ *  SetupSceneLights()
+ *
+ *  This method is called to add and configure the light
+ *  sources for the 3D scene.  There are up to 4 light sources.
+ ***********************************************************/
+void SceneManager::SetupSceneLights()
+{
+	// this line of code is NEEDED for telling the shaders to render 
+	// the 3D scene with custom lighting - to use the default rendered 
+	// lighting then comment out the following line
+	m_pShaderState->SetBool(ShaderStateCache::UNIFORM_USE_LIGHTING, true);
+
+	//overhead lamp with wider reach and neutral/slightly warm toned light
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_POSITION), glm::vec3(-8.0f, 6.0f, 2.0f));
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_AMBIENT_COLOR), glm::vec3(0.65f, 0.55f, 0.35f));
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_DIFFUSE_COLOR), glm::vec3(0.25f, 0.25f, 0.25f));
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_SPECULAR_COLOR), glm::vec3(0.55f, 0.55f, 0.55f));
+	m_pShaderState->SetFloat(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_FOCAL_STRENGTH), 35.0f);
+	m_pShaderState->SetFloat(ShaderStateCache::GetLightUniform(0, ShaderStateCache::LIGHT_SPECULAR_INTENSITY), 5.50f);
+
+	
+	// light from candle, smaller, specular with a warmer tone
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(1, ShaderStateCache::LIGHT_POSITION), glm::vec3(17.0f, 2.15f, 5.0f));
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(1, ShaderStateCache::LIGHT_AMBIENT_COLOR), glm::vec3(0.25f, 0.25f, 0.25f));
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(1, ShaderStateCache::LIGHT_DIFFUSE_COLOR), glm::vec3(0.95f, 0.85f, 0.35f));
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(1, ShaderStateCache::LIGHT_SPECULAR_COLOR), glm::vec3(0.95f, 0.85f, 0.35f));
+	m_pShaderState->SetFloat(ShaderStateCache::GetLightUniform(1, ShaderStateCache::LIGHT_FOCAL_STRENGTH), 20.0f);
+	m_pShaderState->SetFloat(ShaderStateCache::GetLightUniform(1, ShaderStateCache::LIGHT_SPECULAR_INTENSITY), 15.0f);
+
+	/*m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(2, ShaderStateCache::LIGHT_POSITION), glm::vec3(0.0f, 3.0f, 20.0f));
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(2, ShaderStateCache::LIGHT_AMBIENT_COLOR), glm::vec3(0.2f, 0.2f, 0.2f));
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(2, ShaderStateCache::LIGHT_DIFFUSE_COLOR), glm::vec3(0.8f, 0.8f, 0.8f));
+	m_pShaderState->SetVec3(ShaderStateCache::GetLightUniform(2, ShaderStateCache::LIGHT_SPECULAR_COLOR), glm::vec3(0.0f, 0.0f, 0.0f));
+	m_pShaderState->SetFloat(ShaderStateCache::GetLightUniform(2, ShaderStateCache::LIGHT_FOCAL_STRENGTH), 12.0f);
+	m_pShaderState->SetFloat(ShaderStateCache::GetLightUniform(2, ShaderStateCache::LIGHT_SPECULAR_INTENSITY), 0.2f);*/
+}
+
+
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void SceneManager::PrepareScene()
+{
+	LoadSceneTextures();
+
+	// define the materials that will be used for the objects
+	// in the 3D scene
+	DefineObjectMaterials();
+	// give every material a handle matching its index
+	for (size_t i = 0; i < m_objectMaterials.size(); i++)
+	{
+		m_materialTags.Register(m_objectMaterials[i].tag);
+	}
+	// upload them all once, so a draw only selects one by handle
+	UploadMaterials();
+	// look up the handles for every texture and material drawn
+	// by RenderScene, so drawing never searches for a tag
+	ResolveSceneHandles();
+	// add and defile the light sources for the 3D scene
+	SetupSceneLights();
+
+	// every texture array stays bound to its own unit, and
+	// each instance picks its array from the shader's sampler
+	// array, so the samplers are only set once
+	int textureUnits[ShaderStateCache::TEXTURE_ARRAY_COUNT];
+	for (int unit = 0; unit < ShaderStateCache::TEXTURE_ARRAY_COUNT; unit++)
+	{
+		textureUnits[unit] = unit;
+	}
+	m_pShaderState->SetIntArray(ShaderStateCache::UNIFORM_OBJECT_TEXTURES, textureUnits, ShaderStateCache::TEXTURE_ARRAY_COUNT);
+	if (m_pTextureArrays->GetArrayCount() > ShaderStateCache::TEXTURE_ARRAY_COUNT)
+	{
+		std::cout << "ERROR: " << m_pTextureArrays->GetArrayCount() << " texture arrays were created, the shader samples only "
+			<< ShaderStateCache::TEXTURE_ARRAY_COUNT << std::endl;
+	}
+
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene - every basic shape is loaded
+	// into one shared arena, and the whole scene is drawn with
+	// one multi-draw indirect call where the context has it -
+	// MainCode loads the vertex shader that matches
+	m_pInstanceRenderer->Create(*m_pPrimitiveGeometry, InstanceRenderer::IsIndirectSupported());
+}
+
+
+
+
+/***********************************************************
+ *  ResolveSceneHandles()
+ *
+ *  This method is used for looking up the handles of every
+ *  texture and material tag that RenderScene draws with.
+ *  A tag that failed to load gets INVALID_HANDLE, which
+ *  the shader setters ignore.
+ ***********************************************************/
+void SceneManager::ResolveSceneHandles()
+{
+	for (int i = 0; i < g_SceneTextureHandleCount; i++)
+	{
+		m_sceneTextures.*(g_SceneTextureHandles[i].handle) = m_textureTags.Find(g_SceneTextureHandles[i].tag);
+	}
+
+	m_sceneMaterials.metal = m_materialTags.Find("metal");
+	m_sceneMaterials.wood = m_materialTags.Find("wood");
+	m_sceneMaterials.glass = m_materialTags.Find("glass");
+}
+
+
+// function for candle to make moving it around easier
+void SceneManager::RenderCandle(glm::vec3 scaleXYZ,
+								float XrotationDegrees,
+								float YrotationDegrees,
+								float ZrotationDegrees,
+								glm::vec3 positionXYZ)
+{
+	// every part is placed relative to the group, so moving
+	// the group only recomputes the matrices of its parts
+	BeginSceneGroup(positionXYZ);
+
+	// **** TORUS: Candle Jar ************************************************************************** DONE!
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		glm::vec3(0.0f));
+	//set texture and draw candle jar
+	SetShaderColor(0.95, 0.80, 0.55, 0.98f);
+	//SetShaderTexture("candle");
+	SetShaderMaterial(m_sceneMaterials.wood); //frosted glass reflects more like wood, not super shiny
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_TORUS); //Candle jar
+
+
+	// **** CYLINDER: Candle Wax ************************************************************************* DONE!
+	const glm::vec3 waxOffsetXYZ = glm::vec3(0.0f, -0.90f, 0.0f);
+	//set scale
+	scaleXYZ = glm::vec3(1.48, 1.45, 1.48); //inset and shorter than jar
+	//rotation
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		waxOffsetXYZ); // move inside the torus (candle jar)
+	//set color and draw wax
+	//SetShaderColor(0.70, 0.65, 0.65, 1.0f); // lighter cream almost white color
+	SetShaderTexture(m_sceneTextures.candle);
+	SetShaderMaterial(m_sceneMaterials.glass);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER); // Cyl 2
+
+
+	// **** CYLINDER: Wick #1 ************************************************************************* Done!
+	const glm::vec3 wickOneOffsetXYZ = glm::vec3(-0.6f, -0.30f, 0.0f);
+	// set scale
+	scaleXYZ = glm::vec3(0.05, 1.20, 0.05);
+	//rotation
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		wickOneOffsetXYZ);
+	//set color and draw wick
+	SetShaderColor(0.40, 0.25f, 0.11f, 1.0f); // dark brown
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+
+
+	// **** CYLINDER: Wick #2 ************************************************************************* DONE!
+	const glm::vec3 wickTwoOffsetXYZ = glm::vec3(0.55f, -0.30f, -0.25f);
+	// set scale
+	scaleXYZ = glm::vec3(0.05, 1.20, 0.05);
+	//rotation
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		wickTwoOffsetXYZ);
+	//set color and draw wick
+	SetShaderColor(0.40, 0.25f, 0.11f, 1.0f); // dark brown
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+
+	// **** CYLINDER: Wick #3 ************************************************************************* DONE!
+	const glm::vec3 wickThreeOffsetXYZ = glm::vec3(0.10f, -0.30f, 0.6f);
+	// set scale
+	scaleXYZ = glm::vec3(0.05, 1.20, 0.05);
+	//rotation
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		wickThreeOffsetXYZ);
+	//set color and draw wick
+	SetShaderColor(0.40, 0.25f, 0.11f, 1.0f); // dark brown
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+
+	//  **** Flame #1 *********************************************************************************
+	const glm::vec3 flameOneOffsetXYZ = glm::vec3(-0.60f, 0.70f, 0.0f);
+	// set scale and check
+	scaleXYZ = glm::vec3(0.15f, 0.55f, 0.10f); //
+	//rotation not needed for this shape right now
+	XrotationDegrees = 0.0f;//make flame uniquely tilt a bit
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		flameOneOffsetXYZ);
+
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.flame);
+	SetShaderMaterial(m_sceneMaterials.glass);
+	SetTextureUVScale(3.0, 2.0);
+	DrawMesh(PrimitiveGeometry::PART_CONE); // cone
+
+
+	//  **** Flame #2 *********************************************************************************
+	const glm::vec3 flameTwoOffsetXYZ = glm::vec3(0.55f, 0.70f, -0.25f);
+	// set scale and check
+	scaleXYZ = glm::vec3(0.15f, 0.55f, 0.10f); //
+	//rotation not needed for this shape right now
+	XrotationDegrees = 0.0f;//make flame uniquely tilt a bit
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		flameTwoOffsetXYZ);
+
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.flame);
+	SetShaderMaterial(m_sceneMaterials.glass);
+	SetTextureUVScale(3.0, 2.0);
+	DrawMesh(PrimitiveGeometry::PART_CONE); // cone
+
+
+	//  **** Flame #3 *********************************************************************************
+	const glm::vec3 flameThreeOffsetXYZ = glm::vec3(0.10f, 0.70f, 0.6f);
+	// set scale and check
+	scaleXYZ = glm::vec3(0.15f, 0.55f, 0.10f); //
+	//rotation not needed for this shape right now
+	XrotationDegrees = 0.0f;//make flame uniquely tilt a bit
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		flameThreeOffsetXYZ);
+
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.flame);
+	SetShaderMaterial(m_sceneMaterials.glass);
+	SetTextureUVScale(3.0, 2.0);
+	DrawMesh(PrimitiveGeometry::PART_CONE); // cone
+
+	EndSceneGroup();
+}
+
+
+
+// function for headphones to make moving them around easier
+void SceneManager::RenderHeadphones(glm::vec3 positionXYZ)
+{
+	// every part is placed relative to the group, so moving
+	// the group only recomputes the matrices of its parts
+	BeginSceneGroup(positionXYZ);
+
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+
+	// *************************************************************** headband	
+	// set scale and check
+	scaleXYZ = glm::vec3(2.0f, 2.0f, 1.0f);
+	XrotationDegrees = 80.0;
+	YrotationDegrees = 10.0;
+	ZrotationDegrees = 120.0;
+	// set position 
+	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+//	SetShaderColor(0.77f, 0.68f, 0.60f, 1.0f);
+	SetShaderTexture(m_sceneTextures.headphones);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_HALF_TORUS);
+
+	// *************************************************************** L ear muff	
+	// set scale and check
+	scaleXYZ = glm::vec3(1.20f, 0.800f, 2.0f);
+	XrotationDegrees = 90.0;
+	YrotationDegrees = 0.0;
+	ZrotationDegrees = 20.0;
+	// set position 
+	positionXYZ = glm::vec3(1.15f, -0.05f, 2.05f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.headphones);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_TORUS);
+
+	// *************************************************************** L Ear cap		
+	// set scale and check
+	//scaleXYZ = glm::vec3(0.90f, 0.250f, 0.65f);
+	scaleXYZ = glm::vec3(1.0f, 0.30f, 0.75f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = -20.0;
+	ZrotationDegrees = 0.0f;
+	// set position 
+	positionXYZ = glm::vec3(1.15f, 0.05f, 2.05f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.headphones);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+	// *************************************************************** R ear	
+	// set scale and check
+	scaleXYZ = glm::vec3(1.20f, 0.800f, 2.0f);
+	XrotationDegrees = 90.0;
+	YrotationDegrees = 0.0;
+	ZrotationDegrees = 40.0;
+	// set position 
+	positionXYZ = glm::vec3(2.5f, -0.05f, -0.15f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.headphones);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_TORUS);
+
+
+	// ***************************************************************  R Ear cap
+	// set scale and check
+	//scaleXYZ = glm::vec3(1.0f, 0.30f, 0.75f);
+	scaleXYZ = glm::vec3(1.0f, 0.30f, 0.75f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = -40.0;
+	ZrotationDegrees = 0.0f;
+	// set position 
+	positionXYZ = glm::vec3(2.5f, 0.05f, -0.15f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.headphones);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+
+
+	// *************************************************************** headband to R Ear connector	
+	// set scale and check
+	scaleXYZ = glm::vec3(0.2f, 1.85f, 0.2f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = -50.0f;
+	ZrotationDegrees = -65.0f;
+	// set position 
+	positionXYZ = glm::vec3(0.70f, -0.40f, -1.95f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.headphones);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+
+// *************************************************************** headband to L Ear connector	
+	// set scale and check
+	scaleXYZ = glm::vec3(0.2f, 1.65f, 0.2f);
+
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = -5.0f;
+	ZrotationDegrees = -65.0f;
+	// set position 
+	positionXYZ = glm::vec3(-1.30f, -0.20f, 1.55f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.headphones);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+	EndSceneGroup();
+}
+
+
+// function for the paintbrushes to make moving them around easier
+void SceneManager::RenderPaintbrushes(glm::vec3 positionXYZ)
+{
+	// every part is placed relative to the group, so moving
+	// the group only recomputes the matrices of its parts
+	BeginSceneGroup(positionXYZ);
+
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+
+	// top pb
+	scaleXYZ = glm::vec3(0.10f, 6.0f, 0.10f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 25.0f;
+	ZrotationDegrees = 90.0f;
+	// set position 
+	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.pbHandle);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+	//top bristle
+	scaleXYZ = glm::vec3(0.10f, 1.0f, 0.10f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 25.0f;
+	ZrotationDegrees = 90.0f;
+	// set position 
+	positionXYZ = glm::vec3(-5.45f, 0.0f, 2.53f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.candle);
+	//SetShaderMaterial("wood");
+	DrawMesh(PrimitiveGeometry::PART_CONE);
+
+
+
+
+	// mid pb
+	scaleXYZ = glm::vec3(0.10f, 6.0f, 0.10f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 30.0f;
+	ZrotationDegrees = 90.0f;
+	// set position 
+	positionXYZ = glm::vec3(0.05f, 0.0f, 0.0f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.pbHandle);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+	//medium bristle
+	scaleXYZ = glm::vec3(0.10f, 1.0f, 0.10f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 30.0f;
+	ZrotationDegrees = 90.0f;
+	// set position 
+	positionXYZ = glm::vec3(-5.15f, 0.0f, 3.0f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.candle);
+	//SetShaderMaterial("wood");
+	DrawMesh(PrimitiveGeometry::PART_CONE);
+
+
+
+	// bottom pb
+	scaleXYZ = glm::vec3(0.10f, 6.0f, 0.10f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 35.0f;
+	ZrotationDegrees = 90.0f;
+	// set position 
+	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.pbHandle);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+	//bottom bristle
+	scaleXYZ = glm::vec3(0.10f, 1.0f, 0.10f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 35.0f;
+	ZrotationDegrees = 90.0f;
+	// set position 
+	positionXYZ = glm::vec3(-4.90f, 0.0f, 3.45f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.candle);
+	//SetShaderMaterial("wood");
+	DrawMesh(PrimitiveGeometry::PART_CONE);
+
+	EndSceneGroup();
+}
+
+
+// TODO: Complete RenderController function
+void SceneManager::RenderController()
+{
+
+}
+
+// TODO: Complete RenderDrink function
+void SceneManager::RenderDrink(glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	// every part is placed relative to the group, so moving
+	// the group only recomputes the matrices of its parts
+	BeginSceneGroup(positionXYZ);
+
+	// ******************************************************************************   DRINK ******************************************************************************
+	// main can
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		glm::vec3(0.0f));
+	// Set texture and shader and  draw
+	//SetShaderColor(0.92, 0.55, 0.84, 1); //set to blue
+	SetShaderTexture(m_sceneTextures.drink);
+	SetShaderMaterial(m_sceneMaterials.metal);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+	// set the XYZ scale for the mesh                 ************** can top *************
+	scaleXYZ = glm::vec3(1.025f, 0.025f, 1.025f);
+	// set the XYZ rotation for the mesh
+	const glm::vec3 topOffsetXYZ = glm::vec3(0.0f, 5.00f, 0.0f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 80.0f;
+	ZrotationDegrees = 0.0f;
+	//// set the XYZ position for the mesh
+	//positionXYZ = glm::vec3(0.0f, 5.02f, 10.0f);
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		topOffsetXYZ);
+	// Set texture and shader and  draw
+	SetShaderTexture(m_sceneTextures.cantop);
+	SetShaderMaterial(m_sceneMaterials.metal);
+	SetTextureUVScale(0.8, 0.90);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+	EndSceneGroup();
+}
+
+
+void SceneManager::RenderPaintTube(glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ,
+	int textureHandle)
+
+{
+	// every part is placed relative to the group, so moving
+	// the group only recomputes the matrices of its parts
+	BeginSceneGroup(positionXYZ);
+
+	// ******************************************************************************   TUBE ******************************************************************************
+	scaleXYZ = glm::vec3(0.55f, 5.0f, 0.55f);
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		glm::vec3(0.0f));
+	SetShaderTexture(textureHandle);
+	SetShaderMaterial(m_sceneMaterials.metal);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+	// ******************************************************************************   CAP ******************************************************************************
+	scaleXYZ = glm::vec3(0.45f, 0.25f, 0.45f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	// Adjust position with offset
+	const glm::vec3 capOffsetXYZ = glm::vec3(0.0f, -5.45f, 0.0f);
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		capOffsetXYZ);
+	SetShaderTexture(m_sceneTextures.pages);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(0.014, 0.014);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+	// ******************************************************************************   CAP NECK ******************************************************************************
+	scaleXYZ = glm::vec3(0.2f, 0.2f, 0.2f);
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	// Adjust position with offset
+	const glm::vec3 neckOffsetXYZ = glm::vec3(0.0f, -5.2f, 0.0f);
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		neckOffsetXYZ);
+	SetShaderTexture(m_sceneTextures.pages);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(0.01, 0.01);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+	
+
+	////original positions for offsets
+	//positionXYZ = glm::vec3(7.0f, 5.5f, 3.0f); //tube
+	//positionXYZ = glm::vec3(7.0f, 0.3f, 3.0f); //cap
+	//positionXYZ = glm::vec3(7.0f, 0.5f, 3.0f); //neck
+
+	EndSceneGroup();
+}
+
+
+
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene.  The
+ *  scene is recorded into the command list the first time
+ *  and after it is invalidated, and the recording is
+ *  replayed every frame.
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	// count the uniform updates of this frame on their own
+	m_pShaderState->BeginFrame();
+
+	if (!m_bSceneRecorded)
+	{
+		RecordScene();
+	}
+	ReplayScene();
+}
+
+/***********************************************************
+ *  InvalidateScene()
+ *
+ *  This method is used for recording the scene again before
+ *  the next frame is drawn.  Textures are recorded by handle,
+ *  so streaming, reloading and evicting them does not need
+ *  it.
+ ***********************************************************/
+void SceneManager::InvalidateScene()
+{
+	m_bSceneRecorded = false;
+}
+
+/***********************************************************
+ *  ReplayScene()
+ *
+ *  This method is used for drawing the recorded scene.  The
+ *  recorded state changes are applied to the draw state and
+ *  every recorded draw is drawn with it, so nothing of the
+ *  scene definition runs.  Draws outside the view frustum
+ *  or hidden behind the biggest solid shapes are dropped
+ *  before any of them reaches OpenGL.
+ ***********************************************************/
+void SceneManager::ReplayScene()
+{
+	CullScene();
+
+	// the draws are collected and drawn together at the end
+	m_pInstanceRenderer->Begin(m_viewPosition);
+	m_pStaticBatcher->Begin();
+	m_pOcclusionCuller->Begin(m_viewProjection, m_viewPosition);
+	m_pendingDraws.clear();
+	m_pendingBounds.clear();
+
+	size_t offset = 0;
+	int draw = 0;
+	CommandList::COMMAND command;
+	while (m_pCommandList->Read(offset, command))
+	{
+		switch (command.opcode)
+		{
+		case CommandList::OP_COLOR:
+			m_drawState.bUseTexture = false;
+			m_drawState.color = command.color;
+			break;
+		case CommandList::OP_TEXTURE:
+			ApplyTexture(command.handle);
+			break;
+		case CommandList::OP_UV_SCALE:
+			m_drawState.uvScale = command.uvScale;
+			break;
+		case CommandList::OP_MATERIAL:
+			m_drawState.material = command.handle;
+			break;
+		default:
+			SubmitDraw(command, draw++);
+			break;
+		}
+	}
+
+	SubmitVisibleDraws();
+	DrawStaticBatches();
+
+	// draw every use of each shape part with one draw call
+	m_pInstanceRenderer->Flush();
+}
+
+/***********************************************************
+ *  CullScene()
+ *
+ *  This method is used for finding the recorded draws that
+ *  are not outside the view frustum, walking the bounding
+ *  volume tree instead of testing every draw.  The tree's
+ *  subtrees are walked on the job system's threads.
+ ***********************************************************/
+void SceneManager::CullScene()
+{
+	m_culledDraws = 0;
+	m_drawnDraws = 0;
+	m_culledBatches = 0;
+	m_drawnBatches = 0;
+	m_occludedDraws = 0;
+	m_occludedBatches = 0;
+	m_staticTexturedDraws = 0;
+	m_blendedStaticDraws = 0;
+
+	m_visibleDraws.clear();
+	m_pBoundingVolumes->Cull(m_viewFrustum, m_visibleDraws);
+	m_drawVisible.assign(m_drawLeaves.size(), 0);
+	for (size_t i = 0; i < m_visibleDraws.size(); i++)
+	{
+		m_drawVisible[m_visibleDraws[i]] = 1;
+	}
+}
+
+/***********************************************************
+ *  SubmitVisibleDraws()
+ *
+ *  This method is used for drawing the occluders offered by
+ *  the replayed draws into the occlusion culler's depth
+ *  buffer, testing the draws kept inside the view frustum
+ *  against it on the job system, and adding the ones that
+ *  are seen to the instance renderer.
+ ***********************************************************/
+void SceneManager::SubmitVisibleDraws()
+{
+	m_pOcclusionCuller->RenderOccluders();
+	m_pOcclusionCuller->TestBounds(m_pendingBounds, m_pendingVisible);
+
+	for (size_t i = 0; i < m_pendingDraws.size(); i++)
+	{
+		if (!m_pendingVisible[i])
+		{
+			m_occludedDraws++;
+			continue;
+		}
+		const PENDING_DRAW& pending = m_pendingDraws[i];
+		m_pInstanceRenderer->Add(pending.part, pending.bTransparent, pending.instance);
+		m_drawnDraws++;
+	}
+}
+
+/***********************************************************
+ *  RecordScene()
+ *
+ *  This method is used for recording the 3D scene by 
+ *  transforming and drawing the basic 3D shapes into the
+ *  command list.  The scene is recorded on the GL thread
+ *  alone, as its objects take scene graph nodes in the
+ *  order they are drawn and share the draw state.
+ ***********************************************************/
+void SceneManager::RecordScene()
+{
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+	m_pCommandList->Clear();
+	m_drawParts.clear();
+	m_drawNodes.clear();
+	// the objects are drawn in the same order every recording
+	m_pTransforms->BeginFrame();
+	m_pSceneGraph->BeginFrame();
+	m_sceneNode = 0;
+	m_sceneGroup = -1;
+	m_drawState.node = -1;
+	m_drawState.bStatic = false;
+
+	RenderCandle(glm::vec3(1.5f, 1.5f, 5.0f),	//scale		*Torus/Jar only*
+				90.0f, 0.0f, 0.0f,				//rotation	*Torus/Jar only
+				glm::vec3(17.0f, 1.0f, 5.0f ));	//position	All meshes in candle
+
+
+	RenderDrink(glm::vec3(1.0f, 5.0f, 1.0f),		//scale		*Cylinder/Can base only*
+				0.0f, 125.0f, 0.0f,					//rotation	*Cylinder/Can base only
+				glm::vec3(-16.0f, 0.01f, 10.0f));	//position	All meshes in drink
+
+	RenderPaintTube(glm::vec3(0.55f, 5.0f, 0.55f),		//scale		*Cylinder/Can base only*
+					180.0f, 200.0f, 0.0f,				//rotation	*Cylinder/Can base only
+					glm::vec3(7.50f, 5.5f, 3.0f),		//position	All meshes
+					m_sceneTextures.rPaint);
+
+	RenderPaintTube(glm::vec3(0.55f, 5.0f, 0.55f),		//scale		base only*
+					180.0f, 200.0f, 0.0f,				//rotation	base only
+					glm::vec3(9.5f, 5.5f, 2.5f),		//position	All meshes
+					m_sceneTextures.yPaint);
+
+	RenderPaintTube(glm::vec3(0.55f, 5.0f, 0.55f),		//scale		base only*
+					180.0f, 200.0f, 0.0f,				//rotation	base only
+					glm::vec3(11.0f, 5.5f, 3.75f),		//position	All meshes in drink
+					m_sceneTextures.bPaint);
+		 
+	
+	// nothing from the desk on ever moves
+	BeginStaticDraws();
+
+//DESK ******************************************************************************
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(25.0f, -40.0f, 10.0f);
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.0f, 0.0f, 5.0f);
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	// set texture and draw
+	SetShaderTexture(m_sceneTextures.wood); 
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_PLANE);
+	
+
+//WALL ******************************************************************************
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(50.0f, 100.0f, -20.0f);
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.0f, 10.0f, -2.0f);
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	// Set texture and  draw
+	//SetShaderColor(0.42, 0.55, 0.84, 1); //set to blue
+	SetShaderTexture(m_sceneTextures.curtain);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(6.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_PLANE);
+
+
+// ************************************************************* Single ROTATED paint tube ************************************************************* 
+	
+	// the parts are placed relative to the tube
+	BeginSceneGroup(glm::vec3(8.95f, 0.75f, 5.0f));
+
+	// ********************************************   TUBE ********************************************
+	scaleXYZ = glm::vec3(0.55f, 5.0f, 0.55f);
+	//rotation
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 60.0f;
+	//position
+	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f); 
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	SetShaderTexture(m_sceneTextures.wPaint); //TODO - create and add white lable texture
+	SetShaderMaterial(m_sceneMaterials.metal);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER_OPEN_TOP);
+
+	// ********************************************   CAP ********************************************
+	scaleXYZ = glm::vec3(0.45f, 0.3f, 0.45f);
+	//rotation
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 60.0f;
+	//position 
+	positionXYZ = glm::vec3(-4.60f, 0.0f, 2.65f);
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	SetShaderTexture(m_sceneTextures.pages);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(0.014, 0.014);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+	// ******************************************** CAP NECK ********************************************
+	scaleXYZ = glm::vec3(0.2f, 0.4f, 0.2f);
+	//rotation
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 60.0f;
+	//position 
+	positionXYZ = glm::vec3(-4.30f, 0.0f, 2.45f);
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	SetShaderTexture(m_sceneTextures.pages);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(0.01, 0.01);
+	DrawMesh(PrimitiveGeometry::PART_CYLINDER);
+
+	EndSceneGroup();
+
+
+
+// ****************************************************************************************************** BOOKS ******************************************************************************************************    
+
+// **** Book 1 ******************************************************************************
+	// set scale and check
+	scaleXYZ = glm::vec3(8.0f, 10.5f, 0.50f);
+	//rotation
+	XrotationDegrees = 90.0f; 
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 65.0f;
+	// set and check position 
+	positionXYZ = glm::vec3(-9.0f, 0.40f, 5.0f); 
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture of book 1
+	SetShaderTexture(m_sceneTextures.artbook);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	DrawMesh(PrimitiveGeometry::PART_BOX); // book 1
+
+
+// **** Book 2 ******************************************************************************
+	// set scale and check
+	scaleXYZ = glm::vec3(8.0f, 12.5f, 0.65f);//same for all books
+	//rotation not needed for this shape right now
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 70.0f;
+	// set position 
+	positionXYZ = glm::vec3(-9.0f, 1.0f, 4.5f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.hlartbook);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_BOX); // book 2
+
+
+// **** Book 3 ******************************************************************************
+	// set scale and check
+	scaleXYZ = glm::vec3(8.0f, 10.0f, 1.25f);//same for all books
+	//rotation not needed for this shape right now
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 70.0f;
+	// set position 
+	positionXYZ = glm::vec3(-9.0f, 1.90f, 4.0f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ); 
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.botwartbook);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_BOX); // book 3
+
+	//spine
+	// set scale and check
+	scaleXYZ = glm::vec3(10.0f, 0.25f, 1.25f);//same for all books
+	//rotation not needed for this shape right now
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = -20.0f;
+	// set position 
+	positionXYZ = glm::vec3(-7.60f, 1.90f, 7.85f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.botwSpine);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+
+	//pages- top
+	// set scale and check
+	scaleXYZ = glm::vec3(7.8f, 0.20f, 1.15f);
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = -110.0f;
+	// set position 
+	positionXYZ = glm::vec3(-13.60f, 1.90f, 5.75f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.pages);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(0.3, 0.3);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+	//pages - bottom
+	// set scale and check
+	scaleXYZ = glm::vec3(7.8f, 0.20f, 1.15f);
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = -110.0f;
+	// set position 
+	positionXYZ = glm::vec3(-4.30f, 1.90f, 2.45f); 
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.pages);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(0.3, 0.3);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+	//pages-side
+	// set scale and check
+	scaleXYZ = glm::vec3(10.02f, 0.25f, 1.15f);
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = -200.0f;
+	// set position 
+	positionXYZ = glm::vec3(-10.35f, 1.90f, 0.30f);	//**********************
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.pages);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(0.3, 0.3);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+	
+
+
+// **** Book 4 ******************************************************************************
+	// set scale and check
+	scaleXYZ = glm::vec3(8.0f, 10.0f, 1.0f);//same for all booksd
+	//rotation not needed for this shape right now
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 75.5f;
+	// set position 
+	positionXYZ = glm::vec3(-8.950f, 3.10f, 3.85f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.er);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_BOX); // book 4
+
+	//pages- top
+	// set scale and check
+	scaleXYZ = glm::vec3(7.8f, 0.20f, 0.90f);
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 75.5f;
+	// set position 
+	positionXYZ = glm::vec3(-13.78f, 3.10f, 5.0f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.pages);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(0.3, 0.3);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+	
+	//pages - bottom
+	// set scale and check
+	scaleXYZ = glm::vec3(7.8f, 0.20f, 0.9f);
+	XrotationDegrees = 90.0f; 
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 75.5f;
+	// set position 
+	positionXYZ = glm::vec3(-4.22, 3.10f, 2.5f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.pages);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(0.3, 0.3);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+	
+	//pages-side
+	// set scale and check
+	scaleXYZ = glm::vec3(10.02f, 0.25f, 0.90f);
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = -14.50;
+	// set position 
+	positionXYZ = glm::vec3(-9.99f, 3.10f, 0.08f);	//**********************
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.pages);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(0.3, 0.3);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+
+	//spine
+	// set scale and check
+	scaleXYZ = glm::vec3(10.0f, 0.25f, 0.98f);//same for all books
+	//rotation not needed for this shape right now
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = -15.0f;
+	// set position 
+	positionXYZ = glm::vec3(-7.98f, 3.10f, 7.65f);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.erSpine2);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+	
+
+// ******************************************************************************************************    TODO: canvas painting (box) ******************************************************************************************************
+//	
+// 	//Canvas
+	// set scale and check
+	scaleXYZ = glm::vec3(5.0f, 3.5f, 0.4f);
+	XrotationDegrees = -20.0;
+	YrotationDegrees = 0.0;
+	ZrotationDegrees = -0.0;
+	// set position 
+	positionXYZ = glm::vec3(2.25, 1.75, 4.5);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderTexture(m_sceneTextures.painting1);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+
+	//pic standd
+	//****************************************************************
+	// set scale and check
+	scaleXYZ = glm::vec3(0.50f, 0.3f, 1.0f);
+	XrotationDegrees = -20.0;
+	YrotationDegrees = 0.0;
+	ZrotationDegrees = -0.0;
+	// set position 
+	positionXYZ = glm::vec3(0.80, 0.0, 5.0);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderColor(0.52f, 0.4f, 0.24f, 1.0f);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+	//****************************************************************
+	// set scale and check
+	scaleXYZ = glm::vec3(0.50f, 0.3f, 1.0f);
+	XrotationDegrees = -20.0;
+	YrotationDegrees = 0.0;
+	ZrotationDegrees = -0.0;
+	// set position 
+	positionXYZ = glm::vec3(3.80, 0.0, 5.0);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderColor(0.52f, 0.4f, 0.24f, 1.0f);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+	//****************************************************************
+	// set scale and check
+	scaleXYZ = glm::vec3(0.50f, 4.40f, 1.0f);
+	XrotationDegrees = -20.0;
+	YrotationDegrees = 0.0;
+	ZrotationDegrees = 0.0;
+	// set position 
+	positionXYZ = glm::vec3(3.80, 2.0, 3.5);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderColor(0.52f, 0.4f, 0.24f, 1.0f);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+	//****************************************************************
+	// set scale and check
+	scaleXYZ = glm::vec3(0.50f, 4.40f, 1.0f);
+	XrotationDegrees = -20.0;
+	YrotationDegrees = 0.0;
+	ZrotationDegrees = 0.0;
+	// set position 
+	positionXYZ = glm::vec3(0.80, 2.0, 3.5);
+	//set transformation
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	//set texture and draw
+	SetShaderColor(0.52f, 0.4f, 0.24f, 1.0f);
+	SetShaderMaterial(m_sceneMaterials.wood);
+	SetTextureUVScale(1.0, 1.0);
+	DrawMesh(PrimitiveGeometry::PART_BOX);
+
+
+
+
+
+
+	RenderHeadphones(glm::vec3(-6.0f, 0.55f, 11.4f));	//position	All meshes
+
+	RenderPaintbrushes(glm::vec3(13.7f, 0.25f, 4.85f));	//position	All meshes
+
+	EndStaticDraws();
+
+	UpdateDrawBounds();
+
+	m_bSceneRecorded = true;
+	m_recordCount++;
+}
@@ -1,147 +1,458 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.h
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager *pShaderManager);
-	// destructor
-	~SceneManager();
-
-	// properties for loaded texture access
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	// properties for object materials
-	struct OBJECT_MATERIAL
-	{
-		float ambientStrength;
-		glm::vec3 ambientColor;
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes *m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[20]; //adjusted for additional textures
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// methods for managing OpenGL textures
-	bool CreateGLTexture(const char* filename, std::string tag);
-	void BindGLTextures();
-	void DestroyGLTextures();
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-	
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	// set the texture UV scale into the shader
-	void SetTextureUVScale(
-		float u, float v);
-
-	//create function to allow for moving entire set of candle meshes
-	void RenderCandle(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	//TODO: Function for Headphones
-	void RenderHeadphones();
-
-	//TODO: Function for Controller
-	void RenderController();
-
-	//TODO: Function for Controller
-	void RenderDrink(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	void RenderPaintTube(glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ,
-		const char* textureName);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-
-
-
-public:
-
-	/*** The following methods are for the students to ***/
-	/*** customize for their own 3D scene              ***/
-	void PrepareScene();
-	void RenderScene();
-
-	//load texture files
-	void LoadSceneTextures();
-
-
-	// define all the object materials before rendering
-	void DefineObjectMaterials();
-	// add and define the light sources before rendering
-	void SetupSceneLights();
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.h
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "BoundingVolumeTree.h"
+#include "CommandList.h"
+#include "Frustum.h"
+#include "InstanceRenderer.h"
+#include "JobSystem.h"
+#include "MaterialBuffer.h"
+#include "OcclusionCuller.h"
+#include "PrimitiveGeometry.h"
+#include "SceneGraph.h"
+#include "ShaderManager.h"
+#include "ShaderStateCache.h"
+#include "StaticBatcher.h"
+#include "TagRegistry.h"
+#include "TextureArrayManager.h"
+#include "TextureLoader.h"
+#include "TextureResidency.h"
+#include "TextureStreamer.h"
+#include "TextureWatcher.h"
+#include "TransformStore.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor
+	SceneManager(ShaderManager *pShaderManager);
+	// destructor
+	~SceneManager();
+
+	// properties for loaded texture access
+	struct TEXTURE_INFO
+	{
+		std::string tag;
+		// image file the texture is loaded from
+		std::string filename;
+		// texture index in the texture array manager that is
+		// drawn, the placeholder while the image is not drawable
+		uint32_t ID;
+		// texture index reserved for the image
+		int reservedID;
+		// set while the image is being streamed into its layer
+		bool bStreaming;
+		// set while the image is being decoded
+		bool bDecoding;
+		// other tags that draw this texture because their image
+		// files are identical to this one or near duplicates
+		int sharedTags;
+		// set while the image is loaded again after its file
+		// changed, with when the change was noticed
+		bool bReloading;
+		std::chrono::steady_clock::time_point reloadStart;
+		double reloadDecodeMilliseconds;
+		// set when the file changed again while it was decoding
+		bool bDecodeAgain;
+	};
+
+	// properties for object materials
+	struct OBJECT_MATERIAL
+	{
+		float ambientStrength;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		std::string tag;
+	};
+
+	// handles of the textures drawn by RenderScene
+	struct SCENE_TEXTURES
+	{
+		int wood;
+		int candle;
+		int er;
+		int flame;
+		int artbook;
+		int hlartbook;
+		int botwartbook;
+		int drink;
+		int cantop;
+		int botwSpine;
+		int pages;
+		int yPaint;
+		int bPaint;
+		int rPaint;
+		int erSpine2;
+		int painting1;
+		int curtain;
+		int wPaint;
+		int headphones;
+		int pbHandle;
+	};
+
+	// handles of the materials drawn by RenderScene
+	struct SCENE_MATERIALS
+	{
+		int metal;
+		int wood;
+		int glass;
+	};
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// sets the uniforms through locations looked up once,
+	// skipping uploads that would not change anything
+	ShaderStateCache* m_pShaderState;
+	// vertices and indices of the basic shapes
+	PrimitiveGeometry* m_pPrimitiveGeometry;
+	// draws every use of a shape part with one draw call
+	InstanceRenderer* m_pInstanceRenderer;
+	// bakes the draws that never move into a few batches
+	StaticBatcher* m_pStaticBatcher;
+	// textured static draws of the last frame, and the static
+	// draws kept out of the batches because they are blended
+	int m_staticTexturedDraws;
+	int m_blendedStaticDraws;
+	// splits the per-draw work of a frame over worker threads
+	JobSystem* m_pJobSystem;
+	// the state changes and draws of the scene, recorded once
+	// and replayed every frame
+	CommandList* m_pCommandList;
+	// false until the scene is recorded, and again after it is
+	// invalidated
+	bool m_bSceneRecorded;
+	unsigned int m_recordCount;
+	// true while the scene is recorded only to find the texture
+	// tags its draws use
+	bool m_bFindingDrawnTextures;
+	// the world bounds of every recorded draw, and the leaf of
+	// each draw in it by its index in the command list
+	BoundingVolumeTree* m_pBoundingVolumes;
+	std::vector<int> m_drawLeaves;
+	std::vector<PrimitiveGeometry::BOUNDS> m_drawBounds;
+	// the part and transform node of every recorded draw
+	std::vector<PrimitiveGeometry::PART> m_drawParts;
+	std::vector<int> m_drawNodes;
+	// the view the draws are culled against, the draws found
+	// inside it in the last frame, and a flag per draw
+	Frustum m_viewFrustum;
+	std::vector<int> m_visibleDraws;
+	std::vector<char> m_drawVisible;
+	// draws and static batches culled and drawn in the last
+	// frame
+	int m_culledDraws;
+	int m_drawnDraws;
+	int m_culledBatches;
+	int m_drawnBatches;
+	// finds the draws hidden behind the biggest solid shapes,
+	// once the view they are seen with is set
+	OcclusionCuller* m_pOcclusionCuller;
+	glm::mat4 m_viewProjection;
+	bool m_bViewFrustumSet;
+	// a replayed draw inside the view frustum, kept until the
+	// occluders of the frame are drawn
+	struct PENDING_DRAW
+	{
+		PrimitiveGeometry::PART part;
+		bool bTransparent;
+		InstanceRenderer::INSTANCE instance;
+	};
+	std::vector<PENDING_DRAW> m_pendingDraws;
+	std::vector<PrimitiveGeometry::BOUNDS> m_pendingBounds;
+	std::vector<char> m_pendingVisible;
+	// draws and static batches hidden in the last frame
+	int m_occludedDraws;
+	int m_occludedBatches;
+	// pointer to the worker pool for decoding texture images
+	TextureLoader* m_pTextureLoader;
+	// pointer to the texture arrays holding the loaded textures
+	TextureArrayManager* m_pTextureArrays;
+	// streams decoded images into the texture arrays
+	TextureStreamer* m_pTextureStreamer;
+	// keeps the texture arrays inside the memory budget
+	TextureResidency* m_pTextureResidency;
+	// notices changed image files so they can be reloaded
+	TextureWatcher* m_pTextureWatcher;
+	// stream textures in over the first frames instead of
+	// loading them all before the first frame
+	bool m_bStreamTextures;
+	// bytes of pixels uploaded per frame while streaming
+	size_t m_textureUploadBudget;
+	// texture index of the 1x1 placeholder, or -1
+	int m_placeholderTexture;
+	bool m_bPlaceholderUploaded;
+	// textures still decoding or streaming
+	int m_streamingTextures;
+	// for reporting how long streaming took
+	std::chrono::steady_clock::time_point m_streamStart;
+	int m_streamFrames;
+	// total number of loaded textures
+	int m_loadedTextures;
+	// decoding skipped by sharing textures between duplicate
+	// image files, added up as the shared textures are decoded
+	double m_sharedDecodeMilliseconds;
+	// loaded textures info
+	std::vector<TEXTURE_INFO> m_textureIDs;
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// the defined materials in a uniform buffer, indexed by handle
+	MaterialBuffer* m_pMaterialBuffer;
+	// local matrices of the drawn objects, composed again only
+	// when their transforms change
+	TransformStore* m_pTransforms;
+	// groups the drawn objects so a group moves as one
+	SceneGraph* m_pSceneGraph;
+	// node of the next transform set in the frame, and the
+	// group node it is added below, or -1
+	int m_sceneNode;
+	int m_sceneGroup;
+	// texture tags, the handles index m_textureIDs
+	TagRegistry m_textureTags;
+	// material tags, the handles index m_objectMaterials
+	TagRegistry m_materialTags;
+	// texture and material handles resolved in PrepareScene
+	SCENE_TEXTURES m_sceneTextures;
+	SCENE_MATERIALS m_sceneMaterials;
+
+	// what the next draw is drawn with - like the uniforms it
+	// replaces, every value is kept until it is set again.  The
+	// node and static flag are used while recording, the rest
+	// while replaying
+	struct DRAW_STATE
+	{
+		// scene graph node of the last transform set
+		int node;
+		bool bUseTexture;
+		// handle, texture array unit, layer and image rectangle of
+		// the last texture set, and whether its image has pixels
+		// that are not fully opaque
+		int textureHandle;
+		int textureUnit;
+		float textureLayer;
+		glm::vec4 textureRect;
+		bool bTransparentTexture;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		int material;
+		// whether the draw never moves and can be baked
+		bool bStatic;
+	};
+	DRAW_STATE m_drawState;
+	// camera position the draws are sorted by distance from
+	glm::vec3 m_viewPosition;
+
+	// methods for managing OpenGL textures
+	bool CreateGLTexture(const char* filename, std::string tag, bool bAsync = false);
+	bool StreamGLTexture(const TextureLoader::TEXTURE_REQUEST& request);
+	void RestreamGLTexture(int handle);
+	void FinishGLTexture(int handle, bool bLoaded);
+	bool FitsGLTexture(int texture, const TextureLoader::DECODED_IMAGE& image) const;
+	int RegisterGLTexture(const std::string& filename, const std::string& tag, int texture);
+	void ShareGLTextures(const std::vector<TextureLoader::TEXTURE_REQUEST>& requests, const std::vector<int>& sharedWith);
+	void UpdateTextureResidency();
+	void ReloadChangedTextures();
+	int ReserveGLTexture(const TextureLoader::DECODED_IMAGE& image);
+	void UploadGLTexture(int texture, const TextureLoader::DECODED_IMAGE& image);
+	void BindGLTextures();
+	void DestroyGLTextures();
+	int FindTextureID(std::string tag);
+	int FindTextureSlot(std::string tag);
+
+	// find a defined material by tag
+	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+	// copy the defined materials into the material uniform buffer
+	void UploadMaterials();
+	
+	// set the transformation values 
+	// into the transform buffer
+	void SetTransformations(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+	// scene graph node of the next transform in the frame
+	int NextSceneNode();
+	// place the transforms set until EndSceneGroup() relative
+	// to a group position
+	void BeginSceneGroup(glm::vec3 positionXYZ);
+	void EndSceneGroup();
+	// mark the draws until EndStaticDraws() as never moving,
+	// so they are baked into the static batches
+	void BeginStaticDraws();
+	void EndStaticDraws();
+	// bake the static draws if they changed and draw the
+	// batches
+	void DrawStaticBatches();
+
+	// record a draw of a shape part with the last transform
+	void DrawMesh(PrimitiveGeometry::PART part);
+	// find the world bounds of the recorded draws and keep them
+	// in the bounding volume tree
+	void UpdateDrawBounds();
+	// record the scene once to flag the texture handle fields
+	// its draws use, before any texture is loaded
+	void FindDrawnTextureTags(std::vector<char>& drawn);
+
+	// record the scene into the command list, and draw the
+	// recorded scene
+	void RecordScene();
+	void ReplayScene();
+	// select a texture's array, layer and image rectangle for
+	// the replayed draws that follow
+	void ApplyTexture(int textureHandle);
+	// add a replayed draw with the draw state, instanced with
+	// the other draws of the part when the frame is flushed,
+	// unless it was culled
+	void SubmitDraw(const CommandList::COMMAND& command, int draw);
+	// find the recorded draws inside the view frustum
+	void CullScene();
+	// draw the occluders of the frame, and add the draws inside
+	// the view frustum that are not hidden behind them
+	void SubmitVisibleDraws();
+
+	// record the color of the draws that follow
+	void SetShaderColor(
+		float redColorValue,
+		float greenColorValue,
+		float blueColorValue,
+		float alphaValue);
+
+	// record the texture of the draws that follow
+	void SetShaderTexture(
+		int textureHandle);
+	// load-time convenience that looks the texture up by tag
+	void SetShaderTexture(
+		std::string textureTag);
+
+	// record the texture UV scale of the draws that follow
+	void SetTextureUVScale(
+		float u, float v);
+
+	//create function to allow for moving entire set of candle meshes
+	void RenderCandle(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// draw the headphones as one group
+	void RenderHeadphones(
+		glm::vec3 positionXYZ);
+
+	// draw the three paintbrushes as one group
+	void RenderPaintbrushes(
+		glm::vec3 positionXYZ);
+
+	//TODO: Function for Controller
+	void RenderController();
+
+	//TODO: Function for Controller
+	void RenderDrink(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	void RenderPaintTube(glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ,
+		int textureHandle);
+
+	// set the object material into the shader
+	void SetShaderMaterial(
+		int materialHandle);
+	// load-time convenience that looks the material up by tag
+	void SetShaderMaterial(
+		std::string materialTag);
+
+	// look up the texture and material handles used for drawing
+	void ResolveSceneHandles();
+
+
+
+
+public:
+
+	/*** The following methods are for the students to ***/
+	/*** customize for their own 3D scene              ***/
+	void PrepareScene();
+	void RenderScene();
+	// record the scene again before the next frame, after
+	// anything RenderScene draws from has changed
+	void InvalidateScene();
+
+	//load texture files
+	void LoadSceneTextures();
+	// choose whether textures stream in after the first frame
+	// and how many bytes may be uploaded in each frame
+	void SetTextureStreaming(bool bStream, size_t uploadBudget);
+	// upload the next part of the streaming textures, called
+	// once per frame before rendering
+	void UpdateTextureStreaming();
+	// bytes of texture memory to stay inside, 0 for no limit
+	void SetTextureBudget(size_t budget);
+	// camera position the draws of the next frame are sorted
+	// by distance from
+	void SetViewPosition(const glm::vec3& viewPosition);
+	// projection times view matrix the draws of the next frame
+	// are culled against
+	void SetViewFrustum(const glm::mat4& viewProjection);
+	// print the memory and hit counts of every texture
+	void ReportTextureResidency();
+	// print the uniform updates submitted and actually issued
+	void ReportShaderState();
+	// print the model matrices composed, reused and recomputed
+	void ReportTransforms();
+	// print the draws of the last frame, the draw calls they
+	// were instanced into and the state changes sorting them
+	// removed
+	void ReportDrawCalls();
+	// print the size of the recorded scene and how many times
+	// it was recorded
+	void ReportCommandList();
+	// print the draws and static batches culled, hidden and
+	// drawn in the last frame
+	void ReportCulling();
+	// list the image files and tags of the scene textures that
+	// RenderScene draws with, and optionally the tags it skips -
+	// without the flags of the drawn tags, every tag RenderScene
+	// has a handle field for is listed
+	static void GetSceneTextureRequests(std::vector<TextureLoader::TEXTURE_REQUEST>& requests,
+		std::vector<std::string>* pUnreferencedTags = NULL, const std::vector<char>* pDrawnTags = NULL);
+	// write the texture cache files for all scene textures,
+	// compressed to a format named "none", "bc1", "bc3", "bc7"
+	// or "auto"
+	static bool CookSceneTextures(const std::string& formatName = "auto");
+
+
+	// define all the object materials before rendering
+	void DefineObjectMaterials();
+	// add and define the light sources before rendering
+	void SetupSceneLights();
 };
\ No newline at end of file
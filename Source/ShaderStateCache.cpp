@@ -0,0 +1,346 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderstatecache.cpp
+// ============
+// set shader uniforms through a table of locations resolved once, skipping
+// uploads that would not change anything
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderStateCache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// declaration of global variables
+namespace
+{
+	// names of the uniforms before the light sources, in the
+	// order of the UNIFORM enum
+	const char* g_UniformNames[] =
+	{
+		"view",
+		"projection",
+		"viewPosition",
+		"objectTextures",
+		"bUseLighting",
+	};
+	static_assert(sizeof(g_UniformNames) / sizeof(g_UniformNames[0]) == ShaderStateCache::UNIFORM_LIGHT_SOURCES,
+		"every uniform before the light sources needs a name");
+
+	// names of the fields of a light source, in the order of
+	// the LIGHT_FIELD enum
+	const char* g_LightFieldNames[] =
+	{
+		"position",
+		"ambientColor",
+		"diffuseColor",
+		"specularColor",
+		"focalStrength",
+		"specularIntensity",
+	};
+	static_assert(sizeof(g_LightFieldNames) / sizeof(g_LightFieldNames[0]) == ShaderStateCache::LIGHT_FIELD_COUNT,
+		"every light field needs a name");
+}
+
+/***********************************************************
+ *  ShaderStateCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShaderStateCache::ShaderStateCache()
+{
+	for (int i = 0; i < UNIFORM_COUNT; i++)
+	{
+		m_locations[i] = -1;
+	}
+	Invalidate();
+	m_bResolved = false;
+	m_submitted = 0;
+	m_issued = 0;
+	m_lastSubmitted = 0;
+	m_lastIssued = 0;
+	m_totalSubmitted = 0;
+	m_totalIssued = 0;
+}
+
+/***********************************************************
+ *  Resolve()
+ *
+ *  This method is used for looking up the location of every
+ *  uniform in the program that is in use.  Uniforms the
+ *  program does not have, or that its compiler removed, get
+ *  location -1 and are never uploaded.
+ ***********************************************************/
+bool ShaderStateCache::Resolve()
+{
+	GLint programID = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+	if (programID == 0)
+	{
+		std::cout << "ERROR: No shader program is in use to look up the uniforms of" << std::endl;
+		return(false);
+	}
+
+	for (int i = 0; i < UNIFORM_LIGHT_SOURCES; i++)
+	{
+		m_locations[i] = glGetUniformLocation((GLuint)programID, g_UniformNames[i]);
+	}
+	for (int light = 0; light < LIGHT_COUNT; light++)
+	{
+		for (int field = 0; field < LIGHT_FIELD_COUNT; field++)
+		{
+			std::string name = "lightSources[" + std::to_string(light) + "]." + g_LightFieldNames[field];
+			m_locations[GetLightUniform(light, (LIGHT_FIELD)field)] = glGetUniformLocation((GLuint)programID, name.c_str());
+		}
+	}
+
+	// the values the old locations were given are not known to
+	// be in this program
+	Invalidate();
+	m_bResolved = true;
+	return(true);
+}
+
+/***********************************************************
+ *  IsResolved()
+ *
+ *  This method returns true once Resolve() has looked up
+ *  the uniform locations.
+ ***********************************************************/
+bool ShaderStateCache::IsResolved() const
+{
+	return(m_bResolved);
+}
+
+/***********************************************************
+ *  GetLightUniform()
+ *
+ *  This method returns the uniform of one field of one of
+ *  the light sources.
+ ***********************************************************/
+ShaderStateCache::UNIFORM ShaderStateCache::GetLightUniform(int light, LIGHT_FIELD field)
+{
+	return((UNIFORM)(UNIFORM_LIGHT_SOURCES + light * LIGHT_FIELD_COUNT + field));
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for comparing a value with the last
+ *  value uploaded to a uniform and counting the update.
+ *  Uniforms without a location are never issued.
+ ***********************************************************/
+bool ShaderStateCache::Update(UNIFORM uniform, const void* pValue, size_t size)
+{
+	m_submitted++;
+	m_totalSubmitted++;
+
+	SHADOW_VALUE& shadow = m_shadow[uniform];
+	if ((m_locations[uniform] < 0) ||
+		(shadow.bValid && (memcmp(shadow.values, pValue, size) == 0)))
+	{
+		return(false);
+	}
+
+	shadow.bValid = true;
+	memcpy(shadow.values, pValue, size);
+
+	m_issued++;
+	m_totalIssued++;
+	return(true);
+}
+
+/***********************************************************
+ *  SetBool()
+ *
+ *  This method is used for setting a bool uniform.
+ ***********************************************************/
+void ShaderStateCache::SetBool(UNIFORM uniform, bool value)
+{
+	SetInt(uniform, value ? 1 : 0);
+}
+
+/***********************************************************
+ *  SetInt()
+ *
+ *  This method is used for setting an int uniform, or the
+ *  texture unit of a sampler uniform.
+ ***********************************************************/
+void ShaderStateCache::SetInt(UNIFORM uniform, int value)
+{
+	if (Update(uniform, &value, sizeof(value)))
+	{
+		glUniform1i(m_locations[uniform], value);
+	}
+}
+
+/***********************************************************
+ *  SetFloat()
+ *
+ *  This method is used for setting a float uniform.
+ ***********************************************************/
+void ShaderStateCache::SetFloat(UNIFORM uniform, float value)
+{
+	if (Update(uniform, &value, sizeof(value)))
+	{
+		glUniform1f(m_locations[uniform], value);
+	}
+}
+
+/***********************************************************
+ *  SetVec2()
+ *
+ *  This method is used for setting a vec2 uniform.
+ ***********************************************************/
+void ShaderStateCache::SetVec2(UNIFORM uniform, const glm::vec2& value)
+{
+	if (Update(uniform, glm::value_ptr(value), sizeof(value)))
+	{
+		glUniform2fv(m_locations[uniform], 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetVec3()
+ *
+ *  This method is used for setting a vec3 uniform.
+ ***********************************************************/
+void ShaderStateCache::SetVec3(UNIFORM uniform, const glm::vec3& value)
+{
+	if (Update(uniform, glm::value_ptr(value), sizeof(value)))
+	{
+		glUniform3fv(m_locations[uniform], 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetVec4()
+ *
+ *  This method is used for setting a vec4 uniform.
+ ***********************************************************/
+void ShaderStateCache::SetVec4(UNIFORM uniform, const glm::vec4& value)
+{
+	if (Update(uniform, glm::value_ptr(value), sizeof(value)))
+	{
+		glUniform4fv(m_locations[uniform], 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetMat3()
+ *
+ *  This method is used for setting a mat3 uniform.
+ ***********************************************************/
+void ShaderStateCache::SetMat3(UNIFORM uniform, const glm::mat3& value)
+{
+	if (Update(uniform, glm::value_ptr(value), sizeof(value)))
+	{
+		glUniformMatrix3fv(m_locations[uniform], 1, GL_FALSE, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetMat4()
+ *
+ *  This method is used for setting a mat4 uniform.
+ ***********************************************************/
+void ShaderStateCache::SetMat4(UNIFORM uniform, const glm::mat4& value)
+{
+	if (Update(uniform, glm::value_ptr(value), sizeof(value)))
+	{
+		glUniformMatrix4fv(m_locations[uniform], 1, GL_FALSE, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetIntArray()
+ *
+ *  This method is used for setting the elements of an int
+ *  array uniform, or the texture units of a sampler array,
+ *  starting from its first element.  Up to 16 elements fit
+ *  in the shadow copy.
+ ***********************************************************/
+void ShaderStateCache::SetIntArray(UNIFORM uniform, const int* values, int count)
+{
+	if ((count <= 0) || (count > 16))
+	{
+		return;
+	}
+	if (Update(uniform, values, count * sizeof(int)))
+	{
+		glUniform1iv(m_locations[uniform], count, values);
+	}
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for forgetting every shadow value.
+ ***********************************************************/
+void ShaderStateCache::Invalidate()
+{
+	for (int i = 0; i < UNIFORM_COUNT; i++)
+	{
+		m_shadow[i].bValid = false;
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for keeping the counts of the frame
+ *  that just ended and starting new ones.
+ ***********************************************************/
+void ShaderStateCache::BeginFrame()
+{
+	m_lastSubmitted = m_submitted;
+	m_lastIssued = m_issued;
+	m_submitted = 0;
+	m_issued = 0;
+}
+
+/***********************************************************
+ *  GetSubmittedCount()
+ *
+ *  This method returns the uniform values submitted during
+ *  the last frame.
+ ***********************************************************/
+unsigned int ShaderStateCache::GetSubmittedCount() const
+{
+	return(m_lastSubmitted);
+}
+
+/***********************************************************
+ *  GetIssuedCount()
+ *
+ *  This method returns the uniform uploads issued to the
+ *  shader during the last frame.
+ ***********************************************************/
+unsigned int ShaderStateCache::GetIssuedCount() const
+{
+	return(m_lastIssued);
+}
+
+/***********************************************************
+ *  GetTotalSubmittedCount()
+ *
+ *  This method returns the uniform values submitted since
+ *  the cache was created.
+ ***********************************************************/
+unsigned long long ShaderStateCache::GetTotalSubmittedCount() const
+{
+	return(m_totalSubmitted);
+}
+
+/***********************************************************
+ *  GetTotalIssuedCount()
+ *
+ *  This method returns the uniform uploads issued since the
+ *  cache was created.
+ ***********************************************************/
+unsigned long long ShaderStateCache::GetTotalIssuedCount() const
+{
+	return(m_totalIssued);
+}
@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderstatecache.h
+// ============
+// set shader uniforms through a table of locations resolved once, skipping
+// uploads that would not change anything
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  ShaderStateCache
+ *
+ *  This class sets the uniforms of the scene shaders.  Every
+ *  uniform has an entry in the UNIFORM enum, and the
+ *  locations of all of them are looked up by name once, by
+ *  Resolve(), after the shaders are loaded and in use.
+ *  Setting a uniform after that only indexes the table, so
+ *  no strings are touched while drawing.
+ *
+ *  The cache also keeps a shadow copy of every uniform value
+ *  it has uploaded.  A new value is only passed on to OpenGL
+ *  when it differs from the shadow copy, so setting the
+ *  same view, lights and samplers every frame does not
+ *  upload the same values over and over.  Uniforms set
+ *  through a cache must only be set through it, or the
+ *  cache must be invalidated.
+ *
+ *  Counts of the values submitted and the uploads actually
+ *  issued are kept per frame - call BeginFrame() at the
+ *  start of every frame.
+ ***********************************************************/
+class ShaderStateCache
+{
+public:
+	// number of light sources in the shader's lightSources array
+	static const int LIGHT_COUNT = 4;
+	// number of samplers in the shader's objectTextures array,
+	// one per texture array and unit
+	static const int TEXTURE_ARRAY_COUNT = 16;
+
+	// fields of one light source
+	enum LIGHT_FIELD
+	{
+		LIGHT_POSITION = 0,
+		LIGHT_AMBIENT_COLOR,
+		LIGHT_DIFFUSE_COLOR,
+		LIGHT_SPECULAR_COLOR,
+		LIGHT_FOCAL_STRENGTH,
+		LIGHT_SPECULAR_INTENSITY,
+		LIGHT_FIELD_COUNT
+	};
+
+	// every uniform of the scene shaders
+	enum UNIFORM
+	{
+		UNIFORM_VIEW = 0,
+		UNIFORM_PROJECTION,
+		UNIFORM_VIEW_POSITION,
+		UNIFORM_OBJECT_TEXTURES,
+		UNIFORM_USE_LIGHTING,
+		// the fields of every light source, from GetLightUniform()
+		UNIFORM_LIGHT_SOURCES,
+		UNIFORM_COUNT = UNIFORM_LIGHT_SOURCES + LIGHT_COUNT * LIGHT_FIELD_COUNT
+	};
+
+	// constructor
+	ShaderStateCache();
+
+	// look up the location of every uniform in the program in
+	// use - needed again after the program changes
+	bool Resolve();
+	// true once the locations have been looked up
+	bool IsResolved() const;
+
+	// the uniform of one field of one light source
+	static UNIFORM GetLightUniform(int light, LIGHT_FIELD field);
+
+	// set uniform values, uploading only the ones that changed
+	void SetBool(UNIFORM uniform, bool value);
+	void SetInt(UNIFORM uniform, int value);
+	void SetFloat(UNIFORM uniform, float value);
+	void SetVec2(UNIFORM uniform, const glm::vec2& value);
+	void SetVec3(UNIFORM uniform, const glm::vec3& value);
+	void SetVec4(UNIFORM uniform, const glm::vec4& value);
+	void SetMat3(UNIFORM uniform, const glm::mat3& value);
+	void SetMat4(UNIFORM uniform, const glm::mat4& value);
+	// set the elements of an int or sampler array uniform from
+	// the first, at most 16 of them
+	void SetIntArray(UNIFORM uniform, const int* values, int count);
+
+	// forget every shadow value, so the next value of every
+	// uniform is uploaded
+	void Invalidate();
+	// start counting the uniform updates of a new frame
+	void BeginFrame();
+
+	// values submitted and uploads issued during the last frame
+	unsigned int GetSubmittedCount() const;
+	unsigned int GetIssuedCount() const;
+	// values submitted and uploads issued since the start
+	unsigned long long GetTotalSubmittedCount() const;
+	unsigned long long GetTotalIssuedCount() const;
+
+private:
+	// last value uploaded to one uniform, compared bit for bit
+	struct SHADOW_VALUE
+	{
+		bool bValid;
+		float values[16];
+	};
+
+	// location of every uniform, -1 when the program has none
+	GLint m_locations[UNIFORM_COUNT];
+	SHADOW_VALUE m_shadow[UNIFORM_COUNT];
+	bool m_bResolved;
+	unsigned int m_submitted;
+	unsigned int m_issued;
+	unsigned int m_lastSubmitted;
+	unsigned int m_lastIssued;
+	unsigned long long m_totalSubmitted;
+	unsigned long long m_totalIssued;
+
+	// true when a value differs from the shadow copy, which is
+	// then replaced by it
+	bool Update(UNIFORM uniform, const void* pValue, size_t size);
+};
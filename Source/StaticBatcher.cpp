@@ -0,0 +1,274 @@
+///////////////////////////////////////////////////////////////////////////////
+// staticbatcher.cpp
+// ============
+// bake the draws of the scene that never move into world space batches
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StaticBatcher.h"
+
+#include <cstddef>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// the values from color to flags decide which batch a draw
+	// is merged into, the matrices are baked into the vertices
+	const size_t g_LookOffset = offsetof(InstanceRenderer::INSTANCE, color);
+	const size_t g_LookSize = sizeof(InstanceRenderer::INSTANCE) - g_LookOffset;
+
+	/***********************************************************
+	 *  HasSameLook()
+	 *
+	 *  Return true when two draws can be merged, because every
+	 *  value they are drawn with apart from their matrices is
+	 *  the same.
+	 ***********************************************************/
+	bool HasSameLook(const InstanceRenderer::INSTANCE& a, const InstanceRenderer::INSTANCE& b)
+	{
+		return(memcmp((const char*)&a + g_LookOffset, (const char*)&b + g_LookOffset, g_LookSize) == 0);
+	}
+}
+
+/***********************************************************
+ *  StaticBatcher()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+StaticBatcher::StaticBatcher()
+{
+	m_bBaked = false;
+	m_bakeCount = 0;
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used for starting to collect the static
+ *  draws of a new frame.
+ ***********************************************************/
+void StaticBatcher::Begin()
+{
+	m_draws.clear();
+}
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for adding a static draw.  Nothing is
+ *  baked until Bake().
+ ***********************************************************/
+void StaticBatcher::Add(PrimitiveGeometry::PART part, const InstanceRenderer::INSTANCE& instance)
+{
+	DRAW draw;
+	// the whole draw is compared bit for bit, so no padding
+	// may be left unset
+	memset((void*)&draw, 0, sizeof(draw));
+	draw.part = part;
+	draw.instance = instance;
+	m_draws.push_back(draw);
+}
+
+/***********************************************************
+ *  IsUnchanged()
+ *
+ *  This method returns true when the draws of this frame are
+ *  the draws the batches were baked from, in the same order.
+ ***********************************************************/
+bool StaticBatcher::IsUnchanged() const
+{
+	return(m_bBaked &&
+		(m_draws.size() == m_bakedDraws.size()) &&
+		(m_draws.empty() || (memcmp(m_draws.data(), m_bakedDraws.data(), m_draws.size() * sizeof(DRAW)) == 0)));
+}
+
+/***********************************************************
+ *  Bake()
+ *
+ *  This method is used for baking the static draws into
+ *  batches, when they changed since the last bake.  The
+ *  draws are merged in the order they were added, each
+ *  batch at the position of its first draw.  Positions are
+ *  transformed by the model matrix and normals by the
+ *  normal matrix, and the texture coordinates are kept, so
+ *  the batch is drawn with the values of its draws and the
+ *  identity matrix.
+ ***********************************************************/
+bool StaticBatcher::Bake(const PrimitiveGeometry& geometry)
+{
+	if (IsUnchanged())
+	{
+		return(false);
+	}
+
+	// find the batch of every draw, in the order of the first
+	// draw of each batch
+	std::vector<int> drawBatches(m_draws.size());
+	std::vector<int> looks;
+	for (size_t i = 0; i < m_draws.size(); i++)
+	{
+		size_t look = 0;
+		while ((look < looks.size()) && !HasSameLook(m_draws[looks[look]].instance, m_draws[i].instance))
+		{
+			look++;
+		}
+		if (look == looks.size())
+		{
+			looks.push_back((int)i);
+		}
+		drawBatches[i] = (int)look;
+	}
+
+	m_vertices.clear();
+	m_indices.clear();
+	m_batches.clear();
+	for (size_t batch = 0; batch < looks.size(); batch++)
+	{
+		BATCH baked;
+		baked.firstIndex = (int)m_indices.size();
+		baked.drawCount = 0;
+		baked.instance = m_draws[looks[batch]].instance;
+		baked.instance.model = glm::mat4(1.0f);
+		for (int column = 0; column < 3; column++)
+		{
+			baked.instance.normalMatrix[column] = glm::vec4(0.0f);
+			baked.instance.normalMatrix[column][column] = 1.0f;
+		}
+
+		for (size_t i = 0; i < m_draws.size(); i++)
+		{
+			if (drawBatches[i] != (int)batch)
+			{
+				continue;
+			}
+			baked.drawCount++;
+
+			const InstanceRenderer::INSTANCE& instance = m_draws[i].instance;
+			const PrimitiveGeometry::PART_RANGE& range = geometry.GetPart((PrimitiveGeometry::PART)m_draws[i].part);
+			const std::vector<PrimitiveGeometry::VERTEX>& vertices = geometry.GetVertices(range.mesh);
+			const std::vector<unsigned int>& indices = geometry.GetIndices(range.mesh);
+			glm::mat3 normalMatrix(glm::vec3(instance.normalMatrix[0]), glm::vec3(instance.normalMatrix[1]), glm::vec3(instance.normalMatrix[2]));
+
+			// the whole mesh is copied, as a part's indices may use
+			// any of its vertices
+			unsigned int baseVertex = (unsigned int)m_vertices.size();
+			for (size_t vertex = 0; vertex < vertices.size(); vertex++)
+			{
+				PrimitiveGeometry::VERTEX world;
+				world.position = glm::vec3(instance.model * glm::vec4(vertices[vertex].position, 1.0f));
+				world.normal = glm::normalize(normalMatrix * vertices[vertex].normal);
+				world.textureCoordinate = vertices[vertex].textureCoordinate;
+				m_vertices.push_back(world);
+			}
+			for (int index = 0; index < range.indexCount; index++)
+			{
+				m_indices.push_back(baseVertex + indices[range.firstIndex + index]);
+			}
+		}
+
+		baked.indexCount = (int)m_indices.size() - baked.firstIndex;
+
+		// the box and sphere around the batch's world space
+		// vertices, for culling it as a whole
+		PrimitiveGeometry::BOUNDS& bounds = baked.bounds;
+		bounds.minimum = glm::vec3(0.0f);
+		bounds.maximum = glm::vec3(0.0f);
+		for (int index = 0; index < baked.indexCount; index++)
+		{
+			const glm::vec3& position = m_vertices[m_indices[baked.firstIndex + index]].position;
+			bounds.minimum = (index == 0) ? position : glm::min(bounds.minimum, position);
+			bounds.maximum = (index == 0) ? position : glm::max(bounds.maximum, position);
+		}
+		bounds.center = 0.5f * (bounds.minimum + bounds.maximum);
+		bounds.radius = 0.5f * glm::length(bounds.maximum - bounds.minimum);
+
+		m_batches.push_back(baked);
+	}
+
+	m_bakedDraws = m_draws;
+	m_bBaked = true;
+	m_bakeCount++;
+	return(true);
+}
+
+/***********************************************************
+ *  GetVertices()
+ *
+ *  This method returns the baked world space vertices.
+ ***********************************************************/
+const std::vector<PrimitiveGeometry::VERTEX>& StaticBatcher::GetVertices() const
+{
+	return(m_vertices);
+}
+
+/***********************************************************
+ *  GetIndices()
+ *
+ *  This method returns the indices of every batch, indexing
+ *  the baked vertices.
+ ***********************************************************/
+const std::vector<unsigned int>& StaticBatcher::GetIndices() const
+{
+	return(m_indices);
+}
+
+/***********************************************************
+ *  GetBatchCount()
+ *
+ *  This method returns the number of baked batches.
+ ***********************************************************/
+int StaticBatcher::GetBatchCount() const
+{
+	return((int)m_batches.size());
+}
+
+/***********************************************************
+ *  GetBatch()
+ *
+ *  This method returns a baked batch.
+ ***********************************************************/
+const StaticBatcher::BATCH& StaticBatcher::GetBatch(int batch) const
+{
+	return(m_batches[batch]);
+}
+
+/***********************************************************
+ *  GetDrawCount()
+ *
+ *  This method returns the number of static draws the
+ *  batches were baked from.
+ ***********************************************************/
+int StaticBatcher::GetDrawCount() const
+{
+	return((int)m_bakedDraws.size());
+}
+
+/***********************************************************
+ *  GetBakeCount()
+ *
+ *  This method returns the number of times the batches were
+ *  baked.
+ ***********************************************************/
+unsigned int StaticBatcher::GetBakeCount() const
+{
+	return(m_bakeCount);
+}
+
+/***********************************************************
+ *  GetTexturedDrawCount()
+ *
+ *  This method returns the number of static draws that were
+ *  baked into batches drawn with a texture.
+ ***********************************************************/
+int StaticBatcher::GetTexturedDrawCount() const
+{
+	int count = 0;
+	for (size_t batch = 0; batch < m_batches.size(); batch++)
+	{
+		if (m_batches[batch].instance.flags.y != 0)
+		{
+			count += m_batches[batch].drawCount;
+		}
+	}
+	return(count);
+}
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////
+// staticbatcher.h
+// ============
+// bake the draws of the scene that never move into world space batches
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "InstanceRenderer.h"
+#include "PrimitiveGeometry.h"
+
+#include <vector>
+
+/***********************************************************
+ *  StaticBatcher
+ *
+ *  This class bakes draws that never move into a few large
+ *  meshes.  Every draw's shape part is transformed into
+ *  world space on the CPU, and the draws that look the same
+ *  - the same texture array, layer and image rectangle, UV
+ *  scale, color and material - are merged into one batch
+ *  whose vertices are drawn with the identity matrix.
+ *
+ *  The static draws are added again every frame, as the
+ *  scene is defined by drawing it, and are compared with
+ *  the draws the batches were baked from.  The batches are
+ *  only baked again when a draw was added, removed, moved
+ *  or changed its look, so the scene definition can change
+ *  at any time.
+ ***********************************************************/
+class StaticBatcher
+{
+public:
+	// one baked batch - its indices in the baked mesh, the
+	// number of draws merged into it, the values it is drawn
+	// with, and its world space bounds
+	struct BATCH
+	{
+		int firstIndex;
+		int indexCount;
+		int drawCount;
+		InstanceRenderer::INSTANCE instance;
+		PrimitiveGeometry::BOUNDS bounds;
+	};
+
+	// constructor
+	StaticBatcher();
+
+	// start collecting the static draws of a frame
+	void Begin();
+	// add a static draw of a shape part
+	void Add(PrimitiveGeometry::PART part, const InstanceRenderer::INSTANCE& instance);
+	// bake the batches again if the draws of this frame differ
+	// from the ones they were baked from, returning true when
+	// they were baked
+	bool Bake(const PrimitiveGeometry& geometry);
+
+	// the baked world space vertices and the indices of every
+	// batch, one after another
+	const std::vector<PrimitiveGeometry::VERTEX>& GetVertices() const;
+	const std::vector<unsigned int>& GetIndices() const;
+	// the baked batches
+	int GetBatchCount() const;
+	const BATCH& GetBatch(int batch) const;
+
+	// static draws the batches were baked from, and the number
+	// of times they were baked
+	int GetDrawCount() const;
+	unsigned int GetBakeCount() const;
+	// baked draws that ended up in a textured batch
+	int GetTexturedDrawCount() const;
+
+private:
+	// one static draw
+	struct DRAW
+	{
+		int part;
+		InstanceRenderer::INSTANCE instance;
+	};
+
+	// the draws of this frame and the ones that were baked
+	std::vector<DRAW> m_draws;
+	std::vector<DRAW> m_bakedDraws;
+	bool m_bBaked;
+
+	std::vector<PrimitiveGeometry::VERTEX> m_vertices;
+	std::vector<unsigned int> m_indices;
+	std::vector<BATCH> m_batches;
+	unsigned int m_bakeCount;
+
+	// true when the draws of this frame are the baked ones
+	bool IsUnchanged() const;
+};
@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////
+// tagregistry.cpp
+// ============
+// intern string tags into dense integer handles
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TagRegistry.h"
+
+/***********************************************************
+ *  Register()
+ *
+ *  This method is used for getting the handle of a tag,
+ *  giving it the next free handle if it is not registered.
+ ***********************************************************/
+int TagRegistry::Register(const std::string& tag)
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_handles.find(tag);
+	if (found != m_handles.end())
+	{
+		return(found->second);
+	}
+
+	int handle = (int)m_tags.size();
+	m_handles[tag] = handle;
+	m_tags.push_back(tag);
+	return(handle);
+}
+
+/***********************************************************
+ *  Alias()
+ *
+ *  This method is used for making a tag that is not yet
+ *  registered find the same handle as another tag.
+ ***********************************************************/
+int TagRegistry::Alias(const std::string& tag, int handle)
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_handles.find(tag);
+	if (found != m_handles.end())
+	{
+		return(found->second);
+	}
+
+	m_handles[tag] = handle;
+	return(handle);
+}
+
+/***********************************************************
+ *  Find()
+ *
+ *  This method is used for getting the handle of an already
+ *  registered tag.
+ ***********************************************************/
+int TagRegistry::Find(const std::string& tag) const
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_handles.find(tag);
+	if (found == m_handles.end())
+	{
+		return(INVALID_HANDLE);
+	}
+	return(found->second);
+}
+
+/***********************************************************
+ *  GetTag()
+ *
+ *  This method returns the tag a handle was registered with,
+ *  not any of its aliases.
+ ***********************************************************/
+const std::string& TagRegistry::GetTag(int handle) const
+{
+	return(m_tags[handle]);
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method returns the number of handles given out.
+ *  Aliases share a handle, so they are not counted.
+ ***********************************************************/
+int TagRegistry::GetCount() const
+{
+	return((int)m_tags.size());
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for forgetting every registered tag.
+ ***********************************************************/
+void TagRegistry::Clear()
+{
+	m_handles.clear();
+	m_tags.clear();
+}
@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////////////
+// tagregistry.h
+// ============
+// intern string tags into dense integer handles
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  TagRegistry
+ *
+ *  This class turns string tags, such as texture and
+ *  material names, into dense integer handles numbered
+ *  from 0 in the order they are registered.  Tags are only
+ *  looked up by string at load time - everything after
+ *  that indexes arrays by handle.  Several tags can share
+ *  one handle through Alias().
+ ***********************************************************/
+class TagRegistry
+{
+public:
+	// handle value for a tag that is not registered
+	static const int INVALID_HANDLE = -1;
+
+	// get the handle of a tag, registering it if it is new
+	int Register(const std::string& tag);
+	// make a tag another name for a registered handle, returning
+	// the handle the tag has - a tag already registered keeps
+	// its own handle
+	int Alias(const std::string& tag, int handle);
+	// get the handle of a registered tag, or INVALID_HANDLE
+	int Find(const std::string& tag) const;
+	// get the tag a handle was first registered with
+	const std::string& GetTag(int handle) const;
+	// number of handles, not counting aliases
+	int GetCount() const;
+	// forget every registered tag
+	void Clear();
+
+private:
+	// handle of every registered tag
+	std::unordered_map<std::string, int> m_handles;
+	// tag of every handle
+	std::vector<std::string> m_tags;
+};
@@ -0,0 +1,788 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturearraymanager.cpp
+// ============
+// pack scene textures into layers of OpenGL 2D texture arrays
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureArrayManager.h"
+
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// layer sizes above this are rounded up to a multiple of it,
+	// so images of a similar size end up sharing an array
+	const int g_LayerGranularity = 256;
+
+	/***********************************************************
+	 *  GetLayerSize()
+	 *
+	 *  Round an image dimension up to its layer dimension.
+	 ***********************************************************/
+	int GetLayerSize(int size)
+	{
+		if (size > g_LayerGranularity)
+		{
+			return(((size + g_LayerGranularity - 1) / g_LayerGranularity) * g_LayerGranularity);
+		}
+
+		int layerSize = 1;
+		while (layerSize < size)
+		{
+			layerSize *= 2;
+		}
+		return(layerSize);
+	}
+
+	/***********************************************************
+	 *  GetLevelSize()
+	 *
+	 *  Get the size of a dimension at a mip level.
+	 ***********************************************************/
+	int GetLevelSize(int size, int level)
+	{
+		size = size >> level;
+		return((size > 0) ? size : 1);
+	}
+
+	/***********************************************************
+	 *  GetInternalFormat()
+	 *
+	 *  Get the OpenGL internal format for an array's data.
+	 ***********************************************************/
+	GLenum GetInternalFormat(TextureCompressor::FORMAT format, int colorChannels)
+	{
+		switch (format)
+		{
+		case TextureCompressor::FORMAT_BC1:
+			return(GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+		case TextureCompressor::FORMAT_BC3:
+			return(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+		case TextureCompressor::FORMAT_BC7:
+			return(GL_COMPRESSED_RGBA_BPTC_UNORM);
+		default:
+			return((colorChannels == 3) ? GL_RGB8 : GL_RGBA8);
+		}
+	}
+}
+
+/***********************************************************
+ *  TextureArrayManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureArrayManager::TextureArrayManager()
+{
+	m_maxLayers = 256;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &m_maxLayers);
+}
+
+/***********************************************************
+ *  ~TextureArrayManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureArrayManager::~TextureArrayManager()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Reserve()
+ *
+ *  This method is used for reserving a layer for a texture
+ *  in an array with a matching format and layer size.  No
+ *  texture memory is created until Build() is called.
+ ***********************************************************/
+int TextureArrayManager::Reserve(int width, int height, int colorChannels, TextureCompressor::FORMAT format, bool bTranslucent)
+{
+	int layerWidth = GetLayerSize(width);
+	int layerHeight = GetLayerSize(height);
+	int arrayIndex = -1;
+
+	// look for an array that is still open for more layers
+	for (size_t i = 0; (i < m_arrays.size()) && (arrayIndex < 0); i++)
+	{
+		if ((m_arrays[i].width == layerWidth) &&
+			(m_arrays[i].height == layerHeight) &&
+			(m_arrays[i].colorChannels == colorChannels) &&
+			(m_arrays[i].format == format) &&
+			(m_arrays[i].bBuilt == false) &&
+			(m_arrays[i].layerCount < m_maxLayers))
+		{
+			arrayIndex = (int)i;
+		}
+	}
+
+	if (arrayIndex < 0)
+	{
+		TEXTURE_ARRAY textureArray;
+		textureArray.ID = 0;
+		textureArray.width = layerWidth;
+		textureArray.height = layerHeight;
+		textureArray.colorChannels = colorChannels;
+		textureArray.format = format;
+		textureArray.levels = 1;
+		while ((layerWidth >> textureArray.levels) || (layerHeight >> textureArray.levels))
+		{
+			textureArray.levels++;
+		}
+		textureArray.layerCount = 0;
+		textureArray.baseLevel = 0;
+		textureArray.pendingID = 0;
+		textureArray.pendingBaseLevel = 0;
+		textureArray.pendingLayers = 0;
+		textureArray.bBuilt = false;
+		textureArray.bNeedsMipmaps = false;
+		m_arrays.push_back(textureArray);
+		arrayIndex = (int)m_arrays.size() - 1;
+	}
+
+	TEXTURE_ENTRY entry;
+	entry.width = width;
+	entry.height = height;
+	entry.bTranslucent = bTranslucent;
+	entry.location.arrayIndex = arrayIndex;
+	entry.location.layer = m_arrays[arrayIndex].layerCount++;
+	entry.location.uvTransform = glm::vec4(
+		(float)width / (float)layerWidth,
+		(float)height / (float)layerHeight,
+		0.0f,
+		0.0f);
+	m_textures.push_back(entry);
+
+	return((int)m_textures.size() - 1);
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for creating the texture memory for
+ *  every array that has had layers reserved since the last
+ *  call.
+ ***********************************************************/
+void TextureArrayManager::Build()
+{
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		TEXTURE_ARRAY& textureArray = m_arrays[i];
+		if (textureArray.bBuilt || (textureArray.layerCount == 0))
+		{
+			continue;
+		}
+
+		textureArray.ID = CreateStorage((int)i, 0);
+		textureArray.baseLevel = 0;
+		textureArray.bBuilt = true;
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  CreateStorage()
+ *
+ *  This method is used for creating a texture object for an
+ *  array with storage for every mip level from the base level
+ *  down.  The new texture is left bound to the array's unit.
+ ***********************************************************/
+GLuint TextureArrayManager::CreateStorage(int arrayIndex, int baseLevel)
+{
+	const TEXTURE_ARRAY& textureArray = m_arrays[arrayIndex];
+	GLenum internalFormat = GetInternalFormat(textureArray.format, textureArray.colorChannels);
+	GLenum pixelFormat = (textureArray.colorChannels == 3) ? GL_RGB : GL_RGBA;
+	GLuint textureID = 0;
+
+	glGenTextures(1, &textureID);
+	glActiveTexture(GL_TEXTURE0 + (GLenum)arrayIndex);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+	for (int level = baseLevel; level < textureArray.levels; level++)
+	{
+		int levelWidth = GetLevelSize(textureArray.width, level);
+		int levelHeight = GetLevelSize(textureArray.height, level);
+		if (textureArray.format == TextureCompressor::FORMAT_UNCOMPRESSED)
+		{
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, level, (GLint)internalFormat, levelWidth, levelHeight,
+				textureArray.layerCount, 0, pixelFormat, GL_UNSIGNED_BYTE, NULL);
+		}
+		else
+		{
+			size_t layerSize = TextureCompressor::GetImageSize(textureArray.format, levelWidth, levelHeight, textureArray.colorChannels);
+			glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat, levelWidth, levelHeight,
+				textureArray.layerCount, 0, (GLsizei)(layerSize * textureArray.layerCount), NULL);
+		}
+	}
+
+	// the shader repeats the texture coordinates inside the
+	// part of the layer the image fills, so the array itself
+	// is clamped to stop neighbouring padding bleeding in
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// set texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	// dropped top levels are never allocated, so sampling starts
+	// from the base level
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, baseLevel);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, textureArray.levels - 1);
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  UploadLevel()
+ *
+ *  This method is used for uploading one mip level of image
+ *  pixels into the layer reserved for a texture.  Images
+ *  smaller than the layer are padded by repeating their
+ *  last column and row.
+ ***********************************************************/
+void TextureArrayManager::UploadLevel(int texture, int level, int width, int height, const unsigned char* pixels)
+{
+	if ((texture < 0) || (texture >= (int)m_textures.size()) || (NULL == pixels))
+	{
+		return;
+	}
+
+	const TEXTURE_ENTRY& entry = m_textures[texture];
+	const TEXTURE_ARRAY& textureArray = m_arrays[entry.location.arrayIndex];
+	if ((textureArray.bBuilt == false) || (level >= textureArray.levels) ||
+		(level < GetBaseLevel(entry.location.arrayIndex)))
+	{
+		return;
+	}
+
+	int levelWidth = GetLevelSize(textureArray.width, level);
+	int levelHeight = GetLevelSize(textureArray.height, level);
+	size_t rowSize = 0;
+	int rowCount = 0;
+	const unsigned char* source = pixels;
+
+	GetLevelRows(texture, level, rowSize, rowCount);
+	if ((width != levelWidth) || (height != levelHeight))
+	{
+		m_padBuffer.resize(rowSize * rowCount);
+		PadRows(texture, level, width, height, pixels, 0, rowCount, &m_padBuffer[0]);
+		source = &m_padBuffer[0];
+	}
+
+	UploadRows(texture, level, 0, rowCount, source);
+}
+
+/***********************************************************
+ *  PadRows()
+ *
+ *  This method is used for copying rows of one mip level of
+ *  image pixels into a buffer laid out like the same rows of
+ *  the texture's layer.  Images smaller than the layer are
+ *  padded by repeating their last column and row, of pixels
+ *  or of blocks when the array is compressed.
+ ***********************************************************/
+void TextureArrayManager::PadRows(int texture, int level, int width, int height, const unsigned char* pixels,
+	int firstRow, int rowCount, unsigned char* destination) const
+{
+	const TEXTURE_ENTRY& entry = m_textures[texture];
+	const TEXTURE_ARRAY& textureArray = m_arrays[entry.location.arrayIndex];
+
+	// a compressed row is a row of blocks, each copied whole
+	int unitSize = textureArray.colorChannels;
+	int levelWidth = GetLevelSize(textureArray.width, level);
+	if (textureArray.format != TextureCompressor::FORMAT_UNCOMPRESSED)
+	{
+		unitSize = TextureCompressor::GetBlockSize(textureArray.format);
+		levelWidth = (levelWidth + 3) / 4;
+		width = (width + 3) / 4;
+		height = (height + 3) / 4;
+	}
+	size_t rowSize = (size_t)levelWidth * unitSize;
+	int copyWidth = (width < levelWidth) ? width : levelWidth;
+
+	for (int y = 0; y < rowCount; y++)
+	{
+		int sourceY = firstRow + y;
+		const unsigned char* sourceRow = pixels + (size_t)((sourceY < height) ? sourceY : height - 1) * width * unitSize;
+		unsigned char* row = destination + y * rowSize;
+		memcpy(row, sourceRow, (size_t)copyWidth * unitSize);
+		for (int x = copyWidth; x < levelWidth; x++)
+		{
+			memcpy(row + x * unitSize, sourceRow + (copyWidth - 1) * unitSize, unitSize);
+		}
+	}
+}
+
+/***********************************************************
+ *  UploadRows()
+ *
+ *  This method is used for uploading rows of one mip level
+ *  that are already padded to the layer width.  When a pixel
+ *  unpack buffer is bound, data is an offset into it.  The
+ *  rows of a compressed array are rows of blocks.
+ ***********************************************************/
+void TextureArrayManager::UploadRows(int texture, int level, int firstRow, int rowCount, const void* data)
+{
+	const TEXTURE_ENTRY& entry = m_textures[texture];
+	const TEXTURE_ARRAY& textureArray = m_arrays[entry.location.arrayIndex];
+	GLenum pixelFormat = (textureArray.colorChannels == 3) ? GL_RGB : GL_RGBA;
+
+	// uploads go into new storage while there is some, and the
+	// drawn storage is bound back afterwards
+	GLuint textureID = (textureArray.pendingID != 0) ? textureArray.pendingID : textureArray.ID;
+	if ((textureID == 0) || (level < GetBaseLevel(entry.location.arrayIndex)))
+	{
+		return;
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glActiveTexture(GL_TEXTURE0 + (GLenum)entry.location.arrayIndex);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+	if (textureArray.format == TextureCompressor::FORMAT_UNCOMPRESSED)
+	{
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, firstRow, entry.location.layer,
+			GetLevelSize(textureArray.width, level), rowCount, 1, pixelFormat, GL_UNSIGNED_BYTE, data);
+	}
+	else
+	{
+		// the last row of blocks can reach past the bottom of a
+		// level, so the height stops at the level's edge
+		size_t rowSize = 0;
+		int levelRows = 0;
+		GetLevelRows(texture, level, rowSize, levelRows);
+		int levelHeight = GetLevelSize(textureArray.height, level);
+		int height = rowCount * 4;
+		if (firstRow * 4 + height > levelHeight)
+		{
+			height = levelHeight - firstRow * 4;
+		}
+		glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, firstRow * 4, entry.location.layer,
+			GetLevelSize(textureArray.width, level), height, 1,
+			GetInternalFormat(textureArray.format, textureArray.colorChannels),
+			(GLsizei)(rowSize * rowCount), data);
+	}
+	if (textureID != textureArray.ID)
+	{
+		glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.ID);
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  UploadImage()
+ *
+ *  This method is used for uploading the full size pixels
+ *  of an image that has no mip chain.  The rest of the mip
+ *  levels are built by the next GenerateMipmaps() call.
+ ***********************************************************/
+void TextureArrayManager::UploadImage(int texture, int width, int height, const unsigned char* pixels)
+{
+	if ((texture < 0) || (texture >= (int)m_textures.size()))
+	{
+		return;
+	}
+
+	UploadLevel(texture, 0, width, height, pixels);
+	FlagMipmaps(texture);
+}
+
+/***********************************************************
+ *  FlagMipmaps()
+ *
+ *  This method is used for marking the array holding a
+ *  texture so the next GenerateMipmaps() call rebuilds its
+ *  mip levels.
+ ***********************************************************/
+void TextureArrayManager::FlagMipmaps(int texture)
+{
+	if ((texture >= 0) && (texture < (int)m_textures.size()))
+	{
+		m_arrays[m_textures[texture].location.arrayIndex].bNeedsMipmaps = true;
+	}
+}
+
+/***********************************************************
+ *  SetBaseLevel()
+ *
+ *  This method is used for changing how many mip levels of
+ *  an array are kept in memory.  Dropping top levels quarters
+ *  the memory for each level dropped, and a base level past
+ *  the last level evicts the array.  Otherwise new storage is
+ *  created, and every layer has to be uploaded into it and
+ *  passed to FinishLayer() before it replaces the old one.
+ ***********************************************************/
+void TextureArrayManager::SetBaseLevel(int arrayIndex, int baseLevel)
+{
+	if ((arrayIndex < 0) || (arrayIndex >= (int)m_arrays.size()) || (m_arrays[arrayIndex].bBuilt == false))
+	{
+		return;
+	}
+
+	TEXTURE_ARRAY& textureArray = m_arrays[arrayIndex];
+	if (textureArray.pendingID != 0)
+	{
+		glDeleteTextures(1, &textureArray.pendingID);
+		textureArray.pendingID = 0;
+	}
+
+	if (baseLevel >= textureArray.levels)
+	{
+		if (textureArray.ID != 0)
+		{
+			glDeleteTextures(1, &textureArray.ID);
+			textureArray.ID = 0;
+		}
+		textureArray.baseLevel = textureArray.levels;
+		return;
+	}
+
+	if (baseLevel < 0)
+	{
+		baseLevel = 0;
+	}
+	textureArray.pendingID = CreateStorage(arrayIndex, baseLevel);
+	textureArray.pendingBaseLevel = baseLevel;
+	textureArray.pendingLayers = textureArray.layerCount;
+
+	// keep drawing the old storage until the new one is filled
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.ID);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  FinishLayer()
+ *
+ *  This method is used for noting that every level of a
+ *  texture has been uploaded.  Once all the layers of new
+ *  storage are uploaded, it replaces the old storage.  It
+ *  returns true when the texture's layer can be drawn.
+ ***********************************************************/
+bool TextureArrayManager::FinishLayer(int texture)
+{
+	int arrayIndex = m_textures[texture].location.arrayIndex;
+	TEXTURE_ARRAY& textureArray = m_arrays[arrayIndex];
+
+	if (textureArray.pendingID == 0)
+	{
+		return(textureArray.ID != 0);
+	}
+
+	textureArray.pendingLayers--;
+	if (textureArray.pendingLayers > 0)
+	{
+		return(false);
+	}
+
+	if (textureArray.ID != 0)
+	{
+		glDeleteTextures(1, &textureArray.ID);
+	}
+	textureArray.ID = textureArray.pendingID;
+	textureArray.baseLevel = textureArray.pendingBaseLevel;
+	textureArray.pendingID = 0;
+
+	glActiveTexture(GL_TEXTURE0 + (GLenum)arrayIndex);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.ID);
+	glActiveTexture(GL_TEXTURE0);
+
+	return(true);
+}
+
+/***********************************************************
+ *  GenerateMipmaps()
+ *
+ *  This method is used for generating the mipmaps of the
+ *  arrays that had a layer uploaded without its mip chain.
+ ***********************************************************/
+void TextureArrayManager::GenerateMipmaps()
+{
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		if (m_arrays[i].bNeedsMipmaps)
+		{
+			glActiveTexture(GL_TEXTURE0 + (GLenum)i);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[i].ID);
+			glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+			m_arrays[i].bNeedsMipmaps = false;
+		}
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding every texture array to
+ *  the texture unit with the same index.
+ ***********************************************************/
+void TextureArrayManager::Bind()
+{
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		glActiveTexture(GL_TEXTURE0 + (GLenum)i);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[i].ID);
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing all the texture arrays.
+ ***********************************************************/
+void TextureArrayManager::Destroy()
+{
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		if (m_arrays[i].ID != 0)
+		{
+			glDeleteTextures(1, &m_arrays[i].ID);
+		}
+		if (m_arrays[i].pendingID != 0)
+		{
+			glDeleteTextures(1, &m_arrays[i].pendingID);
+		}
+	}
+	m_arrays.clear();
+	m_textures.clear();
+}
+
+/***********************************************************
+ *  GetLocation()
+ *
+ *  This method returns where a texture lives in the arrays.
+ ***********************************************************/
+const TextureArrayManager::TEXTURE_LOCATION& TextureArrayManager::GetLocation(int texture) const
+{
+	return(m_textures[texture].location);
+}
+
+/***********************************************************
+ *  GetArrayID()
+ *
+ *  This method returns the OpenGL ID of the texture array
+ *  that holds a texture.
+ ***********************************************************/
+GLuint TextureArrayManager::GetArrayID(int texture) const
+{
+	return(m_arrays[m_textures[texture].location.arrayIndex].ID);
+}
+
+/***********************************************************
+ *  GetLevelCount()
+ *
+ *  This method returns the number of mip levels in the
+ *  layer that holds a texture.
+ ***********************************************************/
+int TextureArrayManager::GetLevelCount(int texture) const
+{
+	return(m_arrays[m_textures[texture].location.arrayIndex].levels);
+}
+
+/***********************************************************
+ *  GetImageSize()
+ *
+ *  This method returns the size of the image a texture was
+ *  reserved for, which can be smaller than its layer.
+ ***********************************************************/
+void TextureArrayManager::GetImageSize(int texture, int& width, int& height) const
+{
+	width = m_textures[texture].width;
+	height = m_textures[texture].height;
+}
+
+/***********************************************************
+ *  GetLevelExtent()
+ *
+ *  This method returns the size of one mip level of the
+ *  layer that holds a texture, including any padding.
+ ***********************************************************/
+void TextureArrayManager::GetLevelExtent(int texture, int level, int& width, int& height) const
+{
+	const TEXTURE_ARRAY& textureArray = m_arrays[m_textures[texture].location.arrayIndex];
+	width = GetLevelSize(textureArray.width, level);
+	height = GetLevelSize(textureArray.height, level);
+}
+
+/***********************************************************
+ *  GetLevelRows()
+ *
+ *  This method returns how one mip level of the layer that
+ *  holds a texture is split into rows for uploading.  Each
+ *  row of a compressed array is a row of 4x4 blocks.
+ ***********************************************************/
+void TextureArrayManager::GetLevelRows(int texture, int level, size_t& rowSize, int& rowCount) const
+{
+	const TEXTURE_ARRAY& textureArray = m_arrays[m_textures[texture].location.arrayIndex];
+	int levelWidth = GetLevelSize(textureArray.width, level);
+	int levelHeight = GetLevelSize(textureArray.height, level);
+
+	if (textureArray.format == TextureCompressor::FORMAT_UNCOMPRESSED)
+	{
+		rowSize = (size_t)levelWidth * textureArray.colorChannels;
+		rowCount = levelHeight;
+	}
+	else
+	{
+		rowSize = TextureCompressor::GetImageSize(textureArray.format, levelWidth, 1, textureArray.colorChannels);
+		rowCount = (levelHeight + 3) / 4;
+	}
+}
+
+/***********************************************************
+ *  GetColorChannels()
+ *
+ *  This method returns the number of color channels stored
+ *  for a texture.
+ ***********************************************************/
+int TextureArrayManager::GetColorChannels(int texture) const
+{
+	return(m_arrays[m_textures[texture].location.arrayIndex].colorChannels);
+}
+
+/***********************************************************
+ *  IsTranslucent()
+ *
+ *  This method returns whether a texture's image has pixels
+ *  that are not fully opaque.
+ ***********************************************************/
+bool TextureArrayManager::IsTranslucent(int texture) const
+{
+	return(m_textures[texture].bTranslucent);
+}
+
+/***********************************************************
+ *  SetTranslucent()
+ *
+ *  This method is used for recording whether a texture's
+ *  image has pixels that are not fully opaque, once it has
+ *  been decoded.
+ ***********************************************************/
+void TextureArrayManager::SetTranslucent(int texture, bool bTranslucent)
+{
+	m_textures[texture].bTranslucent = bTranslucent;
+}
+
+/***********************************************************
+ *  GetFormat()
+ *
+ *  This method returns the format of the array that holds
+ *  a texture.
+ ***********************************************************/
+TextureCompressor::FORMAT TextureArrayManager::GetFormat(int texture) const
+{
+	return(m_arrays[m_textures[texture].location.arrayIndex].format);
+}
+
+/***********************************************************
+ *  GetArrayCount()
+ *
+ *  This method returns the number of texture arrays.
+ ***********************************************************/
+int TextureArrayManager::GetArrayCount() const
+{
+	return((int)m_arrays.size());
+}
+
+/***********************************************************
+ *  GetArrayLevelCount()
+ *
+ *  This method returns the number of mip levels of an array.
+ ***********************************************************/
+int TextureArrayManager::GetArrayLevelCount(int arrayIndex) const
+{
+	return(m_arrays[arrayIndex].levels);
+}
+
+/***********************************************************
+ *  GetBaseLevel()
+ *
+ *  This method returns the first mip level an array is being
+ *  stored from, counting new storage that is still being
+ *  uploaded.  Evicted arrays return their level count.
+ ***********************************************************/
+int TextureArrayManager::GetBaseLevel(int arrayIndex) const
+{
+	const TEXTURE_ARRAY& textureArray = m_arrays[arrayIndex];
+	return((textureArray.pendingID != 0) ? textureArray.pendingBaseLevel : textureArray.baseLevel);
+}
+
+/***********************************************************
+ *  GetDrawnBaseLevel()
+ *
+ *  This method returns the first mip level of the storage
+ *  that draws are sampling.  Evicted arrays return their
+ *  level count.
+ ***********************************************************/
+int TextureArrayManager::GetDrawnBaseLevel(int arrayIndex) const
+{
+	return(m_arrays[arrayIndex].baseLevel);
+}
+
+/***********************************************************
+ *  IsPending()
+ *
+ *  This method returns true while new storage for an array
+ *  is waiting for its layers to be uploaded.
+ ***********************************************************/
+bool TextureArrayManager::IsPending(int arrayIndex) const
+{
+	return(m_arrays[arrayIndex].pendingID != 0);
+}
+
+/***********************************************************
+ *  GetArrayMemorySize()
+ *
+ *  This method returns the bytes an array takes when it is
+ *  stored from a mip level down.
+ ***********************************************************/
+size_t TextureArrayManager::GetArrayMemorySize(int arrayIndex, int baseLevel) const
+{
+	const TEXTURE_ARRAY& textureArray = m_arrays[arrayIndex];
+	size_t total = 0;
+
+	// RGB8 textures are stored with 4 bytes per pixel
+	for (int level = baseLevel; level < textureArray.levels; level++)
+	{
+		int levelWidth = GetLevelSize(textureArray.width, level);
+		int levelHeight = GetLevelSize(textureArray.height, level);
+		if (textureArray.format == TextureCompressor::FORMAT_UNCOMPRESSED)
+		{
+			total += (size_t)levelWidth * levelHeight * 4 * textureArray.layerCount;
+		}
+		else
+		{
+			total += TextureCompressor::GetImageSize(textureArray.format, levelWidth, levelHeight,
+				textureArray.colorChannels) * textureArray.layerCount;
+		}
+	}
+	return(total);
+}
+
+/***********************************************************
+ *  GetTextureMemorySize()
+ *
+ *  This method returns the bytes one texture's layer takes
+ *  at the base level of its array.
+ ***********************************************************/
+size_t TextureArrayManager::GetTextureMemorySize(int texture) const
+{
+	int arrayIndex = m_textures[texture].location.arrayIndex;
+	return(GetArrayMemorySize(arrayIndex, GetBaseLevel(arrayIndex)) / m_arrays[arrayIndex].layerCount);
+}
+
+/***********************************************************
+ *  GetMemorySize()
+ *
+ *  This method returns the bytes of texture memory used by
+ *  all of the arrays, including every mip level.
+ ***********************************************************/
+size_t TextureArrayManager::GetMemorySize() const
+{
+	size_t total = 0;
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		if (m_arrays[i].bBuilt)
+		{
+			total += GetArrayMemorySize((int)i, GetBaseLevel((int)i));
+		}
+	}
+	return(total);
+}
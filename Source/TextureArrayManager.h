@@ -0,0 +1,185 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturearraymanager.h
+// ============
+// pack scene textures into layers of OpenGL 2D texture arrays
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "TextureCompressor.h"
+
+/***********************************************************
+ *  TextureArrayManager
+ *
+ *  This class packs textures into GL_TEXTURE_2D_ARRAY
+ *  objects.  Textures with the same format and a similar
+ *  size share an array, each one in its own layer, and
+ *  every array stays bound to its own texture unit.  Any
+ *  loaded texture can then be selected by setting the
+ *  sampler unit, the layer and the layer UV transform,
+ *  without binding any textures.  Arrays are only ever
+ *  bound to their own unit, even while uploading.
+ *
+ *  Usage: Reserve() a layer for every texture, Build() the
+ *  arrays, upload the pixels with UploadLevel() for every
+ *  level of a mip chain or UploadImage() followed by
+ *  GenerateMipmaps(), then Bind() the arrays.  Streaming
+ *  uploads can instead copy rows with PadRows() into a pixel
+ *  buffer object and upload them a part at a time with
+ *  UploadRows().
+ *
+ *  Compressed textures are stored in their own arrays and
+ *  are always uploaded with their cooked mip chain.  Their
+ *  rows are rows of 4x4 pixel blocks.
+ *
+ *  To save memory an array can drop its top mip levels, or
+ *  be evicted completely, with SetBaseLevel().  The array
+ *  is then given new storage that every layer is uploaded
+ *  into again, while the old storage keeps being drawn
+ *  until FinishLayer() has been called for every layer.
+ ***********************************************************/
+class TextureArrayManager
+{
+public:
+	// constructor
+	TextureArrayManager();
+	// destructor
+	~TextureArrayManager();
+
+	// where a texture lives inside the texture arrays
+	struct TEXTURE_LOCATION
+	{
+		// texture array, which is also its texture unit
+		int arrayIndex;
+		// layer inside the texture array
+		int layer;
+		// xy scales and zw offsets texture coordinates from the
+		// whole layer to the part of the layer the image fills
+		glm::vec4 uvTransform;
+	};
+
+	// reserve a layer for a texture, returning the texture index -
+	// bTranslucent is set when some pixel of its image is not
+	// fully opaque
+	int Reserve(int width, int height, int colorChannels,
+		TextureCompressor::FORMAT format = TextureCompressor::FORMAT_UNCOMPRESSED, bool bTranslucent = false);
+	// create the storage for arrays with newly reserved layers
+	void Build();
+	// upload one mip level of pixels or blocks into a texture's layer
+	void UploadLevel(int texture, int level, int width, int height, const unsigned char* pixels);
+	// upload the pixels of an image without a mip chain
+	void UploadImage(int texture, int width, int height, const unsigned char* pixels);
+	// copy rows of one mip level of an image into a buffer the
+	// size of those rows of the layer, padding them to its width -
+	// the size of the buffer is rowCount rows from GetLevelRows()
+	void PadRows(int texture, int level, int width, int height, const unsigned char* pixels,
+		int firstRow, int rowCount, unsigned char* destination) const;
+	// upload padded rows of one mip level into a texture's layer -
+	// the data can be an offset into a bound pixel unpack buffer
+	void UploadRows(int texture, int level, int firstRow, int rowCount, const void* data);
+	// mark a texture's array as needing its mipmaps generated
+	void FlagMipmaps(int texture);
+	// give an array new storage that starts at a different mip
+	// level, or free it if the level is past the last level
+	void SetBaseLevel(int arrayIndex, int baseLevel);
+	// note that a layer has been uploaded into new storage,
+	// returning true once the layer can be drawn
+	bool FinishLayer(int texture);
+	// generate the mipmaps of arrays with images uploaded by
+	// UploadImage()
+	void GenerateMipmaps();
+	// bind every texture array to its texture unit
+	void Bind();
+	// free all of the texture arrays
+	void Destroy();
+
+	// get the location of a reserved texture
+	const TEXTURE_LOCATION& GetLocation(int texture) const;
+	// get the OpenGL ID of the texture array holding a texture
+	GLuint GetArrayID(int texture) const;
+	// number of mip levels in a texture's layer
+	int GetLevelCount(int texture) const;
+	// size of the image a texture was reserved for
+	void GetImageSize(int texture, int& width, int& height) const;
+	// size of one mip level of a texture's layer
+	void GetLevelExtent(int texture, int level, int& width, int& height) const;
+	// bytes in one row of a mip level of a texture's layer, and
+	// the number of rows - rows of blocks when compressed
+	void GetLevelRows(int texture, int level, size_t& rowSize, int& rowCount) const;
+	// number of color channels of a texture
+	int GetColorChannels(int texture) const;
+	// whether a texture's image has pixels that are not fully
+	// opaque, which the number of channels does not tell, and
+	// changing it once the image is known
+	bool IsTranslucent(int texture) const;
+	void SetTranslucent(int texture, bool bTranslucent);
+	// format the texture's array stores its data in
+	TextureCompressor::FORMAT GetFormat(int texture) const;
+	// number of texture arrays created
+	int GetArrayCount() const;
+	// number of mip levels in an array's layers
+	int GetArrayLevelCount(int arrayIndex) const;
+	// first mip level an array is stored from, including storage
+	// that is still being uploaded - the level count if evicted
+	int GetBaseLevel(int arrayIndex) const;
+	// first mip level of the storage that is being drawn
+	int GetDrawnBaseLevel(int arrayIndex) const;
+	// true while an array's new storage is being uploaded
+	bool IsPending(int arrayIndex) const;
+	// bytes an array takes when stored from a mip level
+	size_t GetArrayMemorySize(int arrayIndex, int baseLevel) const;
+	// bytes of one texture's layer at its array's base level
+	size_t GetTextureMemorySize(int texture) const;
+	// total bytes of texture memory used by the arrays
+	size_t GetMemorySize() const;
+
+private:
+	// one GL_TEXTURE_2D_ARRAY object
+	struct TEXTURE_ARRAY
+	{
+		GLuint ID;
+		int width;
+		int height;
+		int colorChannels;
+		TextureCompressor::FORMAT format;
+		int levels;
+		int layerCount;
+		// first mip level the drawn storage holds
+		int baseLevel;
+		// new storage being uploaded after a SetBaseLevel()
+		// call, the first level it holds and the layers that
+		// still have to be uploaded into it
+		GLuint pendingID;
+		int pendingBaseLevel;
+		int pendingLayers;
+		// storage is created once, after that no more layers
+		// can be added to the array
+		bool bBuilt;
+		// set when an image was uploaded without a mip chain
+		bool bNeedsMipmaps;
+	};
+
+	// one reserved texture
+	struct TEXTURE_ENTRY
+	{
+		TEXTURE_LOCATION location;
+		int width;
+		int height;
+		bool bTranslucent;
+	};
+
+	std::vector<TEXTURE_ARRAY> m_arrays;
+	std::vector<TEXTURE_ENTRY> m_textures;
+	// scratch buffer for padding images up to the layer size
+	std::vector<unsigned char> m_padBuffer;
+	// largest number of layers allowed in one array
+	int m_maxLayers;
+
+	// create storage for an array from a mip level upwards
+	GLuint CreateStorage(int arrayIndex, int baseLevel);
+};
@@ -0,0 +1,724 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.cpp
+// ============
+// cook decoded images into pre-mipmapped cache files that can be memory
+// mapped and uploaded without decoding
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureCache.h"
+
+#include "ImageKernels.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// "GTEX" read as a little endian integer
+	const uint32_t g_CacheMagic = 0x58455447;
+	// bump whenever the layout below changes
+	const uint32_t g_CacheVersion = 5;
+	// every mip level starts on this byte boundary
+	const uint64_t g_CacheAlignment = 16;
+	// header flag set when the source image has a pixel with an
+	// alpha below 255
+	const uint32_t g_CacheFlagTranslucent = 0x1;
+	// largest width or height a cache file may hold, and so the
+	// longest mip chain, beyond any texture the scene loads
+	const uint32_t g_MaxCacheDimension = 16384;
+	const uint32_t g_MaxCacheMips = 15;
+
+	// fixed size header at the start of a cache file
+	struct CACHE_HEADER
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint32_t colorChannels;
+		uint32_t mipCount;
+		// TextureCompressor::FORMAT of the mip level data
+		uint32_t format;
+		// g_CacheFlag bits
+		uint32_t flags;
+		// size, modification time and contents hash of the
+		// source image the cache file was cooked from
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		uint64_t sourceHash;
+	};
+
+	// table entry following the header, one per mip level
+	struct CACHE_MIP
+	{
+		uint32_t width;
+		uint32_t height;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	// read-only memory mapping of a whole file
+	struct MAPPING
+	{
+		const unsigned char* data;
+		size_t size;
+#ifdef _WIN32
+		HANDLE hFile;
+		HANDLE hMapping;
+#else
+		int fileDescriptor;
+#endif
+	};
+
+	/***********************************************************
+	 *  HasTranslucentPixel()
+	 *
+	 *  Check whether any RGBA pixel has an alpha below 255.
+	 ***********************************************************/
+	bool HasTranslucentPixel(const unsigned char* rgba, size_t pixelCount)
+	{
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			if (rgba[i * 4 + 3] != 255)
+			{
+				return(true);
+			}
+		}
+		return(false);
+	}
+
+	/***********************************************************
+	 *  IsValidHeader()
+	 *
+	 *  Check the values of a cache file header against what
+	 *  Cook() writes - a known format, 3 or 4 color channels,
+	 *  a size the uploader takes, and the number of levels of
+	 *  the full mip chain of that size.
+	 ***********************************************************/
+	bool IsValidHeader(const CACHE_HEADER& header)
+	{
+		if ((header.magic != g_CacheMagic) ||
+			(header.version != g_CacheVersion) ||
+			(header.format >= TextureCompressor::FORMAT_COUNT) ||
+			((header.colorChannels != 3) && (header.colorChannels != 4)) ||
+			(header.width == 0) || (header.width > g_MaxCacheDimension) ||
+			(header.height == 0) || (header.height > g_MaxCacheDimension))
+		{
+			return(false);
+		}
+
+		uint32_t mipCount = 1;
+		for (uint32_t size = (header.width > header.height) ? header.width : header.height; size > 1; size /= 2)
+		{
+			mipCount++;
+		}
+		return((mipCount <= g_MaxCacheMips) && (header.mipCount == mipCount));
+	}
+
+	/***********************************************************
+	 *  IsValidMip()
+	 *
+	 *  Check one entry of the mip table - the level must be
+	 *  half the size of the one above it, hold exactly the
+	 *  bytes of that size in the file's format, and start on
+	 *  an aligned offset past the mip table with all of its
+	 *  bytes inside the file.
+	 ***********************************************************/
+	bool IsValidMip(const CACHE_HEADER& header, const CACHE_MIP& mip, uint32_t width, uint32_t height,
+		uint64_t dataOffset, uint64_t fileSize)
+	{
+		size_t expectedSize = TextureCompressor::GetImageSize((TextureCompressor::FORMAT)header.format,
+			(int)width, (int)height, (int)header.colorChannels);
+		return((mip.width == width) &&
+			(mip.height == height) &&
+			(mip.size == (uint64_t)expectedSize) &&
+			(mip.offset >= dataOffset) &&
+			((mip.offset % g_CacheAlignment) == 0) &&
+			(mip.offset <= fileSize) &&
+			(mip.size <= fileSize - mip.offset));
+	}
+
+	/***********************************************************
+	 *  UnmapFile()
+	 *
+	 *  Release a file memory mapping.
+	 ***********************************************************/
+	void UnmapFile(MAPPING* pMapping)
+	{
+		if (NULL == pMapping)
+		{
+			return;
+		}
+#ifdef _WIN32
+		if (NULL != pMapping->data)
+			UnmapViewOfFile(pMapping->data);
+		if (NULL != pMapping->hMapping)
+			CloseHandle(pMapping->hMapping);
+		if (INVALID_HANDLE_VALUE != pMapping->hFile)
+			CloseHandle(pMapping->hFile);
+#else
+		if (NULL != pMapping->data)
+			munmap((void*)pMapping->data, pMapping->size);
+		if (pMapping->fileDescriptor >= 0)
+			close(pMapping->fileDescriptor);
+#endif
+		delete pMapping;
+	}
+
+	/***********************************************************
+	 *  MapFile()
+	 *
+	 *  Map a whole file into memory for reading.
+	 ***********************************************************/
+	MAPPING* MapFile(const std::string& filename)
+	{
+		MAPPING* pMapping = new MAPPING();
+		pMapping->data = NULL;
+		pMapping->size = 0;
+
+#ifdef _WIN32
+		pMapping->hMapping = NULL;
+		pMapping->hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		LARGE_INTEGER fileSize;
+		if ((INVALID_HANDLE_VALUE == pMapping->hFile) ||
+			(GetFileSizeEx(pMapping->hFile, &fileSize) == FALSE) ||
+			(fileSize.QuadPart == 0))
+		{
+			UnmapFile(pMapping);
+			return(NULL);
+		}
+		pMapping->size = (size_t)fileSize.QuadPart;
+		pMapping->hMapping = CreateFileMappingA(pMapping->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (NULL != pMapping->hMapping)
+		{
+			pMapping->data = (const unsigned char*)MapViewOfFile(pMapping->hMapping, FILE_MAP_READ, 0, 0, 0);
+		}
+#else
+		pMapping->fileDescriptor = open(filename.c_str(), O_RDONLY);
+		struct stat info;
+		if ((pMapping->fileDescriptor < 0) ||
+			(fstat(pMapping->fileDescriptor, &info) != 0) ||
+			(info.st_size == 0))
+		{
+			UnmapFile(pMapping);
+			return(NULL);
+		}
+		pMapping->size = (size_t)info.st_size;
+		void* pData = mmap(NULL, pMapping->size, PROT_READ, MAP_PRIVATE, pMapping->fileDescriptor, 0);
+		if (MAP_FAILED != pData)
+		{
+			pMapping->data = (const unsigned char*)pData;
+		}
+#endif
+
+		if (NULL == pMapping->data)
+		{
+			UnmapFile(pMapping);
+			return(NULL);
+		}
+		return(pMapping);
+	}
+
+}
+
+/***********************************************************
+ *  CACHED_TEXTURE()
+ *
+ *  The constructor for the cached texture data
+ ***********************************************************/
+TextureCache::CACHED_TEXTURE::CACHED_TEXTURE()
+{
+	width = 0;
+	height = 0;
+	colorChannels = 0;
+	format = TextureCompressor::FORMAT_UNCOMPRESSED;
+	bTranslucent = false;
+	pMapping = NULL;
+}
+
+/***********************************************************
+ *  CACHED_TEXTURE(CACHED_TEXTURE&&)
+ *
+ *  The move constructor for the cached texture data
+ ***********************************************************/
+TextureCache::CACHED_TEXTURE::CACHED_TEXTURE(CACHED_TEXTURE&& other)
+{
+	pMapping = NULL;
+	*this = std::move(other);
+}
+
+/***********************************************************
+ *  operator=(CACHED_TEXTURE&&)
+ *
+ *  The move assignment for the cached texture data
+ ***********************************************************/
+TextureCache::CACHED_TEXTURE& TextureCache::CACHED_TEXTURE::operator=(CACHED_TEXTURE&& other)
+{
+	if (this != &other)
+	{
+		TextureCache::Close(*this);
+		width = other.width;
+		height = other.height;
+		colorChannels = other.colorChannels;
+		format = other.format;
+		bTranslucent = other.bTranslucent;
+		// moving the vectors keeps the pixel memory in place, so
+		// the mip level pointers stay valid
+		mipLevels = std::move(other.mipLevels);
+		storage = std::move(other.storage);
+		pMapping = other.pMapping;
+		other.pMapping = NULL;
+		TextureCache::Close(other);
+	}
+	return(*this);
+}
+
+/***********************************************************
+ *  GetCachePath()
+ *
+ *  This method returns the path of the cache file for the
+ *  passed in source image file.
+ ***********************************************************/
+std::string TextureCache::GetCachePath(const std::string& sourceFile)
+{
+	return(sourceFile + ".gtex");
+}
+
+/***********************************************************
+ *  HashFile()
+ *
+ *  This method is used for hashing the full contents of a
+ *  file with 64-bit FNV-1a.
+ ***********************************************************/
+bool TextureCache::HashFile(const std::string& filename, uint64_t& hash)
+{
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	if (!file)
+	{
+		return(false);
+	}
+
+	unsigned char buffer[64 * 1024];
+	hash = 14695981039346656037ULL;
+	while (file)
+	{
+		file.read((char*)buffer, sizeof(buffer));
+		std::streamsize count = file.gcount();
+		for (std::streamsize i = 0; i < count; i++)
+		{
+			hash ^= buffer[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  GetFileStamp()
+ *
+ *  This method is used for getting the size and the
+ *  modification time of a file.
+ ***********************************************************/
+bool TextureCache::GetFileStamp(const std::string& filename, uint64_t& size, int64_t& time)
+{
+#ifdef _WIN32
+	struct _stat64 info;
+	if (_stat64(filename.c_str(), &info) != 0)
+	{
+		return(false);
+	}
+#else
+	struct stat info;
+	if (stat(filename.c_str(), &info) != 0)
+	{
+		return(false);
+	}
+#endif
+	size = (uint64_t)info.st_size;
+	time = (int64_t)info.st_mtime;
+	return(true);
+}
+
+/***********************************************************
+ *  ReadCookedFormat()
+ *
+ *  This method is used for reading the format a source
+ *  image's cache file was cooked in, even when the cache
+ *  file is older than the source.  It fails when there is
+ *  no cache file of this version.
+ ***********************************************************/
+bool TextureCache::ReadCookedFormat(const std::string& sourceFile, TextureCompressor::FORMAT& format)
+{
+	std::ifstream file(GetCachePath(sourceFile).c_str(), std::ios::binary);
+	CACHE_HEADER header;
+	if (!file.read((char*)&header, sizeof(header)) ||
+		(header.magic != g_CacheMagic) ||
+		(header.version != g_CacheVersion) ||
+		(header.format >= TextureCompressor::FORMAT_COUNT))
+	{
+		return(false);
+	}
+
+	format = (TextureCompressor::FORMAT)header.format;
+	return(true);
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for memory mapping the cache file of
+ *  a source image.  It fails when the cache file is missing,
+ *  damaged, or was cooked from a different version of the
+ *  source image.  The header and every entry of the mip
+ *  table are checked against the file's length and the
+ *  sizes Cook() writes, so a truncated or corrupt file is
+ *  rejected and the source image decoded instead, rather
+ *  than the uploader reading past the end of the mapping.
+ ***********************************************************/
+bool TextureCache::Open(const std::string& sourceFile, CACHED_TEXTURE& texture)
+{
+	uint64_t sourceSize = 0;
+	int64_t sourceTime = 0;
+
+	Close(texture);
+
+	if (!GetFileStamp(sourceFile, sourceSize, sourceTime))
+	{
+		return(false);
+	}
+
+	MAPPING* pMapping = MapFile(GetCachePath(sourceFile));
+	if (NULL == pMapping)
+	{
+		return(false);
+	}
+
+	// check the header and the mip table fit in the file
+	CACHE_HEADER header;
+	bool bValid = (pMapping->size >= sizeof(CACHE_HEADER));
+	if (bValid)
+	{
+		memcpy(&header, pMapping->data, sizeof(CACHE_HEADER));
+		bValid = IsValidHeader(header) &&
+			(pMapping->size >= sizeof(CACHE_HEADER) + header.mipCount * sizeof(CACHE_MIP));
+	}
+
+	// a size or timestamp mismatch only means the source was
+	// touched - hash it before deciding the cache is stale
+	if (bValid && ((header.sourceSize != sourceSize) || (header.sourceTime != sourceTime)))
+	{
+		uint64_t sourceHash = 0;
+		bValid = (header.sourceSize == sourceSize) &&
+			HashFile(sourceFile, sourceHash) &&
+			(header.sourceHash == sourceHash);
+	}
+
+	if (bValid)
+	{
+		const CACHE_MIP* mips = (const CACHE_MIP*)(pMapping->data + sizeof(CACHE_HEADER));
+		uint64_t dataOffset = sizeof(CACHE_HEADER) + header.mipCount * sizeof(CACHE_MIP);
+		uint32_t mipWidth = header.width;
+		uint32_t mipHeight = header.height;
+		for (uint32_t i = 0; (i < header.mipCount) && bValid; i++)
+		{
+			CACHE_MIP mip;
+			memcpy(&mip, &mips[i], sizeof(CACHE_MIP));
+			if (!IsValidMip(header, mip, mipWidth, mipHeight, dataOffset, pMapping->size))
+			{
+				bValid = false;
+			}
+			else
+			{
+				MIP_LEVEL level;
+				level.width = (int)mip.width;
+				level.height = (int)mip.height;
+				level.size = (size_t)mip.size;
+				level.pixels = pMapping->data + mip.offset;
+				texture.mipLevels.push_back(level);
+			}
+			mipWidth = (mipWidth > 1) ? mipWidth / 2 : 1;
+			mipHeight = (mipHeight > 1) ? mipHeight / 2 : 1;
+		}
+	}
+
+	if (!bValid)
+	{
+		texture.mipLevels.clear();
+		UnmapFile(pMapping);
+		return(false);
+	}
+
+	texture.width = (int)header.width;
+	texture.height = (int)header.height;
+	texture.colorChannels = (int)header.colorChannels;
+	texture.format = (TextureCompressor::FORMAT)header.format;
+	texture.bTranslucent = ((header.flags & g_CacheFlagTranslucent) != 0);
+	texture.pMapping = pMapping;
+	return(true);
+}
+
+/***********************************************************
+ *  Cook()
+ *
+ *  This method is used for building the full mip chain of
+ *  decoded image pixels and writing it to the cache file of
+ *  the source image.  The levels are filtered in linear
+ *  light, and RGBA images are premultiplied by their alpha
+ *  first.  Uncompressed RGB images are stored as RGBA, so a
+ *  warm start uploads straight from the mapped file.  With
+ *  a compressed format every level is compressed after the
+ *  whole chain has been built, so the smaller levels are
+ *  filtered from the full quality pixels.  The cooked mip
+ *  chain is also returned so it can be uploaded straight
+ *  away.
+ ***********************************************************/
+bool TextureCache::Cook(
+	const std::string& sourceFile,
+	const unsigned char* pixels,
+	int width,
+	int height,
+	int colorChannels,
+	CACHED_TEXTURE& texture,
+	TextureCompressor::FORMAT format)
+{
+	Close(texture);
+
+	if ((NULL == pixels) || (width <= 0) || (height <= 0))
+	{
+		return(false);
+	}
+
+	// uncompressed RGB gets its opaque alpha channel here rather
+	// than every time the cache file is loaded
+	int storedChannels = ((format == TextureCompressor::FORMAT_UNCOMPRESSED) && (colorChannels == 3)) ? 4 : colorChannels;
+
+	// lay out the mip chain, each level on an aligned offset, once
+	// as pixels and once in the format it is stored in
+	std::vector<CACHE_MIP> pixelMips;
+	std::vector<CACHE_MIP> mips;
+	int mipWidth = width;
+	int mipHeight = height;
+	uint64_t pixelOffset = 0;
+	uint64_t offset = 0;
+	while (true)
+	{
+		CACHE_MIP mip;
+		mip.width = (uint32_t)mipWidth;
+		mip.height = (uint32_t)mipHeight;
+		mip.offset = pixelOffset;
+		mip.size = (uint64_t)mipWidth * mipHeight * storedChannels;
+		pixelMips.push_back(mip);
+		pixelOffset = (pixelOffset + mip.size + g_CacheAlignment - 1) & ~(g_CacheAlignment - 1);
+
+		mip.offset = offset;
+		mip.size = TextureCompressor::GetImageSize(format, mipWidth, mipHeight, storedChannels);
+		mips.push_back(mip);
+		offset = (offset + mip.size + g_CacheAlignment - 1) & ~(g_CacheAlignment - 1);
+
+		if ((mipWidth == 1) && (mipHeight == 1))
+			break;
+		mipWidth = (mipWidth > 1) ? mipWidth / 2 : 1;
+		mipHeight = (mipHeight > 1) ? mipHeight / 2 : 1;
+	}
+
+	// build every level from the one above it, straight into the
+	// texture's storage when the pixels are stored as they are
+	std::vector<unsigned char> pixelStorage;
+	std::vector<unsigned char>& chain = (format == TextureCompressor::FORMAT_UNCOMPRESSED) ? texture.storage : pixelStorage;
+	chain.resize((size_t)pixelOffset);
+	if (storedChannels != colorChannels)
+	{
+		ImageKernels::ExpandRGBToRGBA(pixels, &chain[0], (size_t)width * height);
+	}
+	else
+	{
+		memcpy(&chain[0], pixels, (size_t)pixelMips[0].size);
+	}
+	if (colorChannels == 4)
+	{
+		ImageKernels::PremultiplyAlpha(&chain[0], (size_t)width * height);
+	}
+	for (size_t i = 1; i < pixelMips.size(); i++)
+	{
+		ImageKernels::DownsampleSRGB(
+			&chain[(size_t)pixelMips[i - 1].offset], pixelMips[i - 1].width, pixelMips[i - 1].height,
+			&chain[(size_t)pixelMips[i].offset], pixelMips[i].width, pixelMips[i].height,
+			storedChannels);
+	}
+
+	if (format != TextureCompressor::FORMAT_UNCOMPRESSED)
+	{
+		texture.storage.resize((size_t)offset);
+		for (size_t i = 0; i < mips.size(); i++)
+		{
+			TextureCompressor::Compress(format, &pixelStorage[(size_t)pixelMips[i].offset],
+				mips[i].width, mips[i].height, storedChannels, &texture.storage[(size_t)mips[i].offset]);
+		}
+	}
+
+	texture.width = width;
+	texture.height = height;
+	texture.colorChannels = storedChannels;
+	texture.format = format;
+	texture.bTranslucent = (colorChannels == 4) && HasTranslucentPixel(pixels, (size_t)width * height);
+	for (size_t i = 0; i < mips.size(); i++)
+	{
+		MIP_LEVEL level;
+		level.width = (int)mips[i].width;
+		level.height = (int)mips[i].height;
+		level.size = (size_t)mips[i].size;
+		level.pixels = &texture.storage[(size_t)mips[i].offset];
+		texture.mipLevels.push_back(level);
+	}
+
+	// stamp the header with the source file it was cooked from
+	CACHE_HEADER header;
+	memset(&header, 0, sizeof(header));
+	header.magic = g_CacheMagic;
+	header.version = g_CacheVersion;
+	header.width = (uint32_t)width;
+	header.height = (uint32_t)height;
+	header.colorChannels = (uint32_t)storedChannels;
+	header.mipCount = (uint32_t)mips.size();
+	header.format = (uint32_t)format;
+	header.flags = texture.bTranslucent ? g_CacheFlagTranslucent : 0;
+	if (!GetFileStamp(sourceFile, header.sourceSize, header.sourceTime) ||
+		!HashFile(sourceFile, header.sourceHash))
+	{
+		return(false);
+	}
+
+	// the pixel data starts after the header and the mip table
+	uint64_t dataOffset = sizeof(CACHE_HEADER) + mips.size() * sizeof(CACHE_MIP);
+	dataOffset = (dataOffset + g_CacheAlignment - 1) & ~(g_CacheAlignment - 1);
+	for (size_t i = 0; i < mips.size(); i++)
+	{
+		mips[i].offset += dataOffset;
+	}
+
+	// write to a temporary file first so a reader never maps a
+	// half written cache file
+	std::string cachePath = GetCachePath(sourceFile);
+	std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream file(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return(false);
+		}
+
+		static const char padding[g_CacheAlignment] = { 0 };
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)&mips[0], mips.size() * sizeof(CACHE_MIP));
+		file.write(padding, (std::streamsize)(dataOffset - sizeof(CACHE_HEADER) - mips.size() * sizeof(CACHE_MIP)));
+		file.write((const char*)&texture.storage[0], (std::streamsize)texture.storage.size());
+		if (!file)
+		{
+			file.close();
+			std::remove(tempPath.c_str());
+			return(false);
+		}
+	}
+
+	std::remove(cachePath.c_str());
+	if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+	{
+		std::remove(tempPath.c_str());
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  ConvertToRGBA()
+ *
+ *  This method is used for turning every level of a texture
+ *  into RGBA pixels held in memory.  Compressed levels are
+ *  decoded, for drivers that cannot sample their format,
+ *  and RGB levels get an opaque alpha channel.  RGBA pixels
+ *  are left as they are.
+ ***********************************************************/
+void TextureCache::ConvertToRGBA(CACHED_TEXTURE& texture)
+{
+	bool bCompressed = (texture.format != TextureCompressor::FORMAT_UNCOMPRESSED);
+	if ((!bCompressed && (texture.colorChannels != 3)) || texture.mipLevels.empty())
+	{
+		return;
+	}
+
+	std::vector<size_t> offsets;
+	size_t size = 0;
+	for (size_t i = 0; i < texture.mipLevels.size(); i++)
+	{
+		offsets.push_back(size);
+		size += TextureCompressor::GetImageSize(TextureCompressor::FORMAT_UNCOMPRESSED,
+			texture.mipLevels[i].width, texture.mipLevels[i].height, 4);
+	}
+
+	std::vector<unsigned char> storage(size);
+	std::vector<MIP_LEVEL> mipLevels;
+	for (size_t i = 0; i < texture.mipLevels.size(); i++)
+	{
+		MIP_LEVEL level = texture.mipLevels[i];
+		size_t pixelCount = (size_t)level.width * level.height;
+		if (bCompressed)
+		{
+			TextureCompressor::Decompress(texture.format, level.pixels, level.width, level.height, &storage[offsets[i]]);
+		}
+		else
+		{
+			ImageKernels::ExpandRGBToRGBA(level.pixels, &storage[offsets[i]], pixelCount);
+		}
+		level.size = pixelCount * 4;
+		level.pixels = &storage[offsets[i]];
+		mipLevels.push_back(level);
+	}
+
+	// closing releases the mapping the levels were read from
+	int width = texture.width;
+	int height = texture.height;
+	bool bTranslucent = texture.bTranslucent;
+	Close(texture);
+	texture.width = width;
+	texture.height = height;
+	texture.colorChannels = 4;
+	texture.bTranslucent = bTranslucent;
+	texture.mipLevels = mipLevels;
+	texture.storage = std::move(storage);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for releasing the memory or file
+ *  mapping held by a cached texture.
+ ***********************************************************/
+void TextureCache::Close(CACHED_TEXTURE& texture)
+{
+	UnmapFile((MAPPING*)texture.pMapping);
+	texture.pMapping = NULL;
+	texture.mipLevels.clear();
+	std::vector<unsigned char>().swap(texture.storage);
+	texture.width = 0;
+	texture.height = 0;
+	texture.colorChannels = 0;
+	texture.format = TextureCompressor::FORMAT_UNCOMPRESSED;
+	texture.bTranslucent = false;
+}
@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.h
+// ============
+// cook decoded images into pre-mipmapped cache files that can be memory
+// mapped and uploaded without decoding
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TextureCompressor.h"
+
+/***********************************************************
+ *  TextureCache
+ *
+ *  This class reads and writes the binary texture cache
+ *  files.  A cache file stores the full mip chain of one
+ *  image, already flipped and tightly packed, so it can be
+ *  handed straight to OpenGL from the memory mapping.  The
+ *  levels are either raw pixels or, when cooked with a
+ *  compressed format, rows of 4x4 pixel blocks.  The color
+ *  of RGBA images is stored premultiplied by alpha.
+ *
+ *  The cache file for "textures/wood.jpg" is written next
+ *  to it as "textures/wood.jpg.gtex".
+ ***********************************************************/
+class TextureCache
+{
+public:
+	// one level of the stored mip chain
+	struct MIP_LEVEL
+	{
+		int width;
+		int height;
+		size_t size;
+		const unsigned char* pixels;
+	};
+
+	// a cooked texture, either memory mapped from a cache file
+	// or held in memory right after cooking
+	struct CACHED_TEXTURE
+	{
+		int width;
+		int height;
+		int colorChannels;
+		// format of every mip level's data
+		TextureCompressor::FORMAT format;
+		// set when some pixel of the source image is not fully
+		// opaque, whatever number of channels it is stored with
+		bool bTranslucent;
+		std::vector<MIP_LEVEL> mipLevels;
+		// pixel memory owned by a freshly cooked texture
+		std::vector<unsigned char> storage;
+		// platform memory mapping of an opened cache file
+		void* pMapping;
+
+		CACHED_TEXTURE();
+		// the mip levels point into the texture's own memory, so
+		// a cached texture can be moved but never copied
+		CACHED_TEXTURE(CACHED_TEXTURE&& other);
+		CACHED_TEXTURE& operator=(CACHED_TEXTURE&& other);
+		CACHED_TEXTURE(const CACHED_TEXTURE&) = delete;
+		CACHED_TEXTURE& operator=(const CACHED_TEXTURE&) = delete;
+	};
+
+	// get the cache file path for a source image file
+	static std::string GetCachePath(const std::string& sourceFile);
+
+	// try to open the cache file for a source image - this fails
+	// when the cache file is missing or older than the source
+	static bool Open(const std::string& sourceFile, CACHED_TEXTURE& texture);
+
+	// build the mip chain for decoded pixels, compress it to the
+	// format and write it to the cache file for the source image -
+	// the mip chain is returned even when the cache file could not
+	// be written
+	static bool Cook(
+		const std::string& sourceFile,
+		const unsigned char* pixels,
+		int width,
+		int height,
+		int colorChannels,
+		CACHED_TEXTURE& texture,
+		TextureCompressor::FORMAT format = TextureCompressor::FORMAT_UNCOMPRESSED);
+
+	// turn a compressed or RGB texture into uncompressed RGBA levels,
+	// for drivers without support for its format and so RGB never
+	// has to be converted by the driver
+	static void ConvertToRGBA(CACHED_TEXTURE& texture);
+
+	// release the memory or mapping held by a cached texture
+	static void Close(CACHED_TEXTURE& texture);
+
+	// 64-bit FNV-1a hash of a file's contents
+	static bool HashFile(const std::string& filename, uint64_t& hash);
+	// size and modification time of a file
+	static bool GetFileStamp(const std::string& filename, uint64_t& size, int64_t& time);
+	// format the cache file for a source image was last cooked in,
+	// whether or not it is still up to date
+	static bool ReadCookedFormat(const std::string& sourceFile, TextureCompressor::FORMAT& format);
+};
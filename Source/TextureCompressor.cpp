@@ -0,0 +1,1048 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecompressor.cpp
+// ============
+// encode and decode BC1, BC3 and BC7 block compressed texture data
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureCompressor.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+#define TEXTURE_COMPRESSOR_SSE2
+#include <emmintrin.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// interpolation weights of the 4-bit BC7 indices, out of 64
+	const int g_BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// the 16 pixels of one block, one array per channel so four
+	// pixels can be worked on at once
+	struct BLOCK
+	{
+		float channel[4][16];
+	};
+
+	/***********************************************************
+	 *  LoadBlock()
+	 *
+	 *  Read a 4x4 block of pixels, repeating the last row and
+	 *  column past the edge of the image.  RGB images get an
+	 *  alpha of 255.
+	 ***********************************************************/
+	void LoadBlock(const unsigned char* pixels, int width, int height, int colorChannels,
+		int blockX, int blockY, BLOCK& block)
+	{
+		for (int y = 0; y < 4; y++)
+		{
+			int pixelY = blockY * 4 + y;
+			if (pixelY >= height)
+				pixelY = height - 1;
+			for (int x = 0; x < 4; x++)
+			{
+				int pixelX = blockX * 4 + x;
+				if (pixelX >= width)
+					pixelX = width - 1;
+				const unsigned char* pixel = pixels + ((size_t)pixelY * width + pixelX) * colorChannels;
+				int i = y * 4 + x;
+				block.channel[0][i] = pixel[0];
+				block.channel[1][i] = pixel[1];
+				block.channel[2][i] = pixel[2];
+				block.channel[3][i] = (colorChannels == 4) ? pixel[3] : 255.0f;
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  Clamp255()
+	 *
+	 *  Clamp a channel value to the 0 to 255 range.
+	 ***********************************************************/
+	float Clamp255(float value)
+	{
+		return((value < 0.0f) ? 0.0f : ((value > 255.0f) ? 255.0f : value));
+	}
+
+	/***********************************************************
+	 *  FitEndpoints()
+	 *
+	 *  Find the line through the block's pixels along their
+	 *  principal axis, and return the ends of the part of the
+	 *  line the pixels project onto.
+	 ***********************************************************/
+	void FitEndpoints(const BLOCK& block, int channels, float endpoint0[4], float endpoint1[4])
+	{
+		float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float low[4];
+		float high[4];
+
+		for (int c = 0; c < channels; c++)
+		{
+#ifdef TEXTURE_COMPRESSOR_SSE2
+			__m128 sum = _mm_setzero_ps();
+			__m128 minimum = _mm_set1_ps(255.0f);
+			__m128 maximum = _mm_setzero_ps();
+			for (int i = 0; i < 16; i += 4)
+			{
+				__m128 value = _mm_loadu_ps(&block.channel[c][i]);
+				sum = _mm_add_ps(sum, value);
+				minimum = _mm_min_ps(minimum, value);
+				maximum = _mm_max_ps(maximum, value);
+			}
+			float lanes[4];
+			_mm_storeu_ps(lanes, sum);
+			mean[c] = (lanes[0] + lanes[1] + lanes[2] + lanes[3]) / 16.0f;
+			_mm_storeu_ps(lanes, minimum);
+			low[c] = fminf(fminf(lanes[0], lanes[1]), fminf(lanes[2], lanes[3]));
+			_mm_storeu_ps(lanes, maximum);
+			high[c] = fmaxf(fmaxf(lanes[0], lanes[1]), fmaxf(lanes[2], lanes[3]));
+#else
+			low[c] = 255.0f;
+			high[c] = 0.0f;
+			for (int i = 0; i < 16; i++)
+			{
+				mean[c] += block.channel[c][i];
+				low[c] = fminf(low[c], block.channel[c][i]);
+				high[c] = fmaxf(high[c], block.channel[c][i]);
+			}
+			mean[c] /= 16.0f;
+#endif
+		}
+
+		// covariance of the channels around the mean
+		float covariance[4][4];
+		for (int a = 0; a < channels; a++)
+		{
+			for (int b = a; b < channels; b++)
+			{
+				float sum = 0.0f;
+				for (int i = 0; i < 16; i++)
+				{
+					sum += (block.channel[a][i] - mean[a]) * (block.channel[b][i] - mean[b]);
+				}
+				covariance[a][b] = sum;
+				covariance[b][a] = sum;
+			}
+		}
+
+		// a few power iterations find the principal axis, starting
+		// from the diagonal of the bounding box
+		float axis[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (int c = 0; c < channels; c++)
+		{
+			axis[c] = high[c] - low[c];
+		}
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float length = 0.0f;
+			for (int a = 0; a < channels; a++)
+			{
+				for (int b = 0; b < channels; b++)
+				{
+					next[a] += covariance[a][b] * axis[b];
+				}
+				length = fmaxf(length, fabsf(next[a]));
+			}
+			if (length < 1e-6f)
+			{
+				break;
+			}
+			for (int c = 0; c < channels; c++)
+			{
+				axis[c] = next[c] / length;
+			}
+		}
+
+		float length2 = 0.0f;
+		for (int c = 0; c < channels; c++)
+		{
+			length2 += axis[c] * axis[c];
+		}
+		if (length2 < 1e-12f)
+		{
+			// a flat block is one color
+			for (int c = 0; c < 4; c++)
+			{
+				endpoint0[c] = (c < channels) ? mean[c] : 255.0f;
+				endpoint1[c] = endpoint0[c];
+			}
+			return;
+		}
+
+		// project the pixels onto the axis to find its ends
+		float minimumT = 1e30f;
+		float maximumT = -1e30f;
+		for (int i = 0; i < 16; i++)
+		{
+			float t = 0.0f;
+			for (int c = 0; c < channels; c++)
+			{
+				t += (block.channel[c][i] - mean[c]) * axis[c];
+			}
+			minimumT = fminf(minimumT, t);
+			maximumT = fmaxf(maximumT, t);
+		}
+		minimumT /= length2;
+		maximumT /= length2;
+
+		for (int c = 0; c < 4; c++)
+		{
+			if (c < channels)
+			{
+				endpoint0[c] = Clamp255(mean[c] + axis[c] * minimumT);
+				endpoint1[c] = Clamp255(mean[c] + axis[c] * maximumT);
+			}
+			else
+			{
+				endpoint0[c] = 255.0f;
+				endpoint1[c] = 255.0f;
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  ProjectSteps()
+	 *
+	 *  Find the nearest of the evenly spaced steps from one
+	 *  endpoint to the other for every pixel of a block.  Step
+	 *  0 is endpoint0 and step (steps - 1) is endpoint1.
+	 ***********************************************************/
+	void ProjectSteps(const BLOCK& block, int channels, const float endpoint0[4], const float endpoint1[4],
+		int steps, int result[16])
+	{
+		float direction[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float length2 = 0.0f;
+		for (int c = 0; c < channels; c++)
+		{
+			direction[c] = endpoint1[c] - endpoint0[c];
+			length2 += direction[c] * direction[c];
+		}
+		if (length2 < 1e-6f)
+		{
+			memset(result, 0, 16 * sizeof(int));
+			return;
+		}
+		float scale = (float)(steps - 1) / length2;
+
+#ifdef TEXTURE_COMPRESSOR_SSE2
+		__m128 highest = _mm_set1_ps((float)(steps - 1));
+		__m128 zero = _mm_setzero_ps();
+		for (int i = 0; i < 16; i += 4)
+		{
+			__m128 t = _mm_setzero_ps();
+			for (int c = 0; c < channels; c++)
+			{
+				__m128 offset = _mm_sub_ps(_mm_loadu_ps(&block.channel[c][i]), _mm_set1_ps(endpoint0[c]));
+				t = _mm_add_ps(t, _mm_mul_ps(offset, _mm_set1_ps(direction[c])));
+			}
+			t = _mm_mul_ps(t, _mm_set1_ps(scale));
+			t = _mm_min_ps(_mm_max_ps(t, zero), highest);
+			// round to nearest, the value is never negative
+			__m128i step = _mm_cvttps_epi32(_mm_add_ps(t, _mm_set1_ps(0.5f)));
+			_mm_storeu_si128((__m128i*)&result[i], step);
+		}
+#else
+		for (int i = 0; i < 16; i++)
+		{
+			float t = 0.0f;
+			for (int c = 0; c < channels; c++)
+			{
+				t += (block.channel[c][i] - endpoint0[c]) * direction[c];
+			}
+			t *= scale;
+			t = (t < 0.0f) ? 0.0f : ((t > (float)(steps - 1)) ? (float)(steps - 1) : t);
+			result[i] = (int)(t + 0.5f);
+		}
+#endif
+	}
+
+	/***********************************************************
+	 *  RefineEndpoints()
+	 *
+	 *  Solve for the endpoints that best fit the pixels with
+	 *  the given interpolation weights, by least squares.
+	 *  Returns false when the weights cannot pin them down.
+	 ***********************************************************/
+	bool RefineEndpoints(const BLOCK& block, int channels, const float weights[16],
+		float endpoint0[4], float endpoint1[4])
+	{
+		float a = 0.0f;
+		float b = 0.0f;
+		float c = 0.0f;
+		float x[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float y[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		for (int i = 0; i < 16; i++)
+		{
+			float w = weights[i];
+			a += (1.0f - w) * (1.0f - w);
+			b += (1.0f - w) * w;
+			c += w * w;
+			for (int k = 0; k < channels; k++)
+			{
+				x[k] += (1.0f - w) * block.channel[k][i];
+				y[k] += w * block.channel[k][i];
+			}
+		}
+
+		float determinant = a * c - b * b;
+		if (fabsf(determinant) < 1e-3f)
+		{
+			return(false);
+		}
+
+		for (int k = 0; k < channels; k++)
+		{
+			endpoint0[k] = Clamp255((c * x[k] - b * y[k]) / determinant);
+			endpoint1[k] = Clamp255((a * y[k] - b * x[k]) / determinant);
+		}
+		return(true);
+	}
+
+	/***********************************************************
+	 *  WriteLittleEndian()
+	 *
+	 *  Write the low bytes of a value, least significant first.
+	 ***********************************************************/
+	void WriteLittleEndian(unsigned char* destination, uint64_t value, int bytes)
+	{
+		for (int i = 0; i < bytes; i++)
+		{
+			destination[i] = (unsigned char)(value >> (8 * i));
+		}
+	}
+
+	/***********************************************************
+	 *  ReadLittleEndian()
+	 *
+	 *  Read a value stored least significant byte first.
+	 ***********************************************************/
+	uint64_t ReadLittleEndian(const unsigned char* source, int bytes)
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < bytes; i++)
+		{
+			value |= (uint64_t)source[i] << (8 * i);
+		}
+		return(value);
+	}
+
+	/***********************************************************
+	 *  Pack565()
+	 *
+	 *  Quantize an RGB color to 5:6:5 bits.
+	 ***********************************************************/
+	uint16_t Pack565(const float color[4])
+	{
+		int r = (int)(color[0] * 31.0f / 255.0f + 0.5f);
+		int g = (int)(color[1] * 63.0f / 255.0f + 0.5f);
+		int b = (int)(color[2] * 31.0f / 255.0f + 0.5f);
+		return((uint16_t)((r << 11) | (g << 5) | b));
+	}
+
+	/***********************************************************
+	 *  Unpack565()
+	 *
+	 *  Expand a 5:6:5 color back to 8 bits per channel.
+	 ***********************************************************/
+	void Unpack565(uint16_t packed, int color[3])
+	{
+		int r = (packed >> 11) & 31;
+		int g = (packed >> 5) & 63;
+		int b = packed & 31;
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+	}
+
+	/***********************************************************
+	 *  EncodeColorEndpoints()
+	 *
+	 *  Encode the BC1 color block for a pair of endpoints,
+	 *  always in the four color mode, and return its squared
+	 *  error.
+	 ***********************************************************/
+	float EncodeColorEndpoints(const BLOCK& block, const float endpoint0[4], const float endpoint1[4],
+		unsigned char* destination, float weights[16])
+	{
+		// step along the line from color0 to color1 -> index
+		static const int stepIndex[4] = { 0, 2, 3, 1 };
+
+		uint16_t color0 = Pack565(endpoint0);
+		uint16_t color1 = Pack565(endpoint1);
+		if (color0 < color1)
+		{
+			uint16_t swap = color0;
+			color0 = color1;
+			color1 = swap;
+		}
+
+		int palette0[3];
+		int palette1[3];
+		Unpack565(color0, palette0);
+		Unpack565(color1, palette1);
+		float quantized0[4] = { (float)palette0[0], (float)palette0[1], (float)palette0[2], 255.0f };
+		float quantized1[4] = { (float)palette1[0], (float)palette1[1], (float)palette1[2], 255.0f };
+
+		int steps[16];
+		if (color0 == color1)
+		{
+			// equal colors would select the three color mode, so
+			// only index 0 is used
+			memset(steps, 0, sizeof(steps));
+		}
+		else
+		{
+			ProjectSteps(block, 3, quantized0, quantized1, 4, steps);
+		}
+
+		uint32_t indices = 0;
+		float error = 0.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			indices |= (uint32_t)stepIndex[steps[i]] << (2 * i);
+			float w = (float)steps[i] / 3.0f;
+			weights[i] = w;
+			for (int c = 0; c < 3; c++)
+			{
+				float value = quantized0[c] + (quantized1[c] - quantized0[c]) * w;
+				float difference = value - block.channel[c][i];
+				error += difference * difference;
+			}
+		}
+
+		WriteLittleEndian(destination, color0, 2);
+		WriteLittleEndian(destination + 2, color1, 2);
+		WriteLittleEndian(destination + 4, indices, 4);
+		return(error);
+	}
+
+	/***********************************************************
+	 *  EncodeColorBlock()
+	 *
+	 *  Encode the 8 byte BC1 color block, trying the principal
+	 *  axis fit and a least squares refinement of it.
+	 ***********************************************************/
+	void EncodeColorBlock(const BLOCK& block, unsigned char* destination)
+	{
+		float endpoint0[4];
+		float endpoint1[4];
+		float weights[16];
+		unsigned char candidate[8];
+
+		FitEndpoints(block, 3, endpoint0, endpoint1);
+		float bestError = EncodeColorEndpoints(block, endpoint0, endpoint1, destination, weights);
+
+		// the weights above run from the larger 5:6:5 color, so
+		// the refinement solves for the endpoints in that order
+		float refined0[4] = { 0.0f, 0.0f, 0.0f, 255.0f };
+		float refined1[4] = { 0.0f, 0.0f, 0.0f, 255.0f };
+		if ((bestError > 0.0f) && RefineEndpoints(block, 3, weights, refined0, refined1))
+		{
+			float error = EncodeColorEndpoints(block, refined0, refined1, candidate, weights);
+			if (error < bestError)
+			{
+				memcpy(destination, candidate, sizeof(candidate));
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  EncodeAlphaBlock()
+	 *
+	 *  Encode the 8 byte BC3 alpha block using the eight value
+	 *  mode between the smallest and largest alpha.
+	 ***********************************************************/
+	void EncodeAlphaBlock(const BLOCK& block, unsigned char* destination)
+	{
+		float high = 0.0f;
+		float low = 255.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			high = fmaxf(high, block.channel[3][i]);
+			low = fminf(low, block.channel[3][i]);
+		}
+
+		int alpha0 = (int)(high + 0.5f);
+		int alpha1 = (int)(low + 0.5f);
+		uint64_t indices = 0;
+
+		if (alpha0 > alpha1)
+		{
+			float scale = 7.0f / (float)(alpha0 - alpha1);
+			for (int i = 0; i < 16; i++)
+			{
+				// step 0 is alpha0 and step 7 is alpha1, the steps
+				// between are indices 2 to 7
+				int step = (int)(((float)alpha0 - block.channel[3][i]) * scale + 0.5f);
+				step = (step < 0) ? 0 : ((step > 7) ? 7 : step);
+				int index = (step == 0) ? 0 : ((step == 7) ? 1 : step + 1);
+				indices |= (uint64_t)index << (3 * i);
+			}
+		}
+
+		destination[0] = (unsigned char)alpha0;
+		destination[1] = (unsigned char)alpha1;
+		WriteLittleEndian(destination + 2, indices, 6);
+	}
+
+	/***********************************************************
+	 *  QuantizeBC7Endpoint()
+	 *
+	 *  Quantize an RGBA endpoint to 7 bits per channel plus a
+	 *  shared low bit, picking the low bit with less error.
+	 ***********************************************************/
+	void QuantizeBC7Endpoint(const float endpoint[4], int quantized[4], int& pBit)
+	{
+		float bestError = 1e30f;
+		for (int p = 0; p < 2; p++)
+		{
+			int candidate[4];
+			float error = 0.0f;
+			for (int c = 0; c < 4; c++)
+			{
+				int value = (int)((endpoint[c] - (float)p) * 0.5f + 0.5f);
+				value = (value < 0) ? 0 : ((value > 127) ? 127 : value);
+				candidate[c] = value;
+				float difference = (float)((value << 1) | p) - endpoint[c];
+				error += difference * difference;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				pBit = p;
+				memcpy(quantized, candidate, sizeof(candidate));
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  BIT_WRITER
+	 *
+	 *  Appends bit fields to a 128-bit block, least significant
+	 *  bit first.
+	 ***********************************************************/
+	struct BIT_WRITER
+	{
+		unsigned char* destination;
+		int position;
+
+		void Write(uint32_t value, int bits)
+		{
+			for (int i = 0; i < bits; i++)
+			{
+				if (value & (1u << i))
+				{
+					destination[position >> 3] |= (unsigned char)(1 << (position & 7));
+				}
+				position++;
+			}
+		}
+	};
+
+	/***********************************************************
+	 *  BIT_READER
+	 *
+	 *  Reads bit fields from a 128-bit block, least significant
+	 *  bit first.
+	 ***********************************************************/
+	struct BIT_READER
+	{
+		const unsigned char* source;
+		int position;
+
+		uint32_t Read(int bits)
+		{
+			uint32_t value = 0;
+			for (int i = 0; i < bits; i++)
+			{
+				if (source[position >> 3] & (1 << (position & 7)))
+				{
+					value |= 1u << i;
+				}
+				position++;
+			}
+			return(value);
+		}
+	};
+
+	/***********************************************************
+	 *  EncodeBC7Endpoints()
+	 *
+	 *  Encode a BC7 mode 6 block for a pair of endpoints and
+	 *  return its squared error.
+	 ***********************************************************/
+	float EncodeBC7Endpoints(const BLOCK& block, const float endpoint0[4], const float endpoint1[4],
+		unsigned char* destination, float weights[16])
+	{
+		int quantized0[4];
+		int quantized1[4];
+		int pBit0 = 0;
+		int pBit1 = 0;
+		QuantizeBC7Endpoint(endpoint0, quantized0, pBit0);
+		QuantizeBC7Endpoint(endpoint1, quantized1, pBit1);
+
+		float color0[4];
+		float color1[4];
+		for (int c = 0; c < 4; c++)
+		{
+			color0[c] = (float)((quantized0[c] << 1) | pBit0);
+			color1[c] = (float)((quantized1[c] << 1) | pBit1);
+		}
+
+		int indices[16];
+		ProjectSteps(block, 4, color0, color1, 16, indices);
+
+		// the top bit of the first index is not stored, so flip
+		// the endpoints around when it would be set
+		if (indices[0] >= 8)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				int swap = quantized0[c];
+				quantized0[c] = quantized1[c];
+				quantized1[c] = swap;
+				float swapColor = color0[c];
+				color0[c] = color1[c];
+				color1[c] = swapColor;
+			}
+			int swap = pBit0;
+			pBit0 = pBit1;
+			pBit1 = swap;
+			for (int i = 0; i < 16; i++)
+			{
+				indices[i] = 15 - indices[i];
+			}
+		}
+
+		float error = 0.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			int w = g_BC7Weights[indices[i]];
+			weights[i] = (float)w / 64.0f;
+			for (int c = 0; c < 4; c++)
+			{
+				int value = ((64 - w) * (int)color0[c] + w * (int)color1[c] + 32) >> 6;
+				float difference = (float)value - block.channel[c][i];
+				error += difference * difference;
+			}
+		}
+
+		memset(destination, 0, 16);
+		BIT_WRITER writer;
+		writer.destination = destination;
+		writer.position = 0;
+		// mode 6 is six zero bits followed by a one
+		writer.Write(1u << 6, 7);
+		for (int c = 0; c < 4; c++)
+		{
+			writer.Write((uint32_t)quantized0[c], 7);
+			writer.Write((uint32_t)quantized1[c], 7);
+		}
+		writer.Write((uint32_t)pBit0, 1);
+		writer.Write((uint32_t)pBit1, 1);
+		writer.Write((uint32_t)indices[0], 3);
+		for (int i = 1; i < 16; i++)
+		{
+			writer.Write((uint32_t)indices[i], 4);
+		}
+		return(error);
+	}
+
+	/***********************************************************
+	 *  EncodeBC7Block()
+	 *
+	 *  Encode a 16 byte BC7 mode 6 block, trying the principal
+	 *  axis fit and a least squares refinement of it.
+	 ***********************************************************/
+	void EncodeBC7Block(const BLOCK& block, unsigned char* destination)
+	{
+		float endpoint0[4];
+		float endpoint1[4];
+		float weights[16];
+		unsigned char candidate[16];
+
+		FitEndpoints(block, 4, endpoint0, endpoint1);
+		float bestError = EncodeBC7Endpoints(block, endpoint0, endpoint1, destination, weights);
+
+		float refined0[4];
+		float refined1[4];
+		if ((bestError > 0.0f) && RefineEndpoints(block, 4, weights, refined0, refined1))
+		{
+			float error = EncodeBC7Endpoints(block, refined0, refined1, candidate, weights);
+			if (error < bestError)
+			{
+				memcpy(destination, candidate, sizeof(candidate));
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  DecodeColorBlock()
+	 *
+	 *  Decode a BC1 color block into 16 RGBA pixels.  With
+	 *  bAlwaysFourColors, as in BC3, the three color mode with
+	 *  transparent black is never used.
+	 ***********************************************************/
+	void DecodeColorBlock(const unsigned char* source, bool bAlwaysFourColors, unsigned char pixels[16][4])
+	{
+		uint16_t color0 = (uint16_t)ReadLittleEndian(source, 2);
+		uint16_t color1 = (uint16_t)ReadLittleEndian(source + 2, 2);
+		uint32_t indices = (uint32_t)ReadLittleEndian(source + 4, 4);
+
+		int palette[4][4];
+		Unpack565(color0, palette[0]);
+		Unpack565(color1, palette[1]);
+		palette[0][3] = 255;
+		palette[1][3] = 255;
+		for (int c = 0; c < 3; c++)
+		{
+			if ((color0 > color1) || bAlwaysFourColors)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+		palette[2][3] = 255;
+		palette[3][3] = ((color0 > color1) || bAlwaysFourColors) ? 255 : 0;
+
+		for (int i = 0; i < 16; i++)
+		{
+			int index = (indices >> (2 * i)) & 3;
+			for (int c = 0; c < 4; c++)
+			{
+				pixels[i][c] = (unsigned char)palette[index][c];
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  DecodeAlphaBlock()
+	 *
+	 *  Decode a BC3 alpha block into the alpha of 16 pixels.
+	 ***********************************************************/
+	void DecodeAlphaBlock(const unsigned char* source, unsigned char pixels[16][4])
+	{
+		int alpha[8];
+		alpha[0] = source[0];
+		alpha[1] = source[1];
+		for (int i = 2; i < 8; i++)
+		{
+			if (alpha[0] > alpha[1])
+			{
+				alpha[i] = ((8 - i) * alpha[0] + (i - 1) * alpha[1]) / 7;
+			}
+			else if (i < 6)
+			{
+				alpha[i] = ((6 - i) * alpha[0] + (i - 1) * alpha[1]) / 5;
+			}
+			else
+			{
+				alpha[i] = (i == 6) ? 0 : 255;
+			}
+		}
+
+		uint64_t indices = ReadLittleEndian(source + 2, 6);
+		for (int i = 0; i < 16; i++)
+		{
+			pixels[i][3] = (unsigned char)alpha[(indices >> (3 * i)) & 7];
+		}
+	}
+
+	/***********************************************************
+	 *  DecodeBC7Block()
+	 *
+	 *  Decode a BC7 block into 16 RGBA pixels.  Only mode 6 is
+	 *  written by the encoder, so any other mode decodes as
+	 *  magenta to make it stand out.
+	 ***********************************************************/
+	void DecodeBC7Block(const unsigned char* source, unsigned char pixels[16][4])
+	{
+		BIT_READER reader;
+		reader.source = source;
+		reader.position = 0;
+
+		if (reader.Read(7) != (1u << 6))
+		{
+			for (int i = 0; i < 16; i++)
+			{
+				pixels[i][0] = 255;
+				pixels[i][1] = 0;
+				pixels[i][2] = 255;
+				pixels[i][3] = 255;
+			}
+			return;
+		}
+
+		int color0[4];
+		int color1[4];
+		for (int c = 0; c < 4; c++)
+		{
+			color0[c] = (int)reader.Read(7) << 1;
+			color1[c] = (int)reader.Read(7) << 1;
+		}
+		int pBit0 = (int)reader.Read(1);
+		int pBit1 = (int)reader.Read(1);
+		for (int c = 0; c < 4; c++)
+		{
+			color0[c] |= pBit0;
+			color1[c] |= pBit1;
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			int w = g_BC7Weights[reader.Read((i == 0) ? 3 : 4)];
+			for (int c = 0; c < 4; c++)
+			{
+				pixels[i][c] = (unsigned char)(((64 - w) * color0[c] + w * color1[c] + 32) >> 6);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  ParseFormat()
+ *
+ *  This method is used for looking up a format by name.
+ *  "auto" picks a format for each image by its channels.
+ ***********************************************************/
+bool TextureCompressor::ParseFormat(const std::string& name, FORMAT& format, bool& bAuto)
+{
+	bAuto = (name == "auto");
+	if (bAuto)
+	{
+		format = FORMAT_BC7;
+		return(true);
+	}
+
+	for (int i = 0; i < FORMAT_COUNT; i++)
+	{
+		if (name == GetFormatName((FORMAT)i))
+		{
+			format = (FORMAT)i;
+			return(true);
+		}
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  GetFormatName()
+ *
+ *  This method returns the name of a format.
+ ***********************************************************/
+const char* TextureCompressor::GetFormatName(FORMAT format)
+{
+	switch (format)
+	{
+	case FORMAT_BC1:
+		return("bc1");
+	case FORMAT_BC3:
+		return("bc3");
+	case FORMAT_BC7:
+		return("bc7");
+	default:
+		return("none");
+	}
+}
+
+/***********************************************************
+ *  ChooseFormat()
+ *
+ *  This method is used for picking the format an image is
+ *  compressed to.  Images with alpha asked for as BC1 use
+ *  BC3 instead, and auto uses BC1 for RGB and BC7 for RGBA.
+ ***********************************************************/
+TextureCompressor::FORMAT TextureCompressor::ChooseFormat(FORMAT format, bool bAuto, int colorChannels)
+{
+	if (bAuto)
+	{
+		return((colorChannels == 4) ? FORMAT_BC7 : FORMAT_BC1);
+	}
+	if ((format == FORMAT_BC1) && (colorChannels == 4))
+	{
+		return(FORMAT_BC3);
+	}
+	return(format);
+}
+
+/***********************************************************
+ *  GetBlockSize()
+ *
+ *  This method returns the bytes in one 4x4 block.
+ ***********************************************************/
+int TextureCompressor::GetBlockSize(FORMAT format)
+{
+	switch (format)
+	{
+	case FORMAT_BC1:
+		return(8);
+	case FORMAT_BC3:
+	case FORMAT_BC7:
+		return(16);
+	default:
+		return(0);
+	}
+}
+
+/***********************************************************
+ *  GetImageSize()
+ *
+ *  This method returns the bytes an image takes in a format.
+ ***********************************************************/
+size_t TextureCompressor::GetImageSize(FORMAT format, int width, int height, int colorChannels)
+{
+	if (format == FORMAT_UNCOMPRESSED)
+	{
+		return((size_t)width * height * colorChannels);
+	}
+	return((size_t)((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format));
+}
+
+/***********************************************************
+ *  Compress()
+ *
+ *  This method is used for compressing an image into rows
+ *  of blocks, left to right and bottom to top in the same
+ *  order as the pixel rows.
+ ***********************************************************/
+void TextureCompressor::Compress(
+	FORMAT format,
+	const unsigned char* pixels,
+	int width,
+	int height,
+	int colorChannels,
+	unsigned char* blocks)
+{
+	int blocksWide = (width + 3) / 4;
+	int blocksHigh = (height + 3) / 4;
+	int blockSize = GetBlockSize(format);
+	BLOCK block;
+
+	for (int blockY = 0; blockY < blocksHigh; blockY++)
+	{
+		for (int blockX = 0; blockX < blocksWide; blockX++)
+		{
+			unsigned char* destination = blocks + ((size_t)blockY * blocksWide + blockX) * blockSize;
+			LoadBlock(pixels, width, height, colorChannels, blockX, blockY, block);
+
+			switch (format)
+			{
+			case FORMAT_BC1:
+				EncodeColorBlock(block, destination);
+				break;
+			case FORMAT_BC3:
+				EncodeAlphaBlock(block, destination);
+				EncodeColorBlock(block, destination + 8);
+				break;
+			case FORMAT_BC7:
+				EncodeBC7Block(block, destination);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  Decompress()
+ *
+ *  This method is used for decoding blocks back into RGBA
+ *  pixels.
+ ***********************************************************/
+void TextureCompressor::Decompress(
+	FORMAT format,
+	const unsigned char* blocks,
+	int width,
+	int height,
+	unsigned char* rgba)
+{
+	int blocksWide = (width + 3) / 4;
+	int blocksHigh = (height + 3) / 4;
+	int blockSize = GetBlockSize(format);
+	unsigned char pixels[16][4];
+
+	for (int blockY = 0; blockY < blocksHigh; blockY++)
+	{
+		for (int blockX = 0; blockX < blocksWide; blockX++)
+		{
+			const unsigned char* source = blocks + ((size_t)blockY * blocksWide + blockX) * blockSize;
+
+			switch (format)
+			{
+			case FORMAT_BC1:
+				DecodeColorBlock(source, false, pixels);
+				break;
+			case FORMAT_BC3:
+				DecodeColorBlock(source + 8, true, pixels);
+				DecodeAlphaBlock(source, pixels);
+				break;
+			case FORMAT_BC7:
+				DecodeBC7Block(source, pixels);
+				break;
+			default:
+				memset(pixels, 0, sizeof(pixels));
+				break;
+			}
+
+			for (int y = 0; y < 4; y++)
+			{
+				int pixelY = blockY * 4 + y;
+				for (int x = 0; x < 4; x++)
+				{
+					int pixelX = blockX * 4 + x;
+					if ((pixelX < width) && (pixelY < height))
+					{
+						memcpy(rgba + ((size_t)pixelY * width + pixelX) * 4, pixels[y * 4 + x], 4);
+					}
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  MeasurePSNR()
+ *
+ *  This method is used for measuring how close decoded RGBA
+ *  pixels are to the original image, as the peak signal to
+ *  noise ratio in dB.  Identical images return 100 dB.
+ ***********************************************************/
+double TextureCompressor::MeasurePSNR(
+	const unsigned char* pixels,
+	int width,
+	int height,
+	int colorChannels,
+	const unsigned char* rgba)
+{
+	double sum = 0.0;
+	size_t count = (size_t)width * height;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		for (int c = 0; c < colorChannels; c++)
+		{
+			double difference = (double)pixels[i * colorChannels + c] - (double)rgba[i * 4 + c];
+			sum += difference * difference;
+		}
+	}
+
+	double meanSquaredError = sum / ((double)count * colorChannels);
+	if (meanSquaredError <= 0.0)
+	{
+		return(100.0);
+	}
+	return(10.0 * log10((255.0 * 255.0) / meanSquaredError));
+}
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecompressor.h
+// ============
+// encode and decode BC1, BC3 and BC7 block compressed texture data
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/***********************************************************
+ *  TextureCompressor
+ *
+ *  This class compresses tightly packed RGB or RGBA pixels
+ *  into 4x4 pixel blocks that OpenGL can sample directly:
+ *
+ *    BC1 - 8 bytes per block, RGB only
+ *    BC3 - 16 bytes per block, BC1 color plus 8-bit alpha
+ *    BC7 - 16 bytes per block, RGBA, always using mode 6
+ *
+ *  Images whose size is not a multiple of 4 repeat their
+ *  last row and column to fill the edge blocks.  Encoding
+ *  is meant to run ahead of time in the texture cooker, and
+ *  uses SSE2 where it is available.  Decoding is only used
+ *  to measure the quality of the encoded data and to expand
+ *  it on drivers without the matching format.
+ ***********************************************************/
+class TextureCompressor
+{
+public:
+	// pixel formats a cache file can hold
+	enum FORMAT
+	{
+		FORMAT_UNCOMPRESSED = 0,
+		FORMAT_BC1,
+		FORMAT_BC3,
+		FORMAT_BC7,
+		FORMAT_COUNT
+	};
+
+	// get the format for a name like "bc7", "none" or "auto"
+	static bool ParseFormat(const std::string& name, FORMAT& format, bool& bAuto);
+	// get the name of a format
+	static const char* GetFormatName(FORMAT format);
+	// choose the format for an image from the requested format -
+	// BC1 cannot hold alpha, and auto picks BC1 or BC7
+	static FORMAT ChooseFormat(FORMAT format, bool bAuto, int colorChannels);
+	// bytes in one 4x4 block, or 0 for uncompressed data
+	static int GetBlockSize(FORMAT format);
+	// bytes of one image in a format
+	static size_t GetImageSize(FORMAT format, int width, int height, int colorChannels);
+
+	// compress an image into blocks, row by row of blocks
+	static void Compress(
+		FORMAT format,
+		const unsigned char* pixels,
+		int width,
+		int height,
+		int colorChannels,
+		unsigned char* blocks);
+
+	// decompress blocks into RGBA pixels
+	static void Decompress(
+		FORMAT format,
+		const unsigned char* blocks,
+		int width,
+		int height,
+		unsigned char* rgba);
+
+	// peak signal to noise ratio in dB between an image and its
+	// decompressed RGBA pixels, over the image's channels
+	static double MeasurePSNR(
+		const unsigned char* pixels,
+		int width,
+		int height,
+		int colorChannels,
+		const unsigned char* rgba);
+};
@@ -0,0 +1,563 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.cpp
+// ============
+// decode texture image files on a pool of worker threads
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+
+#include "ImageKernels.h"
+#include "stb_image.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// declaration of global variables
+namespace
+{
+	// compressed formats the driver can sample, set from the GL
+	// thread and read by the workers
+	std::atomic<unsigned int> g_SupportedFormats(1u << TextureCompressor::FORMAT_UNCOMPRESSED);
+
+	/***********************************************************
+	 *  IsFormatSupported()
+	 *
+	 *  Check whether the driver can sample a format.
+	 ***********************************************************/
+	bool IsFormatSupported(TextureCompressor::FORMAT format)
+	{
+		return((g_SupportedFormats.load() & (1u << format)) != 0);
+	}
+
+	/***********************************************************
+	 *  GetChainSize()
+	 *
+	 *  Get the bytes of a mip chain as stored, and as it would
+	 *  be stored without compression.
+	 ***********************************************************/
+	void GetChainSize(const TextureCache::CACHED_TEXTURE& texture, size_t& size, size_t& uncompressedSize)
+	{
+		size = 0;
+		uncompressedSize = 0;
+		for (size_t i = 0; i < texture.mipLevels.size(); i++)
+		{
+			size += texture.mipLevels[i].size;
+			uncompressedSize += TextureCompressor::GetImageSize(TextureCompressor::FORMAT_UNCOMPRESSED,
+				texture.mipLevels[i].width, texture.mipLevels[i].height, texture.colorChannels);
+		}
+	}
+}
+
+/***********************************************************
+ *  TextureLoader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureLoader::TextureLoader()
+{
+	m_bShutdown = false;
+
+	// keep one core free for the GL thread, which is busy
+	// uploading while the workers are decoding
+	unsigned int workerCount = std::thread::hardware_concurrency();
+	if (workerCount > 1)
+	{
+		workerCount--;
+	}
+	else
+	{
+		workerCount = 1;
+	}
+
+	for (unsigned int i = 0; i < workerCount; i++)
+	{
+		m_workers.push_back(std::thread(&TextureLoader::WorkerLoop, this));
+	}
+}
+
+/***********************************************************
+ *  ~TextureLoader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+		m_bShutdown = true;
+	}
+	m_jobSignal.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+
+	// free any streamed images that were never collected
+	for (size_t i = 0; i < m_decoded.size(); i++)
+	{
+		FreeImage(*m_decoded[i]);
+		delete m_decoded[i];
+	}
+	m_decoded.clear();
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method runs on every worker thread, pulling jobs
+ *  from the queue until the pool is shut down.
+ ***********************************************************/
+void TextureLoader::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_jobMutex);
+			m_jobSignal.wait(lock, [this] { return m_bShutdown || !m_jobs.empty(); });
+			if (m_jobs.empty())
+			{
+				// only reached when shutting down
+				return;
+			}
+			job = m_jobs.front();
+			m_jobs.pop_front();
+		}
+		job();
+	}
+}
+
+/***********************************************************
+ *  QueueJob()
+ *
+ *  This method is used for adding a job to the queue for
+ *  the next free worker thread.
+ ***********************************************************/
+void TextureLoader::QueueJob(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+		m_jobs.push_back(job);
+	}
+	m_jobSignal.notify_one();
+}
+
+/***********************************************************
+ *  GetWorkerCount()
+ *
+ *  This method returns the number of decoding threads.
+ ***********************************************************/
+int TextureLoader::GetWorkerCount() const
+{
+	return((int)m_workers.size());
+}
+
+/***********************************************************
+ *  DecodeImage()
+ *
+ *  This method is used for decoding a single image file
+ *  into a pixel buffer on the calling thread.
+ ***********************************************************/
+bool TextureLoader::DecodeImage(
+	const TEXTURE_REQUEST& request,
+	DECODED_IMAGE& image,
+	bool bForceCook)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	image.filename = request.filename;
+	image.tag = request.tag;
+	image.width = 0;
+	image.height = 0;
+	image.colorChannels = 0;
+	image.bTranslucent = false;
+	image.pixels = NULL;
+	image.bFromCache = false;
+
+	// a warm start maps the cooked mip chain and skips decoding
+	if (!bForceCook && TextureCache::Open(request.filename, image.mipChain))
+	{
+		image.bFromCache = true;
+	}
+	else
+	{
+		image.pixels = stbi_load(
+			request.filename.c_str(),
+			&image.width,
+			&image.height,
+			&image.colorChannels,
+			0);
+
+		// OpenGL expects the bottom row first
+		if (NULL != image.pixels)
+		{
+			ImageKernels::FlipVertical(image.pixels, (size_t)image.width * image.colorChannels, image.height);
+		}
+
+		// cook the mip chain while still on the worker thread so
+		// the next start can skip decoding this image - a changed
+		// image keeps the format its old cache file was cooked in
+		if (NULL != image.pixels)
+		{
+			TextureCompressor::FORMAT format = TextureCompressor::FORMAT_UNCOMPRESSED;
+			TextureCache::ReadCookedFormat(request.filename, format);
+			format = TextureCompressor::ChooseFormat(format, false, image.colorChannels);
+			if (!TextureCache::Cook(request.filename, image.pixels,
+				image.width, image.height, image.colorChannels, image.mipChain, format))
+			{
+				std::cout << "Could not write texture cache:" << TextureCache::GetCachePath(request.filename) << std::endl;
+			}
+			if (!image.mipChain.mipLevels.empty())
+			{
+				stbi_image_free(image.pixels);
+				image.pixels = NULL;
+			}
+		}
+	}
+
+	// uncompressed RGB is already cooked as RGBA, so only formats
+	// the driver cannot sample are decoded here
+	if (!image.mipChain.mipLevels.empty())
+	{
+		if (!IsFormatSupported(image.mipChain.format))
+		{
+			TextureCache::ConvertToRGBA(image.mipChain);
+		}
+		image.width = image.mipChain.width;
+		image.height = image.mipChain.height;
+		image.colorChannels = image.mipChain.colorChannels;
+		image.bTranslucent = image.mipChain.bTranslucent;
+	}
+	else if ((NULL != image.pixels) && (image.colorChannels == 4))
+	{
+		// without a mip chain the decoded pixels are looked at
+		size_t pixelCount = (size_t)image.width * image.height;
+		for (size_t i = 0; !image.bTranslucent && (i < pixelCount); i++)
+		{
+			image.bTranslucent = (image.pixels[i * 4 + 3] != 255);
+		}
+	}
+
+	image.decodeMilliseconds = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start).count();
+
+	return((image.pixels != NULL) || !image.mipChain.mipLevels.empty());
+}
+
+/***********************************************************
+ *  CookImages()
+ *
+ *  This method is used for decoding every requested image
+ *  and rewriting its cache file, whether or not the current
+ *  cache file is up to date.  The images are cooked at the
+ *  same time on the worker threads, and compressed images
+ *  report their size saving and their quality as PSNR.
+ ***********************************************************/
+int TextureLoader::CookImages(
+	const std::vector<TEXTURE_REQUEST>& requests,
+	TextureCompressor::FORMAT format,
+	bool bAuto)
+{
+	std::mutex doneMutex;
+	std::condition_variable doneSignal;
+	size_t remaining = requests.size();
+	int cooked = 0;
+	size_t totalSize = 0;
+	size_t totalUncompressedSize = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < requests.size(); i++)
+	{
+		QueueJob([&, i]()
+		{
+			int width = 0;
+			int height = 0;
+			int colorChannels = 0;
+			TextureCache::CACHED_TEXTURE texture;
+			TextureCompressor::FORMAT imageFormat = TextureCompressor::FORMAT_UNCOMPRESSED;
+			double psnr = 0.0;
+			size_t size = 0;
+			size_t uncompressedSize = 0;
+
+			unsigned char* pixels = stbi_load(requests[i].filename.c_str(), &width, &height, &colorChannels, 0);
+			bool bCooked = false;
+			if (NULL != pixels)
+			{
+				ImageKernels::FlipVertical(pixels, (size_t)width * colorChannels, height);
+				imageFormat = TextureCompressor::ChooseFormat(format, bAuto, colorChannels);
+				bCooked = TextureCache::Cook(requests[i].filename, pixels, width, height, colorChannels, texture, imageFormat);
+
+				// measure the quality of the full size level against
+				// the pixels as they were before compression
+				if (bCooked && (imageFormat != TextureCompressor::FORMAT_UNCOMPRESSED))
+				{
+					if (colorChannels == 4)
+					{
+						ImageKernels::PremultiplyAlpha(pixels, (size_t)width * height);
+					}
+					std::vector<unsigned char> rgba((size_t)width * height * 4);
+					TextureCompressor::Decompress(imageFormat, texture.mipLevels[0].pixels, width, height, &rgba[0]);
+					psnr = TextureCompressor::MeasurePSNR(pixels, width, height, colorChannels, &rgba[0]);
+				}
+				GetChainSize(texture, size, uncompressedSize);
+				stbi_image_free(pixels);
+
+				// make sure the file that was written reads back
+				bCooked = bCooked && TextureCache::Open(requests[i].filename, texture);
+			}
+			TextureCache::Close(texture);
+
+			std::lock_guard<std::mutex> lock(doneMutex);
+			if (bCooked)
+			{
+				std::ostringstream line;
+				line << "Cooked texture:" << requests[i].filename << " " << TextureCompressor::GetFormatName(imageFormat)
+					<< " " << width << "x" << height << " " << uncompressedSize / 1024 << " KB -> " << size / 1024 << " KB";
+				if (imageFormat != TextureCompressor::FORMAT_UNCOMPRESSED)
+				{
+					line << std::fixed << std::setprecision(1) << " (" << (double)uncompressedSize / (double)size
+						<< "x), PSNR " << psnr << " dB";
+				}
+				std::cout << line.str() << std::endl;
+				cooked++;
+				totalSize += size;
+				totalUncompressedSize += uncompressedSize;
+			}
+			else
+			{
+				std::cout << "Could not cook texture:" << requests[i].filename << std::endl;
+			}
+			remaining--;
+			if (remaining == 0)
+			{
+				doneSignal.notify_one();
+			}
+		});
+	}
+
+	std::unique_lock<std::mutex> lock(doneMutex);
+	doneSignal.wait(lock, [&remaining] { return remaining == 0; });
+
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "INFO: Cooked texture mip chains take " << totalSize / 1024 << " KB of "
+		<< totalUncompressedSize / 1024 << " KB uncompressed, in " << (int)milliseconds << " ms on "
+		<< GetWorkerCount() << " threads" << std::endl;
+
+	return(cooked);
+}
+
+/***********************************************************
+ *  DecodeImages()
+ *
+ *  This method is used for decoding all of the requested
+ *  image files at the same time on the worker threads.  It
+ *  returns once every image has been decoded.
+ ***********************************************************/
+void TextureLoader::DecodeImages(
+	const std::vector<TEXTURE_REQUEST>& requests,
+	std::vector<DECODED_IMAGE>& images)
+{
+	images.resize(requests.size());
+
+	std::mutex doneMutex;
+	std::condition_variable doneSignal;
+	size_t remaining = requests.size();
+
+	for (size_t i = 0; i < requests.size(); i++)
+	{
+		QueueJob([&, i]()
+		{
+			DecodeImage(requests[i], images[i]);
+
+			std::lock_guard<std::mutex> lock(doneMutex);
+			remaining--;
+			if (remaining == 0)
+			{
+				doneSignal.notify_one();
+			}
+		});
+	}
+
+	std::unique_lock<std::mutex> lock(doneMutex);
+	doneSignal.wait(lock, [&remaining] { return remaining == 0; });
+}
+
+/***********************************************************
+ *  QueueDecode()
+ *
+ *  This method is used for starting to decode an image file
+ *  on the worker threads.  It returns right away, and the
+ *  decoded image is picked up later by CollectDecoded().
+ ***********************************************************/
+void TextureLoader::QueueDecode(const TEXTURE_REQUEST& request)
+{
+	QueueJob([this, request]()
+	{
+		DECODED_IMAGE* pImage = new DECODED_IMAGE();
+		DecodeImage(request, *pImage);
+
+		std::lock_guard<std::mutex> lock(m_decodedMutex);
+		m_decoded.push_back(pImage);
+	});
+}
+
+/***********************************************************
+ *  CollectDecoded()
+ *
+ *  This method is used for taking every image that finished
+ *  decoding since the last call.  It never waits.
+ ***********************************************************/
+void TextureLoader::CollectDecoded(std::vector<DECODED_IMAGE*>& images)
+{
+	std::lock_guard<std::mutex> lock(m_decodedMutex);
+	images.insert(images.end(), m_decoded.begin(), m_decoded.end());
+	m_decoded.clear();
+}
+
+/***********************************************************
+ *  ReadImageInfo()
+ *
+ *  This method is used for reading the size, number of
+ *  color channels and format of an image, from its cache
+ *  file when that is up to date or else from the image file
+ *  header.  The decoded image will have the same layout,
+ *  so RGB images and formats the driver cannot sample are
+ *  reported as the RGBA pixels they will be expanded to.
+ *  Whether the image is translucent is only known from the
+ *  cache file, the header only tells if it has alpha.
+ ***********************************************************/
+bool TextureLoader::ReadImageInfo(
+	const std::string& filename,
+	int& width,
+	int& height,
+	int& colorChannels,
+	TextureCompressor::FORMAT& format,
+	bool& bTranslucent)
+{
+	TextureCache::CACHED_TEXTURE texture;
+	if (TextureCache::Open(filename, texture))
+	{
+		width = texture.width;
+		height = texture.height;
+		colorChannels = texture.colorChannels;
+		format = texture.format;
+		bTranslucent = texture.bTranslucent;
+		if (!IsFormatSupported(format))
+		{
+			colorChannels = 4;
+			format = TextureCompressor::FORMAT_UNCOMPRESSED;
+		}
+		TextureCache::Close(texture);
+	}
+	else
+	{
+		format = TextureCompressor::FORMAT_UNCOMPRESSED;
+		if (stbi_info(filename.c_str(), &width, &height, &colorChannels) == 0)
+		{
+			return(false);
+		}
+		bTranslucent = (colorChannels == 4);
+	}
+
+	// uncompressed RGB is cooked as RGBA
+	if ((format == TextureCompressor::FORMAT_UNCOMPRESSED) && (colorChannels == 3))
+	{
+		colorChannels = 4;
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  ReadImagePixels()
+ *
+ *  This method is used for reading the full size level of
+ *  an image as RGBA pixels laid out as they are uploaded.
+ *  An up to date cache file is read without decoding the
+ *  image file, and compressed levels are decompressed, so
+ *  the pixels can be compared whichever way they come.
+ ***********************************************************/
+bool TextureLoader::ReadImagePixels(
+	const std::string& filename,
+	int& width,
+	int& height,
+	std::vector<unsigned char>& pixels)
+{
+	TextureCache::CACHED_TEXTURE texture;
+	if (TextureCache::Open(filename, texture))
+	{
+		if (texture.format != TextureCompressor::FORMAT_UNCOMPRESSED)
+		{
+			TextureCache::ConvertToRGBA(texture);
+		}
+		bool bRGBA = (texture.colorChannels == 4);
+		if (bRGBA)
+		{
+			width = texture.width;
+			height = texture.height;
+			pixels.assign(texture.mipLevels[0].pixels, texture.mipLevels[0].pixels + texture.mipLevels[0].size);
+		}
+		TextureCache::Close(texture);
+		return(bRGBA);
+	}
+
+	int colorChannels = 0;
+	unsigned char* decoded = stbi_load(filename.c_str(), &width, &height, &colorChannels, 0);
+	if (NULL == decoded)
+	{
+		return(false);
+	}
+	if ((colorChannels != 3) && (colorChannels != 4))
+	{
+		stbi_image_free(decoded);
+		return(false);
+	}
+
+	// match the layout Cook() stores the pixels in
+	size_t pixelCount = (size_t)width * height;
+	ImageKernels::FlipVertical(decoded, (size_t)width * colorChannels, height);
+	pixels.resize(pixelCount * 4);
+	if (colorChannels == 3)
+	{
+		ImageKernels::ExpandRGBToRGBA(decoded, &pixels[0], pixelCount);
+	}
+	else
+	{
+		memcpy(&pixels[0], decoded, pixelCount * 4);
+		ImageKernels::PremultiplyAlpha(&pixels[0], pixelCount);
+	}
+	stbi_image_free(decoded);
+	return(true);
+}
+
+/***********************************************************
+ *  SetSupportedFormats()
+ *
+ *  This method is used for setting which compressed formats
+ *  can be uploaded as they are.  Uncompressed pixels are
+ *  always supported.
+ ***********************************************************/
+void TextureLoader::SetSupportedFormats(unsigned int formatMask)
+{
+	g_SupportedFormats = formatMask | (1u << TextureCompressor::FORMAT_UNCOMPRESSED);
+}
+
+/***********************************************************
+ *  FreeImage()
+ *
+ *  This method is used for freeing the pixel data of a
+ *  decoded image.
+ ***********************************************************/
+void TextureLoader::FreeImage(DECODED_IMAGE& image)
+{
+	if (NULL != image.pixels)
+	{
+		stbi_image_free(image.pixels);
+		image.pixels = NULL;
+	}
+	TextureCache::Close(image.mipChain);
+}
@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.h
+// ============
+// decode texture image files on a pool of worker threads
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TextureCache.h"
+
+/***********************************************************
+ *  TextureLoader
+ *
+ *  This class owns a pool of worker threads that decode
+ *  image files into pixel buffers.  No OpenGL calls are
+ *  made here - the decoded buffers are handed back to the
+ *  GL thread for uploading.
+ *
+ *  Images with an up to date cache file are mapped from
+ *  the cache instead of being decoded, and images that are
+ *  decoded get their cache file cooked on the worker.  The
+ *  images are flipped for OpenGL on the worker too, and
+ *  uncompressed RGB images, or cache files compressed to a
+ *  format the driver cannot sample, are expanded to RGBA.
+ ***********************************************************/
+class TextureLoader
+{
+public:
+	// constructor
+	TextureLoader();
+	// destructor
+	~TextureLoader();
+
+	// image file to decode and the tag it will be registered with
+	struct TEXTURE_REQUEST
+	{
+		std::string filename;
+		std::string tag;
+	};
+
+	// decoded pixel data for one image file
+	struct DECODED_IMAGE
+	{
+		std::string filename;
+		std::string tag;
+		int width;
+		int height;
+		int colorChannels;
+		// set when some pixel is not fully opaque - RGB images are
+		// stored with four channels, so the channels cannot tell
+		bool bTranslucent;
+		// decoded pixels, only set when no mip chain is available
+		unsigned char* pixels;
+		// full mip chain, from the cache file or cooked on load
+		TextureCache::CACHED_TEXTURE mipChain;
+		// true when the image came from the cache without decoding
+		bool bFromCache;
+		double decodeMilliseconds;
+	};
+
+	// decode all the requested images at the same time, the
+	// results are returned in the same order as the requests
+	void DecodeImages(
+		const std::vector<TEXTURE_REQUEST>& requests,
+		std::vector<DECODED_IMAGE>& images);
+
+	// decode a single image file on the calling thread - with
+	// bForceCook the cache file is ignored and always rewritten
+	static bool DecodeImage(
+		const TEXTURE_REQUEST& request,
+		DECODED_IMAGE& image,
+		bool bForceCook = false);
+
+	// start decoding an image on the worker threads without
+	// waiting for it to finish
+	void QueueDecode(const TEXTURE_REQUEST& request);
+
+	// take the images started with QueueDecode() that have
+	// finished decoding, whether or not decoding succeeded - the
+	// caller frees each one with FreeImage() and deletes it
+	void CollectDecoded(std::vector<DECODED_IMAGE*>& images);
+
+	// read the size, color channels and format an image will be
+	// decoded with, from its cache file or its file header,
+	// without decoding the pixels - without a cache file an image
+	// with an alpha channel is taken to be translucent
+	static bool ReadImageInfo(
+		const std::string& filename,
+		int& width,
+		int& height,
+		int& colorChannels,
+		TextureCompressor::FORMAT& format,
+		bool& bTranslucent);
+
+	// read the full size level of an image as premultiplied RGBA
+	// pixels, bottom row first, from its cache file or else by
+	// decoding the image file
+	static bool ReadImagePixels(
+		const std::string& filename,
+		int& width,
+		int& height,
+		std::vector<unsigned char>& pixels);
+
+	// set the compressed formats the driver can sample, as a mask
+	// of (1 << FORMAT) bits - others are decompressed on load
+	static void SetSupportedFormats(unsigned int formatMask);
+
+	// decode and cook the cache files for all the requested
+	// images, compressing them to the format or, with bAuto, to a
+	// format chosen for each image - returns the number written
+	int CookImages(
+		const std::vector<TEXTURE_REQUEST>& requests,
+		TextureCompressor::FORMAT format = TextureCompressor::FORMAT_UNCOMPRESSED,
+		bool bAuto = false);
+
+	// free the pixel data of a decoded image
+	static void FreeImage(DECODED_IMAGE& image);
+
+	// number of threads in the worker pool
+	int GetWorkerCount() const;
+
+private:
+	// worker threads in the pool
+	std::vector<std::thread> m_workers;
+	// jobs waiting for a worker thread
+	std::deque<std::function<void()>> m_jobs;
+	// guards the job queue
+	std::mutex m_jobMutex;
+	// signalled when a job is queued or the pool shuts down
+	std::condition_variable m_jobSignal;
+	// set when the pool is shutting down
+	bool m_bShutdown;
+	// images from QueueDecode() waiting to be collected
+	std::vector<DECODED_IMAGE*> m_decoded;
+	// guards the decoded images
+	std::mutex m_decodedMutex;
+
+	// main loop for each worker thread
+	void WorkerLoop();
+	// add a job to the queue for the next free worker
+	void QueueJob(std::function<void()> job);
+};
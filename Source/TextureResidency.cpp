@@ -0,0 +1,342 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureresidency.cpp
+// ============
+// keep the texture arrays inside a memory budget by dropping mip levels
+// and evicting textures that are not being drawn
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureResidency.h"
+
+#include <algorithm>
+#include <iostream>
+
+/***********************************************************
+ *  TextureResidency()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureResidency::TextureResidency(TextureArrayManager* pTextureArrays)
+{
+	m_pTextureArrays = pTextureArrays;
+	m_frame = 0;
+	m_budget = 0;
+	// about two seconds at 60 frames per second
+	m_idleFrames = 120;
+	// a quarter of the width and height is still recognisable
+	m_maxDroppedLevels = 2;
+	m_drops = 0;
+	m_evictions = 0;
+	m_restores = 0;
+	m_bOverBudget = false;
+}
+
+/***********************************************************
+ *  SetBudget()
+ *
+ *  This method is used for setting how many bytes of texture
+ *  memory the tracked arrays should fit in.
+ ***********************************************************/
+void TextureResidency::SetBudget(size_t budget)
+{
+	m_budget = budget;
+	m_bOverBudget = false;
+}
+
+/***********************************************************
+ *  Track()
+ *
+ *  This method is used for putting a texture, and the array
+ *  that holds it, under the control of the budget.  A newly
+ *  tracked texture counts as just drawn.
+ ***********************************************************/
+void TextureResidency::Track(int texture)
+{
+	if (texture < 0)
+	{
+		return;
+	}
+
+	if (texture >= (int)m_textures.size())
+	{
+		TEXTURE_USAGE usage;
+		usage.bTracked = false;
+		usage.hits = 0;
+		usage.misses = 0;
+		m_textures.resize(texture + 1, usage);
+	}
+	m_textures[texture].bTracked = true;
+
+	int arrayIndex = m_pTextureArrays->GetLocation(texture).arrayIndex;
+	if (arrayIndex >= (int)m_arrays.size())
+	{
+		ARRAY_USAGE usage;
+		usage.bTracked = false;
+		usage.lastUsedFrame = m_frame;
+		m_arrays.resize(arrayIndex + 1, usage);
+	}
+	m_arrays[arrayIndex].bTracked = true;
+	m_arrays[arrayIndex].lastUsedFrame = m_frame;
+}
+
+/***********************************************************
+ *  Touch()
+ *
+ *  This method is used for noting that a texture is drawn
+ *  in the current frame.  A draw from full resolution
+ *  storage counts as a hit, anything else as a miss.
+ ***********************************************************/
+void TextureResidency::Touch(int texture)
+{
+	if ((texture < 0) || (texture >= (int)m_textures.size()) || !m_textures[texture].bTracked)
+	{
+		return;
+	}
+
+	int arrayIndex = m_pTextureArrays->GetLocation(texture).arrayIndex;
+	m_arrays[arrayIndex].lastUsedFrame = m_frame;
+	if (m_pTextureArrays->GetDrawnBaseLevel(arrayIndex) == 0)
+	{
+		m_textures[texture].hits++;
+	}
+	else
+	{
+		m_textures[texture].misses++;
+	}
+}
+
+/***********************************************************
+ *  IsIdle()
+ *
+ *  This method returns true when an array has not been
+ *  drawn for more than the idle frame count.
+ ***********************************************************/
+bool TextureResidency::IsIdle(int arrayIndex) const
+{
+	return((m_frame - m_arrays[arrayIndex].lastUsedFrame) > m_idleFrames);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for deciding which arrays change
+ *  their base level this frame.  Arrays that are being drawn
+ *  are restored a level at a time while the budget allows,
+ *  and evicted ones always come back at their lowest level.
+ *  While over budget, idle arrays are evicted, then arrays
+ *  drop their top levels, least recently used first.
+ *  Arrays still uploading an earlier change are left alone.
+ ***********************************************************/
+void TextureResidency::Update(std::vector<RESIDENCY_CHANGE>& changes)
+{
+	size_t budget = (m_budget == 0) ? (size_t)-1 : m_budget;
+	std::vector<int> target(m_arrays.size(), 0);
+	std::vector<int> order;
+	size_t resident = 0;
+
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		if (!m_arrays[i].bTracked)
+		{
+			continue;
+		}
+		target[i] = m_pTextureArrays->GetBaseLevel((int)i);
+		resident += m_pTextureArrays->GetArrayMemorySize((int)i, target[i]);
+		if (!m_pTextureArrays->IsPending((int)i))
+		{
+			order.push_back((int)i);
+		}
+	}
+
+	// most recently drawn first
+	std::sort(order.begin(), order.end(), [this](int a, int b)
+	{
+		return(m_arrays[a].lastUsedFrame > m_arrays[b].lastUsedFrame);
+	});
+
+	// restore the arrays that are being drawn
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		int arrayIndex = order[i];
+		int levels = m_pTextureArrays->GetArrayLevelCount(arrayIndex);
+		if (IsIdle(arrayIndex) || (target[arrayIndex] == 0))
+		{
+			continue;
+		}
+
+		bool bEvicted = (target[arrayIndex] >= levels);
+		int baseLevel = bEvicted ? std::min(m_maxDroppedLevels, levels - 1) : target[arrayIndex] - 1;
+		size_t before = m_pTextureArrays->GetArrayMemorySize(arrayIndex, target[arrayIndex]);
+		size_t after = m_pTextureArrays->GetArrayMemorySize(arrayIndex, baseLevel);
+		if (bEvicted || (resident - before + after <= budget))
+		{
+			resident = resident - before + after;
+			target[arrayIndex] = baseLevel;
+		}
+	}
+
+	// evict idle arrays, least recently drawn first
+	for (size_t i = order.size(); (i > 0) && (resident > budget); i--)
+	{
+		int arrayIndex = order[i - 1];
+		int levels = m_pTextureArrays->GetArrayLevelCount(arrayIndex);
+		if (IsIdle(arrayIndex) && (target[arrayIndex] < levels))
+		{
+			resident -= m_pTextureArrays->GetArrayMemorySize(arrayIndex, target[arrayIndex]);
+			target[arrayIndex] = levels;
+		}
+	}
+
+	// then drop the top level of the least recently drawn arrays,
+	// one level from each array per pass
+	for (int pass = 0; (pass < m_maxDroppedLevels) && (resident > budget); pass++)
+	{
+		for (size_t i = order.size(); (i > 0) && (resident > budget); i--)
+		{
+			int arrayIndex = order[i - 1];
+			int levels = m_pTextureArrays->GetArrayLevelCount(arrayIndex);
+			if ((target[arrayIndex] < m_maxDroppedLevels) && (target[arrayIndex] < levels - 1))
+			{
+				resident -= m_pTextureArrays->GetArrayMemorySize(arrayIndex, target[arrayIndex]) -
+					m_pTextureArrays->GetArrayMemorySize(arrayIndex, target[arrayIndex] + 1);
+				target[arrayIndex]++;
+			}
+		}
+	}
+
+	if (resident > budget)
+	{
+		if (!m_bOverBudget)
+		{
+			std::cout << "WARNING: texture memory " << resident / 1024 << " KB cannot fit the " << budget / 1024 << " KB budget" << std::endl;
+			m_bOverBudget = true;
+		}
+	}
+	else
+	{
+		m_bOverBudget = false;
+	}
+
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		int arrayIndex = order[i];
+		int current = m_pTextureArrays->GetBaseLevel(arrayIndex);
+		if (target[arrayIndex] == current)
+		{
+			continue;
+		}
+
+		RESIDENCY_CHANGE change;
+		change.arrayIndex = arrayIndex;
+		change.baseLevel = target[arrayIndex];
+		changes.push_back(change);
+
+		if (target[arrayIndex] >= m_pTextureArrays->GetArrayLevelCount(arrayIndex))
+		{
+			m_evictions++;
+		}
+		else if (target[arrayIndex] > current)
+		{
+			m_drops++;
+		}
+		else
+		{
+			m_restores++;
+		}
+	}
+
+	m_frame++;
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for forgetting every tracked texture,
+ *  for when the texture arrays are destroyed.
+ ***********************************************************/
+void TextureResidency::Clear()
+{
+	m_textures.clear();
+	m_arrays.clear();
+	m_bOverBudget = false;
+}
+
+/***********************************************************
+ *  GetBudget()
+ *
+ *  This method returns the budget in bytes, 0 for no limit.
+ ***********************************************************/
+size_t TextureResidency::GetBudget() const
+{
+	return(m_budget);
+}
+
+/***********************************************************
+ *  GetResidentBytes()
+ *
+ *  This method returns the bytes the tracked arrays take at
+ *  their current base levels.
+ ***********************************************************/
+size_t TextureResidency::GetResidentBytes() const
+{
+	size_t resident = 0;
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		if (m_arrays[i].bTracked)
+		{
+			resident += m_pTextureArrays->GetArrayMemorySize((int)i, m_pTextureArrays->GetBaseLevel((int)i));
+		}
+	}
+	return(resident);
+}
+
+/***********************************************************
+ *  GetHitCount()
+ *
+ *  This method returns how many draws used the texture at
+ *  full resolution.
+ ***********************************************************/
+unsigned int TextureResidency::GetHitCount(int texture) const
+{
+	return(((texture >= 0) && (texture < (int)m_textures.size())) ? m_textures[texture].hits : 0);
+}
+
+/***********************************************************
+ *  GetMissCount()
+ *
+ *  This method returns how many draws found the texture
+ *  reduced or evicted.
+ ***********************************************************/
+unsigned int TextureResidency::GetMissCount(int texture) const
+{
+	return(((texture >= 0) && (texture < (int)m_textures.size())) ? m_textures[texture].misses : 0);
+}
+
+/***********************************************************
+ *  GetDropCount()
+ *
+ *  This method returns how many times arrays dropped levels.
+ ***********************************************************/
+unsigned int TextureResidency::GetDropCount() const
+{
+	return(m_drops);
+}
+
+/***********************************************************
+ *  GetEvictionCount()
+ *
+ *  This method returns how many times arrays were evicted.
+ ***********************************************************/
+unsigned int TextureResidency::GetEvictionCount() const
+{
+	return(m_evictions);
+}
+
+/***********************************************************
+ *  GetRestoreCount()
+ *
+ *  This method returns how many times arrays were restored.
+ ***********************************************************/
+unsigned int TextureResidency::GetRestoreCount() const
+{
+	return(m_restores);
+}
@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureresidency.h
+// ============
+// keep the texture arrays inside a memory budget by dropping mip levels
+// and evicting textures that are not being drawn
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "TextureArrayManager.h"
+
+/***********************************************************
+ *  TextureResidency
+ *
+ *  This class decides how much of each texture array is
+ *  kept in memory.  Every draw touches its texture, and
+ *  once per frame Update() compares the resident bytes with
+ *  the budget.  Over budget, arrays that have not been drawn
+ *  for a while are evicted first, least recently used first,
+ *  then the least recently used arrays drop their top mip
+ *  levels.  Arrays that are drawn while reduced or evicted
+ *  are restored a level at a time while the budget allows.
+ *
+ *  Arrays are the unit of texture memory, so every decision
+ *  is made for a whole array, while the bytes and the hit
+ *  and miss counts are kept for each texture.  No OpenGL
+ *  calls are made here - the changes are returned for the
+ *  caller to apply.
+ ***********************************************************/
+class TextureResidency
+{
+public:
+	// constructor
+	TextureResidency(TextureArrayManager* pTextureArrays);
+
+	// one change to the base mip level of a texture array
+	struct RESIDENCY_CHANGE
+	{
+		int arrayIndex;
+		// the level count of the array to evict it
+		int baseLevel;
+	};
+
+	// bytes the resident arrays should fit in, 0 for no limit
+	void SetBudget(size_t budget);
+	// start managing the memory of a texture
+	void Track(int texture);
+	// note that a texture is being drawn this frame
+	void Touch(int texture);
+	// decide the changes needed to stay inside the budget,
+	// then start the next frame
+	void Update(std::vector<RESIDENCY_CHANGE>& changes);
+	// stop managing every texture
+	void Clear();
+
+	// bytes the resident arrays should fit in
+	size_t GetBudget() const;
+	// bytes of the tracked arrays at their base levels
+	size_t GetResidentBytes() const;
+	// draws of a texture at full resolution
+	unsigned int GetHitCount(int texture) const;
+	// draws of a texture while reduced or evicted
+	unsigned int GetMissCount(int texture) const;
+	// total number of each kind of change made
+	unsigned int GetDropCount() const;
+	unsigned int GetEvictionCount() const;
+	unsigned int GetRestoreCount() const;
+
+private:
+	// usage of one texture
+	struct TEXTURE_USAGE
+	{
+		bool bTracked;
+		unsigned int hits;
+		unsigned int misses;
+	};
+
+	// usage of one texture array
+	struct ARRAY_USAGE
+	{
+		bool bTracked;
+		int lastUsedFrame;
+	};
+
+	TextureArrayManager* m_pTextureArrays;
+	std::vector<TEXTURE_USAGE> m_textures;
+	std::vector<ARRAY_USAGE> m_arrays;
+	int m_frame;
+	size_t m_budget;
+	// frames without a draw before an array counts as idle
+	int m_idleFrames;
+	// most top mip levels dropped from an array that is drawn
+	int m_maxDroppedLevels;
+	unsigned int m_drops;
+	unsigned int m_evictions;
+	unsigned int m_restores;
+	// set once the budget could not be met, to warn only once
+	bool m_bOverBudget;
+
+	// true when an array has not been drawn for a while
+	bool IsIdle(int arrayIndex) const;
+};
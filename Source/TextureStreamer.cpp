@@ -0,0 +1,226 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturestreamer.cpp
+// ============
+// stream decoded images into the texture arrays a few rows per frame
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureStreamer.h"
+
+/***********************************************************
+ *  TextureStreamer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureStreamer::TextureStreamer(TextureArrayManager* pTextureArrays)
+{
+	m_pTextureArrays = pTextureArrays;
+	m_pixelBuffer = 0;
+	m_uploadedBytes = 0;
+}
+
+/***********************************************************
+ *  ~TextureStreamer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureStreamer::~TextureStreamer()
+{
+	Clear();
+	if (m_pixelBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_pixelBuffer);
+		m_pixelBuffer = 0;
+	}
+	m_pTextureArrays = NULL;
+}
+
+/***********************************************************
+ *  Queue()
+ *
+ *  This method is used for adding a decoded image to the
+ *  end of the upload queue.  Images with a mip chain upload
+ *  every level from the first level down, and images without
+ *  one upload level 0 and have their mipmaps generated once
+ *  it is done.
+ ***********************************************************/
+void TextureStreamer::Queue(int handle, int texture, TextureLoader::DECODED_IMAGE* pImage, int firstLevel)
+{
+	STREAM_JOB job;
+	job.handle = handle;
+	job.texture = texture;
+	job.pImage = pImage;
+	job.level = 0;
+	job.row = 0;
+	job.levelCount = 1;
+	if (!pImage->mipChain.mipLevels.empty())
+	{
+		job.levelCount = (int)pImage->mipChain.mipLevels.size();
+		job.level = firstLevel;
+	}
+	if (job.levelCount > m_pTextureArrays->GetLevelCount(texture))
+	{
+		job.levelCount = m_pTextureArrays->GetLevelCount(texture);
+	}
+	m_jobs.push_back(job);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for uploading the next bands of rows
+ *  from the queued images.  It stops once the byte budget
+ *  is spent, but always uploads at least one row so that a
+ *  tiny budget still makes progress.
+ ***********************************************************/
+void TextureStreamer::Update(size_t byteBudget, std::vector<int>& completed)
+{
+	size_t spent = 0;
+
+	if (m_jobs.empty())
+	{
+		return;
+	}
+
+	if (m_pixelBuffer == 0)
+	{
+		glGenBuffers(1, &m_pixelBuffer);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixelBuffer);
+
+	while (!m_jobs.empty())
+	{
+		STREAM_JOB& job = m_jobs.front();
+		const TextureLoader::DECODED_IMAGE& image = *job.pImage;
+
+		if (job.level >= job.levelCount)
+		{
+			if (image.mipChain.mipLevels.empty())
+			{
+				m_pTextureArrays->FlagMipmaps(job.texture);
+				m_pTextureArrays->GenerateMipmaps();
+			}
+			completed.push_back(job.handle);
+			TextureLoader::FreeImage(*job.pImage);
+			delete job.pImage;
+			m_jobs.pop_front();
+			continue;
+		}
+
+		// rows of pixels, or of blocks for a compressed layer
+		size_t rowSize = 0;
+		int levelRows = 0;
+		m_pTextureArrays->GetLevelRows(job.texture, job.level, rowSize, levelRows);
+
+		// fit as many rows of this level as the budget allows
+		int rowCount = levelRows - job.row;
+		size_t budgetRows = (spent < byteBudget) ? (byteBudget - spent) / rowSize : 0;
+		if (budgetRows == 0)
+		{
+			if (spent > 0)
+			{
+				break;
+			}
+			budgetRows = 1;
+		}
+		if ((size_t)rowCount > budgetRows)
+		{
+			rowCount = (int)budgetRows;
+		}
+		size_t bandSize = rowSize * rowCount;
+
+		// the source pixels of this level of the image
+		int width = image.width;
+		int height = image.height;
+		const unsigned char* pixels = image.pixels;
+		if (!image.mipChain.mipLevels.empty())
+		{
+			width = image.mipChain.mipLevels[job.level].width;
+			height = image.mipChain.mipLevels[job.level].height;
+			pixels = image.mipChain.mipLevels[job.level].pixels;
+		}
+
+		// orphan the buffer's previous storage, so the driver never
+		// waits for the last band to finish uploading before this
+		// band is written
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)bandSize, NULL, GL_STREAM_DRAW);
+		unsigned char* band = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)bandSize,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (NULL != band)
+		{
+			m_pTextureArrays->PadRows(job.texture, job.level, width, height, pixels, job.row, rowCount, band);
+			if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE)
+			{
+				// the data pointer is an offset into the bound buffer
+				m_pTextureArrays->UploadRows(job.texture, job.level, job.row, rowCount, NULL);
+			}
+		}
+
+		spent += bandSize;
+		m_uploadedBytes += bandSize;
+		job.row += rowCount;
+		if (job.row >= levelRows)
+		{
+			job.row = 0;
+			job.level++;
+		}
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+/***********************************************************
+ *  Cancel()
+ *
+ *  This method is used for dropping the queued image for a
+ *  texture without uploading the rest of it.
+ ***********************************************************/
+bool TextureStreamer::Cancel(int texture)
+{
+	for (std::deque<STREAM_JOB>::iterator job = m_jobs.begin(); job != m_jobs.end(); ++job)
+	{
+		if (job->texture == texture)
+		{
+			TextureLoader::FreeImage(*job->pImage);
+			delete job->pImage;
+			m_jobs.erase(job);
+			return(true);
+		}
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for dropping every queued image
+ *  without uploading the rest of it.
+ ***********************************************************/
+void TextureStreamer::Clear()
+{
+	for (size_t i = 0; i < m_jobs.size(); i++)
+	{
+		TextureLoader::FreeImage(*m_jobs[i].pImage);
+		delete m_jobs[i].pImage;
+	}
+	m_jobs.clear();
+}
+
+/***********************************************************
+ *  IsIdle()
+ *
+ *  This method returns true when nothing is left to upload.
+ ***********************************************************/
+bool TextureStreamer::IsIdle() const
+{
+	return(m_jobs.empty());
+}
+
+/***********************************************************
+ *  GetUploadedBytes()
+ *
+ *  This method returns the total bytes uploaded so far.
+ ***********************************************************/
+size_t TextureStreamer::GetUploadedBytes() const
+{
+	return(m_uploadedBytes);
+}
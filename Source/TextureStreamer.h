@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturestreamer.h
+// ============
+// stream decoded images into the texture arrays a few rows per frame
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <deque>
+#include <vector>
+
+#include "TextureArrayManager.h"
+#include "TextureLoader.h"
+
+/***********************************************************
+ *  TextureStreamer
+ *
+ *  This class uploads decoded images into their reserved
+ *  texture array layers through a pixel buffer object,
+ *  spending no more than a byte budget each frame.  Large
+ *  images are split into bands of rows, so no single frame
+ *  has to upload a whole image.  Images are uploaded in the
+ *  order they are queued, every mip level before the next.
+ ***********************************************************/
+class TextureStreamer
+{
+public:
+	// constructor
+	TextureStreamer(TextureArrayManager* pTextureArrays);
+	// destructor
+	~TextureStreamer();
+
+	// start streaming a decoded image into a reserved texture,
+	// skipping mip levels above the first level - the streamer
+	// takes ownership of the image
+	void Queue(int handle, int texture, TextureLoader::DECODED_IMAGE* pImage, int firstLevel = 0);
+	// stop streaming into a texture and free its image,
+	// returning true if it was queued
+	bool Cancel(int texture);
+	// upload up to the byte budget, adding the handles of the
+	// textures that finished uploading to the completed list
+	void Update(size_t byteBudget, std::vector<int>& completed);
+	// stop streaming and free every queued image
+	void Clear();
+
+	// true when no images are waiting to be uploaded
+	bool IsIdle() const;
+	// total bytes uploaded since the streamer was created
+	size_t GetUploadedBytes() const;
+
+private:
+	// one image being streamed into its layer
+	struct STREAM_JOB
+	{
+		int handle;
+		int texture;
+		TextureLoader::DECODED_IMAGE* pImage;
+		// number of mip levels to upload from the image
+		int levelCount;
+		// next level and row of the layer to upload
+		int level;
+		int row;
+	};
+
+	TextureArrayManager* m_pTextureArrays;
+	std::deque<STREAM_JOB> m_jobs;
+	// pixel unpack buffer the rows are copied through
+	GLuint m_pixelBuffer;
+	size_t m_uploadedBytes;
+};
@@ -0,0 +1,259 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturewatcher.cpp
+// ============
+// notice when texture image files are changed on disk
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureWatcher.h"
+
+#include "TextureCache.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// time between two checks of the file stamps
+	const std::chrono::milliseconds g_CheckInterval(250);
+
+	/***********************************************************
+	 *  SplitPath()
+	 *
+	 *  Split a file path into its directory and file name.
+	 ***********************************************************/
+	void SplitPath(const std::string& filename, std::string& directory, std::string& name)
+	{
+		size_t slash = filename.find_last_of("/\\");
+		if (slash == std::string::npos)
+		{
+			directory = ".";
+			name = filename;
+		}
+		else
+		{
+			directory = (slash == 0) ? filename.substr(0, 1) : filename.substr(0, slash);
+			name = filename.substr(slash + 1);
+		}
+	}
+
+	/***********************************************************
+	 *  AddChanged()
+	 *
+	 *  Add a file to the changed files unless it is already
+	 *  there.
+	 ***********************************************************/
+	void AddChanged(const std::string& filename, std::vector<std::string>& changed)
+	{
+		if (std::find(changed.begin(), changed.end(), filename) == changed.end())
+		{
+			changed.push_back(filename);
+		}
+	}
+}
+
+/***********************************************************
+ *  TextureWatcher()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureWatcher::TextureWatcher()
+{
+	m_lastCheck = std::chrono::steady_clock::now();
+#ifdef __linux__
+	m_notifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+/***********************************************************
+ *  ~TextureWatcher()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureWatcher::~TextureWatcher()
+{
+	Clear();
+#ifdef __linux__
+	if (m_notifyDescriptor >= 0)
+	{
+		close(m_notifyDescriptor);
+		m_notifyDescriptor = -1;
+	}
+#endif
+}
+
+/***********************************************************
+ *  Watch()
+ *
+ *  This method is used for starting to watch an image file.
+ *  On Linux its directory is watched, once for all of the
+ *  files inside it.
+ ***********************************************************/
+void TextureWatcher::Watch(const std::string& filename)
+{
+	for (size_t i = 0; i < m_files.size(); i++)
+	{
+		if (m_files[i].filename == filename)
+		{
+			return;
+		}
+	}
+
+	WATCHED_FILE file;
+	file.filename = filename;
+	file.size = 0;
+	file.time = 0;
+	file.bSettling = false;
+	TextureCache::GetFileStamp(filename, file.size, file.time);
+	m_files.push_back(file);
+
+#ifdef __linux__
+	if (m_notifyDescriptor >= 0)
+	{
+		std::string directory;
+		std::string name;
+		SplitPath(filename, directory, name);
+
+		// watching a directory again returns the same watch
+		int watch = inotify_add_watch(m_notifyDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+		if (watch >= 0)
+		{
+			m_directories[watch] = directory;
+		}
+	}
+#endif
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for no longer watching any file.
+ ***********************************************************/
+void TextureWatcher::Clear()
+{
+#ifdef __linux__
+	for (std::unordered_map<int, std::string>::const_iterator it = m_directories.begin(); it != m_directories.end(); ++it)
+	{
+		inotify_rm_watch(m_notifyDescriptor, it->first);
+	}
+	m_directories.clear();
+#endif
+	m_files.clear();
+}
+
+/***********************************************************
+ *  Poll()
+ *
+ *  This method is used for adding the watched files that
+ *  changed since the last call to the changed files.
+ ***********************************************************/
+void TextureWatcher::Poll(std::vector<std::string>& changed)
+{
+#ifdef __linux__
+	if (m_notifyDescriptor >= 0)
+	{
+		ReadEvents(changed);
+		return;
+	}
+#endif
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now - m_lastCheck >= g_CheckInterval)
+	{
+		m_lastCheck = now;
+		CheckStamps(changed);
+	}
+}
+
+#ifdef __linux__
+/***********************************************************
+ *  ReadEvents()
+ *
+ *  This method is used for reading every inotify event that
+ *  is waiting and finding the watched files they are for.
+ *  If the event queue overflowed every file is reported,
+ *  since there is no telling which ones changed.
+ ***********************************************************/
+void TextureWatcher::ReadEvents(std::vector<std::string>& changed)
+{
+	alignas(struct inotify_event) char buffer[4096];
+
+	for (;;)
+	{
+		ssize_t length = read(m_notifyDescriptor, buffer, sizeof(buffer));
+		if (length <= 0)
+		{
+			break;
+		}
+
+		for (char* pEvent = buffer; pEvent < buffer + length; pEvent += sizeof(struct inotify_event) + ((struct inotify_event*)pEvent)->len)
+		{
+			const struct inotify_event* event = (const struct inotify_event*)pEvent;
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				for (size_t i = 0; i < m_files.size(); i++)
+				{
+					AddChanged(m_files[i].filename, changed);
+				}
+				continue;
+			}
+
+			std::unordered_map<int, std::string>::const_iterator found = m_directories.find(event->wd);
+			if ((found == m_directories.end()) || (event->len == 0))
+			{
+				continue;
+			}
+
+			for (size_t i = 0; i < m_files.size(); i++)
+			{
+				std::string directory;
+				std::string name;
+				SplitPath(m_files[i].filename, directory, name);
+				if ((directory == found->second) && (name == event->name))
+				{
+					AddChanged(m_files[i].filename, changed);
+				}
+			}
+		}
+	}
+}
+#endif
+
+/***********************************************************
+ *  CheckStamps()
+ *
+ *  This method is used for comparing the size and the
+ *  modification time of every watched file with the last
+ *  check.  A file is reported at the first check after it
+ *  stopped changing.  A file that is missing, such as while
+ *  an editor replaces it, is checked again next time.
+ ***********************************************************/
+void TextureWatcher::CheckStamps(std::vector<std::string>& changed)
+{
+	for (size_t i = 0; i < m_files.size(); i++)
+	{
+		WATCHED_FILE& file = m_files[i];
+		uint64_t size = 0;
+		int64_t time = 0;
+		if (!TextureCache::GetFileStamp(file.filename, size, time))
+		{
+			continue;
+		}
+
+		if ((size != file.size) || (time != file.time))
+		{
+			file.size = size;
+			file.time = time;
+			file.bSettling = true;
+		}
+		else if (file.bSettling)
+		{
+			file.bSettling = false;
+			AddChanged(file.filename, changed);
+		}
+	}
+}
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturewatcher.h
+// ============
+// notice when texture image files are changed on disk
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  TextureWatcher
+ *
+ *  This class watches image files so that a texture can be
+ *  loaded again as soon as its file is saved.  On Linux the
+ *  directories of the files are watched with inotify, and
+ *  a file is reported once it has been closed after being
+ *  written or moved into place.  Everywhere else the size
+ *  and modification time of every file are checked a few
+ *  times a second, and a file is reported once they have
+ *  stopped changing, so half written files are never read.
+ *
+ *  Poll() never blocks, so it can be called every frame.
+ ***********************************************************/
+class TextureWatcher
+{
+public:
+	// constructor
+	TextureWatcher();
+	// destructor
+	~TextureWatcher();
+
+	// start watching an image file
+	void Watch(const std::string& filename);
+	// stop watching every file
+	void Clear();
+	// get the watched files that changed since the last call,
+	// each one once however many times it was written
+	void Poll(std::vector<std::string>& changed);
+
+private:
+	// one watched file
+	struct WATCHED_FILE
+	{
+		std::string filename;
+		// last size and modification time seen
+		uint64_t size;
+		int64_t time;
+		// set when the stamp changed at the last check, the
+		// file is reported once it stays the same
+		bool bSettling;
+	};
+
+	std::vector<WATCHED_FILE> m_files;
+	// when the file stamps were last checked
+	std::chrono::steady_clock::time_point m_lastCheck;
+
+#ifdef __linux__
+	// inotify instance, or -1 when it could not be created
+	int m_notifyDescriptor;
+	// directory of every inotify watch
+	std::unordered_map<int, std::string> m_directories;
+
+	// read the inotify events that are waiting
+	void ReadEvents(std::vector<std::string>& changed);
+#endif
+
+	// compare the stamps of every file with the last check
+	void CheckStamps(std::vector<std::string>& changed);
+};
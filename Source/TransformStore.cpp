@@ -0,0 +1,466 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformstore.cpp
+// ============
+// cache the model matrices of scene objects until their transforms change
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformStore.h"
+
+#include "ImageKernels.h"
+
+#include <glm/gtx/transform.hpp>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define TRANSFORM_STORE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+// MSVC allows any intrinsic in any function
+#define TRANSFORM_STORE_TARGET(isa)
+#else
+// GCC and Clang need every function using an intrinsic marked
+// with its instruction set
+#define TRANSFORM_STORE_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+// declaration of global variables
+namespace
+{
+	// objects composed together by the batch kernel
+	const int g_BatchSize = 8;
+
+#ifdef TRANSFORM_STORE_X86
+	/***********************************************************
+	 *  SinCosAVX2()
+	 *
+	 *  Find the sine and cosine of 8 angles in radians at once,
+	 *  with the polynomials of the Cephes sinf and cosf.  The
+	 *  angles are brought into the first octant with a three
+	 *  part pi / 4, which stays accurate to a few units in the
+	 *  last place for angles of a few turns either way.
+	 ***********************************************************/
+	TRANSFORM_STORE_TARGET("avx2")
+	void SinCosAVX2(__m256 angle, __m256& sine, __m256& cosine)
+	{
+		const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000u));
+
+		__m256 sinSign = _mm256_and_ps(angle, signMask);
+		__m256 x = _mm256_andnot_ps(signMask, angle);
+
+		// octant of the angle, rounded up to an even one
+		__m256i octant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+		octant = _mm256_add_epi32(octant, _mm256_set1_epi32(1));
+		octant = _mm256_and_si256(octant, _mm256_set1_epi32(~1));
+		__m256 y = _mm256_cvtepi32_ps(octant);
+
+		__m256 sinSwap = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(octant, _mm256_set1_epi32(4)), 29));
+		__m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(
+			_mm256_andnot_si256(_mm256_sub_epi32(octant, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+		__m256 polyMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+			_mm256_and_si256(octant, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+		sinSign = _mm256_xor_ps(sinSign, sinSwap);
+
+		// the angle less the octant
+		x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(0.78515625f)));
+		x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(3.77489497744594108e-8f)));
+		__m256 z = _mm256_mul_ps(x, x);
+
+		__m256 cosPoly = _mm256_set1_ps(2.443315711809948e-5f);
+		cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, z), _mm256_set1_ps(-1.388731625493765e-3f));
+		cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, z), _mm256_set1_ps(4.166664568298827e-2f));
+		cosPoly = _mm256_mul_ps(_mm256_mul_ps(cosPoly, z), z);
+		cosPoly = _mm256_sub_ps(cosPoly, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+		cosPoly = _mm256_add_ps(cosPoly, _mm256_set1_ps(1.0f));
+
+		__m256 sinPoly = _mm256_set1_ps(-1.9515295891e-4f);
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, z), _mm256_set1_ps(8.3321608736e-3f));
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, z), _mm256_set1_ps(-1.6666654611e-1f));
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinPoly, z), x), x);
+
+		// octants 1, 2, 5 and 6 swap the two polynomials
+		sine = _mm256_xor_ps(_mm256_blendv_ps(cosPoly, sinPoly, polyMask), sinSign);
+		cosine = _mm256_xor_ps(_mm256_blendv_ps(sinPoly, cosPoly, polyMask), cosSign);
+	}
+
+	/***********************************************************
+	 *  Transpose8AVX2()
+	 *
+	 *  Transpose 8 rows of 8 floats in place.
+	 ***********************************************************/
+	TRANSFORM_STORE_TARGET("avx2")
+	void Transpose8AVX2(__m256* rows)
+	{
+		__m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+		__m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+		__m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+		__m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+		__m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+		__m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+		__m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+		__m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+		__m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+		rows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+		rows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+		rows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+		rows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+		rows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+		rows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+		rows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+		rows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+	}
+
+	/***********************************************************
+	 *  ComposeAVX2()
+	 *
+	 *  Compose the model matrices of 8 objects at once, each
+	 *  lane holding one object.  The components are gathered
+	 *  from the arrays, in the order scale, rotation and then
+	 *  position, each X, Y and Z.  The product of the three
+	 *  rotations is written out in full rather than multiplied
+	 *  as matrices, and the finished matrices are transposed so
+	 *  each one can be stored whole.
+	 ***********************************************************/
+	TRANSFORM_STORE_TARGET("avx2")
+	void ComposeAVX2(const float* const* components, const int* objects, glm::mat4* matrices)
+	{
+		__m256i index = _mm256_loadu_si256((const __m256i*)objects);
+		__m256 values[9];
+		for (int i = 0; i < 9; i++)
+		{
+			values[i] = _mm256_i32gather_ps(components[i], index, 4);
+		}
+
+		// the angles are brought within half a turn first, then
+		// turned into radians the way glm::radians() does
+		__m256 sine[3];
+		__m256 cosine[3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			__m256 degrees = values[3 + axis];
+			__m256 turns = _mm256_round_ps(_mm256_mul_ps(degrees, _mm256_set1_ps(1.0f / 360.0f)),
+				_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+			degrees = _mm256_sub_ps(degrees, _mm256_mul_ps(turns, _mm256_set1_ps(360.0f)));
+			SinCosAVX2(_mm256_mul_ps(degrees, _mm256_set1_ps(0.01745329251994329576923690768489f)), sine[axis], cosine[axis]);
+		}
+		__m256 sx = sine[0];
+		__m256 cx = cosine[0];
+		__m256 sy = sine[1];
+		__m256 cy = cosine[1];
+		__m256 sz = sine[2];
+		__m256 cz = cosine[2];
+		__m256 sxsy = _mm256_mul_ps(sx, sy);
+		__m256 cxsy = _mm256_mul_ps(cx, sy);
+
+		// rotationX * rotationY * rotationZ, one column at a time,
+		// with each column multiplied by its scale
+		__m256 rows[16];
+		rows[0] = _mm256_mul_ps(_mm256_mul_ps(cy, cz), values[0]);
+		rows[1] = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(cx, sz), _mm256_mul_ps(sxsy, cz)), values[0]);
+		rows[2] = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(sx, sz), _mm256_mul_ps(cxsy, cz)), values[0]);
+		rows[3] = _mm256_setzero_ps();
+		rows[4] = _mm256_mul_ps(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(cy, sz)), values[1]);
+		rows[5] = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(cx, cz), _mm256_mul_ps(sxsy, sz)), values[1]);
+		rows[6] = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(sx, cz), _mm256_mul_ps(cxsy, sz)), values[1]);
+		rows[7] = _mm256_setzero_ps();
+		rows[8] = _mm256_mul_ps(sy, values[2]);
+		rows[9] = _mm256_mul_ps(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(sx, cy)), values[2]);
+		rows[10] = _mm256_mul_ps(_mm256_mul_ps(cx, cy), values[2]);
+		rows[11] = _mm256_setzero_ps();
+		rows[12] = values[6];
+		rows[13] = values[7];
+		rows[14] = values[8];
+		rows[15] = _mm256_set1_ps(1.0f);
+
+		// rows 0 to 7 become the first two columns of each
+		// matrix and rows 8 to 15 the last two
+		Transpose8AVX2(rows);
+		Transpose8AVX2(rows + 8);
+		for (int lane = 0; lane < g_BatchSize; lane++)
+		{
+			float* matrix = &matrices[objects[lane]][0][0];
+			_mm256_storeu_ps(matrix, rows[lane]);
+			_mm256_storeu_ps(matrix + 8, rows[8 + lane]);
+		}
+	}
+#endif
+}
+
+/***********************************************************
+ *  TransformStore()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TransformStore::TransformStore()
+{
+	m_composed = 0;
+	m_lastComposed = 0;
+	m_totalComposed = 0;
+	m_totalReused = 0;
+}
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for adding an object with an identity
+ *  transform.  Its matrix is already composed.
+ ***********************************************************/
+int TransformStore::Add()
+{
+	m_scaleX.push_back(1.0f);
+	m_scaleY.push_back(1.0f);
+	m_scaleZ.push_back(1.0f);
+	m_rotationX.push_back(0.0f);
+	m_rotationY.push_back(0.0f);
+	m_rotationZ.push_back(0.0f);
+	m_positionX.push_back(0.0f);
+	m_positionY.push_back(0.0f);
+	m_positionZ.push_back(0.0f);
+	m_matrices.push_back(glm::mat4(1.0f));
+	m_dirty.push_back(0);
+
+	return((int)m_matrices.size() - 1);
+}
+
+/***********************************************************
+ *  SetTransform()
+ *
+ *  This method is used for setting the scale, rotation and
+ *  position of an object.  The object is only marked dirty
+ *  when one of the values changed, and true is returned.
+ ***********************************************************/
+bool TransformStore::SetTransform(
+	int object,
+	const glm::vec3& scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	const glm::vec3& positionXYZ)
+{
+	if ((m_scaleX[object] == scaleXYZ.x) &&
+		(m_scaleY[object] == scaleXYZ.y) &&
+		(m_scaleZ[object] == scaleXYZ.z) &&
+		(m_rotationX[object] == XrotationDegrees) &&
+		(m_rotationY[object] == YrotationDegrees) &&
+		(m_rotationZ[object] == ZrotationDegrees) &&
+		(m_positionX[object] == positionXYZ.x) &&
+		(m_positionY[object] == positionXYZ.y) &&
+		(m_positionZ[object] == positionXYZ.z))
+	{
+		return(false);
+	}
+
+	m_scaleX[object] = scaleXYZ.x;
+	m_scaleY[object] = scaleXYZ.y;
+	m_scaleZ[object] = scaleXYZ.z;
+	m_rotationX[object] = XrotationDegrees;
+	m_rotationY[object] = YrotationDegrees;
+	m_rotationZ[object] = ZrotationDegrees;
+	m_positionX[object] = positionXYZ.x;
+	m_positionY[object] = positionXYZ.y;
+	m_positionZ[object] = positionXYZ.z;
+	m_dirty[object] = 1;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetMatrix()
+ *
+ *  This method returns the model matrix of an object,
+ *  composing it first when the object is dirty.
+ ***********************************************************/
+const glm::mat4& TransformStore::GetMatrix(int object)
+{
+	if (m_dirty[object])
+	{
+		ComposeMatrix(object);
+	}
+	else
+	{
+		m_totalReused++;
+	}
+	return(m_matrices[object]);
+}
+
+/***********************************************************
+ *  UpdateMatrices()
+ *
+ *  This method is used for composing the matrix of every
+ *  dirty object ahead of drawing.  With AVX2 the dirty
+ *  objects are composed 8 at a time, the last batch filled
+ *  out by composing its last object again.  Which version
+ *  runs follows the instruction set of the image kernels.
+ ***********************************************************/
+void TransformStore::UpdateMatrices()
+{
+	m_dirtyObjects.clear();
+	for (size_t object = 0; object < m_dirty.size(); object++)
+	{
+		if (m_dirty[object])
+		{
+			m_dirtyObjects.push_back((int)object);
+		}
+	}
+	if (m_dirtyObjects.empty())
+	{
+		return;
+	}
+
+#ifdef TRANSFORM_STORE_X86
+	if (ImageKernels::GetISA() == ImageKernels::ISA_AVX2)
+	{
+		const float* components[9] = {
+			&m_scaleX[0], &m_scaleY[0], &m_scaleZ[0],
+			&m_rotationX[0], &m_rotationY[0], &m_rotationZ[0],
+			&m_positionX[0], &m_positionY[0], &m_positionZ[0] };
+		size_t count = m_dirtyObjects.size();
+		while (m_dirtyObjects.size() % g_BatchSize != 0)
+		{
+			m_dirtyObjects.push_back(m_dirtyObjects[count - 1]);
+		}
+		for (size_t i = 0; i < m_dirtyObjects.size(); i += g_BatchSize)
+		{
+			ComposeAVX2(components, &m_dirtyObjects[i], &m_matrices[0]);
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			m_dirty[m_dirtyObjects[i]] = 0;
+		}
+		m_composed += (unsigned int)count;
+		m_totalComposed += count;
+		return;
+	}
+#endif
+
+	for (size_t i = 0; i < m_dirtyObjects.size(); i++)
+	{
+		ComposeMatrix(m_dirtyObjects[i]);
+	}
+}
+
+/***********************************************************
+ *  ComposeMatrix()
+ *
+ *  This method is used for composing the matrix of one
+ *  object and marking it clean.
+ ***********************************************************/
+void TransformStore::ComposeMatrix(int object)
+{
+	m_matrices[object] = Compose(
+		glm::vec3(m_scaleX[object], m_scaleY[object], m_scaleZ[object]),
+		m_rotationX[object],
+		m_rotationY[object],
+		m_rotationZ[object],
+		glm::vec3(m_positionX[object], m_positionY[object], m_positionZ[object]));
+	m_dirty[object] = 0;
+	m_composed++;
+	m_totalComposed++;
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every object.
+ ***********************************************************/
+void TransformStore::Clear()
+{
+	m_scaleX.clear();
+	m_scaleY.clear();
+	m_scaleZ.clear();
+	m_rotationX.clear();
+	m_rotationY.clear();
+	m_rotationZ.clear();
+	m_positionX.clear();
+	m_positionY.clear();
+	m_positionZ.clear();
+	m_matrices.clear();
+	m_dirty.clear();
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method returns the number of objects.
+ ***********************************************************/
+int TransformStore::GetCount() const
+{
+	return((int)m_matrices.size());
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for keeping the count of the frame
+ *  that just ended and starting a new one.
+ ***********************************************************/
+void TransformStore::BeginFrame()
+{
+	m_lastComposed = m_composed;
+	m_composed = 0;
+}
+
+/***********************************************************
+ *  GetComposedCount()
+ *
+ *  This method returns the matrices composed during the
+ *  last frame.
+ ***********************************************************/
+unsigned int TransformStore::GetComposedCount() const
+{
+	return(m_lastComposed);
+}
+
+/***********************************************************
+ *  GetTotalComposedCount()
+ *
+ *  This method returns the matrices composed since the
+ *  store was created.
+ ***********************************************************/
+unsigned long long TransformStore::GetTotalComposedCount() const
+{
+	return(m_totalComposed);
+}
+
+/***********************************************************
+ *  GetTotalReusedCount()
+ *
+ *  This method returns how many times a cached matrix was
+ *  returned instead of being composed again.
+ ***********************************************************/
+unsigned long long TransformStore::GetTotalReusedCount() const
+{
+	return(m_totalReused);
+}
+
+/***********************************************************
+ *  Compose()
+ *
+ *  This method is used for building a model matrix from a
+ *  scale, rotations in degrees about X, Y and Z, and a
+ *  position.
+ ***********************************************************/
+glm::mat4 TransformStore::Compose(
+	const glm::vec3& scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	const glm::vec3& positionXYZ)
+{
+	glm::mat4 scale = glm::scale(scaleXYZ);
+	glm::mat4 rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
+	glm::mat4 rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
+	glm::mat4 translation = glm::translate(positionXYZ);
+
+	return(translation * rotationX * rotationY * rotationZ * scale);
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformstore.h
+// ============
+// cache the model matrices of scene objects until their transforms change
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  TransformStore
+ *
+ *  This class holds the scale, rotation and position of
+ *  every object in the scene along with its model matrix.
+ *  Setting a transform only marks the object dirty when a
+ *  value actually changed, and the matrix of a dirty object
+ *  is composed the next time it is asked for.  Objects that
+ *  never move have their matrix composed once and reused in
+ *  every frame after that.
+ *
+ *  The transform values are kept as a structure of arrays,
+ *  one array per component, so UpdateMatrices() can compose
+ *  8 dirty objects at once with AVX2.  For angles within a
+ *  few turns its matrices match the ones composed with glm
+ *  to within a few units in the last place.
+ ***********************************************************/
+class TransformStore
+{
+public:
+	// constructor
+	TransformStore();
+
+	// add an object with no scale, rotation or translation,
+	// returning its index
+	int Add();
+	// set the transform of an object, marking it dirty when
+	// any value is different from before, returns true if so
+	bool SetTransform(
+		int object,
+		const glm::vec3& scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		const glm::vec3& positionXYZ);
+	// get the model matrix of an object, composing it first if
+	// its transform changed
+	const glm::mat4& GetMatrix(int object);
+	// compose the matrices of every dirty object, 8 at a time
+	// when the CPU has AVX2
+	void UpdateMatrices();
+	// remove every object
+	void Clear();
+	// number of objects
+	int GetCount() const;
+
+	// start counting the matrices composed in a new frame
+	void BeginFrame();
+	// matrices composed during the last frame
+	unsigned int GetComposedCount() const;
+	// matrices composed and matrices reused since the start
+	unsigned long long GetTotalComposedCount() const;
+	unsigned long long GetTotalReusedCount() const;
+
+	// compose a model matrix the way SetTransformations() always
+	// has, translation * rotationX * rotationY * rotationZ * scale
+	static glm::mat4 Compose(
+		const glm::vec3& scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		const glm::vec3& positionXYZ);
+
+private:
+	// transform components of every object
+	std::vector<float> m_scaleX;
+	std::vector<float> m_scaleY;
+	std::vector<float> m_scaleZ;
+	std::vector<float> m_rotationX;
+	std::vector<float> m_rotationY;
+	std::vector<float> m_rotationZ;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	// model matrix of every object, valid unless it is dirty
+	std::vector<glm::mat4> m_matrices;
+	std::vector<unsigned char> m_dirty;
+	// dirty objects found by UpdateMatrices(), kept to reuse
+	std::vector<int> m_dirtyObjects;
+
+	unsigned int m_composed;
+	unsigned int m_lastComposed;
+	unsigned long long m_totalComposed;
+	unsigned long long m_totalReused;
+
+	// compose the matrix of one object
+	void ComposeMatrix(int object);
+};
@@ -1,318 +1,349 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "ViewManager.h"
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>    
-
-// declarations for global variables and defines
-namespace
-{
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1000;
-	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
-	// camera object used for viewing and interacting with
-	// the 3D scene
-	Camera* g_pCamera = nullptr;
-
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
-
-	// the following variable is false when orthographic projection
-	// is off and true when it is on
-	bool bOrthographicProjection = false;
-
-	// global to adjust the speed of keyboard movement keys to move around a bit faster
-	float gSpeedIncrease = 2.0f; //set to twice as fast as default 
-}
-
-/***********************************************************
- *  ViewManager()
- *
- *  The constructor for the class
- ***********************************************************/
-ViewManager::ViewManager(
-	ShaderManager *pShaderManager)
-{
-	// initialize the member variables
-	m_pShaderManager = pShaderManager;
-	m_pWindow = NULL;
-	g_pCamera = new Camera();
-	// default camera view parameters
-	g_pCamera->Position = glm::vec3(0.0f, 15.0f, 20.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -03.0f, -3.0f); // change tilt to align shape perspective to 2D picture
-	g_pCamera->Up = glm::vec3(0.0f, 5.0f, 0.0f);
-	g_pCamera->Zoom = 80; //change to zoom in a bit more
-	//original
-	//g_pCamera->Position = glm::vec3(0.0f, 9.0f, 18.0f);
-	//g_pCamera->Front = glm::vec3(0.0f, -0.8f, -3.0f);
-	//g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	//g_pCamera->Zoom = 80;
-}
-
-/***********************************************************
- *  ~ViewManager()
- *
- *  The destructor for the class
- ***********************************************************/
-ViewManager::~ViewManager()
-{
-	// free up allocated memory
-	m_pShaderManager = NULL;
-	m_pWindow = NULL;
-	if (NULL != g_pCamera)
-	{
-		delete g_pCamera;
-		g_pCamera = NULL;
-	}
-}
-
-/***********************************************************
- *  CreateDisplayWindow()
- *
- *  This method is used to create the main display window.
- ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
-{
-	GLFWwindow* window = nullptr;
-
-	// try to create the displayed OpenGL window
-	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
-		windowTitle,
-		NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return NULL;
-	}
-	glfwMakeContextCurrent(window);
-
-	// this callback is used to receive mouse moving events
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-
-	// Set scroll callback
-	glfwSetScrollCallback(window, &ViewManager::Scroll_Callback);
-
-	// tell GLFW to capture all mouse events
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-	// enable blending for supporting tranparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	m_pWindow = window;
-
-	return(window);
-}
-
-
-
-/***********************************************************
- *  Mouse Scroll_Callback()
- *
- *  This method is to adjust the speed of the movement
- ***********************************************************/
-void ViewManager::Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
-{
-	gSpeedIncrease += (yoffset * 2.0f); //change default speed at 0.1 increments
-	// we do not need xoffset for mouse wheel
-
-	// ensure that the speed change does not invert the directions
-	if (gSpeedIncrease < 0)
-	{
-		gSpeedIncrease = 0.5;
-	}
-	else
-		gSpeedIncrease;
-}
-
-
-/***********************************************************
- *  Mouse_Position_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse is moved within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
-{
-	// adjust mouse sensitiviy to allow for a greater viewing range
-	const float sensitivity = 1.0f;
-
-	// add in functionality to allow the scroll wheel to adjust sensitivity further
-	float updatedSensitivity = sensitivity * gSpeedIncrease;
-
-
-	// when the first mouse move event is received, this needs to be recorded so that
-	// all subsequent mouse moves can correctly calculate the X position offset and Y
-	// position offset for proper operation
-	if (gFirstMouse)
-	{
-		gLastX = xMousePos;
-		gLastY = yMousePos;
-		gFirstMouse = false;
-	}
-
-	// calculate the X offset and Y offset values for moving the 3D camera accordingly
-	float xOffset = (xMousePos - gLastX) * updatedSensitivity;
-	float yOffset = (gLastY - yMousePos) * updatedSensitivity; // reversed since y-coordinates go from bottom to top
-
-	// set the current positions into the last position variables
-	gLastX = xMousePos;
-	gLastY = yMousePos;
-
-	// move the 3D camera according to the calculated offsets
-	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
-}
-
-/***********************************************************
- *  ProcessKeyboardEvents()
- *
- *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
-{
-	// close the window if the escape key has been pressed
-	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(m_pWindow, true);
-	}
-
-	// if the camera object is null, then exit this method
-	if (NULL == g_pCamera)
-	{
-		return;
-	}
-
-	// process camera zooming in and out
-	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime * gSpeedIncrease); //added speed increase
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime * gSpeedIncrease); //added speed increase
-	}
-
-	// process camera panning left and right
-	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime * gSpeedIncrease); //added speed increase
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime * gSpeedIncrease); //added speed increase
-	}
-
-
-	//todo - need to add functionality for Q and E to move
-	//     the camera up and down respectively
-	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(UP, gDeltaTime * gSpeedIncrease); //added speed increase
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_SPACE) == GLFW_PRESS)//add alternate Up key, spacebar
-	{
-		g_pCamera->ProcessKeyboard(UP, gDeltaTime * gSpeedIncrease); //added speed increase
-	}
-
-
-	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime * gSpeedIncrease); //added speed increase
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS) //add alt down key
-	{
-		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime * gSpeedIncrease); //added speed increase
-	}
-
-
-
-	//todo Add functionality to allow for swapping between orthogonal (O) and perspective (P) views
-	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
-	{
-		bOrthographicProjection = true;
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-	{
-		bOrthographicProjection = false;
-	}
-
-}
-
-
-	
-
-
-/***********************************************************
- *  PrepareSceneView()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void ViewManager::PrepareSceneView()
-{
-	glm::mat4 view;
-	glm::mat4 projection;
-
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-	// use the O and P keys input to swap between views
-	if (bOrthographicProjection)
-	{
-		float orthoSize = 10.0f; // Adjust the size as needed
-		projection = glm::ortho(-orthoSize, orthoSize, -orthoSize, orthoSize, 0.1f, 100.0f);
-	}
-	else
-	{
-		projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-	}
-	
-
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
-	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
-	}
-
-	
-
-
-}
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewManager.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>    
+
+// declarations for global variables and defines
+namespace
+{
+	// Variables for window width and height
+	const int WINDOW_WIDTH = 1000;
+	const int WINDOW_HEIGHT = 800;
+
+	// camera object used for viewing and interacting with
+	// the 3D scene
+	Camera* g_pCamera = nullptr;
+
+	// these variables are used for mouse movement processing
+	float gLastX = WINDOW_WIDTH / 2.0f;
+	float gLastY = WINDOW_HEIGHT / 2.0f;
+	bool gFirstMouse = true;
+
+	// time between current frame and last frame
+	float gDeltaTime = 0.0f; 
+	float gLastFrame = 0.0f;
+
+	// the following variable is false when orthographic projection
+	// is off and true when it is on
+	bool bOrthographicProjection = false;
+
+	// global to adjust the speed of keyboard movement keys to move around a bit faster
+	float gSpeedIncrease = 2.0f; //set to twice as fast as default 
+}
+
+/***********************************************************
+ *  ViewManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewManager::ViewManager(
+	ShaderManager *pShaderManager)
+{
+	// initialize the member variables
+	m_pShaderManager = pShaderManager;
+	m_pShaderState = new ShaderStateCache();
+	m_pWindow = NULL;
+	m_viewProjection = glm::mat4(1.0f);
+	g_pCamera = new Camera();
+	// default camera view parameters
+	g_pCamera->Position = glm::vec3(0.0f, 15.0f, 20.0f);
+	g_pCamera->Front = glm::vec3(0.0f, -03.0f, -3.0f); // change tilt to align shape perspective to 2D picture
+	g_pCamera->Up = glm::vec3(0.0f, 5.0f, 0.0f);
+	g_pCamera->Zoom = 80; //change to zoom in a bit more
+	//original
+	//g_pCamera->Position = glm::vec3(0.0f, 9.0f, 18.0f);
+	//g_pCamera->Front = glm::vec3(0.0f, -0.8f, -3.0f);
+	//g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	//g_pCamera->Zoom = 80;
+}
+
+/***********************************************************
+ *  ~ViewManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ViewManager::~ViewManager()
+{
+	// free up allocated memory
+	m_pShaderManager = NULL;
+	delete m_pShaderState;
+	m_pShaderState = NULL;
+	m_pWindow = NULL;
+	if (NULL != g_pCamera)
+	{
+		delete g_pCamera;
+		g_pCamera = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateDisplayWindow()
+ *
+ *  This method is used to create the main display window.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	// try to create the displayed OpenGL window
+	window = glfwCreateWindow(
+		WINDOW_WIDTH,
+		WINDOW_HEIGHT,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// this callback is used to receive mouse moving events
+	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+
+	// Set scroll callback
+	glfwSetScrollCallback(window, &ViewManager::Scroll_Callback);
+
+	// tell GLFW to capture all mouse events
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+	// enable blending for supporting tranparent rendering - the
+	// shader outputs colors premultiplied by alpha, which is how
+	// the textures are stored
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+
+
+/***********************************************************
+ *  Mouse Scroll_Callback()
+ *
+ *  This method is to adjust the speed of the movement
+ ***********************************************************/
+void ViewManager::Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+	gSpeedIncrease += (yoffset * 2.0f); //change default speed at 0.1 increments
+	// we do not need xoffset for mouse wheel
+
+	// ensure that the speed change does not invert the directions
+	if (gSpeedIncrease < 0)
+	{
+		gSpeedIncrease = 0.5;
+	}
+	else
+		gSpeedIncrease;
+}
+
+
+/***********************************************************
+ *  Mouse_Position_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse is moved within the active GLFW display window.
+ ***********************************************************/
+void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
+{
+	// adjust mouse sensitiviy to allow for a greater viewing range
+	const float sensitivity = 1.0f;
+
+	// add in functionality to allow the scroll wheel to adjust sensitivity further
+	float updatedSensitivity = sensitivity * gSpeedIncrease;
+
+
+	// when the first mouse move event is received, this needs to be recorded so that
+	// all subsequent mouse moves can correctly calculate the X position offset and Y
+	// position offset for proper operation
+	if (gFirstMouse)
+	{
+		gLastX = xMousePos;
+		gLastY = yMousePos;
+		gFirstMouse = false;
+	}
+
+	// calculate the X offset and Y offset values for moving the 3D camera accordingly
+	float xOffset = (xMousePos - gLastX) * updatedSensitivity;
+	float yOffset = (gLastY - yMousePos) * updatedSensitivity; // reversed since y-coordinates go from bottom to top
+
+	// set the current positions into the last position variables
+	gLastX = xMousePos;
+	gLastY = yMousePos;
+
+	// move the 3D camera according to the calculated offsets
+	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
+}
+
+/***********************************************************
+ *  ProcessKeyboardEvents()
+ *
+ *  This method is called to process any keyboard events
+ *  that may be waiting in the event queue.
+ ***********************************************************/
+void ViewManager::ProcessKeyboardEvents()
+{
+	// close the window if the escape key has been pressed
+	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	{
+		glfwSetWindowShouldClose(m_pWindow, true);
+	}
+
+	// if the camera object is null, then exit this method
+	if (NULL == g_pCamera)
+	{
+		return;
+	}
+
+	// process camera zooming in and out
+	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime * gSpeedIncrease); //added speed increase
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime * gSpeedIncrease); //added speed increase
+	}
+
+	// process camera panning left and right
+	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime * gSpeedIncrease); //added speed increase
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime * gSpeedIncrease); //added speed increase
+	}
+
+
+	//todo - need to add functionality for Q and E to move
+	//     the camera up and down respectively
+	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(UP, gDeltaTime * gSpeedIncrease); //added speed increase
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_SPACE) == GLFW_PRESS)//add alternate Up key, spacebar
+	{
+		g_pCamera->ProcessKeyboard(UP, gDeltaTime * gSpeedIncrease); //added speed increase
+	}
+
+
+	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime * gSpeedIncrease); //added speed increase
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS) //add alt down key
+	{
+		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime * gSpeedIncrease); //added speed increase
+	}
+
+
+
+	//todo Add functionality to allow for swapping between orthogonal (O) and perspective (P) views
+	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
+	{
+		bOrthographicProjection = true;
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
+	{
+		bOrthographicProjection = false;
+	}
+
+}
+
+
+	
+
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void ViewManager::PrepareSceneView()
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+
+	// per-frame timing
+	float currentFrame = glfwGetTime();
+	gDeltaTime = currentFrame - gLastFrame;
+	gLastFrame = currentFrame;
+
+	// process any keyboard events that may be waiting in the 
+	// event queue
+	ProcessKeyboardEvents();
+
+	// get the current view matrix from the camera
+	view = g_pCamera->GetViewMatrix();
+
+	// use the O and P keys input to swap between views
+	if (bOrthographicProjection)
+	{
+		float orthoSize = 10.0f; // Adjust the size as needed
+		projection = glm::ortho(-orthoSize, orthoSize, -orthoSize, orthoSize, 0.1f, 100.0f);
+	}
+	else
+	{
+		projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
+	}
+	m_viewProjection = projection * view;
+
+	// if the shader manager object is valid
+	if (NULL != m_pShaderManager)
+	{
+		// the shaders are only loaded after this object is created,
+		// so the uniform locations are looked up on the first frame
+		if (!m_pShaderState->IsResolved())
+		{
+			m_pShaderState->Resolve();
+		}
+		// set the view matrix into the shader for proper rendering
+		m_pShaderState->SetMat4(ShaderStateCache::UNIFORM_VIEW, view);
+		// set the view matrix into the shader for proper rendering
+		m_pShaderState->SetMat4(ShaderStateCache::UNIFORM_PROJECTION, projection);
+		// set the view position of the camera into the shader for proper rendering
+		m_pShaderState->SetVec3(ShaderStateCache::UNIFORM_VIEW_POSITION, g_pCamera->Position);
+	}
+
+	
+
+
+}
+
+/***********************************************************
+ *  GetViewPosition()
+ *
+ *  This method returns the position of the camera.
+ ***********************************************************/
+glm::vec3 ViewManager::GetViewPosition() const
+{
+	return(g_pCamera->Position);
+}
+
+/***********************************************************
+ *  GetViewProjection()
+ *
+ *  This method returns the projection times view matrix of
+ *  the current frame.
+ ***********************************************************/
+glm::mat4 ViewManager::GetViewProjection() const
+{
+	return(m_viewProjection);
+}
@@ -1,34 +1,134 @@
 #version 330 core
 
-out vec4 FragColor;
+out vec4 outFragmentColor;
 
-in vec3 FragPos;
-in vec3 Normal;
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+in vec2 fragmentTextureCoordinate;
+// the values of the instance being drawn
+flat in vec4 fragmentColor;
+flat in vec4 fragmentTextureRect;
+flat in vec3 fragmentSurface;
+flat in ivec3 fragmentFlags;
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
-uniform vec3 objectColor;
+// laid out to match MaterialBuffer::MATERIAL under std140
+struct Material
+{
+    vec3 ambientColor;
+    float ambientStrength;
+    vec3 diffuseColor;
+    float shininess;
+    vec3 specularColor;
+};
 
-void main()
+struct LightSource
+{
+    vec3 position;
+    vec3 ambientColor;
+    vec3 diffuseColor;
+    vec3 specularColor;
+    float focalStrength;
+    float specularIntensity;
+};
+
+#define TOTAL_LIGHTS 4
+// one sampler per texture array, matching the unit the array is bound to
+#define TEXTURE_ARRAY_COUNT 16
+// 48 bytes each, so the block fits the 64 KB desktop drivers allow
+#define MAX_MATERIALS 1024
+
+uniform bool bUseLighting;
+uniform vec3 viewPosition;
+
+// every material is uploaded once and an instance picks one by index
+layout(std140) uniform MaterialBlock
+{
+    Material materials[MAX_MATERIALS];
+};
+uniform LightSource lightSources[TOTAL_LIGHTS];
+
+// the scene textures are packed into texture arrays, each on its own
+// unit - every instance picks its array and layer, and has the scale
+// (xy) and offset (zw) of its image in the layer
+uniform sampler2DArray objectTextures[TEXTURE_ARRAY_COUNT];
+
+vec3 CalcLightSource(LightSource light, Material material, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection)
 {
     // Ambient
-    float ambientStrength = 0.1;
-    vec3 ambient = ambientStrength * lightColor;
-    
-    // Diffuse 
-    vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
-    
+    vec3 ambient = light.ambientColor * material.ambientColor * material.ambientStrength;
+
+    // Diffuse
+    vec3 lightDirection = normalize(light.position - vertexPosition);
+    float impact = max(dot(lightNormal, lightDirection), 0.0);
+    vec3 diffuse = impact * light.diffuseColor * material.diffuseColor;
+
     // Specular
-    float specularStrength = 0.5;
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);  
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-    vec3 specular = specularStrength * spec * lightColor;  
-    
-    vec3 result = (ambient + diffuse + specular) * objectColor;
-    FragColor = vec4(result, 1.0);
+    vec3 reflectDirection = reflect(-lightDirection, lightNormal);
+    float specularComponent = pow(max(dot(viewDirection, reflectDirection), 0.0), light.focalStrength);
+    vec3 specular = light.specularIntensity * specularComponent * light.specularColor * material.specularColor;
+
+    return ambient + diffuse + specular;
+}
+
+vec4 SampleObjectTexture()
+{
+    // repeat the scaled coordinates inside the part of the layer
+    // the image fills, using the unwrapped gradients so the wrap
+    // seams do not pick the smallest mip level
+    vec2 uv = fragmentTextureCoordinate * fragmentSurface.xy;
+    vec2 layerUV = fract(uv) * fragmentTextureRect.xy + fragmentTextureRect.zw;
+    vec3 coordinate = vec3(layerUV, fragmentSurface.z);
+    vec2 dx = dFdx(uv) * fragmentTextureRect.xy;
+    vec2 dy = dFdy(uv) * fragmentTextureRect.xy;
+
+    // a sampler array may only be indexed by a constant, and draws of
+    // different arrays can share one draw call, so the array is picked
+    // by a switch - the gradients are found before it branches
+    switch (fragmentFlags.z)
+    {
+        case 0: return textureGrad(objectTextures[0], coordinate, dx, dy);
+        case 1: return textureGrad(objectTextures[1], coordinate, dx, dy);
+        case 2: return textureGrad(objectTextures[2], coordinate, dx, dy);
+        case 3: return textureGrad(objectTextures[3], coordinate, dx, dy);
+        case 4: return textureGrad(objectTextures[4], coordinate, dx, dy);
+        case 5: return textureGrad(objectTextures[5], coordinate, dx, dy);
+        case 6: return textureGrad(objectTextures[6], coordinate, dx, dy);
+        case 7: return textureGrad(objectTextures[7], coordinate, dx, dy);
+        case 8: return textureGrad(objectTextures[8], coordinate, dx, dy);
+        case 9: return textureGrad(objectTextures[9], coordinate, dx, dy);
+        case 10: return textureGrad(objectTextures[10], coordinate, dx, dy);
+        case 11: return textureGrad(objectTextures[11], coordinate, dx, dy);
+        case 12: return textureGrad(objectTextures[12], coordinate, dx, dy);
+        case 13: return textureGrad(objectTextures[13], coordinate, dx, dy);
+        case 14: return textureGrad(objectTextures[14], coordinate, dx, dy);
+        case 15: return textureGrad(objectTextures[15], coordinate, dx, dy);
+    }
+    return vec4(0.0);
+}
+
+void main()
+{
+    // textures are stored premultiplied by alpha, so the object
+    // color is premultiplied to match and the scene blends with
+    // GL_ONE, GL_ONE_MINUS_SRC_ALPHA
+    vec4 baseColor = (fragmentFlags.y != 0) ? SampleObjectTexture() : vec4(fragmentColor.rgb * fragmentColor.a, fragmentColor.a);
+
+    if (bUseLighting)
+    {
+        vec3 lightNormal = normalize(fragmentVertexNormal);
+        vec3 viewDirection = normalize(viewPosition - fragmentPosition);
+        vec3 phongResult = vec3(0.0);
+        Material material = materials[fragmentFlags.x];
+
+        for (int i = 0; i < TOTAL_LIGHTS; i++)
+        {
+            phongResult += CalcLightSource(lightSources[i], material, lightNormal, fragmentPosition, viewDirection);
+        }
+
+        outFragmentColor = vec4(phongResult * baseColor.rgb, baseColor.a);
+    }
+    else
+    {
+        outFragmentColor = baseColor;
+    }
 }
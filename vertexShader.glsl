@@ -1,20 +1,44 @@
 #version 330 core
 
-#set the vertex position 
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aNormal;
+// set the vertex position, normal and texture coordinate
+layout(location = 0) in vec3 inVertexPosition;
+layout(location = 1) in vec3 inVertexNormal;
+layout(location = 2) in vec2 inTextureCoordinate;
 
-out vec3 FragPos;
-out vec3 Normal;
+// every draw of a shape part is one instance, and what used to be
+// set in uniforms before each draw is read per instance - the
+// normal matrix is found once per object on the CPU, and is the
+// model matrix itself for an object scaled the same on every axis
+layout(location = 3) in mat4 instanceModel;
+layout(location = 7) in mat3 instanceNormalMatrix;
+layout(location = 10) in vec4 instanceColor;
+layout(location = 11) in vec4 instanceTextureRect;
+// UV scale (xy) and texture layer (z)
+layout(location = 12) in vec3 instanceSurface;
+// material index (x), whether the texture is used (y) and the
+// texture array it is in (z)
+layout(location = 13) in ivec3 instanceFlags;
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+flat out vec4 fragmentColor;
+flat out vec4 fragmentTextureRect;
+flat out vec3 fragmentSurface;
+flat out ivec3 fragmentFlags;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;  
+    fragmentPosition = vec3(instanceModel * vec4(inVertexPosition, 1.0));
+    fragmentVertexNormal = instanceNormalMatrix * inVertexNormal;
+    fragmentTextureCoordinate = inTextureCoordinate;
+    fragmentColor = instanceColor;
+    fragmentTextureRect = instanceTextureRect;
+    fragmentSurface = instanceSurface;
+    fragmentFlags = instanceFlags;
 
-    gl_Position = projection * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+    gl_Position = projection * view * vec4(fragmentPosition, 1.0);
+}
@@ -0,0 +1,57 @@
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+
+// set the vertex position, normal and texture coordinate
+layout(location = 0) in vec3 inVertexPosition;
+layout(location = 1) in vec3 inVertexNormal;
+layout(location = 2) in vec2 inTextureCoordinate;
+
+// the values of one draw, laid out like InstanceRenderer::INSTANCE -
+// the normal matrix is found once per object on the CPU, and is the
+// model matrix itself for an object scaled the same on every axis
+struct Instance
+{
+    mat4 model;
+    vec4 normalMatrix[3];
+    vec4 color;
+    vec4 textureRect;
+    // UV scale (xy) and texture layer (z)
+    vec4 surface;
+    // material index (x), whether the texture is used (y) and the
+    // texture array it is in (z)
+    ivec4 flags;
+};
+
+// the whole scene is one multi-draw, and every draw command starts
+// at its own first instance in this buffer
+layout(std430, binding = 1) readonly buffer InstanceBlock
+{
+    Instance instances[];
+};
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+flat out vec4 fragmentColor;
+flat out vec4 fragmentTextureRect;
+flat out vec3 fragmentSurface;
+flat out ivec3 fragmentFlags;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    Instance instance = instances[gl_BaseInstanceARB + gl_InstanceID];
+    mat3 normalMatrix = mat3(instance.normalMatrix[0].xyz, instance.normalMatrix[1].xyz, instance.normalMatrix[2].xyz);
+
+    fragmentPosition = vec3(instance.model * vec4(inVertexPosition, 1.0));
+    fragmentVertexNormal = normalMatrix * inVertexNormal;
+    fragmentTextureCoordinate = inTextureCoordinate;
+    fragmentColor = instance.color;
+    fragmentTextureRect = instance.textureRect;
+    fragmentSurface = instance.surface.xyz;
+    fragmentFlags = instance.flags.xyz;
+
+    gl_Position = projection * view * vec4(fragmentPosition, 1.0);
+}